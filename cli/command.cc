@@ -86,7 +86,8 @@ Command::setup_group (std::string id)
 void
 Command::print_verify (enum disir_status status, const char *entry,
                        struct disir_config *config,
-                       struct disir_mold *mold)
+                       struct disir_mold *mold,
+                       const char *error)
 {
     struct disir_collection *collection = NULL;
     struct disir_context *context = NULL;
@@ -160,9 +161,13 @@ Command::print_verify (enum disir_status status, const char *entry,
     {
         std::cout << "    ERROR:   " << entry << std::endl;
         std::cout << "               " << disir_status_string (status) << std::endl;
-        if (disir_error (m_cli->disir()) != NULL)
+        if (error == NULL)
         {
-            std::cout << "             " << disir_error (m_cli->disir()) << std::endl;
+            error = disir_error (m_cli->disir());
+        }
+        if (error != NULL)
+        {
+            std::cout << "             " << error << std::endl;
         }
         else
         {
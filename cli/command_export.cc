@@ -17,7 +17,9 @@ using namespace disir;
 CommandExport::CommandExport (void)
     : Command ("export"),
       m_tempdir("/tmp/disir/"),
-      m_archive_name("/archive.disir")
+      m_archive_name("/archive.disir"),
+      m_options(),
+      m_use_options(false)
 {
     // TODO: Check m_tmpdir access rights
 }
@@ -51,6 +53,20 @@ CommandExport::handle_command (std::vector<std::string> &args)
                            "Append configuration entries to an existing archive",
                            args::Matcher{"append"});
 
+    args::ValueFlag<std::string> opt_compression (parser, "CODEC",
+                                                  "Compression of the written archive:"
+                                                  " xz, zstd or none. Default is xz.",
+                                                  args::Matcher{"compression"});
+
+    args::ValueFlag<int> opt_level (parser, "LEVEL",
+                                    "Compression level. Default is the codec default.",
+                                    args::Matcher{"level"});
+
+    args::ValueFlag<int> opt_threads (parser, "N",
+                                      "Number of compression threads. 0 uses all CPUs." \
+                                      " Default is 1.",
+                                      args::Matcher{"threads"});
+
     args::PositionalList<std::string> opt_entries (parser, "entry",
                                                    "A list of entries to file.");
 
@@ -77,6 +93,27 @@ CommandExport::handle_command (std::vector<std::string> &args)
         return (1);
     }
 
+    m_use_options = (opt_compression || opt_level || opt_threads);
+    if (opt_compression && parse_compression (args::get (opt_compression)) == false)
+    {
+        std::cerr << "ValidationError: unknown compression '"
+                  << args::get (opt_compression) << "'" << std::endl;
+        std::cerr << "See '" << m_cli->m_program_name << " --help'" << std::endl;
+        return (1);
+    }
+    if (opt_level)
+    {
+        m_options.ao_level = args::get (opt_level);
+    }
+    if (opt_threads)
+    {
+        m_options.ao_threads = args::get (opt_threads);
+        if (m_options.ao_threads == 0)
+        {
+            m_options.ao_threads = -1;
+        }
+    }
+
     std::string group_id = m_cli->group_id();
     if (opt_group_id)
     {
@@ -135,6 +172,21 @@ CommandExport::handle_command (std::vector<std::string> &args)
     return populate_archive (NULL, m_archive.c_str(), group_id, entries_to_file);
 }
 
+bool
+CommandExport::parse_compression (const std::string& codec)
+{
+    if (codec == "xz")
+        m_options.ao_compression = DISIR_ARCHIVE_COMPRESSION_XZ;
+    else if (codec == "zstd")
+        m_options.ao_compression = DISIR_ARCHIVE_COMPRESSION_ZSTD;
+    else if (codec == "none")
+        m_options.ao_compression = DISIR_ARCHIVE_COMPRESSION_NONE;
+    else
+        return false;
+
+    return true;
+}
+
 bool
 CommandExport::current_working_directory (std::string& current)
 {
@@ -182,10 +234,16 @@ CommandExport::populate_archive (const char *path, const char *dest_path,
     struct disir_archive *archive;
     int ret = 0;
 
-    auto status = disir_archive_export_begin (m_cli->disir (), path, &archive);
+    // Without options, an existing archive keeps its compression
+    auto status = disir_archive_export_begin_with_options (m_cli->disir (), path,
+                                                           m_use_options ? &m_options : NULL,
+                                                           &archive);
     if (status != DISIR_STATUS_OK)
     {
         std::cout << "Unable to begin archive: " << disir_status_string (status) << std::endl;
+        auto error = disir_error (m_cli->disir ());
+        if (error)
+            std::cout << error << std::endl;
         return(1);
     }
 
@@ -205,6 +205,10 @@ CommandGenerate::generate_entries (std::set<std::string>& entries)
     struct disir_mold *mold;
     struct disir_config *config;
 
+    // Flush the written directories once, when all entries are generated.
+    // On early return, the transaction is committed when the instance is destroyed.
+    disir_write_begin (m_cli->disir());
+
     for (const auto entry : entries)
     {
         status = disir_mold_read (m_cli->disir(), m_cli->group_id().c_str(),
@@ -269,6 +273,13 @@ CommandGenerate::generate_entries (std::set<std::string>& entries)
         std::cout << "  Generated " << entry << std::endl;
     }
 
+    status = disir_write_commit (m_cli->disir());
+    if (status != DISIR_STATUS_OK && status != DISIR_STATUS_NOT_EXIST)
+    {
+        std::cerr << "config write error: " << disir_error (m_cli->disir()) << std::endl;
+        return (-1);
+    }
+
     return (0);
 
 }
@@ -67,6 +67,10 @@ CommandImport::handle_command (std::vector<std::string> &args)
     args::Flag opt_dry_run (prompt_opt_group, "dry-run", "Print the effects of an import option.",
                             args::Matcher{"dry-run"});
 
+    args::ValueFlag<int> opt_jobs (parser, "N",
+                                   "Resolve the import status of up to N entries in parallel.",
+                                   args::Matcher{'j', "jobs"});
+
     try
     {
         parser.ParseArgs (args);
@@ -89,6 +93,17 @@ CommandImport::handle_command (std::vector<std::string> &args)
         return (1);
     }
 
+    int jobs = 1;
+    if (opt_jobs)
+    {
+        jobs = args::get (opt_jobs);
+        if (jobs < 1)
+        {
+            std::cerr << "--jobs must be a positive number." << std::endl;
+            return (1);
+        }
+    }
+
     if (opt_archive_path)
     {
         struct disir_import *import;
@@ -101,7 +116,8 @@ CommandImport::handle_command (std::vector<std::string> &args)
         int ret = 1;
         int entries;
 
-        status = disir_archive_import (m_cli->disir(), archive_path.c_str(), &import, &entries);
+        status = disir_archive_import_with_jobs (m_cli->disir(), archive_path.c_str(), 0, jobs,
+                                                 &import, &entries);
         if (status != DISIR_STATUS_OK)
         {
             std::cerr << "Could not import archive (" << archive_path << "): "
@@ -2,6 +2,11 @@
 #include <algorithm>
 #include <memory>
 #include <set>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 #include <disir/disir.h>
 #include <disir/fslib/util.h>
@@ -12,6 +17,19 @@
 
 using namespace disir;
 
+//! Outcome of reading a single entry, filled in by the thread that read it.
+struct verify_result
+{
+    std::string entry;
+    enum disir_status status;
+    struct disir_config *config;
+    struct disir_mold *mold;
+    //! disir_error () of the reading thread, if any.
+    std::string error;
+    bool has_error;
+    bool done;
+};
+
 CommandVerify::CommandVerify(void)
     : Command ("verify")
 {
@@ -41,6 +59,9 @@ CommandVerify::handle_command (std::vector<std::string> &args)
     args::ValueFlag<std::string> opt_text_mold (parser, "TEXT MOLD",
                                                 "Verify mold from disk.",
                                                 args::Matcher{"text-mold"});
+    args::ValueFlag<int> opt_jobs (parser, "N",
+                                   "Read and verify up to N entries in parallel.",
+                                   args::Matcher{'j', "jobs"});
     args::PositionalList<std::string> opt_entries (parser, "entry",
                                                    "A list of entries to verify.");
 
@@ -105,6 +126,17 @@ CommandVerify::handle_command (std::vector<std::string> &args)
         return (1);
     }
 
+    int jobs = 1;
+    if (opt_jobs)
+    {
+        jobs = args::get (opt_jobs);
+        if (jobs < 1)
+        {
+            std::cerr << "--jobs must be a positive number." << std::endl;
+            return (1);
+        }
+    }
+
     // Get the set of entries to verify
     std::set<std::string> entries_to_verify;
     if (opt_entries)
@@ -162,29 +194,93 @@ CommandVerify::handle_command (std::vector<std::string> &args)
     m_cli->verbose() << "There are " << entries_to_verify.size()
                      << " entries to verify." << std::endl;
     std::cout << std::endl;
+
+    // Entries are read by up to jobs threads, but printed by this thread in set order,
+    // such that the output is identical regardless of the number of jobs.
+    std::vector<struct verify_result> results;
     for (const auto& entry : entries_to_verify)
+    {
+        results.push_back ({entry, DISIR_STATUS_OK, NULL, NULL, "", false, false});
+    }
+
+    std::mutex results_mutex;
+    std::condition_variable results_cond;
+    std::atomic<size_t> next_index (0);
+    bool verify_mold = opt_mold;
+
+    auto read_entry = [&] (struct verify_result& result)
     {
         // We simply read the config entry - the return status shall indicate whether it is invalid or not
         enum disir_status status;
         struct disir_config *config = NULL;
         struct disir_mold *mold = NULL;
+        const char *error;
 
-        if (opt_mold)
+        if (verify_mold)
         {
             status = disir_mold_read (m_cli->disir(), m_cli->group_id().c_str(),
-                                      entry.c_str(), &mold);
+                                      result.entry.c_str(), &mold);
         }
         else
         {
             status = disir_config_read (m_cli->disir(), m_cli->group_id().c_str(),
-                                        entry.c_str(), NULL, &config);
+                                        result.entry.c_str(), NULL, &config);
+        }
+        // The error message is kept per thread - capture it before handing over the result.
+        error = disir_error (m_cli->disir());
+
+        std::lock_guard<std::mutex> lock (results_mutex);
+        result.status = status;
+        result.config = config;
+        result.mold = mold;
+        result.has_error = (error != NULL);
+        if (error)
+            result.error = error;
+        result.done = true;
+        results_cond.notify_all();
+    };
+
+    std::vector<std::thread> workers;
+    if (jobs > 1)
+    {
+        jobs = std::min (jobs, (int) results.size());
+        m_cli->verbose() << "Verifying with " << jobs << " jobs." << std::endl;
+        for (int i = 0; i < jobs; i++)
+        {
+            workers.emplace_back ([&] ()
+            {
+                size_t index;
+                while ((index = next_index++) < results.size())
+                {
+                    read_entry (results[index]);
+                }
+            });
         }
+    }
 
-        print_verify (status, entry.c_str(), config, mold);
-        if (config)
-            disir_config_finished (&config);
-        if (mold)
-            disir_mold_finished (&mold);
+    for (auto& result : results)
+    {
+        if (workers.empty())
+        {
+            read_entry (result);
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock (results_mutex);
+            results_cond.wait (lock, [&result] { return result.done; });
+        }
+
+        print_verify (result.status, result.entry.c_str(), result.config, result.mold,
+                      (result.has_error ? result.error.c_str() : "(no error registered)"));
+        if (result.config)
+            disir_config_finished (&result.config);
+        if (result.mold)
+            disir_mold_finished (&result.mold);
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
     }
     std::cout << std::endl;
 
@@ -41,6 +41,39 @@ enum disir_import_option
     DISIR_IMPORT_UPDATE_WITH_DISCARD,
 };
 
+//! Compression of the archives written by disir_archive_finalize.
+//! Archives are decompressed with whichever codec they were written with.
+enum disir_archive_compression
+{
+    //! xz (LZMA2). The default.
+    DISIR_ARCHIVE_COMPRESSION_XZ = 0,
+    //! Zstandard. Considerably faster than xz, at a slightly lower ratio.
+    DISIR_ARCHIVE_COMPRESSION_ZSTD,
+    //! Plain tar, uncompressed.
+    DISIR_ARCHIVE_COMPRESSION_NONE,
+};
+
+//! Options for writing a disir archive. A zeroed structure holds the defaults.
+struct disir_archive_options
+{
+    //! Codec to compress the archive with.
+    enum disir_archive_compression ao_compression;
+    //! Codec specific compression level, e.g., 0-9 for xz or 1-22 for zstd.
+    //! Zero selects the codec default.
+    int ao_level;
+    //! Number of threads compressing the archive. Zero or one compresses on a single
+    //! thread. A negative number uses one thread per online CPU.
+    int ao_threads;
+};
+
+//! disir archive import flags
+enum disir_archive_import_flag
+{
+    //! Extract the archive to a temporary folder and read the entries from there,
+    //! rather than reading the archive into memory.
+    DISIR_ARCHIVE_IMPORT_EXTRACT = 1 << 0,
+};
+
 //! \brief Begin exporting a new or existing archive.
 //!
 //! Function initiates exporting a new or already existing archive
@@ -48,6 +81,9 @@ enum disir_import_option
 //! be further populated with entries by calls to disir_archive_append_entry or
 //! disir_archive_append_group.
 //!
+//! The entries of an existing archive are kept as they are compressed when finalized;
+//! only the appended entries and the archive metadata are compressed anew.
+//!
 //! \param[in] instance The disir instance.
 //! \param[in] archive_path Filepath either path to an archive to which entries can be
 //!     appended, or NULL to start a new one.
@@ -64,6 +100,31 @@ enum disir_status
 disir_archive_export_begin (struct disir_instance *instance,
                             const char *archive_path, struct disir_archive **archive);
 
+//! \brief Begin exporting a new or existing archive, as disir_archive_export_begin.
+//!
+//! The archive is written by disir_archive_finalize according to options.
+//! The compressed entries of an existing archive with the same codec are kept as they are.
+//! An existing archive compressed with another codec is rewritten with these options.
+//!
+//! \param[in] instance The disir instance.
+//! \param[in] archive_path Filepath either path to an archive to which entries can be
+//!     appended, or NULL to start a new one.
+//! \param[in] options Compression options. NULL selects the defaults.
+//! \param[out] archive The disir archive structure containing archive state.
+//!
+//! \return DISIR_STATUS_OK on success.
+//! \return DISIR_STATUS_INVALID_ARGUMENT if either of the inputs are NULL, or options
+//!     names an unknown codec or a level it does not support.
+//! \return DISIR_STATUS_FS_ERROR if archive is invalid. May involve invalid metadata, failure to
+//!     extract data, failure when writing to new archive or writing config entries to disk.
+//! \return DISIR_STATUS_NO_MEMORY if unable to allocate enough memory for disir archive structure.
+//!
+enum disir_status
+disir_archive_export_begin_with_options (struct disir_instance *instance,
+                                         const char *archive_path,
+                                         const struct disir_archive_options *options,
+                                         struct disir_archive **archive);
+
 //! \brief Append configs within group to a disir archive.
 //!
 //! Function will append all configs within the given group to an archive created
@@ -155,6 +216,46 @@ enum disir_status
 disir_archive_import (struct disir_instance *instance, const char *archive_path,
                       struct disir_import **import, int *entries);
 
+//! \brief Retrive config entries from disir_archive, as disir_archive_import.
+//!
+//! The archive is read into memory and its entries unserialized from there,
+//! unless DISIR_ARCHIVE_IMPORT_EXTRACT is set in flags.
+//!
+//! \param[in] instance The disir instance.
+//! \param[in] archive_path Filepath to the disir archive
+//! \param[in] flags Bitwise OR of enum disir_archive_import_flag values, or zero.
+//! \param[out] import The structure containing import state.
+//! \param[out] import_entries The number of configuration entries
+//!
+//! \return DISIR_STATUS_OK on success.
+//! \return DISIR_STATUS_FS_ERROR if archive is invalid, or cannot be extracted.
+//! \return DISIR_STATUS_NOT_EXIST if no archive on archive_path exist.
+//!
+enum disir_status
+disir_archive_import_with_flags (struct disir_instance *instance, const char *archive_path,
+                                 int flags, struct disir_import **import, int *entries);
+
+//! \brief Retrive config entries from disir_archive, as disir_archive_import_with_flags.
+//!
+//! The import status of the entries is resolved by up to jobs threads.
+//! The entries are ordered as when resolved by a single thread.
+//!
+//! \param[in] instance The disir instance.
+//! \param[in] archive_path Filepath to the disir archive
+//! \param[in] flags Bitwise OR of enum disir_archive_import_flag values, or zero.
+//! \param[in] jobs Number of threads resolving entries. Zero or one resolves them on the
+//!     calling thread. A negative number uses one thread per online CPU.
+//! \param[out] import The structure containing import state.
+//! \param[out] import_entries The number of configuration entries
+//!
+//! \return DISIR_STATUS_OK on success.
+//! \return DISIR_STATUS_FS_ERROR if archive is invalid, or cannot be extracted.
+//! \return DISIR_STATUS_NOT_EXIST if no archive on archive_path exist.
+//!
+enum disir_status
+disir_archive_import_with_jobs (struct disir_instance *instance, const char *archive_path,
+                                int flags, int jobs, struct disir_import **import, int *entries);
+
 //! \brief Retrieve information about a single configuration entry.
 //!
 //! Function will return the information about a import configuration entry
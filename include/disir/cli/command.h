@@ -38,8 +38,11 @@ namespace disir
 
         // Print the unserialized config or mold (not both) and
         // verify its content if the input status is not ok.
+        // error is the disir_error captured by the thread that read the entry;
+        // if NULL, the error of the calling thread is printed.
         void print_verify (enum disir_status status, const char *entry,
-                           struct disir_config *config, struct disir_mold *mold);
+                           struct disir_config *config, struct disir_mold *mold,
+                           const char *error = NULL);
 
     // Variables
     protected:
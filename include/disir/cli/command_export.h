@@ -24,6 +24,10 @@ namespace disir
         std::string m_tempdir = "";
         // name of archive
         std::string m_archive_name = "";
+        // compression of the written archive
+        struct disir_archive_options m_options;
+        // whether m_options was given on the command line
+        bool m_use_options;
 
         // Creates and export archive of config entries
         int populate_archive (const char *path, const char *dest_path,
@@ -34,6 +38,9 @@ namespace disir
         int append_entries (struct disir_archive *archive,
                             std::string& group_id, std::set<std::string>& entries);
 
+        // Parse compression codec name into m_options
+        bool parse_compression (const std::string& codec);
+
         // read cwd
         bool current_working_directory (std::string& current);
     };
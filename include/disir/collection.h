@@ -48,7 +48,8 @@ dc_collection_push_context (struct disir_collection *collection, struct disir_co
 //! When the iterator is exhausted, dc_collection_reset() will set
 //! the iterator to the first context in the collection.
 //!
-//! The collection is coalesced before retrieving the next context.
+//! The collection is coalesced before retrieving the next context,
+//! if any context has been destroyed since it was last coalesced.
 //!
 //! \param[in] collection The iterator to query the next context from.
 //! \param[out] context Populated pointer with the context to retrieve.
@@ -60,6 +61,24 @@ dc_collection_push_context (struct disir_collection *collection, struct disir_co
 enum disir_status
 dc_collection_next (struct disir_collection *collection, struct disir_context **context);
 
+//! \brief Retrieve the next context from the collection, without taking a reference.
+//!
+//! Behaves as dc_collection_next(), except that no reference is incremented
+//! on the yielded context. The context is borrowed from the collection, and
+//! remains valid until the next iteration or until the collection is finished.
+//! The caller must NOT call dc_putcontext() on the yielded context.
+//!
+//! \param[in] collection The iterator to query the next context from.
+//! \param[out] context Populated pointer with the context to retrieve.
+//!
+//! \return DISIR_STATUS_INVALID_ARGUMENT if collection or context are NULL.
+//! \return DISIR_STATUS_EXHAUSTED when the collection iterator is empty.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dc_collection_next_borrowed (struct disir_collection *collection,
+                             struct disir_context **context);
+
 //! \brief Reset the iterator back to the first context in collection.
 //!
 //! \param[in] collection The iterator to reset.
@@ -72,7 +91,8 @@ dc_collection_reset (struct disir_collection *collection);
 
 //! \brief Retrieve the number of context' in the collection.
 //!
-//! The collection is coalesced before retrieving the size.
+//! The collection is coalesced before retrieving the size,
+//! if any context has been destroyed since it was last coalesced.
 //!
 //! \param[in] collection The iterator to reset.
 //!
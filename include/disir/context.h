@@ -138,6 +138,28 @@ enum disir_status dc_finalize (struct disir_context **context);
 //!
 enum disir_status dc_putcontext (struct disir_context **context);
 
+//! \brief Allocate every context subsequently added to a top-level context from an arena.
+//!
+//! Contexts (and their element structures) added below the CONFIG or MOLD context
+//! after this call are carved out of a few large blocks owned by the top-level context,
+//! instead of being allocated one by one. Memory of a child destroyed while the tree
+//! lives on is reused by the children added after it. When the top-level context is
+//! destroyed, the whole tree is released at once instead of child by child.
+//! Contexts still referenced by the user are left behind destroyed, as usual, and the
+//! blocks are freed once the last of them is put back.
+//! Intended for trees that are built in one go and discarded as a whole,
+//! such as configs and molds read from disk. See disir_read_arena().
+//!
+//! Enabling the arena on a context that already has one is a no-op.
+//!
+//! \return DISIR_STATUS_WRONG_CONTEXT if context is not CONFIG or MOLD.
+//! \return DISIR_STATUS_CONTEXT_IN_WRONG_STATE if context is finalized,
+//!     or already has children.
+//! \return DISIR_STATUS_NO_MEMORY if the arena could not be allocated.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status dc_enable_arena (struct disir_context *context);
+
 //! \brief Query the context whether or not it is valid
 //!
 //! \return DISIR_STATUS_OK if valid
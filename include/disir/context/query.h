@@ -125,6 +125,186 @@ enum disir_status
 dc_query_resolve_context_va (struct disir_context *parent, const char *name,
                              struct disir_context **out, va_list args);
 
+//! Opaque handle to a query parsed by dc_query_compile.
+//!
+//! A compiled query holds the parsed element names and indices of a query,
+//! such that it may be resolved repeatedly without parsing it again.
+//! It is not tied to any context, and may be resolved against any config,
+//! mold or section - e.g., against each new config read on reload.
+//! A compiled query is immutable, and may be shared between threads.
+//!
+struct disir_query;
+
+//! \brief Parse a query once into a reusable handle.
+//!
+//! \param[out] query Output handle to the compiled query.
+//!     Caller must use dc_query_finished when done with it.
+//! \param[in] name Query format to compile. See dc_query_resolve_context.
+//! \param[in] ... varadic arguments used for name argument.
+//!
+//! \return DISIR_STATUS_INVALID_ARGUMENT if query or name are NULL, or name does not parse.
+//! \return DISIR_STATUS_NO_MEMORY on allocation failure.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dc_query_compile (struct disir_query **query, const char *name, ...);
+
+//! \see dc_query_compile
+//!
+//! Varadic argument version of dc_query_compile.
+enum disir_status
+dc_query_compile_va (struct disir_query **query, const char *name, va_list args);
+
+//! \brief Free a compiled query. The handle is set to NULL.
+//!
+//! \return DISIR_STATUS_INVALID_ARGUMENT if query or *query is NULL.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dc_query_finished (struct disir_query **query);
+
+//! \brief Resolve a compiled query for a context relative to parent.
+//!
+//! Compiled query equivalent of dc_query_resolve_context.
+//!
+//! \param[in] parent The context to query from.
+//! \param[in] query Compiled query to resolve.
+//! \param[out] out Output context to query for and return.
+//!     Caller must use dc_putcontext when finished.
+//!
+//! \return DISIR_STATUS_NOT_EXIST if any element of the query does not exist.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dc_query_resolve (struct disir_context *parent, struct disir_query *query,
+                  struct disir_context **out);
+
+//! \brief Get the value of the keyval resolved by a compiled query.
+//!
+//! The string and enum variants populate value with a reference to the string
+//! held by the keyval.
+//!
+//! \param[in] parent The config/section to begin resolution from.
+//! \param[in] query Compiled query to resolve.
+//! \param[out] value Populated with the value of the resolved keyval.
+//!
+//! \return DISIR_STATUS_INVALID_ARGUMENT if any argument is NULL.
+//! \return DISIR_STATUS_NOT_EXIST if the keyval does not exist.
+//! \return DISIR_STATUS_WRONG_VALUE_TYPE if the keyval is of another value type.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dc_query_get_string (struct disir_context *parent, struct disir_query *query,
+                     const char **value);
+
+//! \see dc_query_get_string
+enum disir_status
+dc_query_get_enum (struct disir_context *parent, struct disir_query *query,
+                   const char **value);
+
+//! \see dc_query_get_string
+enum disir_status
+dc_query_get_integer (struct disir_context *parent, struct disir_query *query,
+                      int64_t *value);
+
+//! \see dc_query_get_string
+enum disir_status
+dc_query_get_float (struct disir_context *parent, struct disir_query *query,
+                    double *value);
+
+//! \see dc_query_get_string
+enum disir_status
+dc_query_get_boolean (struct disir_context *parent, struct disir_query *query,
+                      uint8_t *value);
+
+//! \brief Set the value of the keyval resolved by a compiled query.
+//!
+//! Follows the same semantics as dc_config_set_keyval_string: if the leaf keyval does not
+//! exist, it is created, provided it is the next entry of its name in its parent.
+//!
+//! \param[in] parent The config/section to begin resolution from.
+//! \param[in] query Compiled query to resolve.
+//! \param[in] value The value to set the keyval to.
+//!
+//! \return DISIR_STATUS_INVALID_ARGUMENT if parent, query or a string value is NULL.
+//! \return DISIR_STATUS_MOLD_MISSING if the keyval to create does not exist in the mold.
+//! \return DISIR_STATUS_WRONG_VALUE_TYPE if the keyval is of another value type.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dc_query_set_string (struct disir_context *parent, struct disir_query *query,
+                     const char *value);
+
+//! \see dc_query_set_string
+enum disir_status
+dc_query_set_enum (struct disir_context *parent, struct disir_query *query,
+                   const char *value);
+
+//! \see dc_query_set_string
+enum disir_status
+dc_query_set_integer (struct disir_context *parent, struct disir_query *query,
+                      int64_t value);
+
+//! \see dc_query_set_string
+enum disir_status
+dc_query_set_float (struct disir_context *parent, struct disir_query *query,
+                    double value);
+
+//! \see dc_query_set_string
+enum disir_status
+dc_query_set_boolean (struct disir_context *parent, struct disir_query *query,
+                      uint8_t value);
+
+//! A single keyval to get or set in a batch. See dc_query_get_batch.
+struct disir_query_item
+{
+    //! Compiled query of the keyval, relative to the batch parent.
+    struct disir_query          *qi_query;
+
+    //! Value type of the keyval.
+    enum disir_value_type       qi_type;
+
+    //! Pointer to a variable of the type matching qi_type:
+    //!     const char * for DISIR_VALUE_TYPE_STRING and DISIR_VALUE_TYPE_ENUM,
+    //!     int64_t for DISIR_VALUE_TYPE_INTEGER,
+    //!     double for DISIR_VALUE_TYPE_FLOAT,
+    //!     uint8_t for DISIR_VALUE_TYPE_BOOLEAN.
+    //! The variable is populated by dc_query_get_batch, and read by dc_query_set_batch.
+    void                        *qi_value;
+
+    //! Populated with the status of getting or setting this item.
+    //! The status is that of the equivalent dc_query_get_* or dc_query_set_* call.
+    enum disir_status           qi_status;
+};
+
+//! \brief Get the value of many keyvals in a single traversal.
+//!
+//! The items are ordered by query, such that the sections shared between
+//! queries are resolved once, in a single depth-first walk from parent.
+//! The items array itself is not reordered.
+//!
+//! \param[in] parent The config/section to begin resolution from.
+//! \param[in,out] items Array of items to get. Each item is populated with its status.
+//! \param[in] count Number of entries in items.
+//!
+//! \return DISIR_STATUS_INVALID_ARGUMENT if parent or items are NULL, or count is negative.
+//! \return DISIR_STATUS_NO_MEMORY on allocation failure. No item is processed.
+//! \return The status of the first failed item in items, if any.
+//! \return DISIR_STATUS_OK if every item succeeded.
+//!
+enum disir_status
+dc_query_get_batch (struct disir_context *parent, struct disir_query_item *items, int32_t count);
+
+//! \brief Set the value of many keyvals in a single traversal.
+//!
+//! \see dc_query_get_batch
+//! \see dc_query_set_string
+//!
+//! Items are set in query order, which need not be the order of the items array.
+//!
+enum disir_status
+dc_query_set_batch (struct disir_context *parent, struct disir_query_item *items, int32_t count);
+
 
 #ifdef __cplusplus
 }
@@ -225,6 +225,56 @@ disir_instance_create (const char *config_filepath, struct disir_config *config,
 enum disir_status
 disir_instance_destroy (struct disir_instance **instance);
 
+//! \brief Batch the config and mold writes that follow into a single write transaction.
+//!
+//! Filesystem plugins always write an entry to a temporary file and rename it into place,
+//! such that an entry is never left partially written. While a transaction is active,
+//! the directories written to are only flushed to disk once each, by disir_write_commit().
+//! Use this when writing many entries in a row.
+//!
+//! \return DISIR_STATUS_INVALID_ARGUMENT if instance is NULL.
+//! \return DISIR_STATUS_EXISTS if a transaction is already active on instance.
+//! \return DISIR_STATUS_NO_MEMORY on allocation failure.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+disir_write_begin (struct disir_instance *instance);
+
+//! \brief Flush every directory written to since disir_write_begin(), ending the transaction.
+//!
+//! The transaction is ended even if flushing a directory fails.
+//! A transaction still active when the instance is destroyed is committed.
+//!
+//! \return DISIR_STATUS_INVALID_ARGUMENT if instance is NULL.
+//! \return DISIR_STATUS_NOT_EXIST if no transaction is active on instance.
+//! \return DISIR_STATUS_FS_ERROR if a directory could not be flushed.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+disir_write_commit (struct disir_instance *instance);
+
+//! \brief Allocate the configs and molds read through instance from an arena.
+//!
+//! When enabled, filesystem plugins enable the arena on every config and mold they
+//! read, see dc_enable_arena(). Such a tree is allocated in a few large blocks instead
+//! of node by node, and released at once when finished. Disabled by default.
+//!
+//! \param[in] instance Library instance.
+//! \param[in] enable Non-zero to enable, zero to disable.
+//!
+//! \return DISIR_STATUS_INVALID_ARGUMENT if instance is NULL.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+disir_read_arena (struct disir_instance *instance, int enable);
+
+//! \brief Query whether configs and molds read through instance are allocated from an arena.
+//!
+//! \return 1 if enabled with disir_read_arena(), 0 otherwise or if instance is NULL.
+//!
+int
+disir_read_arena_enabled (struct disir_instance *instance);
+
 //! \brief Log a USER level log entry to the disir log.
 //!
 void
@@ -233,6 +283,8 @@ disir_log_user (struct disir_instance *instance, const char *message, ...);
 //! \brief Set an error message to the disir instance.
 //!
 //! This will also issue a ERROR level log event to the log stream.
+//! Error messages are kept per calling thread; disir_error(), disir_error_copy()
+//! and disir_error_clear() only operate on the message set by the same thread.
 //!
 void
 disir_error_set (struct disir_instance *instance, const char *message, ...);
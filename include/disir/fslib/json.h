@@ -43,6 +43,12 @@ enum disir_status
 dio_json_config_fd_read (struct disir_instance *instance, FILE *in,
                          struct disir_mold *mold, struct disir_config **config);
 
+//! \brief JSON implementation of config_span_read
+//!
+enum disir_status
+dio_json_config_span_read (struct disir_instance *instance, const char *data, size_t size,
+                           struct disir_mold *mold, struct disir_config **config);
+
 //! \brief JSON imlementation of config_entries
 //!
 enum disir_status
@@ -98,6 +104,12 @@ enum disir_status
 dio_json_unserialize_config (struct disir_instance *instance, FILE *input,
                              struct disir_mold *mold, struct disir_config **config);
 
+//! \brief Unserialize a config from a contiguous span of json, without copying it.
+enum disir_status
+dio_json_unserialize_config_span (struct disir_instance *instance,
+                                  const char *data, size_t size,
+                                  struct disir_mold *mold, struct disir_config **config);
+
 //! TODO: docs
 enum disir_status
 dio_json_serialize_mold (struct disir_instance *instance,
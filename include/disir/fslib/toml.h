@@ -56,6 +56,12 @@ enum disir_status
 dio_toml_unserialize_config (struct disir_instance *instance, FILE *input,
                              struct disir_mold *mold, struct disir_config **config);
 
+//! \brief Unserialize a config from a contiguous span of TOML, without copying it.
+enum disir_status
+dio_toml_unserialize_config_span (struct disir_instance *instance,
+                                  const char *data, size_t size,
+                                  struct disir_mold *mold, struct disir_config **config);
+
 
 #ifdef __cplusplus
 }
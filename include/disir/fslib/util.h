@@ -23,6 +23,14 @@ typedef enum disir_status (*dio_unserialize_config) (struct disir_instance *,
                                                      struct disir_mold *,
                                                      struct disir_config **);
 
+//! Function signature for unserializing a config from a contiguous, read-only span.
+//! The span is only valid for the duration of the call.
+typedef enum disir_status (*dio_unserialize_config_span) (struct disir_instance *,
+                                                          const char *,
+                                                          size_t,
+                                                          struct disir_mold *,
+                                                          struct disir_config **);
+
 //! Function signature for standard filesystem serializable mold format
 typedef enum disir_status (*dio_serialize_mold) (struct disir_instance *,
                                                  struct disir_mold *,
@@ -122,6 +130,17 @@ fslib_plugin_config_read (struct disir_instance *instance,
                           struct disir_mold *mold, struct disir_config **config,
                           dio_unserialize_config func_unserialize);
 
+//! \brief Generic filesystem based implementation of config_read, reading a memory mapping.
+//!
+//! The entry file is mapped and handed to func_unserialize as one contiguous span,
+//! without copying it through any stream buffers.
+//!
+enum disir_status
+fslib_plugin_config_read_mapped (struct disir_instance *instance,
+                                 struct disir_register_plugin *plugin, const char *entry_id,
+                                 struct disir_mold *mold, struct disir_config **config,
+                                 dio_unserialize_config_span func_unserialize);
+
 //! \brief Generic filesystem based implementation of mold_read
 enum disir_status
 fslib_plugin_mold_read (struct disir_instance *instance,
@@ -16,6 +16,11 @@ extern "C"{
 //!
 //! Read a Mold object from `disir` identified by `entry_id`.
 //!
+//! Filesystem based plugins keep the molds they read in a cache held by `instance`,
+//! such that reading the same entry again while its files are unchanged returns the
+//! same object. The returned mold is therefore shared with every other reader of the
+//! entry and MUST NOT be modified. Release it with disir_mold_finished() as usual.
+//!
 //! \param[in] instance Library instance.
 //! \param[in] group_id String identifier for the which group to look for entry.
 //! \param[in] entry_id String identifier for the config entry to read.
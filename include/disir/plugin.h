@@ -57,6 +57,9 @@ typedef enum disir_status (*config_write) (struct disir_instance *instance,
 
 //! \brief Function signature for plugin to implement writing config object to FILE
 //!
+//! The FILE may be a memory stream without a file descriptor, e.g., when
+//! exporting to an archive. Write through the FILE, not its descriptor.
+//!
 //! \param[in] instance Library instance associated with this I/O operation.
 //! \param[in] config The config object to persist to 'id' locatiton.
 //! \param[out] out File to which serialized config is written
@@ -72,6 +75,24 @@ typedef enum disir_status (*config_fd_read) (struct disir_instance *instance,
                                              struct disir_mold *mold,
                                              struct disir_config **config);
 
+//! \brief Function signature for plugin to implement reading config object from memory
+//!
+//! Optional. Allows reading serialized configs, e.g., from an archive, without
+//! wrapping them in a FILE for config_fd_read.
+//!
+//! \param[in] instance Library instance associated with this I/O operation.
+//! \param[in] data Serialized config. Only valid for the duration of the call.
+//! \param[in] size Size of data in bytes.
+//! \param[in] mold The mold to unserialize the config with.
+//! \param[out] config The fully populated config object.
+//!
+//! \return DISIR_STATUS_OK on success.
+//!
+typedef enum disir_status (*config_span_read) (struct disir_instance *instance,
+                                               const char *data, size_t size,
+                                               struct disir_mold *mold,
+                                               struct disir_config **config);
+
 //! \brief Function signature for plugin to implement retrieval of all available config entries.
 //!
 //! Caller is responsible to invoke disir_entry_finished () on (every)
@@ -207,6 +228,8 @@ struct disir_register_plugin
     mold_write      dp_mold_write;
     mold_entries    dp_mold_entries;
     mold_query      dp_mold_query;
+
+    config_span_read dp_config_span_read;
 };
 
 //! Registered plugin with the instance
@@ -0,0 +1,300 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "arena.h"
+#include "log.h"
+
+//! Size of each arena chunk, including its header.
+#define ARENA_CHUNK_SIZE (16 * 1024)
+
+//! Allocations larger than this get a dedicated chunk,
+//! so a single large request does not waste the rest of the current chunk.
+#define ARENA_LARGE_ALLOCATION (ARENA_CHUNK_SIZE / 4)
+
+//! Alignment of every allocation handed out by the arena.
+#define ARENA_ALIGNMENT (sizeof (max_align_t))
+
+#define ARENA_ALIGN(size) (((size) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1))
+
+//! Number of distinct allocation sizes the arena keeps free lists for.
+//! A tree only allocates a handful of structure sizes from its arena.
+#define ARENA_FREE_LISTS 8
+
+//! A contiguous block of memory allocations are carved out of.
+struct arena_chunk
+{
+    //! Next (older) chunk in the arena.
+    struct arena_chunk      *ac_next;
+
+    //! Number of bytes in use in ac_data.
+    size_t                  ac_used;
+
+    //! Number of bytes available in ac_data.
+    size_t                  ac_size;
+
+    //! Start of the allocatable memory.
+    max_align_t             ac_data[];
+};
+
+//! Memory freed back to the arena, to be handed out again.
+struct arena_free
+{
+    //! Next block of the same size.
+    struct arena_free       *af_next;
+};
+
+//! Blocks of a single (aligned) size freed back to the arena.
+struct arena_free_list
+{
+    //! Zero if the list is unused.
+    size_t                  fl_size;
+    struct arena_free       *fl_blocks;
+};
+
+struct disir_arena
+{
+    //! Chunk currently allocated from, linked to all older chunks.
+    struct arena_chunk      *ar_chunks;
+
+    //! Freed memory, by size.
+    struct arena_free_list  ar_free[ARENA_FREE_LISTS];
+
+    //! Most recently tracked link. See dx_arena_track()
+    struct disir_arena_link *ar_tracked;
+
+    //! Number of references held on the arena.
+    int64_t                 ar_refcount;
+};
+
+//! STATIC API
+static struct arena_chunk *
+arena_chunk_create (size_t size)
+{
+    struct arena_chunk *chunk;
+
+    chunk = malloc (sizeof (struct arena_chunk) + size);
+    if (chunk == NULL)
+        return NULL;
+
+    chunk->ac_next = NULL;
+    chunk->ac_used = 0;
+    chunk->ac_size = size;
+
+    return chunk;
+}
+
+//! STATIC API
+//! Return the free list of blocks of size, if any.
+//! If create is non-zero, an unused list is claimed for size if none exists.
+static struct arena_free_list *
+arena_free_list (struct disir_arena *arena, size_t size, int create)
+{
+    int i;
+
+    for (i = 0; i < ARENA_FREE_LISTS; i++)
+    {
+        if (arena->ar_free[i].fl_size == size)
+            return &arena->ar_free[i];
+        if (arena->ar_free[i].fl_size == 0)
+        {
+            if (create == 0)
+                return NULL;
+            arena->ar_free[i].fl_size = size;
+            return &arena->ar_free[i];
+        }
+    }
+
+    return NULL;
+}
+
+//! INTERNAL API
+struct disir_arena *
+dx_arena_create (void)
+{
+    struct disir_arena *arena;
+
+    arena = calloc (1, sizeof (struct disir_arena));
+    if (arena == NULL)
+        return NULL;
+
+    arena->ar_refcount = 1;
+
+    return arena;
+}
+
+//! INTERNAL API
+void *
+dx_arena_alloc (struct disir_arena *arena, size_t size)
+{
+    struct arena_chunk *chunk;
+    struct arena_free_list *list;
+    void *memory;
+
+    if (arena == NULL)
+    {
+        log_debug (0, "invoked with arena NULL pointer.");
+        return NULL;
+    }
+
+    size = ARENA_ALIGN (size);
+
+    list = arena_free_list (arena, size, 0);
+    if (list && list->fl_blocks)
+    {
+        memory = list->fl_blocks;
+        list->fl_blocks = list->fl_blocks->af_next;
+        memset (memory, 0, size);
+        return memory;
+    }
+
+    if (size > ARENA_LARGE_ALLOCATION)
+    {
+        // Dedicated chunk - link it behind the current one so we keep bumping from that.
+        chunk = arena_chunk_create (size);
+        if (chunk == NULL)
+            return NULL;
+
+        if (arena->ar_chunks)
+        {
+            chunk->ac_next = arena->ar_chunks->ac_next;
+            arena->ar_chunks->ac_next = chunk;
+        }
+        else
+        {
+            arena->ar_chunks = chunk;
+        }
+        chunk->ac_used = size;
+        memset (chunk->ac_data, 0, size);
+        return chunk->ac_data;
+    }
+
+    chunk = arena->ar_chunks;
+    if (chunk == NULL || chunk->ac_size - chunk->ac_used < size)
+    {
+        chunk = arena_chunk_create (ARENA_CHUNK_SIZE - sizeof (struct arena_chunk));
+        if (chunk == NULL)
+            return NULL;
+
+        chunk->ac_next = arena->ar_chunks;
+        arena->ar_chunks = chunk;
+    }
+
+    memory = (char *) chunk->ac_data + chunk->ac_used;
+    chunk->ac_used += size;
+    memset (memory, 0, size);
+
+    return memory;
+}
+
+//! INTERNAL API
+void
+dx_arena_free (struct disir_arena *arena, void *ptr, size_t size)
+{
+    struct arena_free_list *list;
+    struct arena_free *block;
+
+    if (arena == NULL || ptr == NULL)
+        return;
+
+    size = ARENA_ALIGN (size);
+
+    // Dedicated chunks are kept until the arena is released.
+    if (size > ARENA_LARGE_ALLOCATION)
+        return;
+
+    list = arena_free_list (arena, size, 1);
+    if (list == NULL)
+        return;
+
+    block = ptr;
+    block->af_next = list->fl_blocks;
+    list->fl_blocks = block;
+}
+
+//! INTERNAL API
+void
+dx_arena_track (struct disir_arena *arena, struct disir_arena_link *link)
+{
+    if (arena == NULL || link == NULL)
+        return;
+
+    link->al_prev = NULL;
+    link->al_next = arena->ar_tracked;
+    if (arena->ar_tracked)
+        arena->ar_tracked->al_prev = link;
+    arena->ar_tracked = link;
+}
+
+//! INTERNAL API
+int
+dx_arena_untrack (struct disir_arena *arena, struct disir_arena_link *link)
+{
+    if (arena == NULL || link == NULL)
+        return 0;
+
+    if (link->al_prev)
+        link->al_prev->al_next = link->al_next;
+    else if (arena->ar_tracked == link)
+        arena->ar_tracked = link->al_next;
+    else
+        return 0;
+
+    if (link->al_next)
+        link->al_next->al_prev = link->al_prev;
+
+    link->al_next = NULL;
+    link->al_prev = NULL;
+
+    return 1;
+}
+
+//! INTERNAL API
+struct disir_arena_link *
+dx_arena_tracked (struct disir_arena *arena)
+{
+    if (arena == NULL)
+        return NULL;
+
+    return arena->ar_tracked;
+}
+
+//! INTERNAL API
+void
+dx_arena_incref (struct disir_arena *arena)
+{
+    if (arena == NULL)
+        return;
+
+    __atomic_add_fetch (&arena->ar_refcount, 1, __ATOMIC_RELAXED);
+}
+
+//! INTERNAL API
+void
+dx_arena_decref (struct disir_arena **arena)
+{
+    dx_arena_decref_count (arena, 1);
+}
+
+//! INTERNAL API
+void
+dx_arena_decref_count (struct disir_arena **arena, int64_t count)
+{
+    struct arena_chunk *chunk;
+    struct arena_chunk *next;
+
+    if (arena == NULL || *arena == NULL || count <= 0)
+        return;
+
+    if (__atomic_sub_fetch (&(*arena)->ar_refcount, count, __ATOMIC_ACQ_REL) > 0)
+        return;
+
+    for (chunk = (*arena)->ar_chunks; chunk != NULL; chunk = next)
+    {
+        next = chunk->ac_next;
+        free (chunk);
+    }
+
+    free (*arena);
+    *arena = NULL;
+}
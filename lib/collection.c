@@ -14,8 +14,8 @@ dc_collection_size (struct disir_collection *collection)
     if (collection == NULL)
         return 0;
 
-    // Collesce to get an accurate count
-    dx_collection_coalesce (collection);
+    // Collesce to get an accurate count, if any context may have been destroyed
+    dx_collection_coalesce_stale (collection);
 
     return collection->cc_numentries;
 }
@@ -79,7 +79,7 @@ dc_collection_next (struct disir_collection *collection, struct disir_context **
     *context = NULL;
 
     // Coalesce array to get it in sync with reality
-    status = dx_collection_coalesce (collection);
+    status = dx_collection_coalesce_stale (collection);
     if (status != DISIR_STATUS_OK)
     {
         return status;
@@ -104,6 +104,47 @@ dc_collection_next (struct disir_collection *collection, struct disir_context **
     return DISIR_STATUS_OK;
 }
 
+//! PUBLIC API
+enum disir_status
+dc_collection_next_borrowed (struct disir_collection *collection,
+                             struct disir_context **context)
+{
+    enum disir_status status;
+
+    if (collection == NULL)
+    {
+        log_debug (0, "invoked with NULL collection pointer.");
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+    if (context == NULL)
+    {
+        log_debug (0, "invoked with NULL context pointer.");
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    // Initialize the output with NULL
+    *context = NULL;
+
+    // Coalesce array to get it in sync with reality
+    status = dx_collection_coalesce_stale (collection);
+    if (status != DISIR_STATUS_OK)
+    {
+        return status;
+    }
+
+    // Exausted?
+    if (collection->cc_iterator_index > collection->cc_numentries - 1)
+    {
+        return DISIR_STATUS_EXHAUSTED;
+    }
+
+    // The collection holds a reference on the context. Lend it out as-is.
+    *context = collection->cc_collection[collection->cc_iterator_index];
+    collection->cc_iterator_index++;
+
+    return DISIR_STATUS_OK;
+}
+
 //! PUBLIC API
 enum disir_status
 dc_collection_reset (struct disir_collection *collection)
@@ -120,6 +161,27 @@ dc_collection_reset (struct disir_collection *collection)
     return DISIR_STATUS_OK;
 }
 
+//! INTERNAL API
+enum disir_status
+dx_collection_coalesce_stale (struct disir_collection *collection)
+{
+    if (collection == NULL)
+    {
+        log_debug (0, "invoked with collection NULL pointer.");
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    // No context has been destroyed since we last coalesced - nothing to purge.
+    if (collection->cc_dirty == 0
+        && collection->cc_generation
+           == __atomic_load_n (&dx_context_destroyed_generation, __ATOMIC_RELAXED))
+    {
+        return DISIR_STATUS_OK;
+    }
+
+    return dx_collection_coalesce (collection);
+}
+
 //! INTERNAL API
 enum disir_status
 dx_collection_coalesce (struct disir_collection *collection)
@@ -184,6 +246,9 @@ dx_collection_coalesce (struct disir_collection *collection)
     }
 
     collection->cc_numentries -= invalid_entries_count;
+    collection->cc_generation = __atomic_load_n (&dx_context_destroyed_generation,
+                                                 __ATOMIC_RELAXED);
+    collection->cc_dirty = 0;
 
     // Take care of the iterator count post-iterate
     collection->cc_iterator_index -= iterator_moveback;
@@ -204,6 +269,8 @@ dc_collection_create (void)
         return NULL;
 
     collection->cc_capacity = 10;
+    collection->cc_generation = __atomic_load_n (&dx_context_destroyed_generation,
+                                                 __ATOMIC_RELAXED);
 
     collection->cc_collection = calloc (collection->cc_capacity, sizeof (struct disir_context *));
     if (collection->cc_collection == NULL)
@@ -268,7 +335,7 @@ dc_collection_push_context (struct disir_collection *collection, struct disir_co
     }
 
     // Coalesce array to get it in sync with reality
-    status = dx_collection_coalesce (collection);
+    status = dx_collection_coalesce_stale (collection);
     if (status != DISIR_STATUS_OK)
     {
         return status;
@@ -294,6 +361,12 @@ dc_collection_push_context (struct disir_collection *collection, struct disir_co
     collection->cc_collection[collection->cc_numentries] = context;
     collection->cc_numentries++;
 
+    // A destroyed context pushed to the collection is not covered by the generation count.
+    if (context->CONTEXT_STATE_DESTROYED)
+    {
+        collection->cc_dirty = 1;
+    }
+
     return DISIR_STATUS_OK;
 }
 
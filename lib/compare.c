@@ -387,7 +387,7 @@ compare_all_in_name (struct disir_context *lhs, struct disir_context *rhs, const
     // if RHS contains more entries, report it out of loop.
     do
     {
-        status = dc_collection_next (lhs_collection, &lhs_entry);
+        status = dc_collection_next_borrowed (lhs_collection, &lhs_entry);
         if (status == DISIR_STATUS_EXHAUSTED)
         {
             status = DISIR_STATUS_OK;
@@ -401,12 +401,11 @@ compare_all_in_name (struct disir_context *lhs, struct disir_context *rhs, const
         }
 
         // Get rhs
-        status = dc_collection_next (rhs_collection, &rhs_entry);
+        status = dc_collection_next_borrowed (rhs_collection, &rhs_entry);
         if (status == DISIR_STATUS_EXHAUSTED)
         {
             status = DISIR_STATUS_OK;
             dx_diff_report_add (report, "%s contains extra entry.", dx_context_name (lhs));
-            dc_putcontext (&lhs_entry);
             continue;
         }
         if (status != DISIR_STATUS_OK)
@@ -422,14 +421,11 @@ compare_all_in_name (struct disir_context *lhs, struct disir_context *rhs, const
         {
             goto out;
         }
-
-        dc_putcontext (&lhs_entry);
-        dc_putcontext (&rhs_entry);
     } while (1);
 
     do
     {
-        status = dc_collection_next (rhs_collection, &rhs_entry);
+        status = dc_collection_next_borrowed (rhs_collection, &rhs_entry);
         if (status == DISIR_STATUS_EXHAUSTED)
         {
             break;
@@ -438,12 +434,9 @@ compare_all_in_name (struct disir_context *lhs, struct disir_context *rhs, const
         {
             // TODO: Report value - stringify?
             dx_diff_report_add (report, "%s missing entry.", dx_context_name (lhs));
-
-            dc_putcontext (&rhs_entry);
             continue;
         }
 
-        dc_putcontext (&rhs_entry);
         log_debug (1, "rhs collection next returned: %s", disir_status_string (status));
         break;
     } while (1);
@@ -452,14 +445,6 @@ compare_all_in_name (struct disir_context *lhs, struct disir_context *rhs, const
     status = DISIR_STATUS_OK;
     // FALL-THROUGH
 out:
-    if (lhs_entry)
-    {
-        dc_putcontext (&lhs_entry);
-    }
-    if (rhs_entry)
-    {
-        dc_putcontext (&rhs_entry);
-    }
     if (lhs_collection)
     {
         dc_collection_finished (&lhs_collection);
@@ -511,7 +496,7 @@ compare_all_elements (struct disir_context *lhs, struct disir_context *rhs,
 
     do
     {
-        status = dc_collection_next (lhs_elements, &element);
+        status = dc_collection_next_borrowed (lhs_elements, &element);
         if (status == DISIR_STATUS_EXHAUSTED)
         {
             status = DISIR_STATUS_OK;
@@ -532,12 +517,9 @@ compare_all_elements (struct disir_context *lhs, struct disir_context *rhs,
             break;
         }
 
-        dc_putcontext (&element);
-
         // Entry already handled. Skip it.
         if (multimap_contains_key (map, name))
         {
-            dc_putcontext (&element);
             continue;
         }
 
@@ -567,7 +549,7 @@ compare_all_elements (struct disir_context *lhs, struct disir_context *rhs,
 
     do
     {
-        status = dc_collection_next (rhs_elements, &element);
+        status = dc_collection_next_borrowed (rhs_elements, &element);
         if (status == DISIR_STATUS_EXHAUSTED)
         {
             status = DISIR_STATUS_OK;
@@ -588,12 +570,9 @@ compare_all_elements (struct disir_context *lhs, struct disir_context *rhs,
             break;
         }
 
-        dc_putcontext (&element);
-
         // Entry exists in lhs - skip it
         if (multimap_contains_key (map, name))
         {
-            dc_putcontext (&element);
             continue;
         }
 
@@ -615,11 +594,6 @@ compare_all_elements (struct disir_context *lhs, struct disir_context *rhs,
         dc_collection_finished (&rhs_elements);
     }
 
-    if (element)
-    {
-        dc_putcontext (&element);
-    }
-
     // FALL-THROUGH
 out:
     return status;
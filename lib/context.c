@@ -1,5 +1,6 @@
 // External public includes
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <stdio.h>
@@ -17,6 +18,13 @@
 #include "log.h"
 #include "mold.h"
 #include "restriction.h"
+#include "documentation.h"
+#include "element_storage.h"
+#include "arena.h"
+#include "name_table.h"
+
+//! INTERNAL DATA
+uint64_t dx_context_destroyed_generation = 0;
 
 static enum disir_status
 context_get_introduced_structure (struct disir_context *context,
@@ -99,6 +107,7 @@ static void
 context_remove_from_parent (struct disir_context **context)
 {
     struct disir_element_storage *storage = NULL;
+    struct disir_context *held;
     const char *name = NULL;
 
     // Remove from parent, if applicable
@@ -125,8 +134,9 @@ context_remove_from_parent (struct disir_context **context)
         break;
     }
     case DISIR_CONTEXT_KEYVAL:
+    case DISIR_CONTEXT_RESTRICTION:
     {
-        // The context here is a restriction - ignore
+        // The context here is a restriction or documentation - ignore
         break;
     }
     default:
@@ -149,8 +159,9 @@ context_remove_from_parent (struct disir_context **context)
         break;
     }
     case DISIR_CONTEXT_RESTRICTION:
+    case DISIR_CONTEXT_DOCUMENTATION:
     {
-        // Ignore - parent has no element storage of restrictions.
+        // Ignore - parent has no element storage of restrictions or documentation.
         break;
     }
     default:
@@ -161,9 +172,13 @@ context_remove_from_parent (struct disir_context **context)
     }
 
     // Remove from parent storage, if available
-    if (storage && name)
+    if (storage && name &&
+        dx_element_storage_remove (storage, name, *context) == DISIR_STATUS_OK)
     {
-        dx_element_storage_remove (storage, name, *context);
+        // Release the reference the parent has held since the context was finalized.
+        // The caller of dc_destroy still holds its own reference.
+        held = *context;
+        dx_context_decref (&held);
     }
 }
 
@@ -198,6 +213,12 @@ dc_destroy (struct disir_context **context)
     // Only applicable if CONTEXT_STATE_IN_PARENT
     context_remove_from_parent (context);
 
+    // The parent lost an element - its validity must be re-checked.
+    if ((*context)->cx_parent_context != *context)
+    {
+        dx_context_mark_dirty ((*context)->cx_parent_context);
+    }
+
     log_debug_context (6, *context, "destroying (context: %p - *context: %p", context, *context);
     // Call destroy on the object pointed to by context.
     // This shall destroy the element, and every single child.
@@ -232,11 +253,13 @@ dc_destroy (struct disir_context **context)
 
     // Set the context to destroyed
     (*context)->CONTEXT_STATE_DESTROYED = 1;
+    __atomic_add_fetch (&dx_context_destroyed_generation, 1, __ATOMIC_RELAXED);
 
     // Decref the parent ref count attained in dx_context_attach
     // Guard against decrefing ourselves (top-level contexts)
     if ((*context)->cx_parent_context && (*context)->cx_parent_context != *context)
     {
+        (*context)->cx_parent_context->cx_attached--;
         dx_context_decref (&(*context)->cx_parent_context);
     }
 
@@ -376,6 +399,9 @@ dc_finalize (struct disir_context **context)
         (*context)->CONTEXT_STATE_FINALIZED = 1;
         (*context)->CONTEXT_STATE_CONSTRUCTING = 0;
 
+        // The parent gained an element - its validity must be re-checked.
+        dx_context_mark_dirty ((*context)->cx_parent_context);
+
         if (status == DISIR_STATUS_INVALID_CONTEXT)
         {
             // Contect invalid - Mark it as so and let user handle it.
@@ -421,6 +447,134 @@ dc_finalize (struct disir_context **context)
     return status;
 }
 
+//! STATIC API
+//! Return the context whose cx_arena_link is link.
+static struct disir_context *
+context_from_arena_link (struct disir_arena_link *link)
+{
+    return (struct disir_context *) ((char *) link - offsetof (struct disir_context, cx_arena_link));
+}
+
+//! STATIC API
+//! Return the number of references the tree holds on a finalized context:
+//! the one handed over by its creator, the one held by the element storage
+//! of its parent, if stored there, and one for each attached child.
+static int64_t
+context_tree_references (struct disir_context *context)
+{
+    int64_t references;
+
+    references = 1 + context->cx_attached;
+    if (context->CONTEXT_STATE_IN_PARENT
+        && (context->cx_type == DISIR_CONTEXT_KEYVAL || context->cx_type == DISIR_CONTEXT_SECTION))
+    {
+        references += 1;
+    }
+
+    return references;
+}
+
+//! INTERNAL API
+enum disir_status
+dx_context_release_arena (struct disir_context *root)
+{
+    struct disir_arena *arena;
+    struct disir_arena_link *link;
+    struct disir_context *context;
+    int64_t references;
+    int64_t released;
+    int64_t detached;
+
+    if (root == NULL || root->cx_arena == NULL)
+        return DISIR_STATUS_NO_CAN_DO;
+
+    arena = root->cx_arena;
+
+    // Contexts under construction are owned by the user, not the tree.
+    // Documentation added through dc_add_documentation() is never finalized,
+    // but held by its parent nonetheless.
+    for (link = dx_arena_tracked (arena); link != NULL; link = link->al_next)
+    {
+        context = context_from_arena_link (link);
+        if (context->CONTEXT_STATE_DESTROYED)
+            continue;
+
+        if ((context->CONTEXT_STATE_CONSTRUCTING && context->CONTEXT_STATE_IN_PARENT == 0)
+            || __atomic_load_n (&context->cx_refcount, __ATOMIC_ACQUIRE)
+               < context_tree_references (context))
+        {
+            log_debug_context (4, context, "cannot release arena of tree at once.");
+            return DISIR_STATUS_NO_CAN_DO;
+        }
+    }
+
+    released = 0;
+    detached = 0;
+    while ((link = dx_arena_tracked (arena)) != NULL)
+    {
+        context = context_from_arena_link (link);
+        dx_arena_untrack (arena, link);
+
+        // Already destroyed, but still referenced. It holds on to the arena by itself.
+        if (context->CONTEXT_STATE_DESTROYED)
+            continue;
+
+        switch (dc_context_type (context))
+        {
+        case DISIR_CONTEXT_DOCUMENTATION:
+            dx_documentation_release (context->cx_documentation);
+            break;
+        case DISIR_CONTEXT_KEYVAL:
+            dx_keyval_release (context->cx_keyval);
+            break;
+        case DISIR_CONTEXT_DEFAULT:
+            dx_default_release (context->cx_default);
+            break;
+        case DISIR_CONTEXT_SECTION:
+            dx_section_release (context->cx_section);
+            dx_element_storage_discard (&context->cx_section->se_elements);
+            break;
+        case DISIR_CONTEXT_RESTRICTION:
+            dx_restriction_release (context->cx_restriction);
+            break;
+        case DISIR_CONTEXT_CONFIG:
+        case DISIR_CONTEXT_MOLD:
+        case DISIR_CONTEXT_UNKNOWN:
+            break;
+        }
+
+        if (context->cx_parent_context == root)
+            detached++;
+
+        references = context_tree_references (context);
+
+        // The type structure is released along with the arena.
+        context->cx_value = NULL;
+        context->CONTEXT_STATE_DESTROYED = 1;
+        context->CONTEXT_STATE_IN_PARENT = 0;
+        context->cx_attached = 0;
+
+        // Contexts referenced from outside the tree are left behind destroyed.
+        // Mold contexts may be released concurrently by the configs referring to them.
+        if (__atomic_sub_fetch (&context->cx_refcount, references, __ATOMIC_ACQ_REL) > 0)
+            continue;
+
+        free (context->cx_error_message);
+        context->cx_error_message = NULL;
+        released++;
+    }
+
+    __atomic_add_fetch (&dx_context_destroyed_generation, 1, __ATOMIC_RELAXED);
+
+    // Drop the references of the attached children on root, and those of the released
+    // contexts on the arena. Root still holds its own, so neither is freed here.
+    root->cx_attached -= detached;
+    __atomic_sub_fetch (&root->cx_refcount, detached, __ATOMIC_ACQ_REL);
+    dx_arena_decref_count (&arena, released);
+
+    return DISIR_STATUS_OK;
+}
+
 //! PUBLIC API
 enum disir_status
 dc_putcontext (struct disir_context **context)
@@ -438,7 +592,7 @@ dc_putcontext (struct disir_context **context)
 
     TRACE_ENTER ("*context: %p", *context);
 
-    if ((*context)->cx_refcount == 1)
+    if (__atomic_load_n (&(*context)->cx_refcount, __ATOMIC_ACQUIRE) == 1)
     {
         log_debug_context (4, *context, "Input context only at 1 reference."
                                         " Destroying instead of reducing refcount.");
@@ -454,6 +608,55 @@ dc_putcontext (struct disir_context **context)
     return DISIR_STATUS_OK;
 }
 
+//! PUBLIC API
+enum disir_status
+dc_enable_arena (struct disir_context *context)
+{
+    enum disir_status status;
+
+    status = CONTEXT_NULL_INVALID_TYPE_CHECK (context);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
+        return status;
+    }
+
+    status = CONTEXT_TYPE_CHECK (context, DISIR_CONTEXT_CONFIG, DISIR_CONTEXT_MOLD);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
+        return status;
+    }
+
+    if (context->CONTEXT_STATE_CONSTRUCTING == 0)
+    {
+        dx_log_context (context, "cannot enable arena on finalized %s.",
+                                 dc_context_type_string (context));
+        return DISIR_STATUS_CONTEXT_IN_WRONG_STATE;
+    }
+
+    if (context->cx_arena != NULL)
+    {
+        return DISIR_STATUS_OK;
+    }
+
+    // Every child must be allocated within the arena, for it to be released at once.
+    if (context->cx_attached != 0)
+    {
+        dx_log_context (context, "cannot enable arena on %s with children.",
+                                 dc_context_type_string (context));
+        return DISIR_STATUS_CONTEXT_IN_WRONG_STATE;
+    }
+
+    context->cx_arena = dx_arena_create ();
+    if (context->cx_arena == NULL)
+    {
+        return DISIR_STATUS_NO_MEMORY;
+    }
+
+    return DISIR_STATUS_OK;
+}
+
 //! PUBLIC API
 enum disir_status
 dc_context_valid (struct disir_context *context)
@@ -476,6 +679,101 @@ dc_context_valid (struct disir_context *context)
     return status;
 }
 
+//! STATIC API
+//! Set the name of a KEYVAL or SECTION context to its interned copy.
+//! A config context shares the name interned by its mold equivalent, if it was just resolved.
+//! Otherwise the name is interned in the table of the root context.
+static enum disir_status
+context_set_interned_name (struct disir_context *context, const char *name, int32_t name_size,
+                           int use_mold_equiv)
+{
+    struct disir_value *value;
+    struct disir_value *equiv_value;
+    struct disir_name_table **value_table;
+    struct disir_name_table *table;
+    struct disir_context *root;
+    char *interned;
+
+    if (dc_context_type (context) == DISIR_CONTEXT_KEYVAL)
+    {
+        value = &context->cx_keyval->kv_name;
+        value_table = &context->cx_keyval->kv_name_table;
+        equiv_value = (context->cx_keyval->kv_mold_equiv
+                        ? &context->cx_keyval->kv_mold_equiv->cx_keyval->kv_name : NULL);
+        table = (equiv_value ? context->cx_keyval->kv_mold_equiv->cx_keyval->kv_name_table
+                             : NULL);
+    }
+    else if (dc_context_type (context) == DISIR_CONTEXT_SECTION)
+    {
+        value = &context->cx_section->se_name;
+        value_table = &context->cx_section->se_name_table;
+        equiv_value = (context->cx_section->se_mold_equiv
+                        ? &context->cx_section->se_mold_equiv->cx_section->se_name : NULL);
+        table = (equiv_value ? context->cx_section->se_mold_equiv->cx_section->se_name_table
+                             : NULL);
+    }
+    else
+    {
+        log_fatal_context (context, "slipped through guard - unsupported.");
+        return DISIR_STATUS_INTERNAL_ERROR;
+    }
+
+    if (name == NULL)
+    {
+        dx_name_table_decref (value_table);
+        value->dv_string = NULL;
+        value->dv_size = 0;
+        return DISIR_STATUS_OK;
+    }
+    if (name_size < 0)
+    {
+        log_debug (0, "invoked with negative name_size (%d)", name_size);
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    interned = NULL;
+    if (use_mold_equiv && table && equiv_value->dv_size == name_size)
+    {
+        interned = equiv_value->dv_string;
+    }
+    else
+    {
+        root = context->cx_root_context;
+        if (dc_context_type (root) == DISIR_CONTEXT_CONFIG)
+        {
+            if (root->cx_config->cf_names == NULL)
+            {
+                root->cx_config->cf_names = dx_name_table_create ();
+            }
+            table = root->cx_config->cf_names;
+        }
+        else
+        {
+            table = root->cx_mold->mo_names;
+        }
+
+        interned = (table ? dx_name_table_intern (table, name, name_size) : NULL);
+        if (interned == NULL)
+        {
+            dx_log_context (context, "failed to allocate memory for name '%.*s'",
+                                     name_size, name);
+            return DISIR_STATUS_NO_MEMORY;
+        }
+    }
+
+    // Take the new reference before dropping the old, they may be the same table.
+    dx_name_table_incref (table);
+    dx_name_table_decref (value_table);
+    *value_table = table;
+    value->dv_string = interned;
+    value->dv_size = name_size;
+
+    log_debug (5, "stored interned name (%p) of size (%d): %s\n",
+               interned, name_size, interned);
+
+    return DISIR_STATUS_OK;
+}
+
 //! PUBLIC API
 enum disir_status
 dc_set_name (struct disir_context *context, const char *name, int32_t name_size)
@@ -505,6 +803,8 @@ dc_set_name (struct disir_context *context, const char *name, int32_t name_size)
         return status;
     }
 
+    dx_context_mark_dirty (context);
+
     // Find the name in the mold
     if (dc_context_type (context->cx_root_context) == DISIR_CONTEXT_CONFIG)
     {
@@ -539,20 +839,8 @@ dc_set_name (struct disir_context *context, const char *name, int32_t name_size)
 
     // QUESTION: Do not allow setting name on finalized context? Only if not invalid
 
-    if (dc_context_type (context) == DISIR_CONTEXT_KEYVAL)
-    {
-        status = dx_value_set_string (&context->cx_keyval->kv_name, name, name_size);
-    }
-    else if (dc_context_type (context) == DISIR_CONTEXT_SECTION)
-    {
-        status = dx_value_set_string (&context->cx_section->se_name, name, name_size);
-    }
-    else
-    {
-        log_fatal_context (context, "slipped through guard - unsupported.");
-        return DISIR_STATUS_INTERNAL_ERROR;
-    }
-
+    status = context_set_interned_name (context, name, name_size,
+                                        (invalid == DISIR_STATUS_OK));
     status = (status == DISIR_STATUS_OK ? invalid : status);
 
     // TODO:  if context is not in constructing mode (it has been finalized once)
@@ -874,7 +1162,8 @@ dx_set_mold_equiv (struct disir_context *context, const char *value, int32_t val
     else if (dc_context_type (context) == DISIR_CONTEXT_KEYVAL)
     {
         context->cx_keyval->kv_mold_equiv = queried;
-        context->cx_keyval->kv_value.dv_type = queried->cx_keyval->kv_value.dv_type;
+        dx_value_set_type (&context->cx_keyval->kv_value,
+                           queried->cx_keyval->kv_value.dv_type);
     }
 
     dx_context_incref (queried);
@@ -929,6 +1218,13 @@ dc_add_introduced (struct disir_context *context, struct disir_version *version)
     {
         introduced->sv_major = version->sv_major;
         introduced->sv_minor = version->sv_minor;
+        // Versioned restrictions and defaults are resolved throughout the tree.
+        dx_context_mark_tree_dirty (context);
+        // Restrictions are ranked by introduced version in the compiled program of their keyval.
+        if (dc_context_type (context) == DISIR_CONTEXT_RESTRICTION)
+        {
+            dx_context_mark_dirty (context);
+        }
 
         log_debug_context (6, context, "adding introduced to root(%s): %s",
                                        dc_context_type_string (context->cx_root_context),
@@ -987,6 +1283,7 @@ dc_add_deprecated (struct disir_context *context, struct disir_version *version)
     {
         deprecated->sv_major = version->sv_major;
         deprecated->sv_minor = version->sv_minor;
+        dx_context_mark_tree_dirty (context);
 
         log_debug_context (6, context, "adding deprecated to root(%s): %s",
                                        dc_context_type_string (context->cx_root_context),
@@ -1098,6 +1395,9 @@ dc_set_version (struct disir_context *context, struct disir_version *version)
         return DISIR_STATUS_INTERNAL_ERROR;
     }
 
+    // Restrictions are resolved against the version of the root context.
+    dx_context_mark_tree_dirty (context);
+
     TRACE_EXIT ("");
     return DISIR_STATUS_OK;
 }
@@ -1253,72 +1553,59 @@ dc_find_element (struct disir_context *parent, const char *name, unsigned int in
                  struct disir_context **output)
 {
     enum disir_status status;
-    struct disir_collection *collection;
-    uint32_t size;
-
-    collection = NULL;
+    struct disir_element_storage *storage;
 
-    if (output == NULL)
+    status = CONTEXT_NULL_INVALID_TYPE_CHECK (parent);
+    if (status != DISIR_STATUS_OK)
     {
-        log_debug (0, "invoked with output NULL pointer.");
-        return DISIR_STATUS_INVALID_ARGUMENT;
+        // Already logged
+        return status;
     }
-
-    status = dc_find_elements (parent, name, &collection);
+    status = CONTEXT_TYPE_CHECK (parent, DISIR_CONTEXT_SECTION,
+                                         DISIR_CONTEXT_MOLD,
+                                         DISIR_CONTEXT_CONFIG);
     if (status != DISIR_STATUS_OK)
     {
-        goto error;
+        return status;
     }
-
-    // collection size is guaranteed to be atleast 1
-    size = dc_collection_size (collection);
-    if ((size - 1) < index)
+    if (output == NULL)
     {
-        log_debug (5, "requested index (%d) out-of-bounds (size %d)", size, index);
-        status = DISIR_STATUS_NOT_EXIST;
-        goto error;
+        log_debug (0, "invoked with output NULL pointer.");
+        return DISIR_STATUS_INVALID_ARGUMENT;
     }
 
-    log_debug (8, "requested index (%d), collection of size (%d)", index, size);
-
-    unsigned int i = 0;
-    do
+    switch (dc_context_type (parent))
     {
-        status = dc_collection_next (collection, output);
-        if (status == DISIR_STATUS_EXHAUSTED)
-        {
-            // This should NOT happen, at all.
-            log_error ("collection exhausted on iteration (%d)," \
-                       " requested index (%d) out of size (%d)",
-                        i, index, size);
-            status = DISIR_STATUS_INTERNAL_ERROR;
-            break;
-        }
-        if (i == index)
-        {
-            status = DISIR_STATUS_OK;
-            break;
-        }
-        if (status != DISIR_STATUS_OK)
-        {
-            // Uhmm, something bad happend
-            log_error ("collection returned erroneous condition: %s",
-                       disir_status_string (status));
-        }
-        dc_putcontext (output);
-        i++;
-
-    } while (1);
+    case DISIR_CONTEXT_MOLD:
+        storage = parent->cx_mold->mo_elements;
+        break;
+    case DISIR_CONTEXT_CONFIG:
+        storage = parent->cx_config->cf_elements;
+        break;
+    case DISIR_CONTEXT_SECTION:
+        storage = parent->cx_section->se_elements;
+        break;
+    default:
+    {
+        dx_context_error_set (parent, "Invalid operation for context '%s'"
+                                      " (slipped through internal guard)",
+                                      dc_context_type_string (parent));
+        return DISIR_STATUS_INTERNAL_ERROR;
+    }
+    }
 
-    // status is OK if output element was retrieved successfully from the collection.
-    // FALL-THROUGH
-error:
-    if (collection)
+    // Lookup is done in place in the element storage - no collection is allocated.
+    status = dx_element_storage_get_at (storage, name, index, output);
+    if (status != DISIR_STATUS_OK)
     {
-        dc_collection_finished (&collection);
+        log_debug (5, "requested index (%d) of '%s' does not exist", index, name);
+        return status;
     }
 
-    return status;
+    // The storage hands out a borrowed reference. The caller owns the output.
+    dx_context_incref (*output);
+
+    return DISIR_STATUS_OK;
 }
 
 //! PUBLIC API
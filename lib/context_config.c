@@ -67,7 +67,7 @@ dc_config_begin (struct disir_mold *mold, struct disir_context **config)
 
     // Set associated mold
     context->cx_config->cf_mold = mold;
-    mold->mo_reference_count++;
+    __atomic_add_fetch (&mold->mo_reference_count, 1, __ATOMIC_RELAXED);
 
     // Set root context to self (such that children can inherit)
     context->cx_root_context = context;
@@ -176,6 +176,13 @@ dx_config_destroy (struct disir_config **config)
     // Remove our reference to the mold
     disir_mold_finished (&(*config)->cf_mold);
 
+    // Release every child at once, if allocated from an arena.
+    if (dx_context_release_arena ((*config)->cf_context) == DISIR_STATUS_OK)
+    {
+        dx_element_storage_discard (&(*config)->cf_elements);
+        goto out;
+    }
+
     // Destroy all element_storage children
     status = dx_element_storage_get_all ((*config)->cf_elements, &collection);
     if (status == DISIR_STATUS_OK)
@@ -194,6 +201,8 @@ dx_config_destroy (struct disir_config **config)
     }
 
     dx_element_storage_destroy (&(*config)->cf_elements);
+out:
+    dx_name_table_decref (&(*config)->cf_names);
 
     free (*config);
     *config = NULL;
@@ -1,6 +1,7 @@
 // standard includes
 #include <stdlib.h>
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 
 // public disir interface
@@ -57,7 +58,7 @@ dx_default_begin (struct disir_context *parent, struct disir_context **def)
         return DISIR_STATUS_INVALID_CONTEXT; // XXX: Revise error return code
     }
 
-    context = dx_context_create (DISIR_CONTEXT_DEFAULT);
+    context = dx_context_create_in (parent, DISIR_CONTEXT_DEFAULT);
     if (context == NULL)
     {
         log_debug_context (1, parent, "failed to allocate new default context");
@@ -90,6 +91,7 @@ dx_default_finalize (struct disir_context *default_context)
     enum disir_status status;
     struct disir_default *def;
     struct disir_default **queue;
+    struct disir_keyval *keyval;
     int exists;
     char buffer[32];
 
@@ -100,7 +102,8 @@ dx_default_finalize (struct disir_context *default_context)
         return status;
     }
     def = default_context->cx_default;
-    queue = &default_context->cx_parent_context->cx_keyval->kv_default_queue;
+    keyval = default_context->cx_parent_context->cx_keyval;
+    queue = &keyval->kv_default_queue;
 
     // TODO: Verify that the default respect the restrictions on the parent keyval
 
@@ -115,9 +118,13 @@ dx_default_finalize (struct disir_context *default_context)
     }
     else
     {
-        MQ_ENQUEUE_CONDITIONAL (*queue, def,
-            (dc_version_compare (&entry->de_introduced, &def->de_introduced) > 0));
-        status = DISIR_STATUS_OK;
+        status = dx_version_index_insert (&keyval->kv_default_index, def,
+                                          offsetof (struct disir_default, de_introduced));
+        if (status == DISIR_STATUS_OK)
+        {
+            MQ_ENQUEUE_CONDITIONAL (*queue, def,
+                (dc_version_compare (&entry->de_introduced, &def->de_introduced) > 0));
+        }
     }
 
     return status;
@@ -129,7 +136,7 @@ dx_default_create (struct disir_context *context)
 {
     struct disir_default *def;
 
-    def = calloc ( 1, sizeof (struct disir_default));
+    def = dx_context_calloc (context, sizeof (struct disir_default));
     if (def == NULL)
     {
         return NULL;
@@ -141,6 +148,13 @@ dx_default_create (struct disir_context *context)
     return def;
 }
 
+//! INTERNAL API
+void
+dx_default_release (struct disir_default *def)
+{
+    dx_value_free (&def->de_value);
+}
+
 //! INTERNAL API
 enum disir_status
 dx_default_destroy (struct disir_default **def)
@@ -156,11 +170,7 @@ dx_default_destroy (struct disir_default **def)
 
     tmp = *def;
 
-    if (tmp->de_value.dv_type == DISIR_VALUE_TYPE_STRING ||
-        tmp->de_value.dv_size > 0)
-    {
-        free (tmp->de_value.dv_string);
-    }
+    dx_default_release (tmp);
 
     context = tmp->de_context;
     if (context && context->cx_parent_context)
@@ -172,6 +182,8 @@ dx_default_destroy (struct disir_default **def)
             {
                 queue = &(context->cx_parent_context->cx_keyval->kv_default_queue);
                 MQ_REMOVE_SAFE (*queue, tmp);
+                dx_version_index_remove (&context->cx_parent_context->cx_keyval->kv_default_index,
+                                         tmp);
             }
             else
             {
@@ -182,7 +194,7 @@ dx_default_destroy (struct disir_default **def)
         }
     }
 
-    free (tmp);
+    dx_context_free (tmp->de_context, tmp, sizeof (struct disir_default));
     *def = NULL;
 
     return DISIR_STATUS_OK;;
@@ -608,31 +620,7 @@ void
 dx_default_get_active (struct disir_context *keyval, struct disir_version *version,
                        struct disir_default **def)
 {
-    struct disir_default *current;
-
-    if (keyval->cx_keyval->kv_default_queue == NULL)
-    {
-        // We cant really do anything - everything is empty.
-        current = NULL;
-    }
-    else if (version)
-    {
-        current = MQ_FIND (keyval->cx_keyval->kv_default_queue,
-                (dc_version_compare (&entry->de_introduced, version) > 0));
-        if (current != NULL && current->prev != MQ_TAIL (keyval->cx_keyval->kv_default_queue))
-        {
-            current = current->prev;
-        }
-        if (current == NULL)
-        {
-            current = MQ_TAIL (keyval->cx_keyval->kv_default_queue);
-        }
-    }
-    else
-    {
-        current = MQ_TAIL (keyval->cx_keyval->kv_default_queue);
-    }
-
-    *def = current;
+    *def = dx_version_index_find (&keyval->cx_keyval->kv_default_index, version,
+                                  offsetof (struct disir_default, de_introduced));
 }
 
@@ -1,6 +1,7 @@
 // External public includes
 #include <stdlib.h>
 #include <stdint.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdarg.h>
@@ -26,6 +27,7 @@ enum disir_status
 dx_documentation_add (struct disir_context *parent, struct disir_documentation *doc)
 {
     struct disir_documentation **doc_queue;
+    struct disir_version_index *doc_index;
     enum disir_status status;
     int exists;
     char buffer[32];
@@ -44,21 +46,25 @@ dx_documentation_add (struct disir_context *parent, struct disir_documentation *
     case DISIR_CONTEXT_MOLD:
     {
         doc_queue = &(parent->cx_mold->mo_documentation_queue);
+        doc_index = &(parent->cx_mold->mo_documentation_index);
         break;
     }
     case DISIR_CONTEXT_KEYVAL:
     {
         doc_queue = &(parent->cx_keyval->kv_documentation_queue);
+        doc_index = &(parent->cx_keyval->kv_documentation_index);
         break;
     }
     case DISIR_CONTEXT_SECTION:
     {
         doc_queue = &(parent->cx_section->se_documentation_queue);
+        doc_index = &(parent->cx_section->se_documentation_index);
         break;
     }
     case DISIR_CONTEXT_RESTRICTION:
     {
         doc_queue = &(parent->cx_restriction->re_documentation_queue);
+        doc_index = &(parent->cx_restriction->re_documentation_index);
         break;
     }
     case DISIR_CONTEXT_CONFIG:
@@ -94,9 +100,14 @@ dx_documentation_add (struct disir_context *parent, struct disir_documentation *
     }
     else
     {
-        MQ_ENQUEUE_CONDITIONAL (*doc_queue, doc,
-            (dc_version_compare (&entry->dd_introduced, &doc->dd_introduced) > 0));
-        status = DISIR_STATUS_OK;
+        status = dx_version_index_insert (doc_index, doc,
+                                          offsetof (struct disir_documentation, dd_introduced));
+        if (status == DISIR_STATUS_OK)
+        {
+            MQ_ENQUEUE_CONDITIONAL (*doc_queue, doc,
+                (dc_version_compare (&entry->dd_introduced, &doc->dd_introduced) > 0));
+            doc->dd_context->CONTEXT_STATE_IN_PARENT = 1;
+        }
     }
 
     TRACE_EXIT ("status: %s", disir_status_string (status));
@@ -197,7 +208,7 @@ dc_get_documentation (struct disir_context *context, struct disir_version *versi
                       const char **doc, int32_t *doc_size)
 {
     enum disir_status status;
-    struct disir_documentation **doc_parent;
+    struct disir_version_index *doc_index;
     struct disir_documentation *doc_context;
 
     status = CONTEXT_NULL_INVALID_TYPE_CHECK (context);
@@ -225,16 +236,16 @@ dc_get_documentation (struct disir_context *context, struct disir_version *versi
     switch (dc_context_type (context))
     {
     case DISIR_CONTEXT_KEYVAL:
-        doc_parent = &context->cx_keyval->kv_documentation_queue;
+        doc_index = &context->cx_keyval->kv_documentation_index;
         break;
     case DISIR_CONTEXT_MOLD:
-        doc_parent = &context->cx_mold->mo_documentation_queue;
+        doc_index = &context->cx_mold->mo_documentation_index;
         break;
     case DISIR_CONTEXT_SECTION:
-        doc_parent = &context->cx_section->se_documentation_queue;
+        doc_index = &context->cx_section->se_documentation_index;
         break;
     case DISIR_CONTEXT_RESTRICTION:
-        doc_parent = &context->cx_restriction->re_documentation_queue;
+        doc_index = &context->cx_restriction->re_documentation_index;
         break;
     default:
     {
@@ -242,26 +253,9 @@ dc_get_documentation (struct disir_context *context, struct disir_version *versi
     }
     }
 
-    if (version == NULL)
-    {
-        // Get highest version
-        doc_context = MQ_TAIL (*doc_parent);
-    }
-    else
-    {
-        // Get the prev entry from the found entry
-        //  NULL is returned if the tail is lower than our version compare input
-        doc_context = MQ_FIND (*doc_parent,
-                (dc_version_compare (&entry->dd_introduced, version) > 0));
-        if (doc_context != NULL && doc_context->prev != MQ_TAIL (*doc_parent))
-        {
-            doc_context = doc_context->prev;
-        }
-        if (doc_context == NULL)
-        {
-            doc_context = MQ_TAIL (*doc_parent);
-        }
-    }
+    // Highest version if version is NULL
+    doc_context = dx_version_index_find (doc_index, version,
+                                         offsetof (struct disir_documentation, dd_introduced));
 
 
     if (doc_context == NULL)
@@ -320,7 +314,7 @@ dx_documentation_begin (struct disir_context *parent, struct disir_context **doc
 
     log_debug_context (6, parent, "capable of adding documentation context");
 
-    context = dx_context_create (DISIR_CONTEXT_DOCUMENTATION);
+    context = dx_context_create_in (parent, DISIR_CONTEXT_DOCUMENTATION);
     if (context == NULL)
     {
         // LOGWARN
@@ -368,7 +362,7 @@ dx_documentation_create (struct disir_context *context)
 {
     struct disir_documentation *doc;
 
-    doc = calloc(1, sizeof (struct disir_documentation));
+    doc = dx_context_calloc (context, sizeof (struct disir_documentation));
     if (doc == NULL)
         return NULL;
 
@@ -378,12 +372,20 @@ dx_documentation_create (struct disir_context *context)
     return doc;
 }
 
+//! INTERNAL API
+void
+dx_documentation_release (struct disir_documentation *documentation)
+{
+    dx_value_free (&documentation->dd_value);
+}
+
 //! INTERNAL API
 enum disir_status
 dx_documentation_destroy (struct disir_documentation **documentation)
 {
     struct disir_documentation *tmp;
     struct disir_documentation **queue;
+    struct disir_version_index *index;
     struct disir_context *context;
 
     if (documentation == NULL || *documentation == NULL)
@@ -391,9 +393,9 @@ dx_documentation_destroy (struct disir_documentation **documentation)
 
     tmp = *documentation;
     queue = NULL;
+    index = NULL;
 
-    if (tmp->dd_value.dv_size > 0)
-        free(tmp->dd_value.dv_string);
+    dx_documentation_release (tmp);
 
     context = (*documentation)->dd_context;
     if (context && context->cx_parent_context)
@@ -405,21 +407,25 @@ dx_documentation_destroy (struct disir_documentation **documentation)
         case DISIR_CONTEXT_MOLD:
         {
             queue = &(context->cx_mold->mo_documentation_queue);
+            index = &(context->cx_mold->mo_documentation_index);
             break;
         }
         case DISIR_CONTEXT_KEYVAL:
         {
             queue = &(context->cx_keyval->kv_documentation_queue);
+            index = &(context->cx_keyval->kv_documentation_index);
             break;
         }
         case DISIR_CONTEXT_SECTION:
         {
             queue = &(context->cx_section->se_documentation_queue);
+            index = &(context->cx_section->se_documentation_index);
             break;
         }
         case DISIR_CONTEXT_RESTRICTION:
         {
             queue = &(context->cx_restriction->re_documentation_queue);
+            index = &(context->cx_restriction->re_documentation_index);
             break;
         }
         default:
@@ -435,10 +441,11 @@ dx_documentation_destroy (struct disir_documentation **documentation)
         if (queue != NULL)
         {
             MQ_REMOVE_SAFE (*queue, tmp);
+            dx_version_index_remove (index, tmp);
         }
     }
 
-    free(tmp);
+    dx_context_free (tmp->dd_context, tmp, sizeof (struct disir_documentation));
     *documentation = NULL;
     return DISIR_STATUS_OK;
 }
@@ -16,6 +16,7 @@
 #include "log.h"
 #include "mqueue.h"
 #include "restriction.h"
+#include "restriction_program.h"
 
 //! INTERNAL API
 enum disir_status
@@ -48,7 +49,7 @@ dx_keyval_begin (struct disir_context *parent, struct disir_context **keyval)
     // XXX: Should all these context have a direct mold pointer? To its equivilant mold
     //  entry?
 
-    context = dx_context_create (DISIR_CONTEXT_KEYVAL);
+    context = dx_context_create_in (parent, DISIR_CONTEXT_KEYVAL);
     if (context == NULL)
     {
         log_debug_context (1, parent, "failed to allocate new keyval context.");
@@ -128,7 +129,8 @@ dx_keyval_finalize (struct disir_context *keyval)
     if (invalid == DISIR_STATUS_OK ||
         invalid == DISIR_STATUS_INVALID_CONTEXT)
     {
-        status = dx_element_storage_add (storage, keyval->cx_keyval->kv_name.dv_string, keyval);
+        status = dx_element_storage_add_interned (storage, keyval->cx_keyval->kv_name.dv_string,
+                                                  keyval->cx_keyval->kv_name_table, keyval);
         if (status != DISIR_STATUS_OK)
         {
             dx_log_context(keyval, "Unable to insert into element storage - Interesting...");
@@ -355,7 +357,7 @@ dx_keyval_create (struct disir_context *parent)
 {
     struct disir_keyval *keyval;
 
-    keyval = calloc(1, sizeof (struct disir_keyval));
+    keyval = dx_context_calloc (parent, sizeof (struct disir_keyval));
     if (keyval == NULL)
         return NULL;
 
@@ -365,6 +367,32 @@ dx_keyval_create (struct disir_context *parent)
     return keyval;
 }
 
+//! INTERNAL API
+void
+dx_keyval_release (struct disir_keyval *keyval)
+{
+    // Release the interned name
+    dx_name_table_decref (&keyval->kv_name_table);
+    keyval->kv_name.dv_string = NULL;
+
+    // Free allocated value, if string or enum
+    dx_value_free (&keyval->kv_value);
+
+    dx_restriction_program_destroy (&keyval->kv_restriction_program);
+
+    // Decref mold_equiv if set
+    if (keyval->kv_mold_equiv)
+    {
+        log_debug (5, "decrefing mold equivalent entry.");
+        dx_context_decref (&keyval->kv_mold_equiv);
+        keyval->kv_mold_equiv = NULL;
+    }
+
+    // The entries unhook themselves from the indexes - drop them first.
+    dx_version_index_free (&keyval->kv_documentation_index);
+    dx_version_index_free (&keyval->kv_default_index);
+}
+
 //! INTERNAL API
 enum disir_status
 dx_keyval_destroy (struct disir_keyval **keyval)
@@ -380,27 +408,7 @@ dx_keyval_destroy (struct disir_keyval **keyval)
         return DISIR_STATUS_INVALID_ARGUMENT;
     }
 
-    // Free allocated name
-    if ((*keyval)->kv_name.dv_size != 0)
-    {
-        free ((*keyval)->kv_name.dv_string);
-    }
-
-    // Free allocated value, if string or enum
-    if (((*keyval)->kv_value.dv_type == DISIR_VALUE_TYPE_STRING
-        || (*keyval)->kv_value.dv_type == DISIR_VALUE_TYPE_ENUM)
-           && (*keyval)->kv_value.dv_size != 0)
-    {
-        free ((*keyval)->kv_value.dv_string);
-    }
-
-    // Decref mold_equiv if set
-    if ((*keyval)->kv_mold_equiv)
-    {
-        log_debug (5, "decrefing mold equivalent entry.");
-        dx_context_decref (&(*keyval)->kv_mold_equiv);
-        (*keyval)->kv_mold_equiv = NULL;
-    }
+    dx_keyval_release (*keyval);
 
     // Destroy (all) documentation entries on the keyval.
     while ((doc = MQ_POP((*keyval)->kv_documentation_queue)))
@@ -423,7 +431,7 @@ dx_keyval_destroy (struct disir_keyval **keyval)
         dc_destroy (&context);
     }
 
-    free (*keyval);
+    dx_context_free ((*keyval)->kv_context, *keyval, sizeof (struct disir_keyval));
     *keyval = NULL;
     return DISIR_STATUS_OK;
 }
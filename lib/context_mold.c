@@ -11,6 +11,7 @@
 #include "mold.h"
 #include "documentation.h"
 #include "mqueue.h"
+#include "restriction_program.h"
 #include "log.h"
 
 
@@ -99,6 +100,9 @@ dc_mold_finalize (struct disir_context **context, struct disir_mold **mold)
         (*context)->CONTEXT_STATE_FINALIZED = 1;
         (*context)->CONTEXT_STATE_CONSTRUCTING = 0;
 
+        // Configs check their values against the compiled restrictions from here on.
+        dx_restriction_program_compile_tree (*context);
+
         // We do not decref context refcount on finalize
         // Deprive the user of his context reference.
         *context = NULL;
@@ -134,6 +138,11 @@ dx_mold_create (struct disir_context *context)
     {
         goto error;
     }
+    mold->mo_names = dx_name_table_create ();
+    if (mold->mo_names == NULL)
+    {
+        goto error;
+    }
 
     // Initialize version to 1.0
     mold->mo_version.sv_major = 1;
@@ -147,6 +156,7 @@ error:
     }
     if (mold)
     {
+        dx_name_table_decref (&mold->mo_names);
         free (mold);
     }
 
@@ -168,6 +178,15 @@ dx_mold_destroy (struct disir_mold **mold)
         return DISIR_STATUS_INVALID_ARGUMENT;
     }
 
+    // Release every child at once, if allocated from an arena.
+    if (dx_context_release_arena ((*mold)->mo_context) == DISIR_STATUS_OK)
+    {
+        dx_element_storage_discard (&(*mold)->mo_elements);
+        dx_version_index_free (&(*mold)->mo_documentation_index);
+        (*mold)->mo_documentation_queue = NULL;
+        goto out;
+    }
+
     // Destroy all element_storage children
     status = dx_element_storage_get_all ((*mold)->mo_elements, &collection);
     if (status == DISIR_STATUS_OK)
@@ -189,12 +208,17 @@ dx_mold_destroy (struct disir_mold **mold)
     dx_element_storage_destroy (&(*mold)->mo_elements);
 
     // Destroy the documentation associated with the mold.
+    dx_version_index_free (&(*mold)->mo_documentation_index);
     while ((doc = MQ_POP ((*mold)->mo_documentation_queue)))
     {
         context = doc->dd_context;
         dc_destroy (&context);
     }
 
+out:
+    // Contexts still referenced elsewhere hold on to the names they use.
+    dx_name_table_decref (&(*mold)->mo_names);
+
     free (*mold);
     *mold = NULL;
 
@@ -17,6 +17,7 @@
 #include "section.h"
 #include "config.h"
 #include "mold.h"
+#include "restriction_program.h"
 
 //! Define the size of the buffer used to name values of all restrictions
 //! active in a restriction check
@@ -136,7 +137,7 @@ dx_restriction_begin (struct disir_context *parent, struct disir_context **restr
         return DISIR_STATUS_WRONG_CONTEXT;
     }
 
-    context = dx_context_create (DISIR_CONTEXT_RESTRICTION);
+    context = dx_context_create_in (parent, DISIR_CONTEXT_RESTRICTION);
     if (context == NULL)
     {
         log_debug_context (1, parent, "failed to allocate new restriction context.");
@@ -211,7 +212,7 @@ dx_restriction_create (struct disir_context *context)
 {
     struct disir_restriction *restriction;
 
-    restriction = calloc ( 1, sizeof (struct disir_restriction));
+    restriction = dx_context_calloc (context, sizeof (struct disir_restriction));
     if (restriction == NULL)
     {
         return NULL;
@@ -225,6 +226,17 @@ dx_restriction_create (struct disir_context *context)
     return restriction;
 }
 
+//! INTERNAL API
+void
+dx_restriction_release (struct disir_restriction *restriction)
+{
+    free (restriction->re_value_string);
+    restriction->re_value_string = NULL;
+
+    // The documentation entries unhook themselves from the index - drop it first.
+    dx_version_index_free (&restriction->re_documentation_index);
+}
+
 //! INTERNAL API
 enum disir_status
 dx_restriction_destroy (struct disir_restriction **restriction)
@@ -237,10 +249,7 @@ dx_restriction_destroy (struct disir_restriction **restriction)
     queue = NULL;
 
     tmp = *restriction;
-    if (tmp->re_value_string)
-    {
-        free (tmp->re_value_string);
-    }
+    dx_restriction_release (tmp);
 
     // Find parent context queue and remove safelt from there
     context = tmp->re_context;
@@ -276,7 +285,7 @@ dx_restriction_destroy (struct disir_restriction **restriction)
         dc_destroy (&context);
     }
 
-    free (tmp);
+    dx_context_free (tmp->re_context, tmp, sizeof (struct disir_restriction));
     *restriction = NULL;
 
     return DISIR_STATUS_OK;
@@ -501,6 +510,9 @@ dc_restriction_set_string (struct disir_context *context, const char *value)
     }
     }
 
+    // The parent keyval must re-check its restrictions.
+    dx_context_mark_dirty (context);
+
     return DISIR_STATUS_OK;
 }
 
@@ -549,6 +561,9 @@ dc_restriction_set_range (struct disir_context *context, double min, double max)
     }
     }
 
+    // The parent keyval must re-check its restrictions.
+    dx_context_mark_dirty (context);
+
     return DISIR_STATUS_OK;
 }
 
@@ -646,6 +661,9 @@ dc_restriction_set_numeric (struct disir_context *context, double value)
     }
     }
 
+    // The parent keyval must re-check its restrictions.
+    dx_context_mark_dirty (context);
+
     return DISIR_STATUS_OK;
 }
 
@@ -1028,7 +1046,9 @@ dx_restriction_exclusive_value_check (struct disir_context *context, int64_t int
     struct disir_version *config_version;
     int exclusive_fulfilled = 0;
     int restriction_entries_inactive = 0;
+    int active;
     double value;
+    struct disir_restriction_program *program;
 
     char allowed_values[RESTRICTION_ENTRIES_BUFFER_SIZE];
     int allowed_written;
@@ -1058,6 +1078,7 @@ dx_restriction_exclusive_value_check (struct disir_context *context, int64_t int
     }
     case DISIR_VALUE_TYPE_ENUM:
         // Do not handle
+        value = 0;
         break;
     default:
     {
@@ -1070,6 +1091,25 @@ dx_restriction_exclusive_value_check (struct disir_context *context, int64_t int
     queue = &context->cx_keyval->kv_mold_equiv->cx_keyval->kv_restrictions_queue;
     config_version = &context->cx_root_context->cx_config->cf_version;
 
+    // Resolve the value against the restrictions compiled at mold finalize.
+    // The queue is only walked below to describe the allowed values of a violation.
+    program = context->cx_keyval->kv_mold_equiv->cx_keyval->kv_restriction_program;
+    if (program != NULL)
+    {
+        if (dx_restriction_program_check (program, config_version,
+                                          (dc_value_type (context) == DISIR_VALUE_TYPE_ENUM
+                                           ? string_value : NULL),
+                                          value, &active))
+        {
+            log_debug (8, "Exclusive restriction fulfilled by compiled program.");
+            return status;
+        }
+        if (active == 0 && dc_value_type (context) != DISIR_VALUE_TYPE_ENUM)
+        {
+            return status;
+        }
+    }
+
     MQ_FOREACH (*queue,
     {
         if (entry->re_type == DISIR_RESTRICTION_INC_ENTRY_MIN ||
@@ -44,7 +44,7 @@ dx_section_begin (struct disir_context *parent, struct disir_context **section)
         return status;
     }
 
-    context = dx_context_create (DISIR_CONTEXT_SECTION);
+    context = dx_context_create_in (parent, DISIR_CONTEXT_SECTION);
     if (context == NULL)
     {
         log_debug_context (1, parent, "failed to allocate new section context.");
@@ -127,7 +127,8 @@ dx_section_finalize (struct disir_context *section)
         invalid == DISIR_STATUS_ELEMENTS_INVALID ||
         invalid == DISIR_STATUS_INVALID_CONTEXT)
     {
-        status = dx_element_storage_add (storage, section->cx_section->se_name.dv_string, section);
+        status = dx_element_storage_add_interned (storage, section->cx_section->se_name.dv_string,
+                                                  section->cx_section->se_name_table, section);
         if (status != DISIR_STATUS_OK)
         {
             dx_log_context(section, "Unable to insert into element storage - Interesting...");
@@ -147,7 +148,7 @@ dx_section_create (struct disir_context *self)
 {
     struct disir_section *section;
 
-    section = calloc(1, sizeof (struct disir_section));
+    section = dx_context_calloc (self, sizeof (struct disir_section));
     if (section == NULL)
         return NULL;
 
@@ -168,11 +169,30 @@ error:
     }
     if (section)
     {
-        free (section);
+        dx_context_free (self, section, sizeof (struct disir_section));
     }
     return NULL;
 }
 
+//! INTERNAL API
+void
+dx_section_release (struct disir_section *section)
+{
+    // Release the interned name
+    dx_name_table_decref (&section->se_name_table);
+    section->se_name.dv_string = NULL;
+
+    // Decref mold_equiv if set
+    if (section->se_mold_equiv)
+    {
+        dx_context_decref (&section->se_mold_equiv);
+        section->se_mold_equiv = NULL;
+    }
+
+    // The documentation entries unhook themselves from the index - drop it first.
+    dx_version_index_free (&section->se_documentation_index);
+}
+
 //! INTERNAL API
 enum disir_status
 dx_section_destroy (struct disir_section **section)
@@ -188,18 +208,7 @@ dx_section_destroy (struct disir_section **section)
         return DISIR_STATUS_INVALID_ARGUMENT;
     }
 
-    // Free allocated name
-    if ((*section)->se_name.dv_size != 0)
-    {
-        free ((*section)->se_name.dv_string);
-    }
-
-    // Decref mold_equiv if set
-    if ((*section)->se_mold_equiv)
-    {
-        dx_context_decref (&(*section)->se_mold_equiv);
-        (*section)->se_mold_equiv = NULL;
-    }
+    dx_section_release (*section);
 
     // Destroy (all) documentation entries on the section.
     while ((doc = MQ_POP((*section)->se_documentation_queue)))
@@ -234,7 +243,7 @@ dx_section_destroy (struct disir_section **section)
         dc_destroy (&context);
     }
 
-    free (*section);
+    dx_context_free ((*section)->se_context, *section, sizeof (struct disir_section));
     *section = NULL;
 
     return DISIR_STATUS_OK;
@@ -11,6 +11,8 @@
 #include "context_private.h"
 #include "log.h"
 #include "keyval.h"
+#include "restriction_program.h"
+#include "arena.h"
 
 //! Array  of string representations corresponding to the
 //! disir_context_type enumeration value.
@@ -147,21 +149,65 @@ dx_context_attach (struct disir_context *parent, struct disir_context *context)
     // without the child having finalized, the child wont be destroyed
     // and may attempt to access parent context after it is destroyed.
     dx_context_incref (parent);
+    parent->cx_attached++;
+}
+
+//! INTERNAL API
+void
+dx_context_mark_dirty (struct disir_context *context)
+{
+    while (context != NULL)
+    {
+        context->cx_validated_epoch = 0;
+
+        // The compiled restrictions of a mold keyval no longer reflect its queue.
+        if (dc_context_type (context) == DISIR_CONTEXT_KEYVAL
+            && context->CONTEXT_STATE_DESTROYED == 0
+            && context->cx_keyval != NULL)
+        {
+            dx_restriction_program_destroy (&context->cx_keyval->kv_restriction_program);
+        }
+
+        // Top-level contexts may be their own parent.
+        if (context->cx_parent_context == context)
+            break;
+        context = context->cx_parent_context;
+    }
+}
+
+//! INTERNAL API
+void
+dx_context_mark_tree_dirty (struct disir_context *context)
+{
+    struct disir_context *root;
+
+    if (context == NULL)
+        return;
+
+    root = (context->cx_root_context ? context->cx_root_context : context);
+    root->cx_validation_epoch += 1;
+    // Zero is reserved for dirty contexts.
+    if (root->cx_validation_epoch == 0)
+        root->cx_validation_epoch = 1;
 }
 
 //! INTERNAL API
 void
 dx_context_incref (struct disir_context *context)
 {
-    context->cx_refcount++;
-    log_debug_context (9, context,
-                       "(%p) increased refcount to: %d", context, context->cx_refcount);
+    int64_t refcount;
+
+    // Mold contexts are referenced by configs read concurrently.
+    refcount = __atomic_add_fetch (&context->cx_refcount, 1, __ATOMIC_RELAXED);
+    log_debug_context (9, context, "(%p) increased refcount to: %d", context, refcount);
 }
 
 //! INTERNAL API
 void
 dx_context_decref (struct disir_context **context)
 {
+    int64_t refcount;
+
     if (context == NULL)
         return;
     if (*context == NULL)
@@ -170,19 +216,42 @@ dx_context_decref (struct disir_context **context)
         return;
     }
 
-    (*context)->cx_refcount--;
-
-    if ((*context)->cx_refcount == 0)
+    refcount = __atomic_sub_fetch (&(*context)->cx_refcount, 1, __ATOMIC_ACQ_REL);
+    if (refcount == 0)
     {
         dx_context_destroy (context);
     }
     else
     {
-        log_debug_context (9, *context, "(%p) reduced refcount to: %d",
-                           *context, (*context)->cx_refcount);
+        log_debug_context (9, *context, "(%p) reduced refcount to: %d", *context, refcount);
     }
 }
 
+//! STATIC API
+//! Return 1 if the context itself is allocated within its arena.
+//! Top-level contexts own their arena, but are always heap allocated.
+static int
+context_in_arena (struct disir_context *context)
+{
+    return (context->cx_arena != NULL && dx_context_type_is_toplevel (context->cx_type) == 0);
+}
+
+//! STATIC API
+static void
+context_initialize (struct disir_context *context, enum disir_context_type type)
+{
+    context->cx_type = type;
+
+    // Set default context state to CONSTRUCTING
+    context->CONTEXT_STATE_CONSTRUCTING = 1;
+
+    // Set refcount to 1 - object is owned by creator.
+    context->cx_refcount = 1;
+
+    // Cached validity is never valid for epoch zero.
+    context->cx_validation_epoch = 1;
+}
+
 //! INTERNAL API
 struct disir_context *
 dx_context_create (enum disir_context_type type)
@@ -203,21 +272,83 @@ dx_context_create (enum disir_context_type type)
     if (context == NULL)
         return NULL;
 
-    context->cx_type = type;
+    context_initialize (context, type);
 
-    // Set default context state to CONSTRUCTING
-    context->CONTEXT_STATE_CONSTRUCTING = 1;
+    return context;
+}
 
-    // Set refcount to 1 - object is owned by creator.
-    context->cx_refcount = 1;
+//! INTERNAL API
+struct disir_context *
+dx_context_create_in (struct disir_context *parent, enum disir_context_type type)
+{
+    struct disir_context *context;
+    struct disir_arena *arena;
+
+    arena = NULL;
+    if (parent && parent->cx_root_context)
+    {
+        arena = parent->cx_root_context->cx_arena;
+    }
+
+    if (arena == NULL || dx_context_type_is_toplevel (type))
+    {
+        return dx_context_create (type);
+    }
+
+    if (dx_context_type_sanify (type) == DISIR_CONTEXT_UNKNOWN)
+    {
+        log_debug (0, "invoked with unknown context type( %d )", type);
+        return NULL;
+    }
+
+    log_debug (8, "Allocating disir_context for %s in arena %p",
+                  dx_context_type_string (type), arena);
+
+    context = dx_arena_alloc (arena, sizeof (struct disir_context));
+    if (context == NULL)
+        return NULL;
+
+    context_initialize (context, type);
+
+    // The arena must outlive every context allocated within it.
+    dx_arena_incref (arena);
+    context->cx_arena = arena;
+    dx_arena_track (arena, &context->cx_arena_link);
 
     return context;
 }
 
+//! INTERNAL API
+void *
+dx_context_calloc (struct disir_context *context, size_t size)
+{
+    if (context && context_in_arena (context))
+    {
+        return dx_arena_alloc (context->cx_arena, size);
+    }
+
+    return calloc (1, size);
+}
+
+//! INTERNAL API
+void
+dx_context_free (struct disir_context *context, void *ptr, size_t size)
+{
+    if (context && context_in_arena (context))
+    {
+        dx_arena_free (context->cx_arena, ptr, size);
+        return;
+    }
+
+    free (ptr);
+}
+
 //! INTERNAL API
 void
 dx_context_destroy  (struct disir_context **context)
 {
+    struct disir_arena *arena;
+
     if (context == NULL || *context == NULL)
         return;
 
@@ -229,8 +360,21 @@ dx_context_destroy  (struct disir_context **context)
 
     log_debug_context (9, *context, " (%p) reached refcount zero. Freeing.", *context);
 
-    free(*context);
+    arena = (*context)->cx_arena;
+    if (context_in_arena (*context) == 0)
+    {
+        free (*context);
+    }
+    else if (dx_arena_untrack (arena, &(*context)->cx_arena_link))
+    {
+        // Children destroyed while the tree lives on leave their memory for reuse.
+        // Contexts outliving the tree were untracked when it was released.
+        dx_arena_free (arena, *context, sizeof (struct disir_context));
+    }
     *context = NULL;
+
+    // Drop the reference held on the arena. The last context releases it.
+    dx_arena_decref (&arena);
 }
 
 //! INTERNAL API
@@ -482,7 +626,8 @@ dc_set_value_type (struct disir_context *context, enum disir_value_type type)
     {
         //TODO XXX: Cannot set type if keyval has defaults
         //TODO XXX: Cannot set type if toplevel context is not DISIR_MOLD
-        context->cx_keyval->kv_value.dv_type = type;
+        dx_value_set_type (&context->cx_keyval->kv_value, type);
+        dx_context_mark_dirty (context);
         break;
     }
     default:
@@ -111,8 +111,8 @@ set_value_input_check (struct disir_context *context, enum disir_value_type type
         // (Makes a correction in the type previously sat wrongfully (on purpose) below.)
         if (context->cx_keyval->kv_mold_equiv)
         {
-            context->cx_keyval->kv_value.dv_type
-                = context->cx_keyval->kv_mold_equiv->cx_keyval->kv_value.dv_type;
+            dx_value_set_type (&context->cx_keyval->kv_value,
+                               context->cx_keyval->kv_mold_equiv->cx_keyval->kv_value.dv_type);
         }
     }
     else if (dc_context_type (context) == DISIR_CONTEXT_DEFAULT)
@@ -173,7 +173,7 @@ set_value_input_check (struct disir_context *context, enum disir_value_type type
                 // context error message already set by set_name
                 status = DISIR_STATUS_INVALID_CONTEXT;
                 // Set storage type to mirror input
-                (*storage)->dv_type = type;
+                dx_value_set_type (*storage, type);
 
             }
             // Use-case 3
@@ -187,7 +187,7 @@ set_value_input_check (struct disir_context *context, enum disir_value_type type
                                       dx_value_type_string (type),
                                       dx_value_type_string ((*storage)->dv_type));
                 // Set storage type to mirror input
-                (*storage)->dv_type = type;
+                dx_value_set_type (*storage, type);
             }
         }
         // Use-case 4
@@ -195,11 +195,15 @@ set_value_input_check (struct disir_context *context, enum disir_value_type type
                  context->CONTEXT_STATE_INVALID)
         {
             // Set storage type to mirror input
-            (*storage)->dv_type = type;
+            dx_value_set_type (*storage, type);
             status = DISIR_STATUS_INVALID_CONTEXT;
         }
     }
 
+    // The value is about to change. Only this context and its parents
+    // need to be re-checked the next time the tree is validated.
+    dx_context_mark_dirty (context);
+
     return status;
 }
 
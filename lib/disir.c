@@ -19,6 +19,8 @@
 #include "log.h"
 #include "mqueue.h"
 #include "restriction.h"
+#include "mold_cache.h"
+#include "entry_index.h"
 
 //! INTERNAL STATIC
 static enum disir_status
@@ -209,6 +211,7 @@ disir_instance_create (const char *config_filepath, struct disir_config *config,
 
     struct disir_config *libconf;
     struct disir_mold *libmold;
+    const char *log_filepath;
 
     status = DISIR_STATUS_OK;
 
@@ -227,6 +230,17 @@ disir_instance_create (const char *config_filepath, struct disir_config *config,
         return DISIR_STATUS_NO_MEMORY;
     }
 
+    // Errors are kept per thread, such that the instance may be shared between threads.
+    if (pthread_key_create (&dis->disir_error_key, NULL) != 0)
+    {
+        free (dis);
+        return DISIR_STATUS_NO_MEMORY;
+    }
+    pthread_mutex_init (&dis->disir_error_mutex, NULL);
+    pthread_mutex_init (&dis->dio_mold_cache_mutex, NULL);
+    pthread_mutex_init (&dis->dio_entry_index_mutex, NULL);
+    pthread_mutex_init (&dis->dio_write_mutex, NULL);
+
     // No user provided config - generate the internal mold since user cannot provide one.
     if (config == NULL)
     {
@@ -276,6 +290,13 @@ disir_instance_create (const char *config_filepath, struct disir_config *config,
     // TODO: Validate libconf
     // XXX: Validate version? Upgrade?
 
+    // Direct the internal log to the configured log file. An empty filepath disables it.
+    if (disir_config_get_keyval_string (libconf, &log_filepath, "log_filepath")
+        == DISIR_STATUS_OK)
+    {
+        dx_log_set_filepath (log_filepath);
+    }
+
     status = load_plugins_from_config (dis, libconf);
     if (status != DISIR_STATUS_OK && status != DISIR_STATUS_NOT_EXIST)
     {
@@ -294,6 +315,12 @@ disir_instance_create (const char *config_filepath, struct disir_config *config,
 error:
     if (dis)
     {
+        dx_error_slots_destroy (dis);
+        pthread_key_delete (dis->disir_error_key);
+        pthread_mutex_destroy (&dis->disir_error_mutex);
+        pthread_mutex_destroy (&dis->dio_mold_cache_mutex);
+        pthread_mutex_destroy (&dis->dio_entry_index_mutex);
+        pthread_mutex_destroy (&dis->dio_write_mutex);
         free (dis);
     }
     if (libmold)
@@ -305,6 +332,31 @@ error:
     return status;
 }
 
+//! PUBLIC API
+enum disir_status
+disir_read_arena (struct disir_instance *instance, int enable)
+{
+    if (instance == NULL)
+    {
+        log_debug (0, "invoked with instance NULL pointer.");
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    __atomic_store_n (&instance->dio_read_arena, (enable != 0), __ATOMIC_RELAXED);
+
+    return DISIR_STATUS_OK;
+}
+
+//! PUBLIC API
+int
+disir_read_arena_enabled (struct disir_instance *instance)
+{
+    if (instance == NULL)
+        return 0;
+
+    return __atomic_load_n (&instance->dio_read_arena, __ATOMIC_RELAXED);
+}
+
 //! PUBLIC API
 enum disir_status
 disir_instance_destroy (struct disir_instance **instance)
@@ -314,6 +366,10 @@ disir_instance_destroy (struct disir_instance **instance)
     if (instance == NULL || *instance == NULL)
         return DISIR_STATUS_INVALID_ARGUMENT;
 
+    // Release cached molds and entry indexes
+    dx_mold_cache_clear (*instance);
+    dx_entry_index_clear (*instance);
+
     // Free loaded plugins
     while (1)
     {
@@ -352,12 +408,20 @@ disir_instance_destroy (struct disir_instance **instance)
     disir_config_finished(&(*instance)->libdisir_config);
     disir_mold_finished(&(*instance)->libdisir_mold);
 
-    // Free any error message set on instance
-    if ((*instance)->disir_error_message)
+    // Commit a write transaction left behind.
+    if ((*instance)->dio_write_transaction)
     {
-        free ((*instance)->disir_error_message);
+        dx_write_transaction_finish (*instance, &(*instance)->dio_write_transaction);
     }
 
+    // Free any error message set on instance, by any thread
+    dx_error_slots_destroy (*instance);
+    pthread_key_delete ((*instance)->disir_error_key);
+    pthread_mutex_destroy (&(*instance)->disir_error_mutex);
+    pthread_mutex_destroy (&(*instance)->dio_mold_cache_mutex);
+    pthread_mutex_destroy (&(*instance)->dio_entry_index_mutex);
+    pthread_mutex_destroy (&(*instance)->dio_write_mutex);
+
     free (*instance);
 
     *instance = NULL;
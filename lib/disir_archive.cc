@@ -19,12 +19,26 @@ extern "C" {
 #include <archive_entry.h>
 #include <cstdio>
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 
 //! PUBLIC API
 enum disir_status
 disir_archive_export_begin (struct disir_instance *instance,
                             const char *archive_path, struct disir_archive **archive)
+{
+    return disir_archive_export_begin_with_options (instance, archive_path, NULL, archive);
+}
+
+//! PUBLIC API
+enum disir_status
+disir_archive_export_begin_with_options (struct disir_instance *instance,
+                                         const char *archive_path,
+                                         const struct disir_archive_options *options,
+                                         struct disir_archive **archive)
 {
     enum disir_status status;
 
@@ -37,26 +51,51 @@ disir_archive_export_begin (struct disir_instance *instance,
 
     if (archive_path == NULL)
     {
-        status = dx_archive_begin_new (archive);
+        status = dx_archive_begin_new (options, archive);
     }
     else
     {
-        status = dx_archive_begin_existing (instance, archive_path, archive);
+        status = dx_archive_begin_existing (instance, archive_path, options, archive);
+    }
+
+    if (status == DISIR_STATUS_INVALID_ARGUMENT && options)
+    {
+        disir_error_set (instance, "invalid archive compression options");
     }
 
     return status;
 }
 
+//! STATIC FUNCTION
+//! Whether the import status of an entry is part of the import report,
+//! rather than a failure to resolve it.
+static bool
+import_status_reported (enum disir_status status)
+{
+    return (status == DISIR_STATUS_OK ||
+            status == DISIR_STATUS_CONFLICT ||
+            status == DISIR_STATUS_NO_CAN_DO ||
+            status == DISIR_STATUS_CONFIG_INVALID ||
+            status == DISIR_STATUS_CONFLICTING_SEMVER);
+}
+
 //! STATIC FUNCTION
 static enum disir_status
 archive_import_config_entries (struct disir_instance *instance,
-                               struct disir_archive *archive,
+                               struct disir_archive *archive, int jobs,
                                struct disir_import **import)
 {
     enum disir_status status;
+    std::vector<const struct disir_archive_entry *> archive_entries;
+    std::vector<enum disir_status> statuses;
+    std::vector<std::string> errors;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> next_index (0);
     struct disir_import_entry **current;
     struct disir_import_entry *entry;
     struct disir_import *im;
+    size_t threads;
+    size_t i;
 
     im = (struct disir_import*)calloc (1, sizeof (disir_import));
     if (im == NULL)
@@ -89,19 +128,89 @@ archive_import_config_entries (struct disir_instance *instance,
         entry->ie_backend_id = strdup (e.de_backend_id.c_str());
         entry->ie_version = strdup (e.de_version.c_str());
 
-        status = dx_resolve_config_import_status (instance, e.de_filepath.c_str(), entry);
-        if (status != DISIR_STATUS_OK &&
-            status != DISIR_STATUS_CONFLICT &&
-            status != DISIR_STATUS_NO_CAN_DO &&
-            status != DISIR_STATUS_CONFIG_INVALID &&
-            status != DISIR_STATUS_CONFLICTING_SEMVER)
+        archive_entries.push_back (&e);
+        (*current++) = entry;
+    }
+
+    statuses.resize (archive_entries.size (), DISIR_STATUS_OK);
+    errors.resize (archive_entries.size ());
+
+    // Reading the mold, the archive entry and the existing config of each entry, and
+    // comparing them, is independent of every other entry. Workers pick entries in turn,
+    // each writing only to its own entry. The report keeps the order of the archive.
+    {
+        auto resolve = [&] ()
         {
-            goto error;
+            size_t index;
+
+            while ((index = next_index++) < archive_entries.size ())
+            {
+                const struct disir_archive_entry *e = archive_entries[index];
+
+                if (e->de_content)
+                {
+                    statuses[index] = dx_resolve_config_import_status (instance, NULL,
+                                                                       e->de_content->data (),
+                                                                       e->de_content->size (),
+                                                                       im->di_entries[index]);
+                }
+                else
+                {
+                    statuses[index] = dx_resolve_config_import_status (instance,
+                                                                       e->de_filepath.c_str(),
+                                                                       NULL, 0,
+                                                                       im->di_entries[index]);
+                }
+
+                // Errors are kept per thread; hand it over to the calling thread.
+                if (import_status_reported (statuses[index]) == false && disir_error (instance))
+                {
+                    errors[index] = disir_error (instance);
+                }
+            }
+        };
+
+        threads = 1;
+        if (jobs < 0)
+        {
+            threads = std::max (std::thread::hardware_concurrency (), 1u);
+        }
+        else if (jobs > 1)
+        {
+            threads = jobs;
+        }
+        threads = std::min (threads, archive_entries.size ());
+        if (threads > 1)
+        {
+            log_debug (4, "resolving %zu import entries with %zu jobs",
+                       archive_entries.size (), threads);
         }
 
-        entry->ie_status = status;
+        // The calling thread is one of the workers
+        for (i = 1; i < threads; i++)
+        {
+            workers.emplace_back (resolve);
+        }
+        resolve ();
+        for (auto& worker : workers)
+        {
+            worker.join ();
+        }
+    }
 
-        (*current++) = entry;
+    for (i = 0; i < statuses.size (); i++)
+    {
+        status = statuses[i];
+        if (import_status_reported (status) == false)
+        {
+            if (errors[i].empty () == false)
+            {
+                disir_error_set (instance, "%s", errors[i].c_str ());
+            }
+            goto error;
+        }
+
+        im->di_entries[i]->ie_status = status;
     }
 
     *import = im;
@@ -117,11 +226,28 @@ error:
 enum disir_status
 disir_archive_import (struct disir_instance *instance, const char *archive_path,
                       struct disir_import **import, int *entries)
+{
+    return disir_archive_import_with_flags (instance, archive_path, 0, import, entries);
+}
+
+//! PUBLIC API
+enum disir_status
+disir_archive_import_with_flags (struct disir_instance *instance, const char *archive_path,
+                                 int flags, struct disir_import **import, int *entries)
+{
+    return disir_archive_import_with_jobs (instance, archive_path, flags, 1, import, entries);
+}
+
+//! PUBLIC API
+enum disir_status
+disir_archive_import_with_jobs (struct disir_instance *instance, const char *archive_path,
+                                int flags, int jobs, struct disir_import **import, int *entries)
 {
     enum disir_status status;
     struct disir_archive *archive = NULL;
     std::map<std::string, std::string> archive_content;
     char *tmp_dir_name = NULL;
+    bool in_memory;
 
     if (instance == NULL || archive_path == NULL || import == NULL || entries == NULL)
     {
@@ -143,27 +269,37 @@ disir_archive_import (struct disir_instance *instance, const char *archive_path,
         return status;
     }
 
-    // Create temp path for extraction
-    tmp_dir_name = dx_archive_create_temp_folder();
-    if (tmp_dir_name == NULL)
+    in_memory = ((flags & DISIR_ARCHIVE_IMPORT_EXTRACT) == 0);
+    if (in_memory)
     {
-        return DISIR_STATUS_FS_ERROR;
+        status = dx_archive_read (archive_path, archive_content, NULL);
     }
+    else
+    {
+        // Create temp path for extraction
+        tmp_dir_name = dx_archive_create_temp_folder();
+        if (tmp_dir_name == NULL)
+        {
+            status = DISIR_STATUS_FS_ERROR;
+            goto out;
+        }
 
-    archive->da_extract_folder_path = tmp_dir_name;
+        archive->da_extract_folder_path = tmp_dir_name;
 
-    status = dx_archive_extract (archive_path, archive_content, tmp_dir_name);
+        status = dx_archive_extract (archive_path, archive_content, tmp_dir_name);
+    }
     if (status != DISIR_STATUS_OK)
         goto out;
 
-    status = dx_archive_validate (archive, archive_content);
+    status = dx_archive_validate (archive, archive_content, in_memory);
     if (status != DISIR_STATUS_OK)
     {
         disir_error_set (instance, "archive on path '%s' is invalid", archive_path);
         goto out;
     }
 
-    status = archive_import_config_entries (instance, archive, import);
+    // Entries read into memory refer to archive_content, which outlives them.
+    status = archive_import_config_entries (instance, archive, jobs, import);
     if (status != DISIR_STATUS_OK)
         goto out;
 
@@ -15,9 +15,13 @@ extern "C" {
 #include <archive_entry.h>
 #include <limits.h>
 #include <fstream>
+#include <sstream>
 #include <iostream>
 #include <ftw.h>
 #include <ctime>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
 
 //! INTERNAL API
 char *dx_archive_create_temp_folder (void)
@@ -53,6 +57,8 @@ dx_archive_create (struct disir_archive **archive)
     ar->da_extract_folder_path = NULL;
     ar->da_existing_path = NULL;
     ar->da_temp_archive_path = NULL;
+    ar->da_stream = NULL;
+    ar->da_fd = -1;
 
     ar->da_metadata = new (std::nothrow) toml::Value (toml::Table());
     if (ar->da_metadata == nullptr)
@@ -215,6 +221,99 @@ out:
     return status;
 }
 
+//! INTERNAL API
+enum disir_status
+dx_archive_read (const char *archive_path, std::map<std::string, std::string>& archive_content,
+                 enum disir_archive_compression *compression)
+{
+    enum disir_status status;
+    struct archive *read_archive = NULL;
+    struct archive_entry *entry;
+    int ret;
+    int64_t offset;
+    size_t size;
+    const void *buff;
+
+    status = dx_archive_open_read (archive_path, &read_archive);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
+        return status;
+    }
+
+    while ((ret = archive_read_next_header (read_archive, &entry)) == ARCHIVE_OK)
+    {
+        if (archive_entry_filetype (entry) != AE_IFREG)
+            continue;
+
+        std::string& content = archive_content[archive_entry_pathname (entry)];
+        content.clear ();
+        if (archive_entry_size_is_set (entry))
+        {
+            content.reserve (archive_entry_size (entry));
+        }
+
+        while (1)
+        {
+            ret = archive_read_data_block (read_archive, &buff, &size, &offset);
+            if (ret == ARCHIVE_EOF)
+                break;
+
+            if (ret != ARCHIVE_OK)
+            {
+                log_error ("could not read archive data: %s",
+                            archive_error_string (read_archive));
+                status = DISIR_STATUS_FS_ERROR;
+                goto out;
+            }
+
+            // Sparse members are filled with zeros up to the offset of the block
+            if ((size_t)offset > content.size ())
+            {
+                content.resize (offset, '\0');
+            }
+            content.append ((const char *)buff, size);
+        }
+    }
+
+    if (ret != ARCHIVE_EOF)
+    {
+        log_error ("could not read archive header: %s", archive_error_string (read_archive));
+        status = DISIR_STATUS_FS_ERROR;
+        goto out;
+    }
+
+    if (compression)
+    {
+        // The filter is detected once the first header is read
+        switch (archive_filter_code (read_archive, 0))
+        {
+        case ARCHIVE_FILTER_XZ:
+            *compression = DISIR_ARCHIVE_COMPRESSION_XZ;
+            break;
+        case ARCHIVE_FILTER_ZSTD:
+            *compression = DISIR_ARCHIVE_COMPRESSION_ZSTD;
+            break;
+        case ARCHIVE_FILTER_NONE:
+            *compression = DISIR_ARCHIVE_COMPRESSION_NONE;
+            break;
+        default:
+            log_error ("unsupported archive compression: %s",
+                       archive_filter_name (read_archive, 0));
+            status = DISIR_STATUS_NO_CAN_DO;
+        }
+    }
+    // FALL-THROUGH
+out:
+    if (archive_read_free (read_archive) != ARCHIVE_OK)
+    {
+        log_error ("unable to free read archive: %s", archive_error_string (read_archive));
+        status = DISIR_STATUS_FS_ERROR;
+    }
+
+    return status;
+}
+
 //! STATIC FUNCTION
 static void
 dx_random_string (unsigned int length, unsigned int seed, char *dest)
@@ -229,6 +328,264 @@ dx_random_string (unsigned int length, unsigned int seed, char *dest)
     *dest = '\0';
 }
 
+//! STATIC FUNCTION
+//! Add the compression filter selected by options to the write archive.
+static enum disir_status
+archive_set_compression (struct archive *ar, const struct disir_archive_options *options)
+{
+    const char *filter;
+    char value[32];
+    int ret;
+
+    switch (options->ao_compression)
+    {
+    case DISIR_ARCHIVE_COMPRESSION_XZ:
+        filter = "xz";
+        ret = archive_write_add_filter_xz (ar);
+        break;
+    case DISIR_ARCHIVE_COMPRESSION_ZSTD:
+        filter = "zstd";
+        ret = archive_write_add_filter_zstd (ar);
+        break;
+    case DISIR_ARCHIVE_COMPRESSION_NONE:
+        return DISIR_STATUS_OK;
+    default:
+        log_error ("unknown archive compression: %d", (int) options->ao_compression);
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (ret != ARCHIVE_OK)
+    {
+        log_error ("unable to set archive compression: %s", archive_error_string (ar));
+        return DISIR_STATUS_FS_ERROR;
+    }
+
+    if (options->ao_level != 0)
+    {
+        snprintf (value, sizeof (value), "%d", options->ao_level);
+        if (archive_write_set_filter_option (ar, filter, "compression-level", value)
+            != ARCHIVE_OK)
+        {
+            log_error ("unable to set %s compression level %d: %s",
+                       filter, options->ao_level, archive_error_string (ar));
+            return DISIR_STATUS_INVALID_ARGUMENT;
+        }
+    }
+
+    if (options->ao_threads > 1 || options->ao_threads < 0)
+    {
+        // libarchive starts one thread per online CPU for zero threads
+        snprintf (value, sizeof (value), "%d", options->ao_threads < 0 ? 0 : options->ao_threads);
+        if (archive_write_set_filter_option (ar, filter, "threads", value) != ARCHIVE_OK)
+        {
+            // Compressing on a single thread still yields a valid archive
+            log_warn ("unable to compress %s with %s threads: %s",
+                      filter, value, archive_error_string (ar));
+        }
+    }
+
+    return DISIR_STATUS_OK;
+}
+
+//! STATIC FUNCTION
+//! Begin a new compressed stream at the current end of the temporary archive file.
+static enum disir_status
+archive_stream_open (struct disir_archive *archive)
+{
+    enum disir_status status;
+    struct archive_entry *entry = NULL;
+    struct archive *stream;
+
+    stream = archive_write_new ();
+    if (stream == NULL)
+    {
+        log_debug (3, "unable to open new compressed stream");
+        return DISIR_STATUS_NO_MEMORY;
+    }
+
+    // The tar archive is already formatted - the stream only compresses it.
+    if (archive_write_set_format_raw (stream) != ARCHIVE_OK)
+    {
+        log_error ("unable to set stream format to raw: %s", archive_error_string (stream));
+        status = DISIR_STATUS_FS_ERROR;
+        goto out;
+    }
+
+    status = archive_set_compression (stream, &archive->da_options);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
+        goto out;
+    }
+
+    // Padding the last block would put garbage between this stream and the next.
+    if (archive_write_set_bytes_in_last_block (stream, 1) != ARCHIVE_OK
+        || archive_write_open_fd (stream, archive->da_fd) != ARCHIVE_OK)
+    {
+        log_error ("unable to open compressed stream: %s", archive_error_string (stream));
+        status = DISIR_STATUS_FS_ERROR;
+        goto out;
+    }
+
+    entry = archive_entry_new ();
+    if (entry == NULL)
+    {
+        status = DISIR_STATUS_NO_MEMORY;
+        goto out;
+    }
+    archive_entry_set_filetype (entry, AE_IFREG);
+    if (archive_write_header (stream, entry) != ARCHIVE_OK)
+    {
+        log_error ("unable to begin compressed stream: %s", archive_error_string (stream));
+        status = DISIR_STATUS_FS_ERROR;
+        goto out;
+    }
+
+    archive->da_stream = stream;
+    // FALL-THROUGH
+out:
+    if (entry)
+        archive_entry_free (entry);
+    if (status != DISIR_STATUS_OK)
+        archive_write_free (stream);
+
+    return status;
+}
+
+//! STATIC FUNCTION
+//! Finish the current compressed stream, if any.
+static enum disir_status
+archive_stream_close (struct disir_archive *archive)
+{
+    enum disir_status status;
+
+    status = DISIR_STATUS_OK;
+    if (archive->da_stream == NULL)
+        return status;
+
+    if (archive_write_close (archive->da_stream) != ARCHIVE_OK)
+    {
+        log_error ("unable to finish compressed stream: %s",
+                   archive_error_string (archive->da_stream));
+        status = DISIR_STATUS_FS_ERROR;
+    }
+    archive_write_free (archive->da_stream);
+    archive->da_stream = NULL;
+
+    return status;
+}
+
+//! STATIC FUNCTION
+//! libarchive write callback of the tar archive: compress the tar output.
+static la_ssize_t
+archive_stream_write (struct archive *ar, void *client_data, const void *buffer, size_t length)
+{
+    struct disir_archive *archive = (struct disir_archive *) client_data;
+    la_ssize_t written;
+
+    if (archive->da_stream == NULL && archive_stream_open (archive) != DISIR_STATUS_OK)
+    {
+        archive_set_error (ar, EIO, "unable to open compressed stream");
+        return -1;
+    }
+
+    written = archive_write_data (archive->da_stream, buffer, length);
+    if (written < 0)
+    {
+        archive_set_error (ar, EIO, "%s", archive_error_string (archive->da_stream));
+        return -1;
+    }
+
+    return written;
+}
+
+//! STATIC FUNCTION
+//! libarchive close callback of the tar archive: finish the last compressed stream.
+static int
+archive_stream_close_file (struct archive *ar, void *client_data)
+{
+    struct disir_archive *archive = (struct disir_archive *) client_data;
+    enum disir_status status;
+
+    status = archive_stream_close (archive);
+    if (close (archive->da_fd) != 0 && status == DISIR_STATUS_OK)
+    {
+        archive_set_error (ar, errno, "unable to close archive: %s", strerror (errno));
+        status = DISIR_STATUS_FS_ERROR;
+    }
+    archive->da_fd = -1;
+
+    return (status == DISIR_STATUS_OK ? ARCHIVE_OK : ARCHIVE_FATAL);
+}
+
+//! INTERNAL API
+enum disir_status
+dx_archive_stream_split (struct disir_archive *archive, int64_t *offset)
+{
+    enum disir_status status;
+    off_t end;
+
+    status = archive_stream_close (archive);
+    if (status != DISIR_STATUS_OK)
+        return status;
+
+    end = lseek (archive->da_fd, 0, SEEK_CUR);
+    if (end == (off_t) -1)
+    {
+        log_error ("unable to tell size of temporary archive: %s", strerror (errno));
+        return DISIR_STATUS_FS_ERROR;
+    }
+
+    *offset = end;
+    return DISIR_STATUS_OK;
+}
+
+//! INTERNAL API
+enum disir_status
+dx_archive_keep_prefix (struct disir_archive *archive, const char *archive_path, int64_t size)
+{
+    enum disir_status status;
+    char buffer[65536];
+    ssize_t res;
+    int fd;
+
+    if (archive->da_stream != NULL)
+    {
+        log_fatal ("prefix kept after the archive was written to");
+        return DISIR_STATUS_INTERNAL_ERROR;
+    }
+
+    fd = open (archive_path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        log_error ("unable to open archive '%s': %s", archive_path, strerror (errno));
+        return DISIR_STATUS_FS_ERROR;
+    }
+
+    status = DISIR_STATUS_OK;
+    while (size > 0)
+    {
+        res = read (fd, buffer, (size_t) std::min<int64_t> (size, sizeof (buffer)));
+        if (res <= 0)
+        {
+            log_error ("unable to read archive '%s': %s", archive_path,
+                       res == 0 ? "unexpected end of file" : strerror (errno));
+            status = DISIR_STATUS_FS_ERROR;
+            break;
+        }
+        if (write (archive->da_fd, buffer, res) != res)
+        {
+            log_error ("unable to write temporary archive: %s", strerror (errno));
+            status = DISIR_STATUS_FS_ERROR;
+            break;
+        }
+        size -= res;
+    }
+
+    close (fd);
+    return status;
+}
+
 //! INTERNAL API
 enum disir_status
 dx_archive_open_write (struct disir_archive *archive)
@@ -236,6 +593,7 @@ dx_archive_open_write (struct disir_archive *archive)
     enum disir_status status;
     char temp_archive_path[PATH_MAX];
     char random_suffix[PATH_MAX];
+    struct archive *check;
     struct archive *ar;
     struct stat st;
     int ret;
@@ -263,9 +621,26 @@ dx_archive_open_write (struct disir_archive *archive)
         goto out;
     }
 
-    if (archive_write_add_filter_xz (ar) != ARCHIVE_OK)
+    // The compressed streams are opened as they are needed. Reject invalid options up front.
+    check = archive_write_new ();
+    if (check == NULL)
     {
-        log_error ("unable to set archive compression: %s", archive_error_string (ar));
+        status = DISIR_STATUS_NO_MEMORY;
+        goto out;
+    }
+    status = archive_set_compression (check, &archive->da_options);
+    archive_write_free (check);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
+        goto out;
+    }
+
+    // The tar archive is handed to the compressed stream as it is written, unblocked,
+    // such that it can be split into separately compressed streams.
+    if (archive_write_set_bytes_per_block (ar, 0) != ARCHIVE_OK)
+    {
+        log_error ("unable to unblock archive: %s", archive_error_string (ar));
         status = DISIR_STATUS_FS_ERROR;
         goto out;
     }
@@ -304,7 +679,16 @@ dx_archive_open_write (struct disir_archive *archive)
         goto out;
     }
 
-    if (archive_write_open_filename (ar, temp_archive_path) != ARCHIVE_OK)
+    archive->da_fd = open (temp_archive_path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+    if (archive->da_fd == -1)
+    {
+        log_error ("unable open archive on path '%s': %s", temp_archive_path, strerror (errno));
+        status = DISIR_STATUS_FS_ERROR;
+        goto out;
+    }
+
+    if (archive_write_open (ar, archive, NULL, archive_stream_write, archive_stream_close_file)
+        != ARCHIVE_OK)
     {
         log_error ("unable open archive on path '%s': %s",
                    temp_archive_path, archive_error_string (ar));
@@ -325,6 +709,11 @@ out:
             if (archive_write_free (ar) != ARCHIVE_OK)
                 log_error ("unable to free archive: %s", archive_error_string (ar));
         }
+        if (archive->da_fd != -1)
+        {
+            close (archive->da_fd);
+            archive->da_fd = -1;
+        }
     }
 
     return status;
@@ -354,18 +743,23 @@ dx_archive_open_read (const char *archive_path, struct archive **archive)
         goto out;
     }
 
-    err = archive_read_support_filter_xz (ar);
-    if (err != ARCHIVE_OK)
+    // The codec is detected from the archive itself
+    for (auto support_filter : { archive_read_support_filter_xz,
+                                 archive_read_support_filter_zstd })
     {
-        if (err != ARCHIVE_WARN)
-        {
-            log_error ("could not set read compression: %s", archive_error_string (ar));
-            status = DISIR_STATUS_FS_ERROR;
-            goto out;
-        }
-        else
+        err = support_filter (ar);
+        if (err != ARCHIVE_OK)
         {
-            log_warn ("%s", archive_error_string (ar));
+            if (err != ARCHIVE_WARN)
+            {
+                log_error ("could not set read compression: %s", archive_error_string (ar));
+                status = DISIR_STATUS_FS_ERROR;
+                goto out;
+            }
+            else
+            {
+                log_warn ("%s", archive_error_string (ar));
+            }
         }
     }
 
@@ -389,11 +783,27 @@ out:
     return status;
 }
 
+//! STATIC FUNCTION
+//! Parse a toml archive member, either extracted to the filepath 'member'
+//! or read into memory as 'member'.
+static toml::ParseResult
+parse_archive_toml (const std::string& member, bool in_memory)
+{
+    if (in_memory)
+    {
+        std::istringstream input (member);
+        return toml::parse (input);
+    }
+
+    std::ifstream input (member.c_str());
+    return toml::parse (input);
+}
+
 //! STATIC FUNCTION
 static enum disir_status
 validate_archive_backend_entries (struct disir_archive *archive,
                                   std::map<std::string, std::string>& extract_content,
-                                  const std::string backend,
+                                  bool in_memory, const std::string backend,
                                   const toml::Value& groups)
 {
     struct stat file_exist;
@@ -409,10 +819,7 @@ validate_archive_backend_entries (struct disir_archive *archive,
         return DISIR_STATUS_NOT_EXIST;
     }
 
-    auto toml_filepath = iter->second;
-
-    std::ifstream entries_toml (toml_filepath.c_str());
-    toml::ParseResult pr = toml::parse (entries_toml);
+    toml::ParseResult pr = parse_archive_toml (iter->second, in_memory);
 
     if (!pr.valid())
     {
@@ -454,7 +861,7 @@ validate_archive_backend_entries (struct disir_archive *archive,
             }
 
             // Validate existence of file on disk. Necessary?
-            if (stat (iter->second.c_str(), &file_exist) != 0)
+            if (in_memory == false && stat (iter->second.c_str(), &file_exist) != 0)
             {
                 log_error ("file does not exist on disk: %s", config_entry.c_str());
                 return DISIR_STATUS_NOT_EXIST;
@@ -463,7 +870,15 @@ validate_archive_backend_entries (struct disir_archive *archive,
             archive_entry.de_backend_id = backend;
             archive_entry.de_group_id = group.as<std::string>();
             archive_entry.de_entry_id = entry.first;
-            archive_entry.de_filepath = iter->second;
+            if (in_memory)
+            {
+                archive_entry.de_content = &iter->second;
+            }
+            else
+            {
+                archive_entry.de_filepath = iter->second;
+                archive_entry.de_content = NULL;
+            }
             archive_entry.de_version  = entry.second.as<std::string>();
             archive->da_config_entries->insert (archive_entry);
         }
@@ -475,7 +890,7 @@ validate_archive_backend_entries (struct disir_archive *archive,
 //! INTERNAL API
 enum disir_status
 dx_archive_validate (struct disir_archive *archive,
-                     std::map<std::string, std::string>& extract_content)
+                     std::map<std::string, std::string>& extract_content, bool in_memory)
 {
     enum disir_status status;
 
@@ -487,10 +902,7 @@ dx_archive_validate (struct disir_archive *archive,
         return DISIR_STATUS_NOT_EXIST;
     }
 
-    std::string toml_filepath = it->second;
-
-    std::ifstream metadata (toml_filepath.c_str());
-    toml::ParseResult pr = toml::parse (metadata);
+    toml::ParseResult pr = parse_archive_toml (it->second, in_memory);
 
     if (!pr.valid())
     {
@@ -589,7 +1001,7 @@ dx_archive_validate (struct disir_archive *archive,
         }
 
         // Validate entries.toml
-        status = validate_archive_backend_entries (archive, extract_content,
+        status = validate_archive_backend_entries (archive, extract_content, in_memory,
                                                    id->as<std::string>(), *groups);
         if (status != DISIR_STATUS_OK)
         {
@@ -741,6 +1153,11 @@ copy_file (const char *from, const char *to)
     }
 
     destination << source.rdbuf();
+    destination.close();
+    if (destination.fail())
+    {
+        return DISIR_STATUS_FS_ERROR;
+    }
 
     return DISIR_STATUS_OK;
 }
@@ -752,7 +1169,7 @@ dx_archive_disk_append (const char *new_archive_path, const char *existing_archi
 {
     enum disir_status status;
     int ret;
-    char backup_path[4096];
+    char partial_path[4096];
     char archive_path_with_extension[4096];
     const char *ext = NULL;
 
@@ -801,37 +1218,22 @@ dx_archive_disk_append (const char *new_archive_path, const char *existing_archi
     if (existing_archive_path &&
         (strcmp (existing_archive_path, archive_path_with_extension) == 0))
     {
-        // Rename existing archive with backup extension.
-        *backup_path = '\0';
-        strcat (backup_path, existing_archive_path);
-        strcat (backup_path, ".backup");
-        ret = rename (existing_archive_path, backup_path);
-        if (ret != 0)
-        {
-            log_error ("failed to create backup of existing archive: %s", strerror (errno));
-            return DISIR_STATUS_FS_ERROR;
-        }
-
-        // Rename new archive to same as existing
-        status = copy_file (temp_archive_path, existing_archive_path);
+        // Copy the new archive next to the existing one, and rename it into place.
+        // The existing archive is intact until then.
+        snprintf (partial_path, sizeof (partial_path), "%s.partial", existing_archive_path);
+        status = copy_file (temp_archive_path, partial_path);
         if (status != DISIR_STATUS_OK)
         {
-            log_error ("failed to rename archive '%s': %s", temp_archive_path, strerror (errno));
-
-            // Error again?! Re-rename existing file back to original name
-            ret = rename (backup_path, existing_archive_path);
-            if (ret != 0)
-            {
-                log_error ("failed to rename archive back to existing name: %s", strerror (errno));
-            }
+            log_error ("failed to copy archive '%s': %s", temp_archive_path, strerror (errno));
+            remove (partial_path);
             return DISIR_STATUS_FS_ERROR;
         }
 
-        // All good, remove old archive
-        ret = remove (backup_path);
+        ret = rename (partial_path, existing_archive_path);
         if (ret != 0)
         {
-            log_error ("failed to remove original archive: %s", strerror (errno));
+            log_error ("failed to replace existing archive: %s", strerror (errno));
+            remove (partial_path);
             return DISIR_STATUS_FS_ERROR;
         }
     }
@@ -35,7 +35,8 @@ set_value_generic (struct disir_context *context, enum disir_value_type type,
     switch (type)
     {
     case DISIR_VALUE_TYPE_ENUM:
-        // FALL-THROUGH
+        status = dc_set_value_enum (context, value_string, strlen (value_string));
+        break;
     case DISIR_VALUE_TYPE_STRING:
         status = dc_set_value_string (context, value_string, strlen (value_string));
         break;
@@ -66,7 +67,8 @@ get_value_generic (struct disir_context *context, enum disir_value_type type,
     switch (type)
     {
     case DISIR_VALUE_TYPE_ENUM:
-        // FALL-THROUGH
+        status = dc_get_value_enum (context, value_string, NULL);
+        break;
     case DISIR_VALUE_TYPE_STRING:
         status = dc_get_value_string (context, value_string, NULL);
         break;
@@ -87,24 +89,15 @@ get_value_generic (struct disir_context *context, enum disir_value_type type,
 }
 
 //! STATIC API
+//! Check that the output pointer matching type is set.
 static enum disir_status
-config_get_keyval_generic (struct disir_context *parent, enum disir_value_type type,
-                           const char *query, va_list args,
-                           const char **value_string, uint8_t *value_boolean,
-                           int64_t *value_integer, double *value_float)
+get_value_check_output (enum disir_value_type type,
+                        const char **value_string, uint8_t *value_boolean,
+                        int64_t *value_integer, double *value_float)
 {
     enum disir_status status;
-    struct disir_context *context;
 
     status = DISIR_STATUS_OK;
-    context = NULL;
-
-    if (parent == NULL || query == NULL)
-    {
-        log_debug (0, "invoked with NULL pointer(s) (parent (%p), query (%p)",
-                      parent, query);
-        return DISIR_STATUS_INVALID_ARGUMENT;
-    }
     switch (type)
     {
     case DISIR_VALUE_TYPE_ENUM:
@@ -133,13 +126,42 @@ config_get_keyval_generic (struct disir_context *parent, enum disir_value_type t
         log_debug (0, "%s invoked with NULL value pointer (string/enum (%p), boolean (%p),"
                       " integer (%p), float (%p))", dx_value_type_string (type),
                       value_string, value_boolean, value_integer, value_float);
+    }
+
+    return status;
+}
+
+//! STATIC API
+static enum disir_status
+config_get_keyval_generic (struct disir_context *parent, enum disir_value_type type,
+                           const char *query, va_list args,
+                           const char **value_string, uint8_t *value_boolean,
+                           int64_t *value_integer, double *value_float)
+{
+    enum disir_status status;
+    struct disir_context *context;
+
+    status = DISIR_STATUS_OK;
+    context = NULL;
+
+    if (parent == NULL || query == NULL)
+    {
+        log_debug (0, "invoked with NULL pointer(s) (parent (%p), query (%p)",
+                      parent, query);
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+    status = get_value_check_output (type, value_string, value_boolean,
+                                     value_integer, value_float);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
         return status;
     }
 
     status = dc_query_resolve_context_va (parent, query, &context, args);
     if (status == DISIR_STATUS_OK)
     {
-        status = get_value_generic (context, DISIR_VALUE_TYPE_STRING, value_string,
+        status = get_value_generic (context, type, value_string,
                                     value_boolean, value_integer, value_float);
         dc_putcontext (&context);
     }
@@ -147,6 +169,68 @@ config_get_keyval_generic (struct disir_context *parent, enum disir_value_type t
     return status;
 }
 
+//! STATIC API
+//! Create the keyval name of value type in section, with the given value.
+static enum disir_status
+create_keyval_generic (struct disir_context *section, const char *name,
+                       enum disir_value_type type,
+                       const char *value_string, uint8_t value_boolean, int64_t value_integer,
+                       double value_float)
+{
+    enum disir_status status;
+    struct disir_context *context;
+
+    context = NULL;
+
+    status = dc_begin (section, DISIR_CONTEXT_KEYVAL, &context);
+    if (status != DISIR_STATUS_OK)
+    {
+        goto error;
+    }
+    status = dc_set_name (context, name, strlen (name));
+    if (status != DISIR_STATUS_OK)
+    {
+        // Signal to the caller that the requested key was infact, invalid.
+        if (status == DISIR_STATUS_NOT_EXIST)
+        {
+            status = DISIR_STATUS_MOLD_MISSING;
+        }
+        goto error;
+    }
+
+    // Check that the keyval type is actually the requested type
+    if (dc_value_type (context) != type)
+    {
+        // TODO: Set error
+        status = DISIR_STATUS_WRONG_VALUE_TYPE;
+        goto error;
+    }
+
+    status = set_value_generic (context, type, value_string, value_boolean,
+                                value_integer, value_float);
+    if (status != DISIR_STATUS_OK)
+    {
+        // TODO: Set error?
+        goto error;
+    }
+
+    status = dc_finalize (&context);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Abort the creation
+        goto error;
+    }
+
+    return DISIR_STATUS_OK;
+error:
+    if (context)
+    {
+        dc_destroy (&context);
+    }
+
+    return status;
+}
+
 //! STATIC API
 static enum disir_status
 config_set_keyval_generic (struct disir_context *parent, enum disir_value_type type,
@@ -188,43 +272,10 @@ config_set_keyval_generic (struct disir_context *parent, enum disir_value_type t
         }
 
         // Create the leaf keyval
-        status = dc_begin (section, DISIR_CONTEXT_KEYVAL, &context);
-        if (status != DISIR_STATUS_OK)
-        {
-            goto error;
-        }
-        status = dc_set_name (context, keyval_name, strlen (keyval_name));
-        if (status != DISIR_STATUS_OK)
-        {
-            // Signal to the caller that the requested key was infact, invalid.
-            if (status == DISIR_STATUS_NOT_EXIST)
-            {
-                status = DISIR_STATUS_MOLD_MISSING;
-            }
-            goto error;
-        }
-
-        // Check that the keyval type is actually string
-        if (dc_value_type (context) != type)
-        {
-            // TODO: Set error
-            status = DISIR_STATUS_WRONG_VALUE_TYPE;
-            goto error;
-        }
-
-        status = set_value_generic (context, type, value_string, value_boolean,
-                                    value_integer, value_float);
-        if (status != DISIR_STATUS_OK)
-        {
-            // TODO: Set error?
-            goto error;
-        }
-
-        status = dc_finalize (&context);
+        status = create_keyval_generic (section, keyval_name, type, value_string, value_boolean,
+                                        value_integer, value_float);
         if (status != DISIR_STATUS_OK)
         {
-            // Abort the creation
-            dc_destroy (&context);
             goto error;
         }
     }
@@ -391,3 +442,440 @@ dc_config_set_keyval_string (struct disir_context *parent, const char *value,
     return status;
 }
 
+
+//! STATIC API
+static enum disir_status
+query_get_value_generic (struct disir_context *parent, struct disir_query *query,
+                         enum disir_value_type type,
+                         const char **value_string, uint8_t *value_boolean,
+                         int64_t *value_integer, double *value_float)
+{
+    enum disir_status status;
+    struct disir_context *context;
+
+    TRACE_ENTER ("parent (%p), query (%p), type (%s)", parent, query,
+                 dx_value_type_string (type));
+
+    context = NULL;
+
+    status = get_value_check_output (type, value_string, value_boolean,
+                                     value_integer, value_float);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
+        return status;
+    }
+
+    status = dc_query_resolve (parent, query, &context);
+    if (status == DISIR_STATUS_OK)
+    {
+        status = get_value_generic (context, type, value_string,
+                                    value_boolean, value_integer, value_float);
+        dc_putcontext (&context);
+    }
+
+    TRACE_EXIT ("%s", disir_status_string (status));
+    return status;
+}
+
+//! STATIC API
+static enum disir_status
+query_set_value_generic (struct disir_context *parent, struct disir_query *query,
+                         enum disir_value_type type,
+                         const char *value_string, uint8_t value_boolean, int64_t value_integer,
+                         double value_float)
+{
+    enum disir_status status;
+    struct disir_context *context;
+    struct disir_context *section;
+    const char *name;
+
+    TRACE_ENTER ("parent (%p), query (%p), type (%s)", parent, query,
+                 dx_value_type_string (type));
+
+    context = NULL;
+    section = NULL;
+
+    if ((type == DISIR_VALUE_TYPE_STRING || type == DISIR_VALUE_TYPE_ENUM)
+        && value_string == NULL)
+    {
+        log_debug (0, "invoked with value_string NULL pointer.");
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    status = dc_query_resolve (parent, query, &context);
+    if (status == DISIR_STATUS_OK)
+    {
+        status = set_value_generic (context, type, value_string, value_boolean,
+                                    value_integer, value_float);
+        dc_putcontext (&context);
+    }
+    else if (status == DISIR_STATUS_NOT_EXIST)
+    {
+        // Lets find the context of the section that should contain the leaf keyval
+        status = dx_query_resolve_parent_compiled (parent, query, &section);
+        if (status == DISIR_STATUS_OK)
+        {
+            name = query->qu_segments[query->qu_size - 1].qs_name;
+            status = create_keyval_generic (section, name, type, value_string, value_boolean,
+                                            value_integer, value_float);
+            dc_putcontext (&section);
+        }
+    }
+
+    TRACE_EXIT ("%s", disir_status_string (status));
+    return status;
+}
+
+//! PUBLIC API: low-level
+enum disir_status
+dc_query_get_string (struct disir_context *parent, struct disir_query *query,
+                     const char **value)
+{
+    return query_get_value_generic (parent, query, DISIR_VALUE_TYPE_STRING,
+                                    value, NULL, NULL, NULL);
+}
+
+//! PUBLIC API: low-level
+enum disir_status
+dc_query_get_enum (struct disir_context *parent, struct disir_query *query,
+                   const char **value)
+{
+    return query_get_value_generic (parent, query, DISIR_VALUE_TYPE_ENUM,
+                                    value, NULL, NULL, NULL);
+}
+
+//! PUBLIC API: low-level
+enum disir_status
+dc_query_get_integer (struct disir_context *parent, struct disir_query *query,
+                      int64_t *value)
+{
+    return query_get_value_generic (parent, query, DISIR_VALUE_TYPE_INTEGER,
+                                    NULL, NULL, value, NULL);
+}
+
+//! PUBLIC API: low-level
+enum disir_status
+dc_query_get_float (struct disir_context *parent, struct disir_query *query,
+                    double *value)
+{
+    return query_get_value_generic (parent, query, DISIR_VALUE_TYPE_FLOAT,
+                                    NULL, NULL, NULL, value);
+}
+
+//! PUBLIC API: low-level
+enum disir_status
+dc_query_get_boolean (struct disir_context *parent, struct disir_query *query,
+                      uint8_t *value)
+{
+    return query_get_value_generic (parent, query, DISIR_VALUE_TYPE_BOOLEAN,
+                                    NULL, value, NULL, NULL);
+}
+
+//! PUBLIC API: low-level
+enum disir_status
+dc_query_set_string (struct disir_context *parent, struct disir_query *query,
+                     const char *value)
+{
+    return query_set_value_generic (parent, query, DISIR_VALUE_TYPE_STRING,
+                                    value, 0, 0, 0);
+}
+
+//! PUBLIC API: low-level
+enum disir_status
+dc_query_set_enum (struct disir_context *parent, struct disir_query *query,
+                   const char *value)
+{
+    return query_set_value_generic (parent, query, DISIR_VALUE_TYPE_ENUM,
+                                    value, 0, 0, 0);
+}
+
+//! PUBLIC API: low-level
+enum disir_status
+dc_query_set_integer (struct disir_context *parent, struct disir_query *query,
+                      int64_t value)
+{
+    return query_set_value_generic (parent, query, DISIR_VALUE_TYPE_INTEGER,
+                                    NULL, 0, value, 0);
+}
+
+//! PUBLIC API: low-level
+enum disir_status
+dc_query_set_float (struct disir_context *parent, struct disir_query *query,
+                    double value)
+{
+    return query_set_value_generic (parent, query, DISIR_VALUE_TYPE_FLOAT,
+                                    NULL, 0, 0, value);
+}
+
+//! PUBLIC API: low-level
+enum disir_status
+dc_query_set_boolean (struct disir_context *parent, struct disir_query *query,
+                      uint8_t value)
+{
+    return query_set_value_generic (parent, query, DISIR_VALUE_TYPE_BOOLEAN,
+                                    NULL, value, 0, 0);
+}
+
+//! STATIC API
+//! Order items by the segments of their query, such that items sharing sections are adjacent.
+//! Items with equal queries keep their order in the items array.
+static int
+batch_item_compare (const void *lhs, const void *rhs)
+{
+    struct disir_query_item *a = *(struct disir_query_item * const *) lhs;
+    struct disir_query_item *b = *(struct disir_query_item * const *) rhs;
+    struct disir_query_segment *sa;
+    struct disir_query_segment *sb;
+    int32_t i;
+    int res;
+
+    for (i = 0; i < a->qi_query->qu_size && i < b->qi_query->qu_size; i++)
+    {
+        sa = &a->qi_query->qu_segments[i];
+        sb = &b->qi_query->qu_segments[i];
+
+        res = strcmp (sa->qs_name, sb->qs_name);
+        if (res != 0)
+            return res;
+        if (sa->qs_index != sb->qs_index)
+            return (sa->qs_index < sb->qs_index ? -1 : 1);
+    }
+
+    if (a->qi_query->qu_size != b->qi_query->qu_size)
+        return (a->qi_query->qu_size < b->qi_query->qu_size ? -1 : 1);
+
+    return (a < b ? -1 : (a > b));
+}
+
+//! STATIC API
+//! Get or set the leaf keyval of item in section.
+static enum disir_status
+batch_item_apply (struct disir_context *section, struct disir_query_item *item, int set)
+{
+    enum disir_status status;
+    struct disir_context *context;
+    struct disir_query_segment *leaf;
+    const char *value_string;
+    uint8_t value_boolean;
+    int64_t value_integer;
+    double value_float;
+
+    context = NULL;
+    value_string = NULL;
+    value_boolean = 0;
+    value_integer = 0;
+    value_float = 0;
+    leaf = &item->qi_query->qu_segments[item->qi_query->qu_size - 1];
+
+    if (set)
+    {
+        switch (item->qi_type)
+        {
+        case DISIR_VALUE_TYPE_ENUM:
+            // FALL-THROUGH
+        case DISIR_VALUE_TYPE_STRING:
+            value_string = *(const char **) item->qi_value;
+            if (value_string == NULL)
+                return DISIR_STATUS_INVALID_ARGUMENT;
+            break;
+        case DISIR_VALUE_TYPE_BOOLEAN:
+            value_boolean = *(uint8_t *) item->qi_value;
+            break;
+        case DISIR_VALUE_TYPE_INTEGER:
+            value_integer = *(int64_t *) item->qi_value;
+            break;
+        case DISIR_VALUE_TYPE_FLOAT:
+            value_float = *(double *) item->qi_value;
+            break;
+        case DISIR_VALUE_TYPE_UNKNOWN:
+            return DISIR_STATUS_INVALID_ARGUMENT;
+        }
+    }
+
+    status = dc_find_element (section, leaf->qs_name, leaf->qs_index, &context);
+    if (status == DISIR_STATUS_OK)
+    {
+        if (set)
+        {
+            status = set_value_generic (context, item->qi_type, value_string, value_boolean,
+                                        value_integer, value_float);
+        }
+        else
+        {
+            status = get_value_generic (context, item->qi_type,
+                                        (const char **) item->qi_value,
+                                        (uint8_t *) item->qi_value,
+                                        (int64_t *) item->qi_value,
+                                        (double *) item->qi_value);
+        }
+        dc_putcontext (&context);
+    }
+    else if (status == DISIR_STATUS_NOT_EXIST && set)
+    {
+        status = dx_query_leaf_available (section, leaf);
+        if (status == DISIR_STATUS_OK)
+        {
+            status = create_keyval_generic (section, leaf->qs_name, item->qi_type,
+                                            value_string, value_boolean,
+                                            value_integer, value_float);
+        }
+    }
+
+    return status;
+}
+
+//! STATIC API
+static enum disir_status
+query_batch_generic (struct disir_context *parent, struct disir_query_item *items,
+                     int32_t count, int set)
+{
+    enum disir_status status;
+    struct disir_query_item **sorted;
+    struct disir_context **sections;
+    struct disir_query *path;
+    struct disir_query *query;
+    struct disir_query_segment *segment;
+    int32_t numsorted;
+    int32_t depth;
+    int32_t shared;
+    int32_t max_size;
+    int32_t i;
+
+    TRACE_ENTER ("parent (%p), items (%p), count (%d), set (%d)", parent, items, count, set);
+
+    status = CONTEXT_NULL_INVALID_TYPE_CHECK (parent);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
+        return status;
+    }
+    status = CONTEXT_TYPE_CHECK (parent, DISIR_CONTEXT_MOLD,
+                                         DISIR_CONTEXT_CONFIG,
+                                         DISIR_CONTEXT_SECTION);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
+        return status;
+    }
+    if (items == NULL || count < 0)
+    {
+        log_debug (0, "invoked with invalid items (%p) or count (%d)", items, count);
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    sorted = NULL;
+    sections = NULL;
+    numsorted = 0;
+    max_size = 0;
+
+    sorted = calloc (count + 1, sizeof (struct disir_query_item *));
+    if (sorted == NULL)
+    {
+        status = DISIR_STATUS_NO_MEMORY;
+        goto error;
+    }
+    for (i = 0; i < count; i++)
+    {
+        if (items[i].qi_query == NULL || items[i].qi_value == NULL)
+        {
+            items[i].qi_status = DISIR_STATUS_INVALID_ARGUMENT;
+            continue;
+        }
+
+        sorted[numsorted++] = &items[i];
+        if (items[i].qi_query->qu_size > max_size)
+            max_size = items[i].qi_query->qu_size;
+    }
+
+    // Contexts of the sections of path resolved so far.
+    sections = calloc (max_size + 1, sizeof (struct disir_context *));
+    if (sections == NULL)
+    {
+        status = DISIR_STATUS_NO_MEMORY;
+        goto error;
+    }
+
+    qsort (sorted, numsorted, sizeof (struct disir_query_item *), batch_item_compare);
+
+    depth = 0;
+    path = NULL;
+    for (i = 0; i < numsorted; i++)
+    {
+        query = sorted[i]->qi_query;
+
+        // Keep the sections shared with the previous query
+        shared = 0;
+        while (shared < depth && shared < query->qu_size - 1
+               && path->qu_segments[shared].qs_index == query->qu_segments[shared].qs_index
+               && strcmp (path->qu_segments[shared].qs_name,
+                          query->qu_segments[shared].qs_name) == 0)
+        {
+            shared++;
+        }
+        while (depth > shared)
+        {
+            dc_putcontext (&sections[--depth]);
+        }
+        path = query;
+
+        // Resolve the remaining sections of this query
+        status = DISIR_STATUS_OK;
+        while (depth < query->qu_size - 1)
+        {
+            segment = &query->qu_segments[depth];
+            status = dc_find_element ((depth ? sections[depth - 1] : parent),
+                                      segment->qs_name, segment->qs_index, &sections[depth]);
+            if (status != DISIR_STATUS_OK)
+            {
+                dx_log_context (parent, "Unable to locate entry '%s@%d' of query '%s'",
+                                        segment->qs_name, segment->qs_index, query->qu_query);
+                break;
+            }
+            depth++;
+        }
+
+        if (status == DISIR_STATUS_OK)
+        {
+            status = batch_item_apply ((depth ? sections[depth - 1] : parent), sorted[i], set);
+        }
+        sorted[i]->qi_status = status;
+    }
+
+    while (depth > 0)
+    {
+        dc_putcontext (&sections[--depth]);
+    }
+
+    // Report the first failure in the order of the caller.
+    status = DISIR_STATUS_OK;
+    for (i = 0; i < count; i++)
+    {
+        if (items[i].qi_status != DISIR_STATUS_OK)
+        {
+            status = items[i].qi_status;
+            break;
+        }
+    }
+    // FALL-THROUGH
+error:
+    free (sorted);
+    free (sections);
+
+    TRACE_EXIT ("%s", disir_status_string (status));
+    return status;
+}
+
+//! PUBLIC API: low-level
+enum disir_status
+dc_query_get_batch (struct disir_context *parent, struct disir_query_item *items, int32_t count)
+{
+    return query_batch_generic (parent, items, count, 0);
+}
+
+//! PUBLIC API: low-level
+enum disir_status
+dc_query_set_batch (struct disir_context *parent, struct disir_query_item *items, int32_t count)
+{
+    return query_batch_generic (parent, items, count, 1);
+}
@@ -17,24 +17,23 @@ extern "C" {
 
 // cpp
 #include <map>
+#include <sstream>
 #include <fstream>
 #include <iostream>
 
 
 // STATIC FUNCTION
 static enum disir_status
-copy_metadata (struct disir_archive *archive, std::map<std::string, std::string>& extract_content)
+copy_metadata (struct disir_archive *archive, std::map<std::string, std::string>& archive_content)
 {
-    auto it = extract_content.find (METADATA_FILENAME);
-    if (it == extract_content.end())
+    auto it = archive_content.find (METADATA_FILENAME);
+    if (it == archive_content.end())
     {
         log_error ("no metadata.toml in disir archive");
         return DISIR_STATUS_NOT_EXIST;
     }
 
-    std::string toml_filepath = it->second;
-
-    std::ifstream metadata (toml_filepath.c_str());
+    std::istringstream metadata (it->second);
     toml::ParseResult pr = toml::parse (metadata);
 
     if (!pr.valid())
@@ -51,16 +50,14 @@ copy_metadata (struct disir_archive *archive, std::map<std::string, std::string>
     {
         auto id = entry.find (ATTRIBUTE_KEY_ID);
 
-        auto iter = extract_content.find (id->as<std::string>() + "/entries.toml");
-        if (iter == extract_content.end())
+        auto iter = archive_content.find (id->as<std::string>() + "/entries.toml");
+        if (iter == archive_content.end())
         {
             log_error ("cannot find entries.toml for backend '%s' in map", id->as<std::string>());
             return DISIR_STATUS_NOT_EXIST;
         }
 
-        auto entries_toml_filepath = iter->second;
-
-        std::ifstream entries_toml (entries_toml_filepath.c_str());
+        std::istringstream entries_toml (iter->second);
         toml::ParseResult pr = toml::parse (entries_toml);
 
         if (!pr.valid())
@@ -175,21 +172,11 @@ populate_archive_entry (struct archive *archive, struct archive_entry *entry,
 
 //! STATIC FUNCTION
 static enum disir_status
-append_config (struct disir_instance *instance, struct archive *archive,
-               const char *filepath, const char *archive_entry_name)
+append_config_data (struct archive *archive, const char *data, size_t size,
+                    const char *archive_entry_name)
 {
     enum disir_status status;
     struct archive_entry *entry = NULL;
-    struct stat st;
-    FILE *infile = NULL;
-    char buf[8192];
-    int read;
-
-    status = fslib_stat_filepath (instance, filepath, &st);
-    if (status != DISIR_STATUS_OK)
-    {
-        return status;
-    }
 
     entry = archive_entry_new();
     if (entry == NULL)
@@ -199,44 +186,58 @@ append_config (struct disir_instance *instance, struct archive *archive,
         return DISIR_STATUS_NO_MEMORY;
     }
 
-    status = populate_archive_entry (archive, entry, archive_entry_name, st.st_size);
+    status = populate_archive_entry (archive, entry, archive_entry_name, size);
     if (status != DISIR_STATUS_OK)
         goto out;
 
-    infile = fopen (filepath, "r");
-    if (infile == NULL)
+    if (size > 0 && archive_write_data (archive, data, size) < 0)
     {
-        log_error ("unable to open %s (%s)", filepath, strerror (errno));
+        log_error ("error writing to archive %s", archive_error_string (archive));
         status = DISIR_STATUS_FS_ERROR;
         goto out;
     }
 
-    do
-    {
-        read = fread (buf, 1, sizeof (buf), infile);
-        if (read == 0)
-            break;
-
-        if (archive_write_data (archive, buf, read) < 0)
-        {
-            log_error ("error writing to archive %s", archive_errno (archive));
-            status = DISIR_STATUS_FS_ERROR;
-            goto out;
-        }
-    } while (1);
-
     if (archive_write_finish_entry (archive) != ARCHIVE_OK)
     {
-        log_error ("could not finish archive write entry %s", archive_errno (archive));
+        log_error ("could not finish archive write entry %s", archive_error_string (archive));
         status = DISIR_STATUS_FS_ERROR;
         goto out;
     }
     // FALL-THROUGH
 out:
-    if (entry)
-        archive_entry_free (entry);
-    if (infile)
-        fclose (infile);
+    archive_entry_free (entry);
+
+    return status;
+}
+
+//! STATIC FUNCTION
+//! Serialize config with the plugin into a heap-allocated buffer.
+//! Caller must free data, regardless of the status returned.
+static enum disir_status
+serialize_config_data (struct disir_instance *instance, struct disir_register_plugin *plugin,
+                       struct disir_config *config, char **data, size_t *size)
+{
+    enum disir_status status;
+    FILE *stream;
+
+    *data = NULL;
+    *size = 0;
+
+    stream = open_memstream (data, size);
+    if (stream == NULL)
+    {
+        log_error ("unable to open memory stream for config: %s", strerror (errno));
+        return DISIR_STATUS_NO_MEMORY;
+    }
+
+    status = plugin->dp_config_fd_write (instance, config, stream);
+
+    // Closing the stream finalizes data and size
+    if (fclose (stream) != 0 && status == DISIR_STATUS_OK)
+    {
+        log_error ("unable to serialize config to memory: %s", strerror (errno));
+        status = DISIR_STATUS_NO_MEMORY;
+    }
 
     return status;
 }
@@ -252,16 +253,13 @@ dx_archive_config_entries_write (struct disir_instance *instance, struct disir_a
     struct disir_config *config = NULL;
     struct disir_entry *current = NULL;
     struct disir_archive_entry archive_entry;
-    FILE *entry_file = NULL;
-    char filepath[PATH_MAX];
     char archive_entry_name[PATH_MAX];
-    char *tmp_dir_name = NULL;
-    int ret;
+    char *data = NULL;
+    size_t size;
 
     // setting it now such that
     // it can be deallocated on label out
     current = config_entry;
-    filepath[0] = '\0';
 
     if (plugin->dp_config_fd_write == NULL)
     {
@@ -270,33 +268,16 @@ dx_archive_config_entries_write (struct disir_instance *instance, struct disir_a
         goto out;
     }
 
-    tmp_dir_name = dx_archive_create_temp_folder();
-    if (tmp_dir_name == NULL)
-    {
-        log_error ("unable to create temp folder for config files");
-        status = DISIR_STATUS_FS_ERROR;
-        goto out;
-    }
-
     do
     {
         config_entry = current->next;
 
-        snprintf(filepath, PATH_MAX, "%s/%s", tmp_dir_name, "temp_entry");
-
-        entry_file = fopen (filepath, "w");
-        if (entry_file == NULL)
-        {
-            log_error ("unable to open temp config file: %s", filepath);
-            status = DISIR_STATUS_FS_ERROR;
-            goto out;
-        }
-
         status = disir_config_read (instance, group_id, current->de_entry_name, NULL, &config);
         if (status != DISIR_STATUS_OK)
             goto out;
 
-        status = plugin->dp_config_fd_write (instance, config, entry_file);
+        // Serialized straight into memory, and from there into the archive stream
+        status = serialize_config_data (instance, plugin, config, &data, &size);
         if (status != DISIR_STATUS_OK)
             goto out;
 
@@ -308,7 +289,7 @@ dx_archive_config_entries_write (struct disir_instance *instance, struct disir_a
         snprintf (archive_entry_name, PATH_MAX, "%s/%s/%s",
                   plugin->dp_name, group_id, current->de_entry_name);
 
-        status = append_config (instance, archive->da_archive, filepath, archive_entry_name);
+        status = append_config_data (archive->da_archive, data, size, archive_entry_name);
         if (status != DISIR_STATUS_OK)
             goto out;
 
@@ -316,32 +297,23 @@ dx_archive_config_entries_write (struct disir_instance *instance, struct disir_a
         archive_entry.de_group_id = group_id;
         archive_entry.de_entry_id = current->de_entry_name;
         archive_entry.de_filepath = "";
+        archive_entry.de_content = NULL;
         archive->da_config_entries->insert (archive_entry);
 
+        free (data);
+        data = NULL;
         disir_entry_finished (&current);
         disir_config_finished (&config);
 
         current = config_entry;
-
-        // Clean-up
-        ret = remove (filepath);
-        if (ret != 0)
-        {
-            log_debug (5, "unable to remove temp config file");
-            status = DISIR_STATUS_FS_ERROR;
-            goto out;
-        }
     }
     while (current != NULL);
     // FALL-THROUGH
 out:
-    if (entry_file)
-        fclose (entry_file);
-
-    if (filepath[0] != '\0')
-    {
-        remove (filepath);
-    }
+    if (data)
+        free (data);
+    if (config)
+        disir_config_finished (&config);
 
     if (current)
     {
@@ -354,17 +326,6 @@ out:
         while (current != NULL);
     }
 
-    if (tmp_dir_name)
-    {
-        ret = rmdir (tmp_dir_name);
-        if (ret != 0)
-        {
-            log_debug (5, "unable to remove temp folder");
-            status = DISIR_STATUS_FS_ERROR;
-        }
-        free (tmp_dir_name);
-    }
-
     return status;
 }
 
@@ -440,6 +401,17 @@ dx_archive_metadata_write (struct disir_archive *archive)
     enum disir_status status;
     struct archive_entry *entry = NULL;
     char archive_entry_name[PATH_MAX];
+    int64_t metadata_offset;
+
+    // The metadata is compressed as a stream of its own. Appending to the archive
+    // replaces this stream, keeping the streams before it as they are.
+    status = dx_archive_stream_split (archive, &metadata_offset);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
+        return status;
+    }
+    archive->da_metadata->setChild (ATTRIBUTE_KEY_METADATA_OFFSET, metadata_offset);
 
     // Create metadata.toml
     status = write_archive_metadata_toml (archive);
@@ -500,13 +472,19 @@ error:
 //! INTERNAL API
 enum disir_status
 dx_archive_begin_existing (struct disir_instance *instance, const char *archive_path,
+                           const struct disir_archive_options *options,
                            struct disir_archive **archive)
 {
     enum disir_status status;
-    std::map<std::string, std::string> extract_content;
+    std::map<std::string, std::string> archive_content;
+    std::set<struct disir_archive_entry, cmp_entry> existing_entries;
     struct disir_archive *write_archive = NULL;
-    char *tmp_dir_name = NULL;
+    struct disir_archive_options write_options = {};
+    enum disir_archive_compression compression;
+    const toml::Value *metadata_offset;
     const char *ext = NULL;
+    struct stat st;
+    bool append;
 
     // Make sure archive path is not a directory
     if (archive_path[strlen(archive_path)-1] == '/')
@@ -531,50 +509,81 @@ dx_archive_begin_existing (struct disir_instance *instance, const char *archive_
         return status;
     }
 
-    status = dx_archive_begin_new (&write_archive);
+    // Read the existing archive into memory, nothing is extracted to disk
+    status = dx_archive_read (archive_path, archive_content, &compression);
     if (status != DISIR_STATUS_OK)
-        goto out;
-
-    // Create temporary extract folder
-    tmp_dir_name = dx_archive_create_temp_folder();
-    if (tmp_dir_name == NULL)
     {
-        status = DISIR_STATUS_FS_ERROR;
-        goto out;
+        disir_error_set (instance, "invalid archive");
+        return status;
     }
 
-    // Store temp path for clean up later
-    write_archive->da_extract_folder_path = tmp_dir_name;
+    // The existing compression is kept unless options select another
+    if (options)
+    {
+        write_options = *options;
+    }
+    else
+    {
+        write_options.ao_compression = compression;
+    }
 
-    status = dx_archive_extract (archive_path, extract_content, tmp_dir_name);
+    status = dx_archive_begin_new (&write_options, &write_archive);
     if (status != DISIR_STATUS_OK)
         goto out;
 
-    status = dx_archive_validate (write_archive, extract_content);
+    status = dx_archive_validate (write_archive, archive_content, true);
     if (status != DISIR_STATUS_OK)
     {
         disir_error_set (instance, "invalid archive");
         goto out;
     }
 
-    status = copy_metadata (write_archive, extract_content);
+    // Only the identity of existing entries is needed from here on;
+    // do not keep references to the archive content.
+    for (const auto& entry : *write_archive->da_config_entries)
+    {
+        struct disir_archive_entry existing = entry;
+        existing.de_content = NULL;
+        existing_entries.insert (existing);
+    }
+    write_archive->da_config_entries->swap (existing_entries);
+
+    status = copy_metadata (write_archive, archive_content);
     if (status != DISIR_STATUS_OK)
         goto out;
 
-    // Copy content
-    for (const auto& entry : extract_content)
+    // An archive in the same codec keeps the compressed streams before its metadata
+    // verbatim. Only new configs and the metadata are compressed on finalize.
+    append = false;
+    metadata_offset = write_archive->da_metadata->find (ATTRIBUTE_KEY_METADATA_OFFSET);
+    if (write_options.ao_compression == compression && metadata_offset
+        && metadata_offset->is<int64_t>() && metadata_offset->as<int64_t>() > 0
+        && stat (archive_path, &st) == 0 && metadata_offset->as<int64_t>() < st.st_size)
     {
-        // Ignore metadata files, they will be re-written in finalize.
-        if (entry.first.find ("entries.toml") != std::string::npos)
-            continue;
-
-        if (entry.first.find ("metadata.toml") != std::string::npos)
-            continue;
-
-        status = append_config (instance, write_archive->da_archive, entry.second.c_str(),
-                                                                     entry.first.c_str());
+        status = dx_archive_keep_prefix (write_archive, archive_path,
+                                         metadata_offset->as<int64_t>());
         if (status != DISIR_STATUS_OK)
             goto out;
+        append = true;
+    }
+
+    // Otherwise, the existing content is re-compressed into the new archive
+    if (append == false)
+    {
+        for (const auto& entry : archive_content)
+        {
+            // Ignore metadata files, they will be re-written in finalize.
+            if (entry.first.find ("entries.toml") != std::string::npos)
+                continue;
+
+            if (entry.first.find ("metadata.toml") != std::string::npos)
+                continue;
+
+            status = append_config_data (write_archive->da_archive, entry.second.data (),
+                                         entry.second.size (), entry.first.c_str());
+            if (status != DISIR_STATUS_OK)
+                goto out;
+        }
     }
 
     write_archive->da_existing_path = strdup (archive_path);
@@ -595,7 +604,8 @@ out:
 
 //! INTERNAL API
 enum disir_status
-dx_archive_begin_new (struct disir_archive **archive)
+dx_archive_begin_new (const struct disir_archive_options *options,
+                      struct disir_archive **archive)
 {
     enum disir_status status;
     struct disir_archive *ar;
@@ -611,6 +621,11 @@ dx_archive_begin_new (struct disir_archive **archive)
         return status;
     }
 
+    if (options)
+    {
+        ar->da_options = *options;
+    }
+
     status = dx_archive_open_write (ar);
     if (status != DISIR_STATUS_OK)
         goto error;
@@ -16,7 +16,9 @@
 
 // external libs
 #include <stdlib.h>
+#include <stdint.h>
 #include <limits.h>
+#include <errno.h>
 
 //! STATIC FUNCTION
 static void
@@ -192,8 +194,10 @@ out:
 }
 
 //! STATIC FUNCTION
+//! Read the serialized config either from memory (data, size) or from filepath.
 static enum disir_status
-read_config_imported (struct disir_instance *instance, const char *filepath, const char *group_id,
+read_config_imported (struct disir_instance *instance, const char *filepath,
+                      const char *data, size_t size, const char *group_id,
                       struct disir_mold *mold, struct disir_config **config)
 {
     enum disir_status status;
@@ -206,24 +210,39 @@ read_config_imported (struct disir_instance *instance, const char *filepath, con
         return DISIR_STATUS_NO_CAN_DO;
     }
 
-    file = fopen (filepath, "r");
-    if (file == NULL)
+    if (data && plugin->dp_config_span_read != NULL)
     {
-        log_debug (10, "unable to read imported config on filepath '%s'", filepath);
-        return DISIR_STATUS_FS_ERROR;
+        return plugin->dp_config_span_read (instance, data, size, mold, config);
     }
 
-    if (plugin->dp_config_fd_read != NULL)
+    if (plugin->dp_config_fd_read == NULL)
     {
-        status = plugin->dp_config_fd_read (instance, file, mold, config);
+        return DISIR_STATUS_NO_CAN_DO;
+    }
+
+    if (data)
+    {
+        // The plugin only reads from FILE; present the serialized config as one.
+        file = fmemopen ((void *)(uintptr_t)data, size, "r");
+        if (file == NULL)
+        {
+            log_debug (10, "unable to open imported config in memory: %s", strerror (errno));
+            return DISIR_STATUS_FS_ERROR;
+        }
     }
     else
     {
-        status = DISIR_STATUS_NO_CAN_DO;
+        file = fopen (filepath, "r");
+        if (file == NULL)
+        {
+            log_debug (10, "unable to read imported config on filepath '%s'", filepath);
+            return DISIR_STATUS_FS_ERROR;
+        }
     }
 
-    if (file)
-        fclose (file);
+    status = plugin->dp_config_fd_read (instance, file, mold, config);
+
+    fclose (file);
 
     return status;
 }
@@ -231,11 +250,12 @@ read_config_imported (struct disir_instance *instance, const char *filepath, con
 // INTERNAL API
 enum disir_status
 dx_resolve_config_import_status (struct disir_instance *instance, const char *config_path,
+                                 const char *config_data, size_t config_size,
                                  struct disir_import_entry *import)
 {
     enum disir_status status;
     struct disir_mold *mold = NULL;
-    struct disir_config *config_imported;
+    struct disir_config *config_imported = NULL;
     char buf[500];
 
     status = verify_mold_support (instance, import, &mold);
@@ -245,8 +265,8 @@ dx_resolve_config_import_status (struct disir_instance *instance, const char *co
         return DISIR_STATUS_NO_CAN_DO;
     }
 
-    status = read_config_imported (instance, config_path, import->ie_group_id,
-                                   mold, &config_imported);
+    status = read_config_imported (instance, config_path, config_data, config_size,
+                                   import->ie_group_id, mold, &config_imported);
 
     import->ie_config = config_imported;
 
@@ -509,6 +529,8 @@ disir_import_finalize (struct disir_instance *instance, enum disir_import_option
                        struct disir_import **import, struct import_report **report)
 {
     enum disir_status status;
+    enum disir_status committed = DISIR_STATUS_OK;
+    int transaction = 0;
     int i;
     unsigned int failed = 0;
     unsigned int total = 0;
@@ -535,7 +557,9 @@ disir_import_finalize (struct disir_instance *instance, enum disir_import_option
     {
     case DISIR_IMPORT_DISCARD:
     {
-        return dx_import_destroy (*import);
+        status = dx_import_destroy (*import);
+        *import = NULL;
+        return status;
     }
     case DISIR_IMPORT_DO:
     {
@@ -558,6 +582,10 @@ disir_import_finalize (struct disir_instance *instance, enum disir_import_option
             rep->ir_internal = (*import)->di_num_entries;
         }
 
+        // Flush the directories written to once, after all entries are written.
+        // Leave an active transaction opened by the caller alone.
+        transaction = (disir_write_begin (instance) == DISIR_STATUS_OK);
+
         for (i = 0; i < (*import)->di_num_entries; i++)
         {
            buf[0] = '\n';
@@ -611,6 +639,11 @@ disir_import_finalize (struct disir_instance *instance, enum disir_import_option
                 }
            }
         }
+
+        if (transaction)
+        {
+            committed = disir_write_commit (instance);
+        }
         break;
     }
     default:
@@ -628,6 +661,9 @@ disir_import_finalize (struct disir_instance *instance, enum disir_import_option
         goto error;
     }
 
+    // Imported entries may not have reached disk.
+    status = committed;
+
     *import = NULL;
 
     if (report)
@@ -330,8 +330,7 @@ disir_mold_finished (struct disir_mold **mold)
 
     TRACE_ENTER ("mold: %p", *mold);
 
-    (*mold)->mo_reference_count--;
-    if ((*mold)->mo_reference_count == 0)
+    if (__atomic_sub_fetch (&(*mold)->mo_reference_count, 1, __ATOMIC_ACQ_REL) == 0)
     {
         log_debug (6, "Mold reached reference count 0 - destroying context.");
         context = (*mold)->mo_context;
@@ -0,0 +1,183 @@
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <disir/disir.h>
+
+#include "disir_private.h"
+#include "log.h"
+
+
+//! Number of directories allocated the first time a transaction records one.
+#define WRITE_TRANSACTION_INIT_CAPACITY 8
+
+//! STATIC API
+//! fsync the directory at dirpath, such that renames into it are durable.
+static enum disir_status
+write_fsync_directory (struct disir_instance *instance, const char *dirpath)
+{
+    int fd;
+    int res;
+
+    fd = open (dirpath, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        disir_error_set (instance, "opening directory %s: %s", dirpath, strerror (errno));
+        return DISIR_STATUS_FS_ERROR;
+    }
+
+    res = fsync (fd);
+    if (res != 0)
+    {
+        disir_error_set (instance, "flushing directory %s: %s", dirpath, strerror (errno));
+    }
+    close (fd);
+
+    return (res == 0 ? DISIR_STATUS_OK : DISIR_STATUS_FS_ERROR);
+}
+
+//! STATIC API
+//! Record dirpath in transaction, unless already recorded.
+static enum disir_status
+write_transaction_add (struct disir_write_transaction *transaction, const char *dirpath)
+{
+    char **directories;
+    int32_t capacity;
+    int32_t i;
+
+    for (i = 0; i < transaction->wt_size; i++)
+    {
+        if (strcmp (transaction->wt_directories[i], dirpath) == 0)
+            return DISIR_STATUS_OK;
+    }
+
+    if (transaction->wt_size == transaction->wt_capacity)
+    {
+        capacity = (transaction->wt_capacity ? 2 * transaction->wt_capacity
+                                             : WRITE_TRANSACTION_INIT_CAPACITY);
+        directories = realloc (transaction->wt_directories, capacity * sizeof (char *));
+        if (directories == NULL)
+            return DISIR_STATUS_NO_MEMORY;
+
+        transaction->wt_directories = directories;
+        transaction->wt_capacity = capacity;
+    }
+
+    transaction->wt_directories[transaction->wt_size] = strdup (dirpath);
+    if (transaction->wt_directories[transaction->wt_size] == NULL)
+        return DISIR_STATUS_NO_MEMORY;
+
+    transaction->wt_size++;
+    return DISIR_STATUS_OK;
+}
+
+//! INTERNAL API
+enum disir_status
+dx_write_sync_directory (struct disir_instance *instance, const char *dirpath)
+{
+    enum disir_status status;
+
+    pthread_mutex_lock (&instance->dio_write_mutex);
+    if (instance->dio_write_transaction)
+    {
+        status = write_transaction_add (instance->dio_write_transaction, dirpath);
+        pthread_mutex_unlock (&instance->dio_write_mutex);
+
+        if (status != DISIR_STATUS_OK)
+        {
+            disir_error_set (instance, "cannot record directory %s in write transaction",
+                             dirpath);
+        }
+        return status;
+    }
+    pthread_mutex_unlock (&instance->dio_write_mutex);
+
+    return write_fsync_directory (instance, dirpath);
+}
+
+//! INTERNAL API
+enum disir_status
+dx_write_transaction_finish (struct disir_instance *instance,
+                             struct disir_write_transaction **transaction)
+{
+    enum disir_status status;
+    enum disir_status synced;
+    int32_t i;
+
+    status = DISIR_STATUS_OK;
+    for (i = 0; i < (*transaction)->wt_size; i++)
+    {
+        synced = write_fsync_directory (instance, (*transaction)->wt_directories[i]);
+        if (status == DISIR_STATUS_OK)
+        {
+            status = synced;
+        }
+        free ((*transaction)->wt_directories[i]);
+    }
+
+    free ((*transaction)->wt_directories);
+    free (*transaction);
+    *transaction = NULL;
+
+    return status;
+}
+
+//! PUBLIC API
+enum disir_status
+disir_write_begin (struct disir_instance *instance)
+{
+    enum disir_status status;
+
+    if (instance == NULL)
+    {
+        log_debug (0, "invoked with instance NULL pointer.");
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    status = DISIR_STATUS_OK;
+
+    pthread_mutex_lock (&instance->dio_write_mutex);
+    if (instance->dio_write_transaction)
+    {
+        status = DISIR_STATUS_EXISTS;
+    }
+    else
+    {
+        instance->dio_write_transaction = calloc (1, sizeof (struct disir_write_transaction));
+        if (instance->dio_write_transaction == NULL)
+        {
+            status = DISIR_STATUS_NO_MEMORY;
+        }
+    }
+    pthread_mutex_unlock (&instance->dio_write_mutex);
+
+    return status;
+}
+
+//! PUBLIC API
+enum disir_status
+disir_write_commit (struct disir_instance *instance)
+{
+    struct disir_write_transaction *transaction;
+
+    if (instance == NULL)
+    {
+        log_debug (0, "invoked with instance NULL pointer.");
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    pthread_mutex_lock (&instance->dio_write_mutex);
+    transaction = instance->dio_write_transaction;
+    instance->dio_write_transaction = NULL;
+    pthread_mutex_unlock (&instance->dio_write_mutex);
+
+    if (transaction == NULL)
+    {
+        disir_error_set (instance, "no write transaction is active");
+        return DISIR_STATUS_NOT_EXIST;
+    }
+
+    return dx_write_transaction_finish (instance, &transaction);
+}
@@ -1,13 +1,13 @@
+#include <stdlib.h>
 #include <string.h>
 
 #include <disir/disir.h>
-#include <multimap.h>
-#include <list.h>
-#include <errno.h>
 
 #include "context_private.h"
+#include "disir_private.h"
 #include "collection.h"
 #include "element_storage.h"
+#include "name_table.h"
 #include "log.h"
 
 //!
@@ -22,75 +22,298 @@
 //!
 //!
 
+//! Number of entries the storage holds before a hash index is built.
+//! Below this threshold, lookups are a linear scan over the (hash, name) pairs
+//! stored inline in the entry array.
+#define ELEMENT_STORAGE_SMALL_MAX 8
+
+//! Initial capacity of the entry array.
+#define ELEMENT_STORAGE_INIT_CAPACITY 4
+
+//! Initial number of buckets in the name index. Must be a power of two.
+#define ELEMENT_STORAGE_INIT_BUCKETS 32
+
+//! A single stored element.
+struct element_storage_entry
+{
+    //! Name the context is stored by. Either interned in ee_table, or ee_copy.
+    //! We never reference the name stored inside the context object itself, since foul
+    //! things may happend if the context is renamed or freed while we hold on to it.
+    const char              *ee_name;
+
+    //! Heap allocated copy of the name, if it is not interned.
+    char                    *ee_copy;
+
+    //! Name table ee_name is interned in. The storage holds a reference on it.
+    //! NULL if ee_name is a heap allocated copy.
+    struct disir_name_table *ee_table;
+
+    //! Cached hash of ee_name.
+    unsigned long           ee_hash;
+
+    //! Stored context. The storage holds a reference on it.
+    //! NULL if the context has been removed (tombstone) and not yet compacted away.
+    struct disir_context    *ee_context;
+
+    //! Index of the next entry stored with the same name, in insertion order.
+    //! -1 if this is the last one. Only maintained while es_buckets is allocated.
+    int32_t                 ee_next;
+
+    //! Index of the last entry stored with the same name.
+    //! Only maintained on the first entry of each name, while es_buckets is allocated.
+    int32_t                 ee_tail;
+};
+
 //! Make the element storage a complete ADT to the entire library
 //! This way, we can really modify the internals without too much fuzz
 //! around the codebase on this rather important interface
 struct disir_element_storage
 {
-    // A multimap that holds all elements inserted by key.
-    // Multiple values may be associated with a key, of which are stored
-    // in insertion order.
-    // Key is a string name of the element to store. We make a copy of the key
-    // upon insertion, since foul things may happend if we reference the name
-    // stored inside a context object that has been freed.
-    // The map allows us to quickly retrieve named entries.
-    struct multimap *es_map;
-
-    // List to simply keep a insertion order of all keyval and section contexts
-    // The list lets us iterate all child context in order of insertion - important
+    // Array of all keyval and section contexts in insertion order.
+    // The array lets us iterate all child context in order of insertion - important
     // for the sake of consistency when exposing the raw dump of all children.
-    struct list     *es_list;
+    // The same array holds the names we look contexts up by.
+    struct element_storage_entry    *es_entries;
+
+    //! Number of entries in use in es_entries, including tombstones.
+    int32_t                         es_numentries;
+
+    //! Number of entries allocated to fit in es_entries.
+    int32_t                         es_capacity;
+
+    //! Number of removed entries in es_entries awaiting compaction.
+    int32_t                         es_numtombstones;
+
+    // Open addressed hash index from name to the first entry stored with that name.
+    // Each bucket holds an index into es_entries, or -1 if empty.
+    // Only allocated once the storage grows beyond ELEMENT_STORAGE_SMALL_MAX entries;
+    // small storages are searched linearly.
+    int32_t                         *es_buckets;
+
+    //! Number of buckets in es_buckets. Always a power of two.
+    int32_t                         es_nbuckets;
 };
 
-// String hashing function for the multimap
-// http://www.cse.yorku.ca/~oz/hash.html
-static unsigned long djb2 (char *str)
+//! STATIC API
+//! Names interned in the same table are equal only if they are the same pointer.
+//! Names from other sources fall back on comparing the strings.
+static inline int
+storage_name_equal (struct element_storage_entry *entry, const char *name, unsigned long hash)
 {
-    unsigned long hash = 5381;
-    char c;
-    while( (c = *str++) ) {
-        hash = ((hash << 5) + hash) + c;
+    return (entry->ee_name == name
+            || (entry->ee_hash == hash && strcmp (entry->ee_name, name) == 0));
+}
+
+//! STATIC API
+//! Free the name of entry, or drop the reference on the table it is interned in.
+static void
+storage_entry_release_name (struct element_storage_entry *entry)
+{
+    dx_name_table_decref (&entry->ee_table);
+    free (entry->ee_copy);
+    entry->ee_copy = NULL;
+    entry->ee_name = NULL;
+}
+
+//! STATIC API
+//! Return the bucket holding the first entry stored by name, or the empty bucket
+//! it would be inserted into.
+static int32_t
+storage_bucket_find (struct disir_element_storage *storage, const char *name, unsigned long hash)
+{
+    struct element_storage_entry *entry;
+    int32_t bucket;
+    int32_t mask;
+
+    mask = storage->es_nbuckets - 1;
+    bucket = (int32_t) (hash & mask);
+    while (storage->es_buckets[bucket] != -1)
+    {
+        entry = &storage->es_entries[storage->es_buckets[bucket]];
+        if (storage_name_equal (entry, name, hash))
+        {
+            break;
+        }
+        bucket = (bucket + 1) & mask;
     }
-    return hash;
+
+    return bucket;
 }
 
-//! INTERNAL API
-struct disir_element_storage *
-dx_element_storage_create (void)
+//! STATIC API
+//! Link the entry at index into the hash index.
+static void
+storage_index_insert (struct disir_element_storage *storage, int32_t index)
 {
-    struct disir_element_storage *storage;
+    struct element_storage_entry *entry;
+    struct element_storage_entry *head;
+    int32_t bucket;
 
-    storage = calloc(1, sizeof (struct disir_element_storage));
-    if (storage == NULL)
+    entry = &storage->es_entries[index];
+    entry->ee_next = -1;
+    entry->ee_tail = index;
+
+    bucket = storage_bucket_find (storage, entry->ee_name, entry->ee_hash);
+    if (storage->es_buckets[bucket] == -1)
+    {
+        storage->es_buckets[bucket] = index;
+        return;
+    }
+
+    // Append to the end of the chain of entries stored with the same name.
+    head = &storage->es_entries[storage->es_buckets[bucket]];
+    storage->es_entries[head->ee_tail].ee_next = index;
+    head->ee_tail = index;
+}
+
+//! STATIC API
+//! (Re)build the hash index over all entries, or drop it if the storage is small.
+static enum disir_status
+storage_index_rebuild (struct disir_element_storage *storage)
+{
+    int32_t nbuckets;
+    int32_t *buckets;
+    int32_t i;
+
+    if (storage->es_numentries <= ELEMENT_STORAGE_SMALL_MAX)
     {
-        goto error;
+        free (storage->es_buckets);
+        storage->es_buckets = NULL;
+        storage->es_nbuckets = 0;
+        return DISIR_STATUS_OK;
     }
 
-    storage->es_map = multimap_create ((int (*)(const void *, const void*)) strcmp,
-                                       (unsigned long (*)(const void*)) djb2);
-    if (storage->es_map == NULL)
+    // Keep the load factor at or below one half.
+    nbuckets = ELEMENT_STORAGE_INIT_BUCKETS;
+    while (nbuckets < 2 * storage->es_numentries)
+        nbuckets <<= 1;
+
+    if (nbuckets != storage->es_nbuckets)
     {
-        goto error;
+        buckets = realloc (storage->es_buckets, nbuckets * sizeof (int32_t));
+        if (buckets == NULL)
+        {
+            log_warn ("in element_storage (%p) - failed to allocate name index", storage);
+            return DISIR_STATUS_NO_MEMORY;
+        }
+        storage->es_buckets = buckets;
+        storage->es_nbuckets = nbuckets;
     }
 
-    storage->es_list = list_create ();
-    if (storage->es_list == NULL)
+    memset (storage->es_buckets, 0xff, storage->es_nbuckets * sizeof (int32_t));
+    for (i = 0; i < storage->es_numentries; i++)
     {
-        goto error;
+        storage_index_insert (storage, i);
     }
 
-    return storage;
-error:
-    if (storage && storage->es_map)
-        multimap_destroy (storage->es_map, NULL, NULL);
+    return DISIR_STATUS_OK;
+}
 
-    if (storage && storage->es_list)
-        list_destroy (&storage->es_list);
+//! STATIC API
+//! Squeeze out all tombstones, keeping insertion order, and rebuild the index.
+static void
+storage_compact (struct disir_element_storage *storage)
+{
+    int32_t i;
+    int32_t j;
 
-    if (storage)
-        free (storage);
+    for (i = 0, j = 0; i < storage->es_numentries; i++)
+    {
+        if (storage->es_entries[i].ee_context == NULL)
+        {
+            storage_entry_release_name (&storage->es_entries[i]);
+            continue;
+        }
+        storage->es_entries[j++] = storage->es_entries[i];
+    }
 
-    return NULL;
+    storage->es_numentries = j;
+    storage->es_numtombstones = 0;
+
+    // Cannot fail when shrinking. Should it fail when growing, the index is left
+    // untouched and lookups fall back on being incorrect - log and carry on.
+    if (storage_index_rebuild (storage) != DISIR_STATUS_OK)
+    {
+        log_error ("in element_storage (%p) - failed to rebuild name index", storage);
+    }
+}
+
+//! STATIC API
+//! Return the entry index of the first entry stored by name (including tombstones), or -1.
+static int32_t
+storage_find_first (struct disir_element_storage *storage, const char *name, unsigned long hash)
+{
+    int32_t i;
+
+    if (storage->es_buckets)
+    {
+        return storage->es_buckets[storage_bucket_find (storage, name, hash)];
+    }
+
+    for (i = 0; i < storage->es_numentries; i++)
+    {
+        if (storage_name_equal (&storage->es_entries[i], name, hash))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+//! STATIC API
+//! Return the entry index of the next entry stored by the same name as the entry at i,
+//! in insertion order (including tombstones), or -1.
+static int32_t
+storage_find_next (struct disir_element_storage *storage, int32_t i)
+{
+    struct element_storage_entry *entry;
+    int32_t j;
+
+    entry = &storage->es_entries[i];
+    if (storage->es_buckets)
+    {
+        return entry->ee_next;
+    }
+
+    for (j = i + 1; j < storage->es_numentries; j++)
+    {
+        if (storage_name_equal (&storage->es_entries[j], entry->ee_name, entry->ee_hash))
+        {
+            return j;
+        }
+    }
+
+    return -1;
+}
+
+//! STATIC API
+//! Return the entry index of the index'th context stored by name, or -1.
+static int32_t
+storage_find (struct disir_element_storage *storage, const char *name, unsigned int index)
+{
+    int32_t i;
+
+    for (i = storage_find_first (storage, name, dx_hash_string (name, -1)); i != -1;
+         i = storage_find_next (storage, i))
+    {
+        if (storage->es_entries[i].ee_context == NULL)
+            continue;
+
+        if (index == 0)
+            break;
+        index--;
+    }
+
+    return i;
+}
+
+//! INTERNAL API
+struct disir_element_storage *
+dx_element_storage_create (void)
+{
+    // The entry array and name index are allocated lazily upon insertion.
+    return calloc (1, sizeof (struct disir_element_storage));
 }
 
 //! INTERNAL API
@@ -99,8 +322,10 @@ error:
 enum disir_status
 dx_element_storage_destroy (struct disir_element_storage **storage)
 {
-    list_iterator_t *iter;
+    struct element_storage_entry *entries;
     struct disir_context *context;
+    int32_t numentries;
+    int32_t i;
 
     if (storage == NULL || *storage == NULL)
     {
@@ -108,35 +333,58 @@ dx_element_storage_destroy (struct disir_element_storage **storage)
         return DISIR_STATUS_INVALID_ARGUMENT;
     }
 
-    iter = list_iterator_create ((*storage)->es_list, LIST_HEAD);
-    if (iter == NULL)
-    {
-        log_warn ("list_iterator_create allocation failed.");
-        return DISIR_STATUS_NO_MEMORY;
-    }
-
-    // Destroy each context stored in the element storage (through the list)
-    while ((context = list_iterator_next (iter)))
+    // Detach the entries from the storage before destroying the contexts,
+    // such that their removal from this storage (as their parent) is a no-op.
+    entries = (*storage)->es_entries;
+    numentries = (*storage)->es_numentries;
+    (*storage)->es_entries = NULL;
+    (*storage)->es_numentries = 0;
+    free ((*storage)->es_buckets);
+    (*storage)->es_buckets = NULL;
+
+    // Destroy each context stored in the element storage (in insertion order)
+    for (i = 0; i < numentries; i++)
     {
         // Ignore return code - we just want to destroy and get out of town.
         // Destroying the context will decref our reference on it.
+        context = entries[i].ee_context;
         if (context)
         {
             dc_destroy (&context);
         }
+        storage_entry_release_name (&entries[i]);
     }
 
-    // Destroy iterator and element_storage data structures
-    // multimap key is heap allocated upon insertion - free it upon deletion.
-    list_iterator_destroy (&iter);
-    list_destroy (&(*storage)->es_list);
-    multimap_destroy ((*storage)->es_map, free, NULL);
-
+    free (entries);
     free (*storage);
     *storage = NULL;
     return DISIR_STATUS_OK;;
 }
 
+//! INTERNAL API
+enum disir_status
+dx_element_storage_discard (struct disir_element_storage **storage)
+{
+    int32_t i;
+
+    if (storage == NULL || *storage == NULL)
+    {
+        log_debug (0, "invoked with storage NULL pointer.");
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    for (i = 0; i < (*storage)->es_numentries; i++)
+    {
+        storage_entry_release_name (&(*storage)->es_entries[i]);
+    }
+
+    free ((*storage)->es_entries);
+    free ((*storage)->es_buckets);
+    free (*storage);
+    *storage = NULL;
+    return DISIR_STATUS_OK;
+}
+
 //! INTERNAL API
 int32_t
 dx_element_storage_numentries (struct disir_element_storage *storage)
@@ -144,23 +392,22 @@ dx_element_storage_numentries (struct disir_element_storage *storage)
     if (storage == NULL)
         return (-1);
 
-    // Get the number of entries from the multimap
-    return multimap_size (storage->es_map);
+    return storage->es_numentries - storage->es_numtombstones;
 }
 
-//! INTERNAL API
-//! Make a copy of the input name to use as key for multimap. Only allocate if no such
-//! key exist in the map.
+//! STATIC API
+//! Store context by name. Name is copied, unless it is interned in table.
 //! Will increment context refcount.
-enum disir_status
-dx_element_storage_add (struct disir_element_storage *storage,
-                        const char * name,
-                        struct disir_context *context)
+static enum disir_status
+storage_add (struct disir_element_storage *storage, const char *name,
+             struct disir_name_table *table, struct disir_context *context)
 {
     enum disir_status status;
-    int res;
-    int keys_in_map;
-    char *key;
+    struct element_storage_entry *entry;
+    struct element_storage_entry *entries;
+    unsigned long hash;
+    int32_t capacity;
+    int32_t i;
 
     if (storage == NULL || name == NULL || context == NULL)
     {
@@ -169,71 +416,161 @@ dx_element_storage_add (struct disir_element_storage *storage,
         return DISIR_STATUS_INVALID_ARGUMENT;
     }
 
-    keys_in_map = multimap_contains_key (storage->es_map, name);
-    if (keys_in_map == 0)
+    // Check if the context is already stored by this name.
+    hash = dx_hash_string (name, -1);
+    for (i = storage_find_first (storage, name, hash); i != -1;
+         i = storage_find_next (storage, i))
     {
-        // Map does not contain a key with this name. Allocate space to store
-        // key in, so we can safely access the key memory even if the appointed context
-        // is destroyed whilst in our storage.
-        key = malloc (strlen (name) + 1); // XXX: Is there a more safe way to allocate this memory?
-        memcpy(key, name, strlen (name) + 1);
+        if (storage->es_entries[i].ee_context == context)
+        {
+            log_warn ("attempted to add context (%p) to element storage which already exists",
+                      context);
+            return DISIR_STATUS_EXISTS;
+        }
     }
 
-    // Add to map - will check if it already exists or not.
-    res = multimap_push_value (storage->es_map,
-            (keys_in_map ? name : key),
-            context);
-    if (res == (-ENOMEM))
+    // Expand capacity if needed
+    if (storage->es_numentries == storage->es_capacity)
     {
-        log_warn ("multimap_push_value failed to allocate sufficient memory.");
-        status = DISIR_STATUS_NO_MEMORY;
-        goto map_error;
+        capacity = (storage->es_capacity ? storage->es_capacity * 2
+                                         : ELEMENT_STORAGE_INIT_CAPACITY);
+        entries = realloc (storage->es_entries, capacity * sizeof (struct element_storage_entry));
+        if (entries == NULL)
+        {
+            log_warn ("element storage reallocation of capacity( %d ) failed.", capacity);
+            return DISIR_STATUS_NO_MEMORY;
+        }
+        storage->es_entries = entries;
+        storage->es_capacity = capacity;
     }
-    else if (res != 0)
+
+    entry = &storage->es_entries[storage->es_numentries];
+    if (table)
     {
-        log_warn ("attempted to add context (%p) to element storage which already exists",
-                context);
-        status = DISIR_STATUS_EXISTS;
-        goto map_error;
+        entry->ee_name = name;
+        entry->ee_copy = NULL;
+        entry->ee_table = table;
+        dx_name_table_incref (table);
     }
-
-    // Add to list for chronological ordering.
-    if (list_rpush (storage->es_list, context))
+    else
     {
-        status = DISIR_STATUS_INTERNAL_ERROR;
-        goto list_error;
+        entry->ee_copy = strdup (name);
+        entry->ee_name = entry->ee_copy;
+        entry->ee_table = NULL;
+        if (entry->ee_copy == NULL)
+        {
+            log_warn ("failed to allocate sufficient memory for element name.");
+            return DISIR_STATUS_NO_MEMORY;
+        }
+    }
+    entry->ee_hash = hash;
+    entry->ee_context = context;
+    entry->ee_next = -1;
+    entry->ee_tail = storage->es_numentries;
+    storage->es_numentries++;
+
+    // Promote to (or grow) the hash index when the storage outgrows the linear scan.
+    if (storage->es_numentries > ELEMENT_STORAGE_SMALL_MAX)
+    {
+        if (storage->es_buckets == NULL || storage->es_nbuckets < 2 * storage->es_numentries)
+        {
+            status = storage_index_rebuild (storage);
+            if (status != DISIR_STATUS_OK)
+            {
+                storage->es_numentries--;
+                storage_entry_release_name (entry);
+                return status;
+            }
+        }
+        else
+        {
+            storage_index_insert (storage, storage->es_numentries - 1);
+        }
     }
 
     dx_context_incref (context);
 
     return DISIR_STATUS_OK;;
-list_error:
-    multimap_remove_value (storage->es_map,
-        (keys_in_map ? name : key),
-        free, // Free's the allocated memory above, if removing last element with this key name.
-        NULL);
+}
 
-map_error:
-    if (keys_in_map == 0)
+//! INTERNAL API
+//! Make a copy of the input name to use as key for lookups.
+enum disir_status
+dx_element_storage_add (struct disir_element_storage *storage,
+                        const char *name,
+                        struct disir_context *context)
+{
+    return storage_add (storage, name, NULL, context);
+}
+
+//! INTERNAL API
+//! Reference the interned name as key for lookups.
+enum disir_status
+dx_element_storage_add_interned (struct disir_element_storage *storage,
+                                 const char *name,
+                                 struct disir_name_table *table,
+                                 struct disir_context *context)
+{
+    if (table == NULL)
     {
-        // Allocated on heap - free it.
-        free (key);
+        log_debug (0, "invoked with table NULL pointer.");
+        return DISIR_STATUS_INVALID_ARGUMENT;
     }
 
-    return status;
+    return storage_add (storage, name, table, context);
 }
 
+//! INTERNAL API
+//! The entry is left as a tombstone, which is compacted away once they
+//! make up half the storage. This keeps removal of every child in a row linear.
 enum disir_status
 dx_element_storage_remove (struct disir_element_storage *storage,
                            const char * const name,
                            struct disir_context *context)
 {
-    multimap_remove_value (storage->es_map, name, free, context);
-    if (list_remove (storage->es_list, context))
+    int32_t i;
+
+    if (storage == NULL || context == NULL)
     {
-        dx_context_decref (&context);
+        log_debug (0, "invoked with NULL pointer(s) (storage %p, context %p)",
+                   storage, context);
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    i = -1;
+    if (name)
+    {
+        for (i = storage_find_first (storage, name, dx_hash_string (name, -1)); i != -1;
+             i = storage_find_next (storage, i))
+        {
+            if (storage->es_entries[i].ee_context == context)
+                break;
+        }
+    }
+    if (i == -1)
+    {
+        // The context may have been renamed since it was stored. Search it all.
+        for (i = 0; i < storage->es_numentries; i++)
+        {
+            if (storage->es_entries[i].ee_context == context)
+                break;
+        }
+        if (i == storage->es_numentries)
+        {
+            return DISIR_STATUS_NOT_EXIST;
+        }
     }
 
+    storage->es_entries[i].ee_context = NULL;
+    storage->es_numtombstones++;
+
+    if (storage->es_numtombstones * 2 >= storage->es_numentries)
+    {
+        storage_compact (storage);
+    }
+
+    dx_context_decref (&context);
+
     return DISIR_STATUS_OK;
 }
 
@@ -243,47 +580,43 @@ dx_element_storage_get (struct disir_element_storage *storage,
                         struct disir_collection **collection)
 {
     enum disir_status status;
-    struct disir_context *context;
     struct disir_collection *col;
-    struct multimap_value_iterator *iter;
+    int32_t i;
 
-    iter = multimap_fetch (storage->es_map, name);
-    if (iter == NULL)
+    if (storage == NULL || name == NULL || collection == NULL)
+    {
+        log_debug (0, "invoked with NULL pointer(s) (storage %p, name %p, collection %p)",
+                   storage, name, collection);
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    i = storage_find (storage, name, 0);
+    if (i == -1)
     {
         return DISIR_STATUS_NOT_EXIST;
     }
+
     col = dc_collection_create ();
-    if (collection == NULL)
+    if (col == NULL)
     {
-        status = DISIR_STATUS_NO_MEMORY;
-        goto error;
+        return DISIR_STATUS_NO_MEMORY;
     }
 
-    while ((context = multimap_iterator_next (iter)))
+    for (; i != -1; i = storage_find_next (storage, i))
     {
-        status = dc_collection_push_context (col, context);
+        if (storage->es_entries[i].ee_context == NULL)
+            continue;
+
+        status = dc_collection_push_context (col, storage->es_entries[i].ee_context);
         if (status != DISIR_STATUS_OK)
         {
-            goto error;
+            dc_collection_finished (&col);
+            return status;
         }
     }
 
-    multimap_iterator_destroy (iter);
-
     *collection = col;
     return DISIR_STATUS_OK;
-error:
-
-    if (col)
-    {
-        dc_collection_finished (&col);
-    }
-    if (iter)
-    {
-        multimap_iterator_destroy (iter);
-    }
-
-    return status;
 }
 
 // INTERNAL API
@@ -292,12 +625,8 @@ dx_element_storage_get_all (struct disir_element_storage *storage,
                             struct disir_collection **collection)
 {
     enum disir_status status;
-    struct disir_context *context;
     struct disir_collection *coll;
-    struct list_iterator *iter;
-
-    coll = NULL;
-    iter = NULL;
+    int32_t i;
 
     if (storage == NULL)
     {
@@ -310,63 +639,66 @@ dx_element_storage_get_all (struct disir_element_storage *storage,
         return DISIR_STATUS_INVALID_ARGUMENT;
     }
 
-    iter = list_iterator_create (storage->es_list, LIST_HEAD);
-    if (iter == NULL)
-    {
-        log_warn ("in element_storage (%p) - list_iterator_create failed", storage);
-        status = DISIR_STATUS_NO_MEMORY;
-        goto error;
-    }
-
     coll = dc_collection_create ();
     if (coll == NULL)
     {
         log_warn (
             "in element_storage (%p) - dc_collection_create failed to allocate sufficient memory",
             storage);
-        status = DISIR_STATUS_NO_MEMORY;
-        goto error;
+        return DISIR_STATUS_NO_MEMORY;
     }
 
-    while ((context = list_iterator_next (iter)))
+    for (i = 0; i < storage->es_numentries; i++)
     {
-        status = dc_collection_push_context (coll, context);
+        if (storage->es_entries[i].ee_context == NULL)
+            continue;
+
+        status = dc_collection_push_context (coll, storage->es_entries[i].ee_context);
         if (status != DISIR_STATUS_OK)
-            goto error;
+        {
+            dc_collection_finished (&coll);
+            return status;
+        }
     }
 
-    list_iterator_destroy (&iter);
-
     *collection = coll;
 
     return DISIR_STATUS_OK;
-error:
-    if (iter)
-        list_iterator_destroy (&iter);
-    if (coll)
-    {
-        dc_collection_finished (&coll);
-    }
-
-    return status;
 }
 
 //! INTERNAL API
 enum disir_status
-dx_element_storage_get_first(struct disir_element_storage *storage,
-                             const char *name,
-                             struct disir_context **context)
+dx_element_storage_get_at (struct disir_element_storage *storage,
+                           const char *name, unsigned int index,
+                           struct disir_context **context)
 {
-    struct disir_context *keyval;
+    int32_t i;
+
+    if (storage == NULL || name == NULL || context == NULL)
+    {
+        log_debug (0, "invoked with NULL pointer(s) (storage %p, name %p, context %p)",
+                   storage, name, context);
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
 
-    keyval = multimap_get_first (storage->es_map, name);
-    if (keyval == NULL)
+    // Read the entry array in place - nothing is allocated.
+    i = storage_find (storage, name, index);
+    if (i == -1)
     {
         return DISIR_STATUS_NOT_EXIST;
     }
 
-    *context = keyval;
+    *context = storage->es_entries[i].ee_context;
     return DISIR_STATUS_OK;
 }
 
+//! INTERNAL API
+enum disir_status
+dx_element_storage_get_first(struct disir_element_storage *storage,
+                             const char *name,
+                             struct disir_context **context)
+{
+    return dx_element_storage_get_at (storage, name, 0, context);
+}
+
 
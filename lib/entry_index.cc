@@ -0,0 +1,444 @@
+// private
+#include "entry_index.h"
+extern "C" {
+#include "disir_private.h"
+#include "log.h"
+}
+
+// system
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+
+//! Upper bound on the number of threads scanning a directory tree.
+#define ENTRY_INDEX_MAX_THREADS 8
+
+//! Entry indexes held by an instance, keyed by base directory and suffix.
+struct disir_entry_index_table
+{
+    std::map<std::string, std::shared_ptr<const struct disir_entry_index>> et_indexes;
+};
+
+//! Shared state of the threads scanning a directory tree.
+struct entry_index_scan
+{
+    std::string                 es_basedir;
+    std::string                 es_suffix;
+    struct timespec             es_start;
+
+    std::mutex                  es_mutex;
+    std::condition_variable     es_cond;
+    //! Directories waiting to be scanned, relative to es_basedir.
+    std::deque<std::string>     es_pending;
+    //! Number of directories being scanned.
+    int                         es_busy;
+
+    struct disir_entry_index    *es_index;
+};
+
+//! STATIC API
+static std::string
+entry_index_key (const char *basedir, const char *suffix)
+{
+    std::string key (basedir);
+    key.push_back ('\0');
+    key.append (suffix);
+    return key;
+}
+
+//! STATIC API
+static std::string
+entry_index_path (const std::string &basedir, const std::string &relative)
+{
+    if (relative.empty ())
+        return basedir;
+    return basedir + "/" + relative;
+}
+
+//! STATIC API
+static void
+entry_index_directory_set (struct entry_index_directory *directory, const struct stat *statbuf,
+                           const struct timespec *start)
+{
+    directory->ed_dev = statbuf->st_dev;
+    directory->ed_ino = statbuf->st_ino;
+    directory->ed_mtime = statbuf->st_mtim;
+
+    // Filesystem timestamps are coarse; a modification right after the directory
+    // was read may leave its modification time unchanged.
+    directory->ed_racy = (statbuf->st_mtim.tv_sec + 1 >= start->tv_sec);
+}
+
+//! STATIC API
+//! Return non-zero if the directory at path is unchanged since it was indexed.
+static int
+entry_index_directory_valid (const struct entry_index_directory *directory,
+                             const std::string &path)
+{
+    struct stat statbuf;
+
+    if (directory->ed_racy || stat (path.c_str(), &statbuf) != 0)
+        return 0;
+
+    return (directory->ed_dev == statbuf.st_dev
+            && directory->ed_ino == statbuf.st_ino
+            && directory->ed_mtime.tv_sec == statbuf.st_mtim.tv_sec
+            && directory->ed_mtime.tv_nsec == statbuf.st_mtim.tv_nsec);
+}
+
+//! STATIC API
+//! Read a single directory of the scan, recording its entry files and queueing its
+//! subdirectories. Return non-zero if the directory could not be read.
+static int
+entry_index_scan_directory (struct entry_index_scan *scan, const std::string &relative)
+{
+    struct entry_index_directory directory;
+    std::vector<std::string> entries;
+    std::vector<std::string> links;
+    std::vector<std::string> subdirectories;
+    std::string path;
+    struct stat statbuf;
+    struct dirent *dp;
+    DIR *dir;
+    size_t namelen;
+    int fd;
+
+    path = entry_index_path (scan->es_basedir, relative);
+    std::string prefix = (relative.empty () ? relative : relative + "/");
+
+    fd = open (path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd == -1 || fstat (fd, &statbuf) != 0 || (dir = fdopendir (fd)) == NULL)
+    {
+        if (fd != -1)
+            close (fd);
+
+        // Record unreadable directories by their state, such that they are rescanned
+        // once modified.
+        if (stat (path.c_str(), &statbuf) != 0)
+            return 1;
+
+        entry_index_directory_set (&directory, &statbuf, &scan->es_start);
+
+        std::lock_guard<std::mutex> lock (scan->es_mutex);
+        scan->es_index->ei_directories[relative] = directory;
+        return 1;
+    }
+
+    entry_index_directory_set (&directory, &statbuf, &scan->es_start);
+
+    while ((dp = readdir (dir)) != NULL)
+    {
+        unsigned char type = dp->d_type;
+
+        if (strcmp (dp->d_name, ".") == 0 || strcmp (dp->d_name, "..") == 0)
+            continue;
+
+        if (type == DT_UNKNOWN)
+        {
+            if (fstatat (dirfd (dir), dp->d_name, &statbuf, AT_SYMLINK_NOFOLLOW) != 0)
+                continue;
+            if (S_ISREG (statbuf.st_mode))
+                type = DT_REG;
+            else if (S_ISDIR (statbuf.st_mode))
+                type = DT_DIR;
+            else if (S_ISLNK (statbuf.st_mode))
+                type = DT_LNK;
+        }
+
+        if (type == DT_DIR)
+        {
+            subdirectories.push_back (prefix + dp->d_name);
+            continue;
+        }
+        if (type != DT_REG && type != DT_LNK)
+            continue;
+
+        // Check that our file extension (suffix) is valid for this file entry
+        namelen = strlen (dp->d_name);
+        if (namelen <= scan->es_suffix.size ()
+            || scan->es_suffix.compare (0, std::string::npos,
+                                        dp->d_name + namelen - scan->es_suffix.size ()) != 0)
+        {
+            continue;
+        }
+
+        std::string entry = prefix + std::string (dp->d_name, namelen - scan->es_suffix.size ());
+        if (type == DT_LNK)
+        {
+            // Symbolic links to directories are not followed, which keeps link cycles
+            // out of the scan. Entries below them are looked up on disk.
+            if (fstatat (dirfd (dir), dp->d_name, &statbuf, 0) == 0 && S_ISREG (statbuf.st_mode))
+                entries.push_back (entry);
+            links.push_back (std::move (entry));
+        }
+        else
+        {
+            entries.push_back (std::move (entry));
+        }
+    }
+    closedir (dir);
+
+    std::lock_guard<std::mutex> lock (scan->es_mutex);
+    scan->es_index->ei_directories[relative] = directory;
+    scan->es_index->ei_entries.insert (entries.begin (), entries.end ());
+    scan->es_index->ei_links.insert (links.begin (), links.end ());
+    for (auto &subdirectory : subdirectories)
+    {
+        scan->es_pending.push_back (std::move (subdirectory));
+    }
+    if (subdirectories.empty () == false)
+    {
+        scan->es_cond.notify_all ();
+    }
+
+    return 0;
+}
+
+//! STATIC API
+//! Scan pending directories until every directory of the tree is scanned.
+static void
+entry_index_scan_worker (struct entry_index_scan *scan)
+{
+    std::string relative;
+
+    while (1)
+    {
+        {
+            std::unique_lock<std::mutex> lock (scan->es_mutex);
+            scan->es_cond.wait (lock, [scan] {
+                return (scan->es_pending.empty () == false || scan->es_busy == 0);
+            });
+            if (scan->es_pending.empty ())
+                return;
+
+            relative = std::move (scan->es_pending.front ());
+            scan->es_pending.pop_front ();
+            scan->es_busy++;
+        }
+
+        entry_index_scan_directory (scan, relative);
+
+        std::lock_guard<std::mutex> lock (scan->es_mutex);
+        scan->es_busy--;
+        if (scan->es_busy == 0 && scan->es_pending.empty ())
+        {
+            scan->es_cond.notify_all ();
+        }
+    }
+}
+
+//! STATIC API
+static enum disir_status
+entry_index_build (struct disir_instance *instance, const char *basedir, const char *suffix,
+                   std::shared_ptr<const struct disir_entry_index> &index)
+{
+    std::vector<std::thread> workers;
+    struct entry_index_scan scan;
+    size_t threads;
+
+    auto built = std::make_shared<struct disir_entry_index> ();
+
+    scan.es_basedir = basedir;
+    scan.es_suffix = suffix;
+    scan.es_busy = 0;
+    scan.es_index = built.get ();
+    clock_gettime (CLOCK_REALTIME, &scan.es_start);
+
+    // The base directory is scanned up front, to size the thread pool
+    // by the subdirectories found.
+    if (entry_index_scan_directory (&scan, "") != 0)
+    {
+        disir_error_set (instance, "Unable to open directory: %s", basedir);
+        return DISIR_STATUS_FS_ERROR;
+    }
+
+    threads = std::thread::hardware_concurrency ();
+    threads = std::min<size_t> (threads, ENTRY_INDEX_MAX_THREADS);
+    threads = std::min<size_t> (threads, scan.es_pending.size ());
+
+    // The calling thread is one of the workers
+    for (size_t i = 1; i < threads; i++)
+    {
+        try
+        {
+            workers.emplace_back (entry_index_scan_worker, &scan);
+        }
+        catch (std::system_error &)
+        {
+            // Out of threads - scan with those already started.
+            log_debug (4, "unable to start scan thread %zu of %zu", i, threads);
+            break;
+        }
+    }
+    entry_index_scan_worker (&scan);
+    for (auto &worker : workers)
+    {
+        worker.join ();
+    }
+
+    log_debug (4, "indexed %zu entries in %zu directories below %s",
+               built->ei_entries.size (), built->ei_directories.size (), basedir);
+
+    index = built;
+    return DISIR_STATUS_OK;
+}
+
+//! STATIC API
+static std::shared_ptr<const struct disir_entry_index>
+entry_index_lookup (struct disir_instance *instance, const std::string &key)
+{
+    std::shared_ptr<const struct disir_entry_index> index;
+
+    pthread_mutex_lock (&instance->dio_entry_index_mutex);
+    if (instance->dio_entry_index)
+    {
+        auto it = instance->dio_entry_index->et_indexes.find (key);
+        if (it != instance->dio_entry_index->et_indexes.end ())
+        {
+            index = it->second;
+        }
+    }
+    pthread_mutex_unlock (&instance->dio_entry_index_mutex);
+
+    return index;
+}
+
+//! INTERNAL API
+enum disir_status
+dx_entry_index_get (struct disir_instance *instance, const char *basedir, const char *suffix,
+                    std::shared_ptr<const struct disir_entry_index> &index)
+{
+    enum disir_status status;
+    std::string key;
+    int valid;
+
+    key = entry_index_key (basedir, suffix);
+
+    index = entry_index_lookup (instance, key);
+    if (index)
+    {
+        valid = 1;
+        for (const auto &directory : index->ei_directories)
+        {
+            if (entry_index_directory_valid (&directory.second,
+                                             entry_index_path (basedir, directory.first)) == 0)
+            {
+                valid = 0;
+                break;
+            }
+        }
+        if (valid)
+            return DISIR_STATUS_OK;
+    }
+
+    status = entry_index_build (instance, basedir, suffix, index);
+    if (status != DISIR_STATUS_OK)
+    {
+        return status;
+    }
+
+    pthread_mutex_lock (&instance->dio_entry_index_mutex);
+    try
+    {
+        if (instance->dio_entry_index == NULL)
+        {
+            instance->dio_entry_index = new disir_entry_index_table;
+        }
+        instance->dio_entry_index->et_indexes[key] = index;
+    }
+    catch (std::bad_alloc &)
+    {
+        // The index is still handed out, only not kept.
+    }
+    pthread_mutex_unlock (&instance->dio_entry_index_mutex);
+
+    return DISIR_STATUS_OK;
+}
+
+//! INTERNAL API
+enum disir_status
+dx_entry_index_query (struct disir_instance *instance, const char *basedir, const char *suffix,
+                      const char *entry)
+{
+    std::shared_ptr<const struct disir_entry_index> index;
+    const char *separator;
+    std::string directory;
+    std::string component;
+
+    index = entry_index_lookup (instance, entry_index_key (basedir, suffix));
+    if (!index)
+        return DISIR_STATUS_NO_CAN_DO;
+
+    separator = strrchr (entry, '/');
+    if (separator)
+    {
+        directory.assign (entry, separator - entry);
+    }
+
+    // Only entries naming their file canonically are indexed.
+    if (strcmp (separator ? separator + 1 : entry, ".") == 0
+        || strcmp (separator ? separator + 1 : entry, "..") == 0)
+    {
+        return DISIR_STATUS_NO_CAN_DO;
+    }
+    if (separator)
+    {
+        size_t start = 0;
+        size_t end;
+        do
+        {
+            end = directory.find ('/', start);
+            component = directory.substr (start, end - start);
+            if (component.empty () || component == "." || component == "..")
+                return DISIR_STATUS_NO_CAN_DO;
+            start = end + 1;
+        } while (end != std::string::npos);
+    }
+
+    auto it = index->ei_directories.find (directory);
+    if (it == index->ei_directories.end ())
+    {
+        // The directory was not there when indexed.
+        // It may have been created since, in which case the index is stale.
+        struct stat statbuf;
+        if (stat (entry_index_path (basedir, directory).c_str(), &statbuf) != 0)
+            return DISIR_STATUS_NOT_EXIST;
+        return DISIR_STATUS_NO_CAN_DO;
+    }
+
+    if (entry_index_directory_valid (&it->second, entry_index_path (basedir, directory)) == 0)
+        return DISIR_STATUS_NO_CAN_DO;
+
+    // The target of a symbolic link may change without modifying its directory.
+    if (index->ei_links.count (entry))
+        return DISIR_STATUS_NO_CAN_DO;
+
+    if (index->ei_entries.count (entry))
+        return DISIR_STATUS_EXISTS;
+
+    return DISIR_STATUS_NOT_EXIST;
+}
+
+//! INTERNAL API
+void
+dx_entry_index_clear (struct disir_instance *instance)
+{
+    if (instance == NULL)
+        return;
+
+    pthread_mutex_lock (&instance->dio_entry_index_mutex);
+    delete instance->dio_entry_index;
+    instance->dio_entry_index = NULL;
+    pthread_mutex_unlock (&instance->dio_entry_index_mutex);
+}
@@ -10,9 +10,53 @@
 
 // private
 #include "disir_private.h"
+#include "mqueue.h"
 #include "log.h"
 
 
+//! INTERNAL API
+struct disir_error_slot *
+dx_error_slot (struct disir_instance *instance, int create)
+{
+    struct disir_error_slot *slot;
+
+    slot = pthread_getspecific (instance->disir_error_key);
+    if (slot != NULL || create == 0)
+        return slot;
+
+    slot = calloc (1, sizeof (struct disir_error_slot));
+    if (slot == NULL)
+        return NULL;
+
+    if (pthread_setspecific (instance->disir_error_key, slot) != 0)
+    {
+        free (slot);
+        return NULL;
+    }
+
+    pthread_mutex_lock (&instance->disir_error_mutex);
+    MQ_ENQUEUE (instance->disir_error_slots, slot);
+    pthread_mutex_unlock (&instance->disir_error_mutex);
+
+    return slot;
+}
+
+//! INTERNAL API
+void
+dx_error_slots_destroy (struct disir_instance *instance)
+{
+    struct disir_error_slot *slot;
+
+    pthread_mutex_lock (&instance->disir_error_mutex);
+    while ((slot = MQ_POP (instance->disir_error_slots)))
+    {
+        free (slot->es_message);
+        free (slot);
+    }
+    pthread_mutex_unlock (&instance->disir_error_mutex);
+}
+
+
 //! PUBLIC API
 void
 disir_log_user (struct disir_instance *instance, const char *message, ...)
@@ -47,11 +91,14 @@ disir_error_set (struct disir_instance *instance, const char *message, ...)
 void
 disir_error_clear (struct disir_instance *instance)
 {
-    if (instance->disir_error_message_size != 0)
+    struct disir_error_slot *slot;
+
+    slot = dx_error_slot (instance, 0);
+    if (slot && slot->es_message_size != 0)
     {
-        instance->disir_error_message_size = 0;
-        free (instance->disir_error_message);
-        instance->disir_error_message = NULL;
+        slot->es_message_size = 0;
+        free (slot->es_message);
+        slot->es_message = NULL;
     }
 }
 
@@ -61,6 +108,8 @@ disir_error_copy (struct disir_instance *instance,
                   char *buffer, int32_t buffer_size, int32_t *bytes_written)
 {
     enum disir_status status;
+    struct disir_error_slot *slot;
+    const char *message;
     int32_t size;
 
     if (instance == NULL || buffer == NULL)
@@ -75,7 +124,9 @@ disir_error_copy (struct disir_instance *instance,
         return DISIR_STATUS_INSUFFICIENT_RESOURCES;
     }
 
-    size = instance->disir_error_message_size;
+    slot = dx_error_slot (instance, 0);
+    message = (slot ? slot->es_message : NULL);
+    size = (slot ? slot->es_message_size : 0);
     if (bytes_written)
     {
         // Write the total size of the error message
@@ -89,7 +140,7 @@ disir_error_copy (struct disir_instance *instance,
         status = DISIR_STATUS_INSUFFICIENT_RESOURCES;
     }
 
-    memcpy (buffer, instance->disir_error_message, size);
+    memcpy (buffer, message, size);
     if (status == DISIR_STATUS_INSUFFICIENT_RESOURCES)
     {
         sprintf (buffer + size, "...");
@@ -104,6 +155,9 @@ disir_error_copy (struct disir_instance *instance,
 const char *
 disir_error (struct disir_instance *instance)
 {
-    return instance->disir_error_message;
+    struct disir_error_slot *slot;
+
+    slot = dx_error_slot (instance, 0);
+    return (slot ? slot->es_message : NULL);
 }
 
@@ -3,6 +3,13 @@
 #include <disir/fslib/util.h>
 #include <disir/fslib/json.h>
 
+// private
+extern "C" {
+#include "mold_cache.h"
+}
+
+#include <string.h>
+
 
 //! PLUGIN API
 enum disir_status
@@ -10,8 +17,8 @@ dio_json_config_read (struct disir_instance *instance,
                       struct disir_register_plugin *plugin, const char *entry_id,
                       struct disir_mold *mold, struct disir_config **config)
 {
-    return fslib_plugin_config_read (instance, plugin, entry_id, mold,
-                                     config, dio_json_unserialize_config);
+    return fslib_plugin_config_read_mapped (instance, plugin, entry_id, mold,
+                                            config, dio_json_unserialize_config_span);
 }
 
 //! PLUGIN API
@@ -40,6 +47,14 @@ dio_json_config_fd_read (struct disir_instance *instance, FILE *in,
     return dio_json_unserialize_config (instance, in, mold, config);
 }
 
+//! PLUGIN API
+enum disir_status
+dio_json_config_span_read (struct disir_instance *instance, const char *data, size_t size,
+                           struct disir_mold *mold, struct disir_config **config)
+{
+    return dio_json_unserialize_config_span (instance, data, size, mold, config);
+}
+
 //! PLUGIN API
 enum disir_status
 dio_json_config_entries (struct disir_instance *instance,
@@ -67,9 +82,13 @@ dio_json_mold_read (struct disir_instance *instance,
 {
     enum disir_status status;
     char filepath_mold[4096];
+    char filepath_namespace[4096];
+    const char *namespace_dependency;
     struct stat statbuf;
     int namespace_entry;
 
+    namespace_entry = 0;
+
     status = fslib_mold_resolve_entry_id (instance, plugin, entry_id,
                                           filepath_mold, &statbuf, &namespace_entry);
     if (status != DISIR_STATUS_OK)
@@ -77,8 +96,24 @@ dio_json_mold_read (struct disir_instance *instance,
         return status;
     }
 
+    namespace_dependency = dx_mold_cache_namespace_filepath (plugin, filepath_mold,
+                                                             namespace_entry, filepath_namespace,
+                                                             sizeof (filepath_namespace));
+
+    // Molds are frequently shared between config entries through namespace entries.
+    status = dx_mold_cache_lookup (instance, plugin, filepath_mold, namespace_dependency, mold);
+    if (status == DISIR_STATUS_OK)
+    {
+        return status;
+    }
+
     status = dio_json_unserialize_mold_filepath (instance, filepath_mold, mold);
-    if (status == DISIR_STATUS_MOLD_MISSING)
+    if (status == DISIR_STATUS_OK)
+    {
+        // Failing to cache only costs us reading the mold again.
+        dx_mold_cache_insert (instance, plugin, filepath_mold, namespace_dependency, *mold);
+    }
+    else if (status == DISIR_STATUS_MOLD_MISSING)
     {
         // Overwrites error set in callee function
         disir_error_set (instance,
@@ -18,10 +18,9 @@ dio_json_serialize_config (struct disir_instance *instance,
 
     try
     {
-        boost::fdostream file(fileno(output));
-        dio::ConfigWriter writer (NULL);
+        dio::ConfigWriter writer (instance);
 
-         return writer.serialize (config, file);
+        return writer.serialize (config, output);
     }
     catch (std::exception& e)
     {
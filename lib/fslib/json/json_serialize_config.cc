@@ -5,17 +5,30 @@
 #include <disir/disir.h>
 
 // standard
+#include <algorithm>
 #include <iostream>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string>
+#include <unordered_map>
 
 using namespace dio;
 
+//! Buffered output is written to the stream or file once it grows past this size.
+#define CONFIG_WRITER_FLUSH_SIZE (64 * 1024)
+
+//! Width and indentation of Json::StyledWriter
+#define CONFIG_WRITER_RIGHT_MARGIN 74
+#define CONFIG_WRITER_INDENT "   "
+
 ConfigWriter::ConfigWriter (struct disir_instance *disir)
     : JsonIO (disir)
 {
     m_contextConfig = NULL;
+    m_output = &m_buffer;
+    m_stream = NULL;
+    m_file = NULL;
+    m_last = 0;
 }
 
 ConfigWriter::~ConfigWriter ()
@@ -30,44 +43,58 @@ enum disir_status
 ConfigWriter::serialize (struct disir_config *config, std::ostream& stream)
 {
     enum disir_status status;
-    Json::StyledWriter writer;
-    std::string outputJson;
 
-    status = DISIR_STATUS_OK;
+    m_stream = &stream;
+    status = serialize_document (config);
+    m_stream = NULL;
 
-    // Retrieving the config's context object
-    m_contextConfig = dc_config_getcontext (config);
-    if (m_contextConfig == NULL )
-    {
-        disir_error_set (m_disir, "could not retrieve cconfig context object");
-        return DISIR_STATUS_INTERNAL_ERROR;
-    }
+    return status;
+}
 
-    status = set_config_version (m_contextConfig, m_configRoot);
-    if (status != DISIR_STATUS_OK)
+enum disir_status
+ConfigWriter::serialize (struct disir_config *config, FILE *file)
+{
+    enum disir_status status;
+
+    m_file = file;
+    status = serialize_document (config);
+    m_file = NULL;
+
+    // Callers may read back the underlying descriptor before closing the file.
+    if (status == DISIR_STATUS_OK && fflush (file) != 0)
     {
-        goto end;
+        disir_error_set (m_disir, "failed to flush serialized config to file");
+        status = DISIR_STATUS_FS_ERROR;
     }
 
-    status = _serialize_context (m_contextConfig, m_configRoot[ATTRIBUTE_KEY_CONFIG]);
-    if (status != DISIR_STATUS_OK)
+    return status;
+}
+
+enum disir_status
+ConfigWriter::serialize (struct disir_config *config, std::string& output)
+{
+    enum disir_status status;
+
+    status = serialize_document (config);
+    if (status == DISIR_STATUS_OK)
     {
-        goto end;
+        output.swap (m_buffer);
     }
+    m_buffer.clear ();
 
-    stream << writer.writeOrdered (m_configRoot);
-
-end:
-    dc_putcontext (&m_contextConfig);
     return status;
 }
 
 enum disir_status
-ConfigWriter::serialize (struct disir_config *config, std::string& output)
+ConfigWriter::serialize_document (struct disir_config *config)
 {
     enum disir_status status;
-    Json::StyledWriter writer;
-    std::string outputJson;
+    std::vector<struct element_group> groups;
+
+    m_buffer.clear ();
+    m_output = &m_buffer;
+    m_indent.clear ();
+    m_last = 0;
 
     // Retrieving the config's context object
     m_contextConfig = dc_config_getcontext (config);
@@ -77,28 +104,113 @@ ConfigWriter::serialize (struct disir_config *config, std::string& output)
         return DISIR_STATUS_INTERNAL_ERROR;
     }
 
-    status = set_config_version (m_contextConfig, m_configRoot);
+    write_with_indent ("{");
+    m_indent += CONFIG_WRITER_INDENT;
+
+    status = write_config_version (m_contextConfig);
     if (status != DISIR_STATUS_OK)
     {
         goto end;
     }
 
-    status = _serialize_context (m_contextConfig, m_configRoot[ATTRIBUTE_KEY_CONFIG]);
+    push (",", 1);
+    write_with_indent ("\"" ATTRIBUTE_KEY_CONFIG "\"");
+    push (" : ", 3);
+
+    status = collect_groups (m_contextConfig, groups);
     if (status != DISIR_STATUS_OK)
     {
         goto end;
     }
 
-    output = writer.writeOrdered (m_configRoot);
+    if (groups.empty ())
+    {
+        push ("null", 4);
+    }
+    else
+    {
+        status = write_object (groups, true);
+        if (status != DISIR_STATUS_OK)
+        {
+            goto end;
+        }
+    }
+
+    m_indent.clear ();
+    write_with_indent ("}");
+    push ("\n", 1);
 
+    status = flush ();
 
 end:
+    release_groups (groups);
     dc_putcontext (&m_contextConfig);
     return status;
 }
 
 enum disir_status
-ConfigWriter::set_config_version (struct disir_context *context_config, Json::Value& root)
+ConfigWriter::flush ()
+{
+    if (m_buffer.empty ())
+        return DISIR_STATUS_OK;
+
+    if (m_stream)
+    {
+        m_stream->write (m_buffer.data (), m_buffer.size ());
+        if (m_stream->fail ())
+        {
+            disir_error_set (m_disir, "failed to write serialized config to stream");
+            return DISIR_STATUS_FS_ERROR;
+        }
+        m_buffer.clear ();
+    }
+    else if (m_file)
+    {
+        if (fwrite (m_buffer.data (), 1, m_buffer.size (), m_file) != m_buffer.size ())
+        {
+            disir_error_set (m_disir, "failed to write serialized config to file");
+            return DISIR_STATUS_FS_ERROR;
+        }
+        m_buffer.clear ();
+    }
+
+    return DISIR_STATUS_OK;
+}
+
+void
+ConfigWriter::push (const char *token, size_t size)
+{
+    if (size == 0)
+        return;
+
+    m_output->append (token, size);
+    m_last = token[size - 1];
+}
+
+void
+ConfigWriter::write_indent ()
+{
+    if (m_last == ' ')
+    {
+        // Already awaiting a value on the current line
+        return;
+    }
+    if (m_last != 0 && m_last != '\n')
+    {
+        push ("\n", 1);
+    }
+    push (m_indent);
+}
+
+void
+ConfigWriter::write_with_indent (const std::string& token)
+{
+    write_indent ();
+    push (token);
+}
+
+enum disir_status
+ConfigWriter::write_config_version (struct disir_context *context_config)
 {
     struct disir_version version;
     enum disir_status status;
@@ -120,78 +232,132 @@ ConfigWriter::set_config_version (struct disir_context *context_config, Json::Va
         return DISIR_STATUS_INTERNAL_ERROR;
     }
 
-    root[ATTRIBUTE_KEY_VERSION] = buf;
+    write_with_indent ("\"" ATTRIBUTE_KEY_VERSION "\"");
+    push (" : ", 3);
+    push (Json::valueToQuotedString (buf));
 
     return status;
 }
 
-// Mapping child node (section) to key (section name)
 enum disir_status
-ConfigWriter::set_section_keyname (struct disir_context *context, Json::Value& parent,
-                                   Json::Value& sectionVal)
+ConfigWriter::get_context_key (struct disir_context *context, std::string& key)
 {
-    std::string name;
+    const char *name;
+    int32_t size;
     enum disir_status status;
 
-    status = get_context_key (context, name);
-    if (status != DISIR_STATUS_OK)
-    {
-        // logged
+    status = dc_get_name (context, &name, &size);
+    if (status != DISIR_STATUS_OK) {
+        // Should not happen
+        disir_error_set (m_disir, "Disir returned an error from dc_get_name: %s",
+                                   disir_status_string (status));
         return status;
     }
 
-    serialize_duplicate_entries (parent, sectionVal, name);
+    key = std::string (name, size);
 
     return status;
 }
 
 enum disir_status
-ConfigWriter::get_context_key (struct disir_context *context, std::string& key)
+ConfigWriter::collect_groups (struct disir_context *parent,
+                              std::vector<struct element_group>& groups)
 {
-    const char *name;
-    int32_t size;
+    struct disir_collection *collection;
+    struct disir_context *child_context;
     enum disir_status status;
+    std::unordered_map<std::string, size_t> index;
+    std::string name;
 
-    status = dc_get_name (context, &name, &size);
-    if (status != DISIR_STATUS_OK) {
-        // Should not happen
-        disir_error_set (m_disir, "Disir returned an error from dc_get_name: %s",
-                                   disir_status_string (status));
+    status = dc_get_elements (parent, &collection);
+    if (status != DISIR_STATUS_OK)
+    {
         return status;
     }
 
-    key = std::string (name, size);
+    while (dc_collection_next (collection, &child_context)
+           != DISIR_STATUS_EXHAUSTED)
+    {
+        if (dc_context_type (child_context) != DISIR_CONTEXT_SECTION
+            && dc_context_type (child_context) != DISIR_CONTEXT_KEYVAL)
+        {
+            dc_putcontext (&child_context);
+            continue;
+        }
+
+        status = get_context_key (child_context, name);
+        if (status != DISIR_STATUS_OK)
+        {
+            dc_putcontext (&child_context);
+            break;
+        }
+
+        // Elements sharing a name are serialized where the first of them is found.
+        auto found = index.emplace (name, groups.size ());
+        if (found.second)
+        {
+            groups.push_back (element_group ());
+            groups.back ().eg_name = name;
+        }
+        // The group holds the reference
+        groups[found.first->second].eg_elements.push_back (child_context);
+    }
+
+    dc_collection_finished (&collection);
 
     return status;
 }
 
 void
-ConfigWriter::serialize_duplicate_entries (Json::Value& parent,
-                                           Json::Value& child, const std::string name)
+ConfigWriter::release_groups (std::vector<struct element_group>& groups)
 {
-    Json::Value entries;
-
-    if (parent[name].isArray())
+    for (auto& group : groups)
     {
-        parent[name].append (child);
+        for (auto& element : group.eg_elements)
+        {
+            dc_putcontext (&element);
+        }
     }
-    else if (parent[name].isNull() == false)
+    groups.clear ();
+}
+
+bool
+ConfigWriter::is_null (struct disir_context *context)
+{
+    struct disir_collection *collection;
+    enum disir_value_type type;
+    int32_t size;
+
+    if (dc_context_type (context) == DISIR_CONTEXT_SECTION)
     {
-        entries = Json::arrayValue;
-        entries.append (parent[name]);
-        entries.append (child);
-        child = entries;
-        parent[name] = child;
+        if (dc_get_elements (context, &collection) != DISIR_STATUS_OK)
+            return true;
+
+        size = dc_collection_size (collection);
+        dc_collection_finished (&collection);
+        return (size == 0);
     }
-    else
+
+    if (dc_get_value_type (context, &type) != DISIR_STATUS_OK)
+        return false;
+
+    switch (type)
     {
-        parent[name] = child;
+    case DISIR_VALUE_TYPE_STRING:
+    case DISIR_VALUE_TYPE_INTEGER:
+    case DISIR_VALUE_TYPE_FLOAT:
+    case DISIR_VALUE_TYPE_BOOLEAN:
+    case DISIR_VALUE_TYPE_ENUM:
+    case DISIR_VALUE_TYPE_UNKNOWN:
+        return false;
+    default:
+        return true;
     }
 }
 
 // Wraps libdisir dc_get_value to handle arbitrary value sizes
 enum disir_status
-ConfigWriter::set_keyval (struct disir_context *context, std::string name, Json::Value& node)
+ConfigWriter::write_keyval (struct disir_context *context)
 {
     enum disir_status status;
     enum disir_value_type type;
@@ -200,8 +366,7 @@ ConfigWriter::set_keyval (struct disir_context *context, std::string name, Json:
     int64_t intval;
     const char *stringval;
     uint8_t boolval;
-    std::string buf;
-    Json::Value keyval;
+    std::string name;
 
     status = dc_get_value_type (context, &type);
     if (status != DISIR_STATUS_OK)
@@ -219,7 +384,7 @@ ConfigWriter::set_keyval (struct disir_context *context, std::string name, Json:
                 goto error;
             }
 
-            keyval = stringval;
+            push (Json::valueToQuotedString (stringval));
             break;
         case DISIR_VALUE_TYPE_INTEGER:
             status = dc_get_value_integer (context, &intval);
@@ -228,7 +393,7 @@ ConfigWriter::set_keyval (struct disir_context *context, std::string name, Json:
                 goto error;
             }
 
-            keyval = (Json::Int64)intval;
+            push (Json::valueToString ((Json::LargestInt)intval));
             break;
         case DISIR_VALUE_TYPE_FLOAT:
             status = dc_get_value_float (context, &floatval);
@@ -237,7 +402,7 @@ ConfigWriter::set_keyval (struct disir_context *context, std::string name, Json:
                 goto error;
             }
 
-            keyval = floatval;
+            push (Json::valueToString (floatval));
             break;
         case DISIR_VALUE_TYPE_BOOLEAN:
             status = dc_get_value_boolean (context, &boolval);
@@ -246,7 +411,7 @@ ConfigWriter::set_keyval (struct disir_context *context, std::string name, Json:
                 goto error;
             }
 
-            keyval = !!boolval;
+            push (Json::valueToString (!!boolval));
             break;
         case DISIR_VALUE_TYPE_ENUM:
             status = dc_get_value_enum (context, &stringval, NULL);
@@ -254,104 +419,233 @@ ConfigWriter::set_keyval (struct disir_context *context, std::string name, Json:
             {
                 goto error;
             }
-            keyval = stringval;
+            push (Json::valueToQuotedString (stringval));
             break;
         case DISIR_VALUE_TYPE_UNKNOWN:
             // If type is not know, we mark it
             // as unkwnown
-            keyval = dc_value_type_string (context);
+            push (Json::valueToQuotedString (dc_value_type_string (context)));
             break;
         default:
             // HUH? Type not supported?
             disir_error_set (m_disir, "Got an unsupported disir value type: %s",
                                        dc_value_type_string (context));
+            push ("null", 4);
             break;
     }
 
-    serialize_duplicate_entries (node, keyval, name);
-
     return status;
 error:
+    get_context_key (context, name);
     disir_error_set (m_disir, "Unable to fetch value from keyval with name: %s and type %s",
                                name.c_str(), dc_value_type_string (context));
     return status;
 }
 
 enum disir_status
-ConfigWriter::serialize_keyval (struct disir_context *context, Json::Value& node)
+ConfigWriter::write_value (struct disir_context *context, bool ordered)
 {
     enum disir_status status;
-    std::string name;
-    status = get_context_key (context, name);
-    if (status != DISIR_STATUS_OK)
+    std::vector<struct element_group> groups;
+
+    if (dc_context_type (context) == DISIR_CONTEXT_KEYVAL)
     {
-       return status;
+        return write_keyval (context);
     }
 
-    return set_keyval (context, name, node);
+    status = collect_groups (context, groups);
+    if (status == DISIR_STATUS_OK)
+    {
+        if (groups.empty ())
+        {
+            // Empty sections are serialized as null
+            push ("null", 4);
+        }
+        else
+        {
+            status = write_object (groups, ordered);
+        }
+    }
+
+    release_groups (groups);
+
+    // Flush in between sections, keeping the buffer bounded
+    if (status == DISIR_STATUS_OK && m_output == &m_buffer
+        && m_buffer.size () >= CONFIG_WRITER_FLUSH_SIZE)
+    {
+        status = flush ();
+    }
+
+    return status;
 }
 
 enum disir_status
-ConfigWriter::_serialize_context (struct disir_context *parent_context, Json::Value& parent)
+ConfigWriter::write_object (std::vector<struct element_group>& groups, bool ordered)
 {
-    struct disir_collection *collection;
-    struct disir_context *child_context;
     enum disir_status status;
+    std::vector<struct element_group *> members;
 
-    status = dc_get_elements (parent_context, &collection);
-    if (status != DISIR_STATUS_OK)
+    for (auto& group : groups)
     {
-        goto end;
+        members.push_back (&group);
     }
+    if (ordered == false)
+    {
+        std::sort (members.begin (), members.end (),
+                   [] (const struct element_group *a, const struct element_group *b) {
+                       return a->eg_name < b->eg_name;
+                   });
+    }
+
+    write_with_indent ("{");
+    m_indent += CONFIG_WRITER_INDENT;
 
     status = DISIR_STATUS_OK;
+    for (auto it = members.begin (); it != members.end (); ++it)
+    {
+        if (it != members.begin ())
+        {
+            push (",", 1);
+        }
 
-    while (dc_collection_next (collection, &child_context)
-           != DISIR_STATUS_EXHAUSTED)
+        write_with_indent (Json::valueToQuotedString ((*it)->eg_name.c_str ()));
+        push (" : ", 3);
+
+        status = write_group (**it, ordered);
+        if (status != DISIR_STATUS_OK)
+        {
+            return status;
+        }
+    }
+
+    m_indent.resize (m_indent.size () - (sizeof (CONFIG_WRITER_INDENT) - 1));
+    write_with_indent ("}");
+
+    return status;
+}
+
+enum disir_status
+ConfigWriter::write_group (struct element_group& group, bool ordered)
+{
+    std::vector<struct disir_context *> elements;
+    bool array;
+
+    // Fold the elements the way they were merged into a json document:
+    // a second non-null value turns the entry into an array, which later
+    // elements are appended to. A null entry is replaced by the next element.
+    array = false;
+    for (auto element : group.eg_elements)
     {
-        // per-iteration such that child values
-        // never have old references to pre-marshaled
-        // context objects
-        Json::Value child;
+        if (array)
+        {
+            elements.push_back (element);
+        }
+        else if (elements.empty () == false && is_null (elements.back ()) == false)
+        {
+            elements.push_back (element);
+            array = true;
+        }
+        else
+        {
+            elements.assign (1, element);
+        }
+    }
 
-        switch (dc_context_type (child_context))
+    if (array)
+    {
+        return write_array (elements);
+    }
+
+    return write_value (elements.front (), ordered);
+}
+
+enum disir_status
+ConfigWriter::write_array (std::vector<struct disir_context *>& elements)
+{
+    enum disir_status status;
+    std::vector<std::string> tokens;
+    std::string *output;
+    size_t length;
+    bool multiline;
+    char last;
+
+    multiline = (elements.size () * 3 >= CONFIG_WRITER_RIGHT_MARGIN);
+    for (auto element : elements)
+    {
+        if (multiline)
+            break;
+        multiline = (dc_context_type (element) == DISIR_CONTEXT_SECTION
+                     && is_null (element) == false);
+    }
+
+    status = DISIR_STATUS_OK;
+    if (multiline == false)
+    {
+        // Every element is a single token. Render them up front to measure the line.
+        output = m_output;
+        last = m_last;
+        length = 4 + (elements.size () - 1) * 2;
+        for (auto element : elements)
         {
-            case DISIR_CONTEXT_SECTION:
-
-                status = _serialize_context (child_context, child);
-                if (status != DISIR_STATUS_OK)
-                {
-                    goto end;
-                }
-
-                status = set_section_keyname (child_context, parent, child);
-                if (status != DISIR_STATUS_OK)
-                {
-                    // logged
-                    return status;
-                }
-                break;
-            case DISIR_CONTEXT_KEYVAL:
-                status = serialize_keyval (child_context, parent);
-                if (status != DISIR_STATUS_OK)
-                {
-                    goto end;
-                }
-                break;
-            default:
+            tokens.push_back (std::string ());
+            m_output = &tokens.back ();
+            status = write_value (element, false);
+            if (status != DISIR_STATUS_OK)
                 break;
+            length += tokens.back ().size ();
+        }
+        m_output = output;
+        m_last = last;
+        if (status != DISIR_STATUS_OK)
+        {
+            return status;
         }
-        dc_putcontext (&child_context);
+
+        multiline = (length >= CONFIG_WRITER_RIGHT_MARGIN);
     }
 
-end:
-    if (child_context)
+    if (multiline == false)
     {
-        dc_putcontext (&child_context);
+        push ("[ ", 2);
+        for (auto it = tokens.begin (); it != tokens.end (); ++it)
+        {
+            if (it != tokens.begin ())
+            {
+                push (", ", 2);
+            }
+            push (*it);
+        }
+        push (" ]", 2);
+        return status;
     }
 
-    dc_collection_finished (&collection);
+    write_with_indent ("[");
+    m_indent += CONFIG_WRITER_INDENT;
+
+    for (size_t i = 0; i < elements.size (); i++)
+    {
+        if (i > 0)
+        {
+            push (",", 1);
+        }
+
+        if (tokens.empty () == false)
+        {
+            write_with_indent (tokens[i]);
+        }
+        else
+        {
+            write_indent ();
+            status = write_value (elements[i], false);
+            if (status != DISIR_STATUS_OK)
+            {
+                return status;
+            }
+        }
+    }
+
+    m_indent.resize (m_indent.size () - (sizeof (CONFIG_WRITER_INDENT) - 1));
+    write_with_indent ("]");
 
     return status;
 }
-
@@ -0,0 +1,668 @@
+// JSON private
+#include "json/json_stream.h"
+
+// standard
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+using namespace dio;
+
+//! Same nesting limit as the jsoncpp Reader
+#define JSON_STREAM_DEPTH_LIMIT 1000
+
+//! Bytes read from the stream buffer at a time
+#define JSON_STREAM_CHUNK_SIZE 65536
+
+//! STATIC API
+static void
+append_utf8 (std::string& out, unsigned int cp)
+{
+    if (cp <= 0x7f)
+    {
+        out += static_cast<char> (cp);
+    }
+    else if (cp <= 0x7ff)
+    {
+        out += static_cast<char> (0xc0 | (cp >> 6));
+        out += static_cast<char> (0x80 | (cp & 0x3f));
+    }
+    else if (cp <= 0xffff)
+    {
+        out += static_cast<char> (0xe0 | (cp >> 12));
+        out += static_cast<char> (0x80 | ((cp >> 6) & 0x3f));
+        out += static_cast<char> (0x80 | (cp & 0x3f));
+    }
+    else if (cp <= 0x10ffff)
+    {
+        out += static_cast<char> (0xf0 | (cp >> 18));
+        out += static_cast<char> (0x80 | ((cp >> 12) & 0x3f));
+        out += static_cast<char> (0x80 | ((cp >> 6) & 0x3f));
+        out += static_cast<char> (0x80 | (cp & 0x3f));
+    }
+}
+
+JsonTokenizer::JsonTokenizer (std::istream& stream)
+{
+    m_buf = stream.rdbuf ();
+    m_chunk.resize (JSON_STREAM_CHUNK_SIZE);
+    m_cur = m_end = m_chunk.data ();
+    initialize ();
+}
+
+JsonTokenizer::JsonTokenizer (const char *data, size_t size)
+{
+    m_buf = NULL;
+    m_cur = data;
+    m_end = data + size;
+    initialize ();
+}
+
+//! PRIVATE
+void
+JsonTokenizer::initialize ()
+{
+    m_integer = 0;
+    m_real = 0;
+    m_failed = false;
+    m_depth = 0;
+    m_line = 1;
+    m_column = 1;
+    m_token_line = 1;
+    m_token_column = 1;
+}
+
+//! PRIVATE
+bool
+JsonTokenizer::refill ()
+{
+    std::streamsize count;
+
+    // Reading from a span; there is nothing more.
+    if (m_buf == NULL)
+        return false;
+
+    count = m_buf->sgetn (m_chunk.data (), m_chunk.size ());
+    if (count <= 0)
+        return false;
+
+    m_cur = m_chunk.data ();
+    m_end = m_cur + count;
+    return true;
+}
+
+//! PRIVATE
+int
+JsonTokenizer::peek ()
+{
+    if (m_cur == m_end && refill () == false)
+        return EOF;
+
+    return static_cast<unsigned char> (*m_cur);
+}
+
+//! PRIVATE
+int
+JsonTokenizer::get ()
+{
+    int c;
+
+    if (m_cur == m_end && refill () == false)
+        return EOF;
+
+    c = static_cast<unsigned char> (*m_cur++);
+    if (c == '\n')
+    {
+        m_line++;
+        m_column = 1;
+    }
+    else
+    {
+        m_column++;
+    }
+
+    return c;
+}
+
+//! PRIVATE
+bool
+JsonTokenizer::read_literal (const char *rest)
+{
+    for (; *rest != '\0'; rest++)
+    {
+        if (get () != *rest)
+            return false;
+    }
+    return true;
+}
+
+//! PRIVATE
+bool
+JsonTokenizer::read_comment ()
+{
+    int c;
+
+    c = get ();
+    if (c == '/')
+    {
+        // Line comment
+        do
+        {
+            c = get ();
+        } while (c != '\n' && c != '\r' && c != EOF);
+        return true;
+    }
+    else if (c == '*')
+    {
+        // Block comment
+        c = get ();
+        while (c != EOF)
+        {
+            if (c == '*' && peek () == '/')
+            {
+                get ();
+                return true;
+            }
+            c = get ();
+        }
+    }
+
+    return false;
+}
+
+//! PRIVATE
+bool
+JsonTokenizer::read_hex (unsigned int& unicode)
+{
+    int c;
+    int i;
+
+    unicode = 0;
+    for (i = 0; i < 4; i++)
+    {
+        c = get ();
+        unicode <<= 4;
+        if (c >= '0' && c <= '9')
+            unicode += c - '0';
+        else if (c >= 'a' && c <= 'f')
+            unicode += c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            unicode += c - 'A' + 10;
+        else
+        {
+            syntax_error ("Bad unicode escape sequence in string: "
+                          "hexadecimal digit expected.");
+            return false;
+        }
+    }
+    return true;
+}
+
+//! PRIVATE
+bool
+JsonTokenizer::read_string ()
+{
+    unsigned int unicode;
+    unsigned int surrogate;
+    const char *run;
+    int c;
+
+    m_string.clear ();
+
+    while (1)
+    {
+        // Copy runs without escapes or line breaks in one go.
+        run = m_cur;
+        while (run != m_end && *run != '"' && *run != '\\' && *run != '\n')
+            run++;
+        if (run != m_cur)
+        {
+            m_string.append (m_cur, run - m_cur);
+            m_column += run - m_cur;
+            m_cur = run;
+        }
+
+        c = get ();
+        if (c == '"')
+            return true;
+        if (c == EOF)
+        {
+            syntax_error ("Missing '\"' at end of string");
+            return false;
+        }
+        if (c != '\\')
+        {
+            m_string += static_cast<char> (c);
+            continue;
+        }
+
+        c = get ();
+        switch (c)
+        {
+        case '"':
+        case '/':
+        case '\\':
+            m_string += static_cast<char> (c);
+            break;
+        case 'b':
+            m_string += '\b';
+            break;
+        case 'f':
+            m_string += '\f';
+            break;
+        case 'n':
+            m_string += '\n';
+            break;
+        case 'r':
+            m_string += '\r';
+            break;
+        case 't':
+            m_string += '\t';
+            break;
+        case 'u':
+            if (!read_hex (unicode))
+                return false;
+            if (unicode >= 0xd800 && unicode <= 0xdbff)
+            {
+                if (get () != '\\' || get () != 'u')
+                {
+                    syntax_error ("expecting another \\u token to begin the second half of "
+                                  "a unicode surrogate pair");
+                    return false;
+                }
+                if (!read_hex (surrogate))
+                    return false;
+                unicode = 0x10000 + ((unicode & 0x3ff) << 10) + (surrogate & 0x3ff);
+            }
+            append_utf8 (m_string, unicode);
+            break;
+        default:
+            syntax_error ("Bad escape sequence in string");
+            return false;
+        }
+    }
+}
+
+//! PRIVATE
+enum json_token
+JsonTokenizer::read_number (int first)
+{
+    const char *start;
+    const char *current;
+    char *endptr;
+    uint64_t value;
+    uint64_t limit;
+    bool negative;
+    bool integral;
+    int c;
+
+    m_string.assign (1, static_cast<char> (first));
+    integral = true;
+
+    // Same grammar as the jsoncpp Reader; validated when decoded.
+    c = peek ();
+    while (c >= '0' && c <= '9')
+    {
+        m_string += static_cast<char> (get ());
+        c = peek ();
+    }
+    if (c == '.')
+    {
+        integral = false;
+        m_string += static_cast<char> (get ());
+        c = peek ();
+        while (c >= '0' && c <= '9')
+        {
+            m_string += static_cast<char> (get ());
+            c = peek ();
+        }
+    }
+    if (c == 'e' || c == 'E')
+    {
+        integral = false;
+        m_string += static_cast<char> (get ());
+        c = peek ();
+        if (c == '+' || c == '-')
+        {
+            m_string += static_cast<char> (get ());
+            c = peek ();
+        }
+        while (c >= '0' && c <= '9')
+        {
+            m_string += static_cast<char> (get ());
+            c = peek ();
+        }
+    }
+
+    start = m_string.c_str ();
+    negative = (*start == '-');
+    current = negative ? start + 1 : start;
+
+    if (integral && *current != '\0')
+    {
+        limit = negative ? (uint64_t) INT64_MAX + 1 : (uint64_t) INT64_MAX;
+        value = 0;
+        for (; *current != '\0'; current++)
+        {
+            if (value > (limit - (*current - '0')) / 10)
+                break;
+            value = value * 10 + (*current - '0');
+        }
+
+        // Integers that do not fit are decoded as real numbers below.
+        if (*current == '\0')
+        {
+            if (negative)
+                m_integer = (value == limit) ? INT64_MIN : -(int64_t) value;
+            else
+                m_integer = (int64_t) value;
+            return JSON_TOKEN_INTEGER;
+        }
+    }
+
+    m_real = strtod (start, &endptr);
+    if (endptr == start || *endptr != '\0')
+    {
+        return syntax_error ("'" + m_string + "' is not a number.");
+    }
+
+    return JSON_TOKEN_REAL;
+}
+
+//! PUBLIC
+enum json_token
+JsonTokenizer::syntax_error (const std::string& message)
+{
+    // Only the first error is of interest
+    if (m_failed == false)
+    {
+        std::ostringstream formatted;
+
+        formatted << "* Line " << m_token_line << ", Column " << m_token_column << "\n"
+                  << "  " << message << "\n";
+        m_error = formatted.str ();
+        m_failed = true;
+    }
+
+    return JSON_TOKEN_ERROR;
+}
+
+//! PUBLIC
+std::string
+JsonTokenizer::error_message () const
+{
+    return m_error;
+}
+
+//! PUBLIC
+enum json_token
+JsonTokenizer::next ()
+{
+    int c;
+
+    if (m_failed)
+        return JSON_TOKEN_ERROR;
+
+    while (1)
+    {
+        // Skip whitespace
+        c = peek ();
+        while (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+        {
+            get ();
+            c = peek ();
+        }
+
+        m_token_line = m_line;
+        m_token_column = m_column;
+
+        c = get ();
+        switch (c)
+        {
+        case '{':
+        case '[':
+            if (++m_depth > JSON_STREAM_DEPTH_LIMIT)
+                return syntax_error ("Exceeded nesting depth limit");
+            return (c == '{') ? JSON_TOKEN_OBJECT_BEGIN : JSON_TOKEN_ARRAY_BEGIN;
+        case '}':
+            m_depth--;
+            return JSON_TOKEN_OBJECT_END;
+        case ']':
+            m_depth--;
+            return JSON_TOKEN_ARRAY_END;
+        case ':':
+            return JSON_TOKEN_MEMBER_SEPARATOR;
+        case ',':
+            return JSON_TOKEN_VALUE_SEPARATOR;
+        case '"':
+            return read_string () ? JSON_TOKEN_STRING : JSON_TOKEN_ERROR;
+        case '/':
+            if (read_comment () == false)
+                return syntax_error ("Syntax error: malformed comment.");
+            continue;
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            return read_number (c);
+        case 't':
+            if (read_literal ("rue"))
+                return JSON_TOKEN_TRUE;
+            break;
+        case 'f':
+            if (read_literal ("alse"))
+                return JSON_TOKEN_FALSE;
+            break;
+        case 'n':
+            if (read_literal ("ull"))
+                return JSON_TOKEN_NULL;
+            break;
+        default:
+            if (c == EOF)
+                return JSON_TOKEN_END;
+            break;
+        }
+
+        return syntax_error ("Syntax error: value, object or array expected.");
+    }
+}
+
+//! PUBLIC
+enum json_token
+JsonTokenizer::next_value ()
+{
+    enum json_token token;
+
+    token = next ();
+    switch (token)
+    {
+    case JSON_TOKEN_OBJECT_BEGIN:
+    case JSON_TOKEN_ARRAY_BEGIN:
+    case JSON_TOKEN_STRING:
+    case JSON_TOKEN_INTEGER:
+    case JSON_TOKEN_REAL:
+    case JSON_TOKEN_TRUE:
+    case JSON_TOKEN_FALSE:
+    case JSON_TOKEN_NULL:
+    case JSON_TOKEN_ERROR:
+        return token;
+    default:
+        return syntax_error ("Syntax error: value, object or array expected.");
+    }
+}
+
+//! PUBLIC
+enum json_token
+JsonTokenizer::next_member (bool first)
+{
+    enum json_token token;
+
+    token = next ();
+    if (token == JSON_TOKEN_OBJECT_END)
+        return token;
+
+    if (first == false)
+    {
+        if (token != JSON_TOKEN_VALUE_SEPARATOR)
+        {
+            if (token == JSON_TOKEN_ERROR)
+                return token;
+            return syntax_error ("Missing ',' or '}' in object declaration");
+        }
+        token = next ();
+    }
+
+    if (token != JSON_TOKEN_STRING)
+    {
+        if (token == JSON_TOKEN_ERROR)
+            return token;
+        return syntax_error ("Missing '}' or object member name");
+    }
+    m_key.swap (m_string);
+
+    token = next ();
+    if (token != JSON_TOKEN_MEMBER_SEPARATOR)
+    {
+        if (token == JSON_TOKEN_ERROR)
+            return token;
+        return syntax_error ("Missing ':' after object member name");
+    }
+
+    return next_value ();
+}
+
+//! PUBLIC
+enum json_token
+JsonTokenizer::next_element (bool first)
+{
+    enum json_token token;
+
+    if (first)
+    {
+        token = next ();
+        if (token == JSON_TOKEN_ARRAY_END)
+            return token;
+    }
+    else
+    {
+        token = next ();
+        if (token == JSON_TOKEN_ARRAY_END || token == JSON_TOKEN_ERROR)
+            return token;
+        if (token != JSON_TOKEN_VALUE_SEPARATOR)
+            return syntax_error ("Missing ',' or ']' in array declaration");
+        token = next ();
+    }
+
+    switch (token)
+    {
+    case JSON_TOKEN_OBJECT_BEGIN:
+    case JSON_TOKEN_ARRAY_BEGIN:
+    case JSON_TOKEN_STRING:
+    case JSON_TOKEN_INTEGER:
+    case JSON_TOKEN_REAL:
+    case JSON_TOKEN_TRUE:
+    case JSON_TOKEN_FALSE:
+    case JSON_TOKEN_NULL:
+    case JSON_TOKEN_ERROR:
+        return token;
+    default:
+        return syntax_error ("Syntax error: value, object or array expected.");
+    }
+}
+
+//! PUBLIC
+bool
+JsonTokenizer::skip_members (bool first)
+{
+    enum json_token token;
+
+    while ((token = next_member (first)) != JSON_TOKEN_OBJECT_END)
+    {
+        first = false;
+        if (skip_value (token) == false)
+            return false;
+    }
+
+    return true;
+}
+
+//! PUBLIC
+bool
+JsonTokenizer::skip_elements (bool first)
+{
+    enum json_token token;
+
+    while ((token = next_element (first)) != JSON_TOKEN_ARRAY_END)
+    {
+        first = false;
+        if (skip_value (token) == false)
+            return false;
+    }
+
+    return true;
+}
+
+//! PUBLIC
+bool
+JsonTokenizer::skip_value (enum json_token token)
+{
+    switch (token)
+    {
+    case JSON_TOKEN_OBJECT_BEGIN:
+        return skip_members (true);
+    case JSON_TOKEN_ARRAY_BEGIN:
+        return skip_elements (true);
+    case JSON_TOKEN_ERROR:
+        return false;
+    default:
+        return true;
+    }
+}
+
+//! PUBLIC
+bool
+JsonTokenizer::read_value (enum json_token token, Json::Value& value)
+{
+    bool first;
+
+    first = true;
+    switch (token)
+    {
+    case JSON_TOKEN_OBJECT_BEGIN:
+        value = Json::Value (Json::objectValue);
+        while ((token = next_member (first)) != JSON_TOKEN_OBJECT_END)
+        {
+            first = false;
+            if (read_value (token, value[m_key]) == false)
+                return false;
+        }
+        return true;
+    case JSON_TOKEN_ARRAY_BEGIN:
+        value = Json::Value (Json::arrayValue);
+        while ((token = next_element (first)) != JSON_TOKEN_ARRAY_END)
+        {
+            first = false;
+            if (read_value (token, value.append (Json::Value ())) == false)
+                return false;
+        }
+        return true;
+    case JSON_TOKEN_STRING:
+        value = Json::Value (m_string);
+        return true;
+    case JSON_TOKEN_INTEGER:
+        value = Json::Value (static_cast<Json::Int64> (m_integer));
+        return true;
+    case JSON_TOKEN_REAL:
+        value = Json::Value (m_real);
+        return true;
+    case JSON_TOKEN_TRUE:
+    case JSON_TOKEN_FALSE:
+        value = Json::Value (token == JSON_TOKEN_TRUE);
+        return true;
+    case JSON_TOKEN_NULL:
+        value = Json::Value ();
+        return true;
+    default:
+        return false;
+    }
+}
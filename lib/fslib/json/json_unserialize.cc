@@ -32,6 +32,25 @@ dio_json_unserialize_config (struct disir_instance *instance, FILE *input,
     return DISIR_STATUS_OK;
 }
 
+//! FSLIB API
+enum disir_status
+dio_json_unserialize_config_span (struct disir_instance *instance,
+                                  const char *data, size_t size,
+                                  struct disir_mold *mold, struct disir_config **config)
+{
+    try
+    {
+        dio::ConfigReader reader (instance, mold);
+
+        return reader.unserialize (config, data, size);
+    }
+    catch (std::exception& e)
+    {
+        disir_log_user (instance, "JSON: fatal exception in unserialize_config_span");
+        return DISIR_STATUS_INTERNAL_ERROR;
+    }
+}
+
 //! FSLIB API
 enum disir_status
 dio_json_unserialize_mold (struct disir_instance *instance,
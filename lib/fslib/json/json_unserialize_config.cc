@@ -26,47 +26,59 @@ ConfigReader::ConfigReader (struct disir_instance *disir, struct disir_mold *mol
 enum disir_status
 ConfigReader::unserialize (struct disir_config **config, std::istream& stream)
 {
-    Json::Reader reader;
-    Json::Value root;
+    JsonTokenizer tokens (stream);
 
-    bool success = reader.parse (stream, root);
-
-    if (!success)
-    {
-        disir_error_set (m_disir, "Parse error: %s",
-                                   reader.getFormattedErrorMessages ().c_str());
-        return DISIR_STATUS_FS_ERROR;
-    }
-
-    return construct_config (root, config);
+    return read_config (tokens, config);
 }
 
 //! PUBLIC
 enum disir_status
 ConfigReader::unserialize (struct disir_config **config, const std::string string)
 {
-    Json::Reader reader;
-    Json::Value root;
+    return unserialize (config, string.data (), string.size ());
+}
 
-    bool success = reader.parse (string, root);
-    if (!success)
-    {
-        disir_error_set (m_disir, "Parse error: %s",
-                                   reader.getFormattedErrorMessages ().c_str());
-        return DISIR_STATUS_FS_ERROR;
-    }
+//! PUBLIC
+enum disir_status
+ConfigReader::unserialize (struct disir_config **config, const char *data, size_t size)
+{
+    JsonTokenizer tokens (data, size);
 
-    return construct_config (root, config);
+    return read_config (tokens, config);
 }
 
+//! PRIVATE
+//!
+//! The config is built while the document is tokenized; only scalar values
+//! and a config object that precedes the version keyval are ever held in a
+//! Json::Value. The document is always consumed in full, such that a syntax
+//! error takes precedence over any other error, just like a parse up front.
+//!
 enum disir_status
-ConfigReader::construct_config (Json::Value& root, struct disir_config **config)
+ConfigReader::read_config (JsonTokenizer& tokens, struct disir_config **config)
 {
     enum disir_status status;
+    enum json_token token;
     struct disir_context *context_config = NULL;
+    Json::Value version;
+    Json::Value deferred;
+    bool version_applied = false;
+    bool config_read = false;
+    bool first = true;
 
     *config = NULL;
 
+    token = tokens.next_value ();
+    if (token == JSON_TOKEN_ERROR)
+    {
+        goto parse_error;
+    }
+    if (token != JSON_TOKEN_OBJECT_BEGIN)
+    {
+        tokens.syntax_error ("config document is not an object");
+        goto parse_error;
+    }
+
     status = dc_config_begin (m_mold, &context_config);
     if (status != DISIR_STATUS_OK)
     {
@@ -74,25 +86,99 @@ ConfigReader::construct_config (Json::Value& root, struct disir_config **config)
         goto error;
     }
 
-    status = set_config_version (context_config, root[VERSION]);
-    if (status != DISIR_STATUS_OK && status == DISIR_STATUS_INVALID_CONTEXT)
+    // The parsed tree is built in one go and discarded as a whole, if the user opts in.
+    // Regular allocations are used if the arena cannot be enabled.
+    if (disir_read_arena_enabled (m_disir))
     {
-       goto finalize;
+        dc_enable_arena (context_config);
     }
-    else if (status != DISIR_STATUS_OK && status != DISIR_STATUS_INVALID_CONTEXT)
+
+    while ((token = tokens.next_member (first)) != JSON_TOKEN_OBJECT_END)
     {
-        goto error;
+        first = false;
+        if (token == JSON_TOKEN_ERROR)
+            goto parse_error;
+
+        // A hard error is pending; only verify the remaining syntax.
+        if (status != DISIR_STATUS_OK)
+        {
+            if (tokens.skip_value (token) == false)
+                goto parse_error;
+            continue;
+        }
+
+        if (tokens.key () == VERSION && version_applied == false)
+        {
+            if (tokens.read_value (token, version) == false)
+                goto parse_error;
+            continue;
+        }
+
+        if (tokens.key () != ATTRIBUTE_KEY_CONFIG || config_read)
+        {
+            if (tokens.skip_value (token) == false)
+                goto parse_error;
+            continue;
+        }
+        config_read = true;
+
+        // The version decides how the config is read. If it has not been
+        // seen yet, hold on to the config until the whole document is read.
+        if (version.isNull ())
+        {
+            if (tokens.read_value (token, deferred) == false)
+                goto parse_error;
+            continue;
+        }
+
+        status = set_config_version (context_config, version);
+        version_applied = true;
+        if (status == DISIR_STATUS_OK && token != JSON_TOKEN_OBJECT_BEGIN)
+        {
+            dc_fatal_error (context_config, "config does not contain config element");
+        }
+        else if (status == DISIR_STATUS_OK)
+        {
+            status = stream_node (tokens, context_config);
+            if (tokens.failed ())
+                goto parse_error;
+            if (status == DISIR_STATUS_INVALID_CONTEXT)
+                status = DISIR_STATUS_OK;
+            continue;
+        }
+
+        if (status == DISIR_STATUS_INVALID_CONTEXT)
+            status = DISIR_STATUS_OK;
+        if (tokens.skip_value (token) == false)
+            goto parse_error;
     }
+    if (tokens.failed ())
+        goto parse_error;
+    if (status != DISIR_STATUS_OK)
+        goto error;
 
-    if (assert_json_value_type (root[ATTRIBUTE_KEY_CONFIG], Json::objectValue))
+    if (version_applied == false)
     {
-        dc_fatal_error (context_config, "config does not contain config element");
-        goto finalize;
-    }
+        status = set_config_version (context_config, version);
+        if (status != DISIR_STATUS_OK && status == DISIR_STATUS_INVALID_CONTEXT)
+        {
+           goto finalize;
+        }
+        else if (status != DISIR_STATUS_OK && status != DISIR_STATUS_INVALID_CONTEXT)
+        {
+            goto error;
+        }
 
-    status = _unserialize_node (context_config, root[ATTRIBUTE_KEY_CONFIG]);
-    if (status != DISIR_STATUS_OK && status != DISIR_STATUS_INVALID_CONTEXT)
-        goto error;
+        if (assert_json_value_type (deferred, Json::objectValue))
+        {
+            dc_fatal_error (context_config, "config does not contain config element");
+            goto finalize;
+        }
+
+        status = _unserialize_node (context_config, deferred);
+        if (status != DISIR_STATUS_OK && status != DISIR_STATUS_INVALID_CONTEXT)
+            goto error;
+    }
 
 finalize:
     status = dc_config_finalize (&context_config, config);
@@ -104,6 +190,10 @@ finalize:
     }
 
     return status;
+parse_error:
+    disir_error_set (m_disir, "Parse error: %s", tokens.error_message ().c_str ());
+    status = DISIR_STATUS_FS_ERROR;
+    // FALL-THROUGH
 error:
     if (context_config)
     {
@@ -344,3 +434,143 @@ ConfigReader::_unserialize_node (struct disir_context *parent_context, Json::Val
     return status;
 }
 
+
+//! PRIVATE
+enum disir_status
+ConfigReader::stream_node (JsonTokenizer& tokens, struct disir_context *parent_context)
+{
+    enum disir_status status;
+    enum json_token token;
+    std::string name;
+    bool first = true;
+
+    status = DISIR_STATUS_OK;
+
+    while ((token = tokens.next_member (first)) != JSON_TOKEN_OBJECT_END)
+    {
+        first = false;
+        if (token == JSON_TOKEN_ERROR)
+            return DISIR_STATUS_FS_ERROR;
+
+        name = tokens.key ();
+
+        status = stream_type (tokens, parent_context, token, name);
+        if (status != DISIR_STATUS_OK && status != DISIR_STATUS_INVALID_CONTEXT)
+        {
+            // Consume the rest of the object; the caller decides
+            // whether a syntax error or this status is reported.
+            tokens.skip_members (false);
+            return status;
+        }
+    }
+
+    return status;
+}
+
+//! PRIVATE
+enum disir_status
+ConfigReader::stream_array (JsonTokenizer& tokens, struct disir_context *parent,
+                            const std::string& name)
+{
+    enum disir_status status;
+    enum json_token token;
+    bool first = true;
+
+    while ((token = tokens.next_element (first)) != JSON_TOKEN_ARRAY_END)
+    {
+        first = false;
+        if (token == JSON_TOKEN_ERROR)
+            return DISIR_STATUS_FS_ERROR;
+
+        status = stream_type (tokens, parent, token, name);
+        if (status != DISIR_STATUS_OK && status != DISIR_STATUS_INVALID_CONTEXT)
+        {
+            tokens.skip_elements (false);
+            return status;
+        }
+    }
+
+    return DISIR_STATUS_OK;
+}
+
+//! PRIVATE
+enum disir_status
+ConfigReader::stream_type (JsonTokenizer& tokens, struct disir_context *context,
+                           enum json_token token, const std::string& name)
+{
+    struct disir_context *child_context = NULL;
+    enum disir_status status;
+    Json::Value value;
+
+    switch (token)
+    {
+    case JSON_TOKEN_OBJECT_BEGIN:
+        status = dc_begin (context, DISIR_CONTEXT_SECTION, &child_context);
+        if (status != DISIR_STATUS_OK)
+        {
+            // This error cannot pass, crash hard!
+            disir_log_user (m_disir, "could not start DISIR_CONTEXT_SECTION");
+            tokens.skip_value (token);
+            goto error;
+        }
+
+        status = dc_set_name (child_context, name.c_str (), name.size ());
+        if (status != DISIR_STATUS_OK &&
+            status != DISIR_STATUS_NOT_EXIST)
+        {
+            // THis is unexpected, crash hard!
+            disir_log_user (m_disir, "Could not set name (%s) : %s", name.c_str (),
+                                      disir_status_string (status));
+            tokens.skip_value (token);
+            goto error;
+        }
+
+        status = stream_node (tokens, child_context);
+        if (status != DISIR_STATUS_OK && status != DISIR_STATUS_INVALID_CONTEXT)
+        {
+            // logged
+            goto error;
+        }
+
+        status = dc_finalize (&child_context);
+        if (status != DISIR_STATUS_OK &&
+            status != DISIR_STATUS_INVALID_CONTEXT)
+        {
+            disir_log_user (m_disir, "Could not finalize context: %s",
+                                     disir_status_string (status));
+            goto error;
+        }
+
+        // If context is invalid we need to
+        // get rid of our reference to it.
+        if (status == DISIR_STATUS_INVALID_CONTEXT)
+        {
+            dc_putcontext (&child_context);
+        }
+        break;
+    case JSON_TOKEN_ARRAY_BEGIN:
+        status = stream_array (tokens, context, name);
+        break;
+    case JSON_TOKEN_STRING:
+    case JSON_TOKEN_INTEGER:
+    case JSON_TOKEN_REAL:
+    case JSON_TOKEN_TRUE:
+    case JSON_TOKEN_FALSE:
+        tokens.read_value (token, value);
+        status = set_keyval (context, name, value);
+        break;
+    case JSON_TOKEN_NULL:
+        status = DISIR_STATUS_OK;
+        break;
+    default:
+        status = DISIR_STATUS_FS_ERROR;
+        break;
+    }
+    return status;
+error:
+    if (child_context)
+    {
+        dc_destroy (&child_context);
+    }
+    return status;
+}
@@ -90,6 +90,13 @@ MoldReader::construct_mold (struct disir_mold **mold)
         goto error;
     }
 
+    // The parsed tree is built in one go and discarded as a whole, if the user opts in.
+    // Regular allocations are used if the arena cannot be enabled.
+    if (disir_read_arena_enabled (m_disir))
+    {
+        dc_enable_arena (context_mold);
+    }
+
     if (mold_has_documentation (m_moldRoot))
     {
         auto doc = m_moldRoot[ATTRIBUTE_KEY_DOCUMENTATION].asString ();
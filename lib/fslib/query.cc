@@ -1,47 +1,31 @@
 // private
 #include "mqueue.h"
+#include "entry_index.h"
 
 // public
 #include <disir/fslib/util.h>
 
 // system
-#include <dirent.h>
-#include <sstream>
+#include <limits.h>
+#include <string>
 
 
-//! FSLIB API
-enum disir_status
-fslib_config_query_entries (struct disir_instance *instance, struct disir_register_plugin *plugin,
-                            const char *basedir, struct disir_entry **entries)
+//! STATIC API
+//! Retrieve the index of entry files of type below plugin directory base_id.
+//! The directory is created if it does not exist.
+static enum disir_status
+query_entry_index (struct disir_instance *instance, const char *base_id, const char *entry_type,
+                   std::shared_ptr<const struct disir_entry_index> &index)
 {
     enum disir_status status;
-    DIR *directory;
-    struct dirent *dp;
-    struct disir_entry *entry;
-    struct disir_entry *mold_entry;
     struct stat statbuf;
 
-    // File extension is always without the leading dot - add 1 for it
-    std::stringstream suffix_stream;
-    suffix_stream << "." << plugin->dp_config_entry_type;
-    std::string suffix = suffix_stream.str();
-
-    // Directory is a combinarion of plugin config_base_id and input basedir
-    std::stringstream sd;
-    sd << plugin->dp_config_base_id;
-    if (basedir)
-    {
-        sd << '/';
-        sd << basedir;
-    }
-    std::string searchdir = sd.str();
-
     // Stat if directory exists. If it does not, we try to create it
-    status = fslib_stat_filepath (instance, searchdir.c_str(), &statbuf);
+    status = fslib_stat_filepath (instance, base_id, &statbuf);
     if (status == DISIR_STATUS_NOT_EXIST)
     {
         // lets create it
-        status = fslib_mkdir_p (instance, searchdir.c_str());
+        status = fslib_mkdir_p (instance, base_id);
     }
     if (status != DISIR_STATUS_OK)
     {
@@ -49,60 +33,76 @@ fslib_config_query_entries (struct disir_instance *instance, struct disir_regist
         return status;
     }
 
-    directory = opendir (searchdir.c_str());
-    if (directory == NULL)
+    // File extension is always without the leading dot - add 1 for it
+    std::string suffix = std::string (".") + entry_type;
+
+    return dx_entry_index_get (instance, base_id, suffix.c_str(), index);
+}
+
+//! STATIC API
+//! Return whether the indexed entry is below basedir, if given.
+static bool
+query_entry_below (const std::string &entry, const char *basedir)
+{
+    size_t size;
+
+    if (basedir == NULL)
+        return true;
+
+    size = strlen (basedir);
+    return (entry.size () > size && entry.compare (0, size, basedir) == 0 && entry[size] == '/');
+}
+
+//! STATIC API
+//! Query the entry index of a plugin directory for entry.
+//! Returns DISIR_STATUS_NO_CAN_DO if the entry file must be looked up on disk.
+static enum disir_status
+query_entry_indexed (struct disir_instance *instance, const char *base_id,
+                     const char *entry_type, const char *entry)
+{
+    std::string suffix = std::string (".") + entry_type;
+
+    return dx_entry_index_query (instance, base_id, suffix.c_str(), entry);
+}
+
+//! FSLIB API
+enum disir_status
+fslib_config_query_entries (struct disir_instance *instance, struct disir_register_plugin *plugin,
+                            const char *basedir, struct disir_entry **entries)
+{
+    enum disir_status status;
+    struct disir_entry *entry;
+    struct disir_entry *mold_entry;
+    std::shared_ptr<const struct disir_entry_index> index;
+
+    status = query_entry_index (instance, plugin->dp_config_base_id,
+                                plugin->dp_config_entry_type, index);
+    if (status != DISIR_STATUS_OK)
     {
-        disir_error_set (instance, "Unable to open directory: %s", searchdir.c_str());
-        return DISIR_STATUS_FS_ERROR;
+        // Error already set
+        return status;
     }
-    while ((dp = readdir(directory)) != NULL)
+
+    for (const auto &entry_name : index->ei_entries)
     {
-        // entry file, relative to basedir
-        std::stringstream ef;
-        if (basedir)
-        {
-            ef << basedir;
-            ef << '/';
-        }
-        ef << dp->d_name;
-        std::string name = ef.str();
+        if (query_entry_below (entry_name, basedir) == false)
+            continue;
 
-        if (dp->d_type == DT_REG)
+        //! Check if we have a mold entry for this directory entry
+        status = plugin->dp_mold_query (instance, plugin, entry_name.c_str(), &mold_entry);
+        if (status != DISIR_STATUS_EXISTS)
         {
-            // Check that our file extension (suffix) is valid for this file entry
-            if (name.size() > suffix.size()
-                && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
-            {
-                //! Check if we have a mold entry for this directory entry
-                std::string entry_name(name, 0, name.size() - suffix.size());
-                status = plugin->dp_mold_query (instance, plugin, entry_name.c_str(), &mold_entry);
-                if (status != DISIR_STATUS_EXISTS)
-                {
-                    // We dont really care what happened here...
-                    continue;
-                }
-
-                entry = (struct disir_entry *) calloc (1, sizeof (struct disir_entry));
-                entry->de_entry_name = strdup(entry_name.c_str());
-                entry->de_attributes = mold_entry->de_attributes;
-                MQ_ENQUEUE (*entries, entry);
-
-                disir_entry_finished (&mold_entry);
-            }
-        }
-        else if (dp->d_type == DT_DIR)
-        {
-            // Must be a better way to check this..
-            if (strcmp (dp->d_name, ".") == 0) {}
-            else if (strcmp (dp->d_name, "..") == 0) {}
-            else
-            {
-                fslib_config_query_entries (instance, plugin, name.c_str(), entries);
-            }
+            // We dont really care what happened here...
+            continue;
         }
-    }
 
-    closedir (directory);
+        entry = (struct disir_entry *) calloc (1, sizeof (struct disir_entry));
+        entry->de_entry_name = strdup(entry_name.c_str());
+        entry->de_attributes = mold_entry->de_attributes;
+        MQ_ENQUEUE (*entries, entry);
+
+        disir_entry_finished (&mold_entry);
+    }
 
     return DISIR_STATUS_OK;
 }
@@ -113,106 +113,50 @@ fslib_mold_query_entries (struct disir_instance *instance, struct disir_register
                           const char *basedir, struct disir_entry **entries)
 {
     enum disir_status status;
-    DIR *directory;
-    struct dirent *dp;
     struct disir_entry *entry;
-    struct stat statbuf;
+    std::shared_ptr<const struct disir_entry_index> index;
 
-    // File extension is always without the leading dot - add 1 for it
-    std::stringstream suffix_stream;
-    suffix_stream << "." << plugin->dp_mold_entry_type;
-    std::string suffix = suffix_stream.str();
-
-    // Directory is a combinarion of plugin config_base_id and input basedir
-    std::stringstream sd;
-    sd << plugin->dp_mold_base_id;
-    if (basedir)
-    {
-        sd << '/';
-        sd << basedir;
-    }
-    std::string searchdir = sd.str();
-
-    // Stat if directory exists. If it does not, we try to create it
-    status = fslib_stat_filepath (instance, searchdir.c_str(), &statbuf);
-    if (status == DISIR_STATUS_NOT_EXIST)
-    {
-        // lets create it
-        status = fslib_mkdir_p (instance, searchdir.c_str());
-    }
+    status = query_entry_index (instance, plugin->dp_mold_base_id,
+                                plugin->dp_mold_entry_type, index);
     if (status != DISIR_STATUS_OK)
     {
         // Error already set
         return status;
     }
 
-    directory = opendir (searchdir.c_str());
-    if (directory == NULL)
-    {
-        disir_error_set (instance, "Unable to open directory: %s", searchdir.c_str());
-        return DISIR_STATUS_FS_ERROR;
-    }
-    while ((dp = readdir(directory)) != NULL)
+    for (const auto &indexed : index->ei_entries)
     {
-        // entry file, relative to basedir
-        std::stringstream ef;
-        if (basedir)
-        {
-            ef << basedir;
-            ef << '/';
-        }
-        ef << dp->d_name;
-        std::string name = ef.str();
+        if (query_entry_below (indexed, basedir) == false)
+            continue;
+
+        std::string entry_name (indexed);
+        entry = (struct disir_entry *) calloc (1, sizeof (struct disir_entry));
 
-        if (dp->d_type == DT_REG)
+        std::size_t found = entry_name.find_last_of('/');
+        std::size_t start = (found == std::string::npos ? 0 : found + 1);
+        if (entry_name.compare (start, std::string::npos, "__namespace") == 0)
         {
-            // Check that our file extension (suffix) is valid for this file entry
-            if (name.size() > suffix.size()
-                && name.compare (name.size() - suffix.size(), suffix.size(), suffix) == 0)
+            entry->flag.DE_NAMESPACE_ENTRY = 1;
+            if (found != std::string::npos)
             {
-                std::string entry_name(name, 0, name.size() - suffix.size());
-                entry = (struct disir_entry *) calloc (1, sizeof (struct disir_entry));
-
-                std::string direntry (dp->d_name);
-                if (direntry.compare (0, direntry.size() - suffix.size(), "__namespace") == 0)
-                {
-                    entry->flag.DE_NAMESPACE_ENTRY = 1;
-                    std::size_t found = entry_name.find_last_of('/');
-                    if (found != std::string::npos)
-                    {
-                        entry_name[found+1] = '\0';
-                    }
-                    else
-                    {
-                        entry_name = std::string("/");
-                    }
-                }
-                else
-                {
-                    entry->flag.DE_NAMESPACE_ENTRY = 0;
-                }
-
-                entry->de_entry_name = strdup(entry_name.c_str());
-                // TODO: stat entry to get READABLE and WRITABLE
-                entry->flag.DE_READABLE = 1;
-                entry->flag.DE_WRITABLE = 1;
-                MQ_ENQUEUE (*entries, entry);
+                entry_name.erase (found + 1);
             }
-        }
-        else if (dp->d_type == DT_DIR)
-        {
-            // Must be a better way to check this..
-            if (strcmp (dp->d_name, ".") == 0) {}
-            else if (strcmp (dp->d_name, "..") == 0) {}
             else
             {
-
-                fslib_mold_query_entries (instance, plugin, name.c_str(), entries);
+                entry_name = std::string("/");
             }
         }
-    }
+        else
+        {
+            entry->flag.DE_NAMESPACE_ENTRY = 0;
+        }
 
-    closedir (directory);
+        entry->de_entry_name = strdup(entry_name.c_str());
+        // TODO: stat entry to get READABLE and WRITABLE
+        entry->flag.DE_READABLE = 1;
+        entry->flag.DE_WRITABLE = 1;
+        MQ_ENQUEUE (*entries, entry);
+    }
 
     return DISIR_STATUS_OK;
 }
@@ -245,13 +189,25 @@ fslib_plugin_config_query (struct disir_instance *instance, struct disir_registe
         return status;
     }
 
-    struct stat statbuf;
-    status = fslib_stat_filepath (instance, filepath, &statbuf);
-    if (status != DISIR_STATUS_OK)
+    status = query_entry_indexed (instance, plugin->dp_config_base_id,
+                                  plugin->dp_config_entry_type, entry_id);
+    if (status == DISIR_STATUS_NOT_EXIST)
     {
-        // Already logged
+        disir_error_set (instance, "entry resolved to filepath '%s' does not exist", filepath);
+        disir_entry_finished (&ret);
         return status;
     }
+    if (status != DISIR_STATUS_EXISTS)
+    {
+        struct stat statbuf;
+        status = fslib_stat_filepath (instance, filepath, &statbuf);
+        if (status != DISIR_STATUS_OK)
+        {
+            // Already logged
+            disir_entry_finished (&ret);
+            return status;
+        }
+    }
 
     // TODO: Update ret with READABLE and WRITABLE from statbuf
 
@@ -266,6 +222,47 @@ fslib_plugin_config_query (struct disir_instance *instance, struct disir_registe
     return DISIR_STATUS_EXISTS;
 }
 
+//! STATIC API
+//! Resolve whether a mold, or the namespace mold covering it, exists for entry_id
+//! through the mold entry index.
+//! Returns DISIR_STATUS_NO_CAN_DO if the mold must be resolved on disk.
+static enum disir_status
+query_mold_indexed (struct disir_instance *instance, struct disir_register_plugin *plugin,
+                    const char *entry_id, int *namespace_entry)
+{
+    enum disir_status status;
+    const char *separator;
+
+    status = query_entry_indexed (instance, plugin->dp_mold_base_id,
+                                  plugin->dp_mold_entry_type, entry_id);
+    if (status == DISIR_STATUS_EXISTS)
+        return DISIR_STATUS_OK;
+    if (status != DISIR_STATUS_NOT_EXIST)
+        return status;
+
+    // Attempt to find the namespace entry in the same directory
+    separator = strrchr (entry_id, '/');
+    std::string namespace_id (entry_id, separator ? separator - entry_id + 1 : 0);
+    namespace_id.append ("__namespace");
+
+    status = query_entry_indexed (instance, plugin->dp_mold_base_id,
+                                  plugin->dp_mold_entry_type, namespace_id.c_str());
+    if (status == DISIR_STATUS_EXISTS)
+    {
+        // This is a namespace entry
+        *namespace_entry = 1;
+        return DISIR_STATUS_OK;
+    }
+    if (status == DISIR_STATUS_NOT_EXIST)
+    {
+        disir_error_set (instance, "entry resolved to filepath '%s/%s.%s' does not exist",
+                         plugin->dp_mold_base_id, namespace_id.c_str(),
+                         plugin->dp_mold_entry_type);
+    }
+
+    return status;
+}
+
 //! FSLIB API
 enum disir_status
 fslib_plugin_mold_query (struct disir_instance *instance, struct disir_register_plugin *plugin,
@@ -279,8 +276,12 @@ fslib_plugin_mold_query (struct disir_instance *instance, struct disir_register_
 
     namespace_entry = 0;
 
-    status = fslib_mold_resolve_entry_id (instance, plugin, entry_id,
-                                          filepath, &statbuf, &namespace_entry);
+    status = query_mold_indexed (instance, plugin, entry_id, &namespace_entry);
+    if (status == DISIR_STATUS_NO_CAN_DO)
+    {
+        status = fslib_mold_resolve_entry_id (instance, plugin, entry_id,
+                                              filepath, &statbuf, &namespace_entry);
+    }
     if (status != DISIR_STATUS_OK)
     {
         return status;
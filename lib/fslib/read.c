@@ -1,22 +1,29 @@
 // public
 #include <disir/fslib/util.h>
 
+// private
+#include "mold_cache.h"
+
 // system
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
-
-
-//! FSLIB API
-enum disir_status
-fslib_plugin_config_read (struct disir_instance *instance,
-                          struct disir_register_plugin *plugin, const char *entry_id,
-                          struct disir_mold *mold, struct disir_config **config,
-                          dio_unserialize_config func_unserialize)
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+//! STATIC API
+//!
+//! Resolve the filepath of the config entry_id and the mold it shall be read with.
+//! If mold is NULL, the mold is read from plugin and must be put back by the caller.
+//!
+static enum disir_status
+plugin_config_resolve (struct disir_instance *instance,
+                       struct disir_register_plugin *plugin, const char *entry_id,
+                       struct disir_mold *mold, char *filepath,
+                       struct stat *statbuf, struct disir_mold **resolved_mold)
 {
     enum disir_status status;
-    char filepath[PATH_MAX];
-    struct stat statbuf;
-    struct disir_mold *resolved_mold;
 
     status = fslib_config_resolve_filepath (instance, plugin, entry_id, filepath);
     if (status != DISIR_STATUS_OK)
@@ -26,7 +33,7 @@ fslib_plugin_config_read (struct disir_instance *instance,
     }
 
     // TODO: Verify that filepath exists.
-    status = fslib_stat_filepath (instance, filepath, &statbuf);
+    status = fslib_stat_filepath (instance, filepath, statbuf);
     if (status != DISIR_STATUS_OK)
     {
         // Already logged
@@ -36,7 +43,7 @@ fslib_plugin_config_read (struct disir_instance *instance,
     // Locate mold from plugin
     if (mold == NULL)
     {
-        status = plugin->dp_mold_read (instance, plugin, entry_id, &resolved_mold);
+        status = plugin->dp_mold_read (instance, plugin, entry_id, resolved_mold);
         if (status != DISIR_STATUS_OK)
         {
             if (status == DISIR_STATUS_INVALID_CONTEXT)
@@ -50,9 +57,31 @@ fslib_plugin_config_read (struct disir_instance *instance,
     }
     else
     {
-        resolved_mold = mold;
+        *resolved_mold = mold;
     }
 
+    return DISIR_STATUS_OK;
+}
+
+//! FSLIB API
+enum disir_status
+fslib_plugin_config_read (struct disir_instance *instance,
+                          struct disir_register_plugin *plugin, const char *entry_id,
+                          struct disir_mold *mold, struct disir_config **config,
+                          dio_unserialize_config func_unserialize)
+{
+    enum disir_status status;
+    char filepath[PATH_MAX];
+    struct stat statbuf;
+    struct disir_mold *resolved_mold;
+
+    status = plugin_config_resolve (instance, plugin, entry_id, mold,
+                                    filepath, &statbuf, &resolved_mold);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
+        return status;
+    }
 
     FILE *file;
     file = fopen (filepath, "r");
@@ -61,13 +90,87 @@ fslib_plugin_config_read (struct disir_instance *instance,
         // TODO: Check errno and set appropriate error
         // TODO: Use threadsafe strerror, or refactor entirely
         disir_error_set (instance, "opening for reading %s: %s", filepath, strerror (errno));
-        return DISIR_STATUS_FS_ERROR;
+        status = DISIR_STATUS_FS_ERROR;
+        goto out;
     }
 
     status = func_unserialize (instance, file, resolved_mold, config);
 
     // Cleanup
     fclose (file);
+out:
+    if (mold == NULL)
+    {
+        // We only decref the mold if we were the one allocating it
+        disir_mold_finished (&resolved_mold);
+    }
+
+    return status;
+}
+
+//! FSLIB API
+enum disir_status
+fslib_plugin_config_read_mapped (struct disir_instance *instance,
+                                 struct disir_register_plugin *plugin, const char *entry_id,
+                                 struct disir_mold *mold, struct disir_config **config,
+                                 dio_unserialize_config_span func_unserialize)
+{
+    enum disir_status status;
+    char filepath[PATH_MAX];
+    struct stat statbuf;
+    struct disir_mold *resolved_mold;
+    void *data;
+    size_t size;
+    int fd;
+
+    data = NULL;
+    size = 0;
+    fd = -1;
+
+    status = plugin_config_resolve (instance, plugin, entry_id, mold,
+                                    filepath, &statbuf, &resolved_mold);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
+        return status;
+    }
+
+    fd = open (filepath, O_RDONLY | O_CLOEXEC);
+    if (fd == -1 || fstat (fd, &statbuf) != 0)
+    {
+        // TODO: Use threadsafe strerror, or refactor entirely
+        disir_error_set (instance, "opening for reading %s: %s", filepath, strerror (errno));
+        status = DISIR_STATUS_FS_ERROR;
+        goto out;
+    }
+
+    // An empty file cannot be mapped; hand over an empty span instead.
+    size = statbuf.st_size;
+    if (size > 0)
+    {
+        data = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            disir_error_set (instance, "mapping %s: %s", filepath, strerror (errno));
+            data = NULL;
+            status = DISIR_STATUS_FS_ERROR;
+            goto out;
+        }
+        // The unserializers read the span front to back, once.
+        madvise (data, size, MADV_SEQUENTIAL);
+    }
+
+    status = func_unserialize (instance, (data ? data : ""), size, resolved_mold, config);
+
+out:
+    if (data)
+    {
+        munmap (data, size);
+    }
+    if (fd != -1)
+    {
+        close (fd);
+    }
     if (mold == NULL)
     {
         // We only decref the mold if we were the one allocating it
@@ -86,6 +189,8 @@ fslib_plugin_mold_read (struct disir_instance *instance,
 {
     enum disir_status status;
     char filepath[PATH_MAX];
+    char filepath_namespace[PATH_MAX];
+    const char *namespace_dependency;
     struct stat statbuf;
     int namespace_entry;
     FILE *file;
@@ -99,6 +204,16 @@ fslib_plugin_mold_read (struct disir_instance *instance,
         return status;
     }
 
+    namespace_dependency = dx_mold_cache_namespace_filepath (plugin, filepath, namespace_entry,
+                                                             filepath_namespace,
+                                                             sizeof (filepath_namespace));
+
+    status = dx_mold_cache_lookup (instance, plugin, filepath, namespace_dependency, mold);
+    if (status == DISIR_STATUS_OK)
+    {
+        return status;
+    }
+
     file = fopen (filepath, "r");
     if (file == NULL)
     {
@@ -112,6 +227,11 @@ fslib_plugin_mold_read (struct disir_instance *instance,
     // Cleanup
     fclose (file);
 
+    if (status == DISIR_STATUS_OK)
+    {
+        // Failing to cache only costs us reading the mold again.
+        dx_mold_cache_insert (instance, plugin, filepath, namespace_dependency, *mold);
+    }
+
     return status;
 }
-
@@ -10,8 +10,8 @@ dio_toml_config_read (struct disir_instance *instance,
                       struct disir_register_plugin *plugin, const char *entry_id,
                       struct disir_mold *mold, struct disir_config **config)
 {
-    return fslib_plugin_config_read (instance, plugin, entry_id, mold,
-                                     config, dio_toml_unserialize_config);
+    return fslib_plugin_config_read_mapped (instance, plugin, entry_id, mold,
+                                            config, dio_toml_unserialize_config_span);
 }
 
 //! PLUGIN API
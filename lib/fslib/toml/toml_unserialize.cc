@@ -12,6 +12,17 @@
 #define ATTRIBUTE_KEY_DISIR_CONFIG_VERSION "@DISIR_CONFIG_VERSION"
 #define ATTRIBUTE_KEY_DISIR_CONFIG_VERSION_QUOTED "\"@DISIR_CONFIG_VERSION\""
 
+//! Read-only stream buffer over a contiguous span, read in place.
+class SpanStreambuf : public std::streambuf
+{
+public:
+    SpanStreambuf (const char *data, size_t size)
+    {
+        char *begin = const_cast<char *> (data);
+        setg (begin, begin, begin + size);
+    }
+};
+
 // Forward declare
 static enum disir_status
 dio_toml_unserialize_all (struct disir_instance *instance, const char *key,
@@ -230,27 +241,16 @@ dio_toml_unserialize_all (struct disir_instance *instance, const char *key,
     return status;
 }
 
-//! FSLIB API
-enum disir_status
-dio_toml_unserialize_config (struct disir_instance *instance, FILE *input,
-                             struct disir_mold *mold, struct disir_config **config)
+//! STATIC API
+static enum disir_status
+unserialize_config_stream (struct disir_instance *instance, std::istream& input,
+                           struct disir_mold *mold, struct disir_config **config)
 {
     enum disir_status status;
     struct disir_context *context_config;
 
-    if (instance == NULL || input == NULL || mold == NULL || config == NULL)
-    {
-        // LOG debug 0
-        return DISIR_STATUS_INVALID_ARGUMENT;
-    }
-
-    disir_log_user (instance, "TRACE ENTER dio_toml_unserialize_config");
-
-    boost::fdistream file(fileno(input));
-    // XXX: Check file
-
     // Pare the TOML formatted file and extract it into a toml::Value object
-    toml::ParseResult pr = toml::parse (file);
+    toml::ParseResult pr = toml::parse (input);
     if (pr.valid() == false)
     {
         disir_log_user (instance, "TOML: Parse error: %s", pr.errorReason.c_str());
@@ -267,6 +267,13 @@ dio_toml_unserialize_config (struct disir_instance *instance, FILE *input,
         return status;
     }
 
+    // The parsed tree is built in one go and discarded as a whole, if the user opts in.
+    // Regular allocations are used if the arena cannot be enabled.
+    if (disir_read_arena_enabled (instance))
+    {
+        dc_enable_arena (context_config);
+    }
+
     // Check if root contains version
     const toml::Value* version = root.findChild (ATTRIBUTE_KEY_DISIR_CONFIG_VERSION);
     if (version != nullptr)
@@ -328,3 +335,43 @@ dio_toml_unserialize_config (struct disir_instance *instance, FILE *input,
     return status;
 }
 
+//! FSLIB API
+enum disir_status
+dio_toml_unserialize_config (struct disir_instance *instance, FILE *input,
+                             struct disir_mold *mold, struct disir_config **config)
+{
+    if (instance == NULL || input == NULL || mold == NULL || config == NULL)
+    {
+        // LOG debug 0
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    disir_log_user (instance, "TRACE ENTER dio_toml_unserialize_config");
+
+    boost::fdistream file(fileno(input));
+    // XXX: Check file
+
+    return unserialize_config_stream (instance, file, mold, config);
+}
+
+//! FSLIB API
+enum disir_status
+dio_toml_unserialize_config_span (struct disir_instance *instance,
+                                  const char *data, size_t size,
+                                  struct disir_mold *mold, struct disir_config **config)
+{
+    if (instance == NULL || data == NULL || mold == NULL || config == NULL)
+    {
+        // LOG debug 0
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    disir_log_user (instance, "TRACE ENTER dio_toml_unserialize_config_span");
+
+    // The parser reads the span in place through the stream buffer.
+    SpanStreambuf buffer (data, size);
+    std::istream input (&buffer);
+
+    return unserialize_config_stream (instance, input, mold, config);
+}
+
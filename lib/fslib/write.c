@@ -1,184 +1,264 @@
 // public
 #include <disir/fslib/util.h>
 
+// private
+#include "disir_private.h"
+
 // system
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 
-//! FSLIB API
-enum disir_status
-fslib_plugin_config_write (struct disir_instance *instance, struct disir_register_plugin *plugin,
-                           const char *entry_id, struct disir_config *config,
-                           dio_serialize_config func_serialize)
+//! Distinguishes temporary files created concurrently by the same process.
+static unsigned long write_temporary_counter = 0;
+
+//! STATIC API
+//! Open a file to write filepath through.
+//!
+//! The file written is a temporary file next to the file filepath resolves to,
+//! creating its directory if missing. A symbolic link at filepath is thus kept,
+//! and the file it points to replaced. Populates targetpath with the resolved file,
+//! dirpath with its directory and tmppath with the temporary file.
+//! The temporary file inherits the mode, owner and group of the file it replaces.
+//! If the owner or group cannot be kept, the existing file is truncated and written
+//! in place instead, as it is not ours to hand over. tmppath is then empty.
+static enum disir_status
+write_open_temporary (struct disir_instance *instance, const char *filepath, char *targetpath,
+                      char *dirpath, char *tmppath, FILE **file)
 {
     enum disir_status status;
-    char filepath[PATH_MAX];
+    const char *basename;
     struct stat statbuf;
+    struct stat tmpbuf;
+    int have_mode;
+    int res;
+    int fd;
 
-    status = plugin->dp_mold_query (instance, plugin, entry_id, NULL);
-    if (status == DISIR_STATUS_NOT_EXIST)
+    // A missing file (or dangling link) is created at filepath itself.
+    if (realpath (filepath, targetpath) == NULL)
     {
-        disir_error_set (instance, "there exists no mold for entry %s", entry_id);
-        return DISIR_STATUS_MOLD_MISSING;
+        snprintf (targetpath, PATH_MAX, "%s", filepath);
     }
-    if (status != DISIR_STATUS_EXISTS)
+
+    basename = strrchr (targetpath, '/');
+    if (basename == NULL)
     {
-        // Unknown error ?
-        return status;
+        strcpy (dirpath, ".");
+        basename = targetpath;
     }
-
-    status = fslib_config_resolve_filepath (instance, plugin, entry_id, filepath);
-    if (status != DISIR_STATUS_OK)
+    else
     {
-        // Already logged
-        return status;
+        snprintf (dirpath, PATH_MAX, "%.*s", (int) (basename - targetpath), targetpath);
+        basename++;
     }
 
-    status = fslib_stat_filepath (instance, filepath, &statbuf);
-    if (status == DISIR_STATUS_NOT_EXIST)
+    res = snprintf (tmppath, PATH_MAX, "%s/.%s.%ld.%lu.tmp", dirpath, basename, (long) getpid (),
+                    __atomic_fetch_add (&write_temporary_counter, 1, __ATOMIC_RELAXED));
+    if (res >= PATH_MAX)
     {
-        // Create the directory strcutreu
-        char dirpath[PATH_MAX];
-        char *separator = NULL;
-        int res;
-
-        res = snprintf (dirpath, PATH_MAX, "%s/%s", plugin->dp_config_base_id, entry_id);
-        if (res >= 4096)
-        {
-            disir_error_set (instance, "filepath exceeded internal buffer of %d bytes", PATH_MAX);
-            return DISIR_STATUS_INSUFFICIENT_RESOURCES;
-        }
+        disir_error_set (instance, "filepath exceeded internal buffer of %d bytes", PATH_MAX);
+        return DISIR_STATUS_INSUFFICIENT_RESOURCES;
+    }
 
-        // Reverse search for directory separator
-        separator = strrchr (dirpath, '/');
-        if (separator == NULL)
+    have_mode = 0;
+    status = fslib_stat_filepath (instance, targetpath, &statbuf);
+    if (status == DISIR_STATUS_OK)
+    {
+        // Check if stat'd file is a directory - that should fail
+        if (S_ISREG (statbuf.st_mode) == 0)
         {
-            // Mamma mia! What does this entail?
-            disir_error_set (instance, "unable to determine directory location for entry: '%s'",
-                             dirpath);
+            disir_error_set (instance, "resolved filepath is not a file: %s", filepath);
             return DISIR_STATUS_FS_ERROR;
         }
+        have_mode = 1;
+    }
+    else if (status != DISIR_STATUS_NOT_EXIST)
+    {
+        // Already logged
+        return status;
+    }
 
-        *separator = '\0';
-
+    fd = open (tmppath, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+    if (fd == -1 && errno == ENOENT)
+    {
         status = fslib_mkdir_p (instance, dirpath);
         if (status != DISIR_STATUS_OK)
         {
             return status;
         }
+        fd = open (tmppath, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
     }
-    else if (status != DISIR_STATUS_OK)
+    if (fd == -1)
     {
-        // Already logged
-        return status;
+        // TODO: Use threadsafe strerror, or refactor entirely
+        disir_error_set (instance, "opening for writing %s: %s", tmppath, strerror (errno));
+        return DISIR_STATUS_FS_ERROR;
     }
-    else
+
+    if (have_mode && fstat (fd, &tmpbuf) == 0
+        && (tmpbuf.st_uid != statbuf.st_uid || tmpbuf.st_gid != statbuf.st_gid)
+        && fchown (fd, statbuf.st_uid, statbuf.st_gid) != 0)
     {
-        // Check if stat'd file is a directory - that should fail
-        if (S_ISREG (statbuf.st_mode) == 0)
+        // Not permitted to create a file with the same ownership. Write in place.
+        close (fd);
+        unlink (tmppath);
+        tmppath[0] = '\0';
+
+        fd = open (targetpath, O_WRONLY | O_TRUNC | O_CLOEXEC);
+        if (fd == -1)
         {
-            disir_error_set (instance, "resolved filepath is not a file: %s", filepath);
+            disir_error_set (instance, "opening for writing %s: %s", targetpath, strerror (errno));
             return DISIR_STATUS_FS_ERROR;
         }
+        have_mode = 0;
     }
 
-    FILE *file;
-
-    file = fopen (filepath, "w+");
-    if (file == NULL)
+    if (have_mode && fchmod (fd, statbuf.st_mode & 07777) != 0)
     {
-        // TODO: Check errno and set appropriate error
-        // TODO: Use threadsafe strerror, or refactor entirely
-        disir_error_set (instance, "opening for writing %s: %s", filepath, strerror (errno));
-        return DISIR_STATUS_FS_ERROR;
+        disir_error_set (instance, "setting mode of %s: %s", tmppath, strerror (errno));
+        goto error;
     }
 
-    status = func_serialize (instance, config, file);
-    fclose (file);
+    *file = fdopen (fd, "w");
+    if (*file == NULL)
+    {
+        disir_error_set (instance, "opening for writing %s: %s",
+                         (tmppath[0] ? tmppath : targetpath), strerror (errno));
+        goto error;
+    }
 
-    return status;
+    return DISIR_STATUS_OK;
+error:
+    close (fd);
+    if (tmppath[0])
+        unlink (tmppath);
+    return DISIR_STATUS_FS_ERROR;
 }
 
-//! FSLIB API
-enum disir_status
-fslib_plugin_mold_write (struct disir_instance *instance, struct disir_register_plugin *plugin,
-                         const char *entry_id, struct disir_mold *mold,
-                         dio_serialize_mold func_serialize)
+//! STATIC API
+//! Flush and close the file opened by write_open_temporary, then rename the temporary
+//! file over targetpath if status is OK. The temporary file is removed on any failure.
+static enum disir_status
+write_finish (struct disir_instance *instance, FILE *file, const char *tmppath,
+              const char *targetpath, const char *dirpath, enum disir_status status)
 {
-    enum disir_status status;
-    char filepath[PATH_MAX];
-    struct stat statbuf;
+    const char *written;
 
-    status = fslib_mold_resolve_filepath (instance, plugin, entry_id, filepath);
+    written = (tmppath[0] ? tmppath : targetpath);
+    if (status == DISIR_STATUS_OK && (fflush (file) != 0 || fsync (fileno (file)) != 0))
+    {
+        disir_error_set (instance, "flushing %s: %s", written, strerror (errno));
+        status = DISIR_STATUS_FS_ERROR;
+    }
+    if (fclose (file) != 0 && status == DISIR_STATUS_OK)
+    {
+        disir_error_set (instance, "closing %s: %s", written, strerror (errno));
+        status = DISIR_STATUS_FS_ERROR;
+    }
+    if (tmppath[0] == '\0')
+    {
+        // Written in place
+        return status;
+    }
     if (status != DISIR_STATUS_OK)
     {
-        // Already logged
+        unlink (tmppath);
         return status;
     }
 
-    status = fslib_stat_filepath (instance, filepath, &statbuf);
-    if (status == DISIR_STATUS_NOT_EXIST)
+    if (rename (tmppath, targetpath) != 0)
     {
-        // Create the directory strcutreu
-        char dirpath[PATH_MAX];
-        char *separator = NULL;
-        int res;
-
-        res = snprintf (dirpath, PATH_MAX, "%s/%s", plugin->dp_mold_base_id, entry_id);
-        if (res >= 4096)
+        if (errno == EISDIR)
         {
-            disir_error_set (instance, "filepath exceeded internal buffer of %d bytes", PATH_MAX);
-            return DISIR_STATUS_INSUFFICIENT_RESOURCES;
+            disir_error_set (instance, "resolved filepath is not a file: %s", targetpath);
         }
-
-        // Reverse search for directory separator
-        separator = strrchr (dirpath, '/');
-        if (separator == NULL)
+        else
         {
-            // Mamma mia! What does this entail?
-            disir_error_set (instance, "unable to determine directory location for entry: '%s'",
-                             dirpath);
-            return DISIR_STATUS_FS_ERROR;
+            disir_error_set (instance, "renaming %s to %s: %s",
+                             tmppath, targetpath, strerror (errno));
         }
+        unlink (tmppath);
+        return DISIR_STATUS_FS_ERROR;
+    }
 
-        *separator = '\0';
+    return dx_write_sync_directory (instance, dirpath);
+}
 
-        status = fslib_mkdir_p (instance, dirpath);
-        if (status != DISIR_STATUS_OK)
-        {
-            return status;
-        }
+//! FSLIB API
+enum disir_status
+fslib_plugin_config_write (struct disir_instance *instance, struct disir_register_plugin *plugin,
+                           const char *entry_id, struct disir_config *config,
+                           dio_serialize_config func_serialize)
+{
+    enum disir_status status;
+    char filepath[PATH_MAX];
+    char targetpath[PATH_MAX];
+    char dirpath[PATH_MAX];
+    char tmppath[PATH_MAX];
+    FILE *file;
+
+    status = plugin->dp_mold_query (instance, plugin, entry_id, NULL);
+    if (status == DISIR_STATUS_NOT_EXIST)
+    {
+        disir_error_set (instance, "there exists no mold for entry %s", entry_id);
+        return DISIR_STATUS_MOLD_MISSING;
     }
-    else if (status != DISIR_STATUS_OK)
+    if (status != DISIR_STATUS_EXISTS)
+    {
+        // Unknown error ?
+        return status;
+    }
+
+    status = fslib_config_resolve_filepath (instance, plugin, entry_id, filepath);
+    if (status != DISIR_STATUS_OK)
     {
         // Already logged
         return status;
     }
-    else
+
+    status = write_open_temporary (instance, filepath, targetpath, dirpath, tmppath, &file);
+    if (status != DISIR_STATUS_OK)
     {
-        // Check if stat'd file is a directory - that should fail
-        if (S_ISREG (statbuf.st_mode) == 0)
-        {
-            disir_error_set (instance, "resolved filepath is not a file: %s", filepath);
-            return DISIR_STATUS_FS_ERROR;
-        }
+        // Already logged
+        return status;
     }
 
+    status = func_serialize (instance, config, file);
+
+    return write_finish (instance, file, tmppath, targetpath, dirpath, status);
+}
+
+//! FSLIB API
+enum disir_status
+fslib_plugin_mold_write (struct disir_instance *instance, struct disir_register_plugin *plugin,
+                         const char *entry_id, struct disir_mold *mold,
+                         dio_serialize_mold func_serialize)
+{
+    enum disir_status status;
+    char filepath[PATH_MAX];
+    char targetpath[PATH_MAX];
+    char dirpath[PATH_MAX];
+    char tmppath[PATH_MAX];
     FILE *file;
 
-    file = fopen (filepath, "w+");
-    if (file == NULL)
+    status = fslib_mold_resolve_filepath (instance, plugin, entry_id, filepath);
+    if (status != DISIR_STATUS_OK)
     {
-        // TODO: Check errno and set appropriate error
-        // TODO: Use threadsafe strerror, or refactor entirely
-        disir_error_set (instance, "opening for writing %s: %s", filepath, strerror (errno));
-        return DISIR_STATUS_FS_ERROR;
+        // Already logged
+        return status;
+    }
+
+    status = write_open_temporary (instance, filepath, targetpath, dirpath, tmppath, &file);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
+        return status;
     }
 
     status = func_serialize (instance, mold, file);
-    fclose (file);
 
-    return status;
+    return write_finish (instance, file, tmppath, targetpath, dirpath, status);
 }
-
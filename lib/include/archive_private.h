@@ -13,6 +13,8 @@
 #define ATTRIBUTE_KEY_ID "id"
 //! toml key for gourp table
 #define ATTRIBUTE_KEY_GROUPS "groups"
+//! toml key for the offset of the compressed stream holding the archive metadata
+#define ATTRIBUTE_KEY_METADATA_OFFSET "metadata_offset"
 //! name of metadata file in archive
 #define METADATA_FILENAME "metadata.toml"
 
@@ -25,8 +27,10 @@ struct disir_archive_entry
     std::string de_group_id;
     // The entry if of the config
     std::string de_entry_id;
-    // path to its location on disk
+    // path to its location on disk, if extracted
     std::string de_filepath;
+    // contents of the config, if read into memory. Owned by the archive content map.
+    const std::string *de_content;
     // archive entry version (config)
     std::string de_version;
 };
@@ -58,6 +62,12 @@ struct disir_archive
     std::map<std::string, toml::Value*> *da_entries;
     // Config entries in open disir_archive
     std::set<struct disir_archive_entry, cmp_entry> *da_config_entries;
+    // Compression of the archive written
+    struct disir_archive_options da_options;
+    // Compressed stream the tar archive is currently written through
+    struct archive *da_stream;
+    // Temporary archive file the compressed streams are written to
+    int da_fd;
 };
 
 //! Create a disir_archive
@@ -70,29 +80,50 @@ enum disir_status
 dx_archive_extract (const char *archive_path, std::map<std::string, std::string>& extract_content,
                     const char *extract_path);
 
-//! Opens the archive in write-mode.
+//! Reads the contents of archive into memory, populating 'archive_content' with
+//! the data of all its entries. Nothing is written to disk.
+//! The codec the archive is compressed with is stored in 'compression', unless NULL.
+enum disir_status
+dx_archive_read (const char *archive_path, std::map<std::string, std::string>& archive_content,
+                 enum disir_archive_compression *compression);
+
+//! Opens the archive in write-mode, compressed according to archive->da_options.
 //! Caller is responsible for closing archive, unless disir_archive_finalize is called.
 enum disir_status
 dx_archive_open_write (struct disir_archive *archive);
 
+//! Finish the compressed stream the archive is written through. What is written
+//! next begins a new stream. 'offset' is populated with the size of the temporary
+//! archive file, which is where the new stream begins.
+enum disir_status
+dx_archive_stream_split (struct disir_archive *archive, int64_t *offset);
+
+//! Copy the first 'size' bytes of the archive at 'archive_path' to the start of the
+//! temporary archive, verbatim. Must be called before anything is written to archive.
+enum disir_status
+dx_archive_keep_prefix (struct disir_archive *archive, const char *archive_path, int64_t size);
+
 //! Opens the archive in read-mode.
 //! Caller is responsible for closing archive when finished.
 enum disir_status
 dx_archive_open_read (const char *archive_path, struct archive **archive);
 
-//! Validates the integrity of the entries retrieved from dx_archive_extract
+//! Validates the integrity of the entries retrieved from dx_archive_extract,
+//! or from dx_archive_read if 'in_memory' is set.
 enum disir_status
 dx_archive_validate (struct disir_archive *archive,
-                     std::map<std::string, std::string>& archive_entries);
+                     std::map<std::string, std::string>& archive_entries, bool in_memory);
 
 //! Begin existing archive referred to by 'archive_path'
 enum disir_status
 dx_archive_begin_existing (struct disir_instance *instance, const char *archive_path,
+                           const struct disir_archive_options *options,
                            struct disir_archive **archive);
 
-//! Begin new archive open for appends
+//! Begin new archive open for appends. Options may be NULL for the defaults.
 enum disir_status
-dx_archive_begin_new (struct disir_archive **archive);
+dx_archive_begin_new (const struct disir_archive_options *options,
+                      struct disir_archive **archive);
 
 //! Write config entries to archive.
 enum disir_status
@@ -117,7 +148,8 @@ dx_archive_metadata_write (struct disir_archive *archive);
 char *
 dx_archive_create_temp_folder (void);
 
-//! Move archive to given location on disk. Overwrite existing archive with backup.
+//! Move archive to given location on disk. An existing archive is replaced
+//! by renaming a copy of the new archive into place.
 enum disir_status
 dx_archive_disk_append (const char *new_archive_path, const char *existing_archive_path,
                         const char *temp_archive_path);
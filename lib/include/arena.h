@@ -0,0 +1,88 @@
+#ifndef _LIBDISIR_PRIVATE_ARENA_H
+#define _LIBDISIR_PRIVATE_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//! Forward declare Disir Arena structure.
+//!
+//! The arena is a chunked bump allocator that a config or mold may opt into.
+//! Every context allocated in the arena holds a reference on it.
+//! Memory freed back to the arena is handed out again to allocations of the same size;
+//! all chunks are released together when the last reference is dropped.
+struct disir_arena;
+
+//! Link embedded in an object allocated within an arena, by which the arena
+//! keeps track of the objects still alive within it.
+struct disir_arena_link
+{
+    struct disir_arena_link     *al_next;
+    struct disir_arena_link     *al_prev;
+};
+
+//! \brief Allocate a new, empty arena with a reference count of one.
+//!
+//! \return NULL if the allocation failed.
+//! \return Pointer to the newly allocated arena.
+//!
+struct disir_arena *
+dx_arena_create (void);
+
+//! \brief Allocate zeroed memory of size bytes from the arena.
+//!
+//! The memory is suitably aligned for any type, and lives until the arena is released.
+//!
+//! \return NULL if the allocation failed.
+//! \return Pointer to the allocated memory.
+//!
+void *
+dx_arena_alloc (struct disir_arena *arena, size_t size);
+
+//! \brief Return memory of size bytes allocated with dx_arena_alloc() to the arena.
+//!
+//! The memory is handed out again by a later allocation of the same size.
+//! Memory of sizes the arena does not keep free lists for is only released with the arena.
+//!
+void
+dx_arena_free (struct disir_arena *arena, void *ptr, size_t size);
+
+//! \brief Keep track of link, embedded in an object allocated within arena.
+void
+dx_arena_track (struct disir_arena *arena, struct disir_arena_link *link);
+
+//! \brief Stop keeping track of link. Nothing is done if link is not tracked.
+//!
+//! \return 1 if link was tracked, 0 otherwise.
+//!
+int
+dx_arena_untrack (struct disir_arena *arena, struct disir_arena_link *link);
+
+//! \brief Return the most recently tracked link in arena.
+//!
+//! Older links are reached through al_next.
+//!
+//! \return NULL if no link is tracked.
+//!
+struct disir_arena_link *
+dx_arena_tracked (struct disir_arena *arena);
+
+//! \brief Increment the reference count of the arena.
+void
+dx_arena_incref (struct disir_arena *arena);
+
+//! \brief Decrement the reference count of the arena.
+//!
+//! When the reference count reaches zero, every chunk is released and
+//! the arena pointer is set to NULL.
+//!
+void
+dx_arena_decref (struct disir_arena **arena);
+
+//! \brief Drop count references held on the arena at once.
+//!
+//! \see dx_arena_decref
+//!
+void
+dx_arena_decref_count (struct disir_arena **arena, int64_t count);
+
+#endif // _LIBDISIR_PRIVATE_ARENA_H
@@ -25,6 +25,12 @@ struct disir_collection
 
     //! Index into cc_collection the iterator is presently at.
     int32_t         cc_iterator_index;
+
+    //! Value of dx_context_destroyed_generation when this collection was last coalesced.
+    uint64_t        cc_generation;
+
+    //! Set when a context that is already destroyed is pushed to the collection.
+    uint8_t         cc_dirty;
 };
 
 //! INTERNAL API
@@ -33,6 +39,11 @@ struct disir_collection
 //! Decref and lose invalid context pointers.
 enum disir_status dx_collection_coalesce (struct disir_collection *collection);
 
+//! INTERNAL API
+//! Coalesce the collection only if a context may have been destroyed since
+//! the last time it was coalesced. This is O(1) when nothing has changed.
+enum disir_status dx_collection_coalesce_stale (struct disir_collection *collection);
+
 //! \brief Return the next entry in the collection without coalescing.
 //!
 //! This function is used to potentially retrieve destroyed contexts
@@ -3,6 +3,7 @@
 
 #include "context_private.h"
 #include "element_storage.h"
+#include "name_table.h"
 
 //! Represents a complete config instance.
 struct disir_config
@@ -25,6 +26,10 @@ struct disir_config
     //!     * DISIR_CONTEXT_KEYVAL
     //!     * DISIR_CONTEXT_SECTION.
     struct disir_element_storage    *cf_elements;
+
+    //! Names of keyvals and sections in the config without a mold equivalent.
+    //! Allocated the first time such a name is set.
+    struct disir_name_table         *cf_names;
 };
 
 //! \brief Create a new disir_config structure with the input as its context representation
@@ -3,6 +3,8 @@
 
 #include <disir/context.h>
 
+#include "arena.h"
+
 //
 // Definitions
 //
@@ -57,13 +59,43 @@ struct disir_context
     //! is in possession of.
     int64_t                     cx_refcount;
 
+    //! Number of child contexts holding a reference on this context
+    //! through dx_context_attach().
+    int64_t                     cx_attached;
+
     //! Allocated and populated if an error message occurs.
     //! Should probably be a stack of messages, with a counter.
     //! and a state counter!
     char                        *cx_error_message;
     int32_t                     cx_error_message_size;
+
+    //! Outcome of the last validity check on this context, see dx_validate_context().
+    //! Only reused for finalized keyvals and sections whose cx_validated_epoch
+    //! matches the cx_validation_epoch of their root context.
+    //! Zero cx_validated_epoch marks the context as dirty.
+    enum disir_status           cx_validated_status;
+    uint32_t                    cx_validated_invalid;
+    uint32_t                    cx_validated_epoch;
+    //! Only used on the root context. Bumped when a change may affect the
+    //! validity of every context in the tree, e.g., the config version.
+    uint32_t                    cx_validation_epoch;
+
+    //! Arena this context tree allocates from, if enabled on the root context.
+    //! Top-level contexts own the arena but are themselves heap allocated.
+    //! Every other context holding an arena is allocated within it, along with its
+    //! type structure, and holds a reference on the arena.
+    struct disir_arena          *cx_arena;
+
+    //! Tracks the context in cx_arena while it is alive, if allocated within it.
+    struct disir_arena_link     cx_arena_link;
 };
 
+//! Incremented every time a context is marked CONTEXT_STATE_DESTROYED.
+//! Collections compare it against the generation they last coalesced at,
+//! so they only rescan their entries when a context may have been destroyed.
+//! Accessed atomically, as contexts may be destroyed from several threads.
+extern uint64_t dx_context_destroyed_generation;
+
 //
 // Macro prototypes
 //
@@ -109,6 +141,13 @@ void dx_context_decref (struct disir_context **context);
 //! Attach 'parent' as parent context to 'context'
 void dx_context_attach (struct disir_context *parent, struct disir_context *context);
 
+//! Discard the cached validity of context and all its parents,
+//! such that the next validation re-checks them.
+void dx_context_mark_dirty (struct disir_context *context);
+
+//! Discard the cached validity of every context in the tree of context.
+void dx_context_mark_tree_dirty (struct disir_context *context);
+
 //! Return the string representation of the disir_context_type enumeration
 const char * dx_context_type_string (enum disir_context_type type);
 
@@ -132,9 +171,45 @@ enum disir_context_type dx_context_type_sanify (enum disir_context_type type);
 //! Allocate a disir_context
 struct disir_context * dx_context_create (enum disir_context_type type);
 
+//! \brief Allocate a disir_context that shall become a child of parent.
+//!
+//! If the root context of parent has an arena enabled, the context is allocated
+//! within that arena. Otherwise, this is equivalent to dx_context_create().
+//! The child context is not attached to parent.
+//!
+struct disir_context * dx_context_create_in (struct disir_context *parent,
+                                             enum disir_context_type type);
+
 //! Free an allocated disir_context
 void dx_context_destroy (struct disir_context **context);
 
+//! \brief Allocate zeroed memory for the type structure of context.
+//!
+//! Allocated from the arena context was created in, if any. Otherwise from the heap.
+//!
+void * dx_context_calloc (struct disir_context *context, size_t size);
+
+//! \brief Release memory of size bytes allocated with dx_context_calloc() for the same context.
+//!
+//! Memory allocated within an arena is handed back to the arena for reuse.
+//!
+void dx_context_free (struct disir_context *context, void *ptr, size_t size);
+
+//! \brief Release every context allocated in the arena of the top-level context root at once.
+//!
+//! Instead of walking the tree and dropping references child by child, each context
+//! still alive in the arena only releases what it holds outside of it, and the
+//! references the tree holds on itself are dropped in bulk. Contexts referenced from
+//! outside the tree are left behind destroyed, exactly as dc_destroy() on the tree would.
+//! The element storage and documentation queue of root still refer to the released
+//! contexts, and must be discarded without destroying their entries.
+//!
+//! \return DISIR_STATUS_NO_CAN_DO if root has no arena, or a context in it is still
+//!     under construction. Nothing is released; the tree must be destroyed as usual.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status dx_context_release_arena (struct disir_context *root);
+
 //! \brief Associate the input config related context with its equiv mold related context
 //!
 //! The input context must have root CONFIG context, where valid contexts are:
@@ -35,6 +35,10 @@ struct disir_default *dx_default_create (struct disir_context *parent);
 //! memory and unhooking from linked list storage.
 enum disir_status dx_default_destroy (struct disir_default **def);
 
+//! Release what the disir_default structure holds,
+//! leaving the structure itself and its place in the parent untouched.
+void dx_default_release (struct disir_default *def);
+
 
 //! \brief Query a keyval context, whose root is mold, for the active default entry for version.
 //!
@@ -4,6 +4,8 @@
 #include <disir/disir.h>
 #include <disir/plugin.h>
 
+#include <pthread.h>
+
 //! Internal plugin structure
 struct disir_register_plugin_internal
 {
@@ -24,6 +26,26 @@ struct disir_register_plugin_internal
     struct disir_register_plugin_internal *next, *prev;
 };
 
+//! Error message of a single thread on a disir instance.
+struct disir_error_slot
+{
+    //! Error message set with disir_error_set()
+    char                            *es_message;
+    //! Bytes allocated/occupied by es_message.
+    int32_t                         es_message_size;
+
+    struct disir_error_slot         *next, *prev;
+};
+
+//! Directories written to since disir_write_begin(), flushed by disir_write_commit().
+struct disir_write_transaction
+{
+    //! Heap allocated, distinct directory paths.
+    char                            **wt_directories;
+    int32_t                         wt_size;
+    int32_t                         wt_capacity;
+};
+
 //! \brief The main libdisir instance structure. All I/O operations requires an instance of it.
 struct disir_instance
 {
@@ -35,18 +57,79 @@ struct disir_instance
     //! Mold of configuration entry for libdisir itself.
     struct disir_mold               *libdisir_mold;
 
-    //! Error message sat on the disir instance.
+    //! Error messages sat on the disir instance, one per thread.
     //! Set with disir_error_set() and clear with disir_error_clear()
     //! Retrievable through disir_error() and disir_error_copy()
-    char                            *disir_error_message;
-    //! Bytes allocated/occupied by the disir_error_message.
-    int32_t                         disir_error_message_size;
+    //! The calling thread's slot is found through disir_error_key.
+    pthread_key_t                   disir_error_key;
+    //! Double-linked list queue of every slot allocated, freed with the instance.
+    //! Protected by disir_error_mutex.
+    struct disir_error_slot         *disir_error_slots;
+    pthread_mutex_t                 disir_error_mutex;
+
+    //! Double-linked list queue of molds read from disk, shared between config reads.
+    //! Protected by dio_mold_cache_mutex. See mold_cache.h
+    struct disir_mold_cache_entry   *dio_mold_cache_queue;
+    pthread_mutex_t                 dio_mold_cache_mutex;
+
+    //! Protected by dio_entry_index_mutex. See entry_index.h
+    struct disir_entry_index_table  *dio_entry_index;
+    pthread_mutex_t                 dio_entry_index_mutex;
+
+    //! Active write transaction, or NULL. Protected by dio_write_mutex.
+    struct disir_write_transaction  *dio_write_transaction;
+    pthread_mutex_t                 dio_write_mutex;
+
+    //! Non-zero if configs and molds read shall be allocated from an arena.
+    //! Accessed atomically. See disir_read_arena()
+    int                             dio_read_arena;
 };
 
+//! \brief Retrieve the error slot of the calling thread on instance.
+//!
+//! \param[in] create Allocate the slot if the calling thread has none.
+//!
+//! \return NULL if the thread has no slot and create is zero, or allocation failed.
+//!
+struct disir_error_slot *
+dx_error_slot (struct disir_instance *instance, int create);
+
+//! \brief Free all error slots on instance.
+void
+dx_error_slots_destroy (struct disir_instance *instance);
+
+//! \brief Make the entries of directory dirpath durable on disk.
+//!
+//! If a write transaction is active on instance, the directory is recorded
+//! and flushed once by disir_write_commit() instead.
+//!
+//! \return DISIR_STATUS_NO_MEMORY if the directory could not be recorded.
+//! \return DISIR_STATUS_FS_ERROR if the directory could not be flushed.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dx_write_sync_directory (struct disir_instance *instance, const char *dirpath);
+
+//! \brief Flush and free every directory recorded by transaction.
+//!
+//! \return The status of the first directory that failed to flush, or DISIR_STATUS_OK.
+//!
+enum disir_status
+dx_write_transaction_finish (struct disir_instance *instance,
+                             struct disir_write_transaction **transaction);
+
 //! \brief get disir_register_plugin by group id
 enum disir_status
 dx_retrieve_plugin_by_group (struct disir_instance *instance, const char *group_id,
                              struct disir_register_plugin **plugin);
 
+//! \brief Hash string with djb2. http://www.cse.yorku.ca/~oz/hash.html
+//!
+//! \param[in] size Number of bytes of string to hash, or negative if string is
+//!     zero terminated. Either way, equal strings hash equal.
+//!
+unsigned long
+dx_hash_string (const char *string, int32_t size);
+
 #endif // _LIBDISIR_PRIVATE_DISIR_H
 
@@ -33,6 +33,10 @@ struct disir_documentation *dx_documentation_create (struct disir_context *paren
 //! memory and unhooking from linked list storage.
 enum disir_status dx_documentation_destroy (struct disir_documentation **documentation);
 
+//! Release what the disir_documentation structure holds,
+//! leaving the structure itself and its place in the parent untouched.
+void dx_documentation_release (struct disir_documentation *documentation);
+
 //! Return the number of documentation contexts associated with the passed context.
 //! \return -1 if invalid context
 int32_t dx_documentation_numentries (struct disir_context *context);
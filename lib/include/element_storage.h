@@ -4,9 +4,13 @@
 #include <disir/context.h>
 
 #include "collection.h"
+#include "name_table.h"
 
 //! Forward declare Disir Element Storage structure.
 //! This is a private structure, even to the internals of Disir.
+//!
+//! Elements are kept in a single array in insertion order. Small storages are
+//! searched linearly; a hash index by name is only built once the storage grows.
 struct disir_element_storage;
 
 //! \brief Allocate a new instance of the Disir Element Storage
@@ -24,6 +28,18 @@ dx_element_storage_create (void);
 enum disir_status
 dx_element_storage_destroy (struct disir_element_storage **storage);
 
+//! \brief Free a Disir Element Storage without destroying the contexts stored in it.
+//!
+//! The references held on the stored contexts are abandoned. Only applicable when
+//! the contexts are released by other means, see dx_context_release_arena().
+//!
+//! \param[in,out] storage Double-pointer to the allocated instance that shall be freed.
+//!                 The pointer is set to NULL when the element storage is free'd.
+//! \return DISIR_STATUS_OK when the storage was successfully freed.
+//!
+enum disir_status
+dx_element_storage_discard (struct disir_element_storage **storage);
+
 //! \brief Return the number of elements stored in the Disir Element Storage
 //!
 //! \param[in] storage Pointer to the element storage to query entries from.
@@ -54,11 +70,39 @@ dx_element_storage_add (struct disir_element_storage *storage,
                         const char *name,
                         struct disir_context *context);
 
+//! \brief Add a context to the storage by a name interned in table.
+//!
+//! Same as dx_element_storage_add, except the name is referenced rather than copied.
+//! The storage holds a reference on table for as long as it holds on to the name.
+//! Lookups by the interned pointer are resolved without comparing strings.
+//!
+//! \param[in] storage The input storage to store the context
+//! \param[in] name Name interned in table, used as key to store the context by.
+//! \param[in] table Name table that name is interned in.
+//! \param[in] context The context to store into the storage.
+//!
+//! \return DISIR_STATUS_INVALID_ARGUMENT if either storage, name, table or context are NULL.
+//! \return DISIR_STATUS_NO_MEMORY if no memory could be allocated for internal storage mechanism
+//! \return DISIR_STATUS_EXISTS if the context is already stored in storage (by the input name)
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dx_element_storage_add_interned (struct disir_element_storage *storage,
+                                 const char *name,
+                                 struct disir_name_table *table,
+                                 struct disir_context *context);
+
 //! \brief Remove a context from the element storage
 //!
-//! TODO: Not implemented
+//! The reference the storage held on the context is released.
 //!
-//! \return DISIR_STATUS_INTERNAL_ERROR
+//! \param[in] storage The storage to remove the context from.
+//! \param[in] name Name the context was stored by. Used to speed up the lookup.
+//! \param[in] context The context to remove.
+//!
+//! \return DISIR_STATUS_INVALID_ARGUMENT if storage or context are NULL.
+//! \return DISIR_STATUS_NOT_EXIST if the context is not in the storage.
+//! \return DISIR_STATUS_OK on success.
 enum disir_status
 dx_element_storage_remove (struct disir_element_storage *storage,
                            const char * const name,
@@ -96,6 +140,25 @@ enum disir_status
 dx_element_storage_get_all (struct disir_element_storage *storage,
                             struct disir_collection **collection);
 
+//! \brief Get the context at index among those stored under name, in insertion order.
+//!
+//! The lookup reads the storage in place and allocates nothing.
+//! The returned context is a borrowed reference; no reference count is incremented.
+//! The caller must dx_context_incref() it if it is to outlive the storage.
+//!
+//! \param[in] storage Query storage to retrieve context from.
+//! \param[in] name Query parameter to locate context by in storage
+//! \param[in] index Zero-based index among the contexts stored under name.
+//! \param[out] context Populated context on success.
+//!
+//! \return DISIR_STATUS_INVALID_ARGUMENT if storage, name or context are NULL.
+//! \return DISIR_STATUS_NOT_EXIST if no context is stored under name at index.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dx_element_storage_get_at (struct disir_element_storage *storage,
+                           const char *name, unsigned int index,
+                           struct disir_context **context);
 
 //! \brief Convenience method to get the first context with input name from storage.
 //!
@@ -0,0 +1,83 @@
+#ifndef _LIBDISIR_PRIVATE_ENTRY_INDEX_H
+#define _LIBDISIR_PRIVATE_ENTRY_INDEX_H
+
+#include <disir/disir.h>
+
+#ifdef __cplusplus
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include <sys/stat.h>
+
+//! State of a directory when it was indexed.
+struct entry_index_directory
+{
+    dev_t               ed_dev;
+    ino_t               ed_ino;
+    struct timespec     ed_mtime;
+
+    //! Non-zero if the directory was modified too close to the indexing to tell
+    //! later modifications apart by its modification time. Never trusted.
+    int                 ed_racy;
+};
+
+//! Every entry file with a given suffix below a base directory.
+struct disir_entry_index
+{
+    //! Indexed directories, relative to the base directory. The base directory itself is "".
+    std::map<std::string, struct entry_index_directory>    ei_directories;
+
+    //! Entry files relative to the base directory, without the suffix.
+    std::set<std::string>                                   ei_entries;
+
+    //! Entries named by a symbolic link. Those resolving to a regular file
+    //! are also in ei_entries. Never trusted by dx_entry_index_query.
+    std::set<std::string>                                   ei_links;
+};
+
+//! \brief Retrieve an up-to-date index of the entry files below basedir.
+//!
+//! The index is kept by the instance and reused as long as none of the indexed
+//! directories are modified, which costs a single stat per directory.
+//! Otherwise, the directory tree is rescanned with a pool of threads.
+//! The returned index is immutable and remains valid after being replaced.
+//!
+//! \param[in] basedir Directory to index. Must exist.
+//! \param[in] suffix Filename suffix of entry files, including the leading dot.
+//! \param[out] index Populated with the index.
+//!
+//! \return DISIR_STATUS_FS_ERROR if basedir cannot be read.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dx_entry_index_get (struct disir_instance *instance, const char *basedir, const char *suffix,
+                    std::shared_ptr<const struct disir_entry_index> &index);
+
+//! \brief Query an existing index for an entry file, relative to basedir and without suffix.
+//!
+//! Only the directory holding the entry is checked for modifications.
+//! No index is built by this call.
+//!
+//! \return DISIR_STATUS_EXISTS if the entry file exists.
+//! \return DISIR_STATUS_NOT_EXIST if the entry file does not exist.
+//! \return DISIR_STATUS_NO_CAN_DO if the index cannot answer. The caller must look up
+//!     the entry file itself.
+//!
+enum disir_status
+dx_entry_index_query (struct disir_instance *instance, const char *basedir, const char *suffix,
+                      const char *entry);
+
+extern "C" {
+#endif // __cplusplus
+
+//! \brief Drop every entry index held by the instance.
+void
+dx_entry_index_clear (struct disir_instance *instance);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // _LIBDISIR_PRIVATE_ENTRY_INDEX_H
@@ -1,6 +1,8 @@
 #ifndef _LIBDISIR_IMPORT_H
 #define _LIBDISIR_IMPORT_H
 
+#include <stddef.h>
+
 //! Defines the state of a single archive entry
 struct disir_import_entry
 {
@@ -49,9 +51,13 @@ dx_import_entry_destroy (struct disir_import_entry *entry);
 
 //! \brief Determine whether an archive entry conflicts or
 //!     simply cannot be imported.
+//!
+//! The serialized archive entry is read from memory at config_data, if set.
+//! Otherwise, it is read from the extracted file at config_path.
 enum disir_status
 dx_resolve_config_import_status (struct disir_instance *instance,
                                  const char *config_path,
+                                 const char *config_data, size_t config_size,
                                  struct disir_import_entry *import);
 
 #endif // _LIBDISIR_IMPORT_H
@@ -4,10 +4,18 @@
 #include "dplugin_json.h"
 #include <json/json.h>
 
+// cpp standard
+#include <string>
+#include <vector>
+#include <stdio.h>
+
 namespace dio
 {
     // A Class implementing o a
     // disir_config object in json
+    //
+    // The config is written in a single walk over its elements, straight into
+    // a buffered output. The layout is that of Json::StyledWriter::writeOrdered.
     class ConfigWriter : public JsonIO
     {
     public:
@@ -30,46 +38,109 @@ namespace dio
         //! \param[in] config Config object to be serialize.
         //! \param[out] stream Stream that will be conatined the serialized config.
         //!
+        //! \return DISIR_STATUS_FS_ERROR if writing to stream failed.
         //! \return DISIR_STATUS_OK on success.
         //!
         enum disir_status
         serialize (struct disir_config *config, std::ostream& stream);
 
+        //! \brief Serialize config to json
+        //!
+        //! \param[in] config Config object to be serialize.
+        //! \param[out] file File the serialized config is written to.
+        //!
+        //! \return DISIR_STATUS_FS_ERROR if writing to file failed.
+        //! \return DISIR_STATUS_OK on success.
+        //!
+        enum disir_status
+        serialize (struct disir_config *config, FILE *file);
+
      private:
+        //! Elements sharing a name under the same parent, in insertion order.
+        struct element_group
+        {
+            std::string eg_name;
+            std::vector<struct disir_context *> eg_elements;
+        };
+
         // Variables
-        Json::Value m_configRoot;
         struct disir_context *m_contextConfig;
 
+        //! Serialized output not yet flushed to m_stream or m_file
+        std::string m_buffer;
+        //! Output tokens are appended to. Either m_buffer or a single value token.
+        std::string *m_output;
+        std::ostream *m_stream;
+        FILE *m_file;
+
+        //! Current indentation
+        std::string m_indent;
+        //! Last character written, zero if nothing is written yet.
+        char m_last;
+
+        //! \brief Walk the config and write it to m_output, flushing as it grows.
+        enum disir_status
+        serialize_document (struct disir_config *config);
+
+        //! \brief Write buffered output to m_stream or m_file.
+        enum disir_status
+        flush ();
+
+        //! \brief Append to the output
+        void
+        push (const char *token, size_t size);
+
+        void
+        push (const std::string& token) { push (token.data (), token.size ()); }
+
+        //! \brief Start a new, indented line unless the current line awaits a value.
+        void
+        write_indent ();
+
+        void
+        write_with_indent (const std::string& token);
+
         //! \brief Retrive context name
         enum disir_status
         get_context_key (struct disir_context *context, std::string& key);
 
-        //! \brief Serialize section name
+        //! \brief Serialize config version
         enum disir_status
-        set_section_keyname (struct disir_context *context, Json::Value& parent,
-                             Json::Value& sectionVal);
+        write_config_version (struct disir_context *context_config);
 
-        // \brief Serialize keyval value
+        //! \brief Group the elements of parent by name, holding a reference to each.
         enum disir_status
-        set_keyval (struct disir_context *context, std::string name, Json::Value& node);
+        collect_groups (struct disir_context *parent, std::vector<struct element_group>& groups);
 
-        // \brief Serialize keyval name and value
+        //! \brief Release the element references held by groups.
+        void
+        release_groups (std::vector<struct element_group>& groups);
+
+        //! \brief Whether context serializes to null (empty section or unsupported value)
+        bool
+        is_null (struct disir_context *context);
+
+        // \brief Serialize keyval value
         enum disir_status
-        serialize_keyval (struct disir_context *context, Json::Value& parent);
+        write_keyval (struct disir_context *context);
 
-        //! \brief Serialize config version
+        //! \brief Serialize keyval or section. Members are written in insertion order
+        //! if ordered is set, sorted by name otherwise.
         enum disir_status
-        set_config_version (struct disir_context *context_config, Json::Value& root);
+        write_value (struct disir_context *context, bool ordered);
 
-        //! \brief recursive function that extracts an entire config starting from root
+        //! \brief Serialize the elements of a section or config as a json object.
         enum disir_status
-        _serialize_context (struct disir_context *parent_context, Json::Value& parent);
+        write_object (std::vector<struct element_group>& groups, bool ordered);
 
         //! \brief if a config has keyvals or sections with identical names
         //! under the same root, we merge them into an array.
-        void
-        serialize_duplicate_entries (Json::Value& parent, Json::Value& child,
-                                     const std::string name);
+        enum disir_status
+        write_group (struct element_group& group, bool ordered);
+
+        //! \brief Serialize duplicate entries as a json array.
+        enum disir_status
+        write_array (std::vector<struct disir_context *>& elements);
     };
 
     // Class implementing outputting a
@@ -0,0 +1,190 @@
+#ifndef DIO_JSON_STREAM_H
+#define DIO_JSON_STREAM_H
+
+#include <json/json.h>
+
+// cpp standard
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace dio
+{
+    //! Tokens produced by JsonTokenizer
+    enum json_token
+    {
+        JSON_TOKEN_OBJECT_BEGIN,
+        JSON_TOKEN_OBJECT_END,
+        JSON_TOKEN_ARRAY_BEGIN,
+        JSON_TOKEN_ARRAY_END,
+        JSON_TOKEN_MEMBER_SEPARATOR,
+        JSON_TOKEN_VALUE_SEPARATOR,
+        JSON_TOKEN_STRING,
+        JSON_TOKEN_INTEGER,
+        JSON_TOKEN_REAL,
+        JSON_TOKEN_TRUE,
+        JSON_TOKEN_FALSE,
+        JSON_TOKEN_NULL,
+        JSON_TOKEN_END,
+        JSON_TOKEN_ERROR,
+    };
+
+    //! \brief Pull tokenizer reading JSON straight from a stream.
+    //!
+    //! The tokenizer accepts the same dialect as the jsoncpp Reader used elsewhere
+    //! in this plugin, comments included, but never materializes more than the
+    //! current token. Errors are sticky; once a syntax error is recorded every
+    //! subsequent call returns JSON_TOKEN_ERROR.
+    //!
+    class JsonTokenizer
+    {
+    public:
+        //! \brief Construct a tokenizer reading from the stream buffer of stream.
+        JsonTokenizer (std::istream& stream);
+
+        //! \brief Construct a tokenizer reading from a contiguous span.
+        //!
+        //! The span is read in place and must outlive the tokenizer.
+        //!
+        JsonTokenizer (const char *data, size_t size);
+
+        //! \brief Read the next raw token.
+        enum json_token
+        next ();
+
+        //! \brief Read the next token, which must start a value.
+        enum json_token
+        next_value ();
+
+        //! \brief Read the next member of the current object.
+        //!
+        //! \param[in] first True if this is the first call after JSON_TOKEN_OBJECT_BEGIN.
+        //!
+        //! \return JSON_TOKEN_OBJECT_END when the object is exhausted.
+        //! \return JSON_TOKEN_ERROR on syntax error.
+        //! \return The first token of the member value otherwise. The member name is
+        //!     available through key () until the next member is read.
+        //!
+        enum json_token
+        next_member (bool first);
+
+        //! \brief Read the next element of the current array.
+        //!
+        //! \param[in] first True if this is the first call after JSON_TOKEN_ARRAY_BEGIN.
+        //!
+        //! \return JSON_TOKEN_ARRAY_END when the array is exhausted.
+        //! \return JSON_TOKEN_ERROR on syntax error.
+        //! \return The first token of the element value otherwise.
+        //!
+        enum json_token
+        next_element (bool first);
+
+        //! \brief Consume the remainder of the value started by token.
+        //!
+        //! \return false on syntax error.
+        //!
+        bool
+        skip_value (enum json_token token);
+
+        //! \brief Consume the remaining members of the current object.
+        bool
+        skip_members (bool first);
+
+        //! \brief Consume the remaining elements of the current array.
+        bool
+        skip_elements (bool first);
+
+        //! \brief Read the remainder of the value started by token into value.
+        //!
+        //! \return false on syntax error.
+        //!
+        bool
+        read_value (enum json_token token, Json::Value& value);
+
+        //! \brief Record a syntax error at the position of the last token.
+        //!
+        //! \return JSON_TOKEN_ERROR
+        //!
+        enum json_token
+        syntax_error (const std::string& message);
+
+        //! \brief Whether a syntax error has been recorded.
+        bool
+        failed () const { return m_failed; }
+
+        //! \brief Error message formatted like Json::Reader::getFormattedErrorMessages ()
+        std::string
+        error_message () const;
+
+        //! \brief Name of the current object member
+        const std::string&
+        key () const { return m_key; }
+
+        //! \brief Decoded contents of the last JSON_TOKEN_STRING
+        const std::string&
+        string () const { return m_string; }
+
+        //! \brief Value of the last JSON_TOKEN_INTEGER
+        int64_t
+        integer () const { return m_integer; }
+
+        //! \brief Value of the last JSON_TOKEN_REAL
+        double
+        real () const { return m_real; }
+
+    private:
+        //! Stream buffer to refill from, or NULL when reading a span
+        std::streambuf *m_buf;
+        std::vector<char> m_chunk;
+        //! Unread portion of the span or current chunk
+        const char *m_cur;
+        const char *m_end;
+
+        std::string m_key;
+        std::string m_string;
+        int64_t m_integer;
+        double m_real;
+
+        bool m_failed;
+        std::string m_error;
+        int m_depth;
+
+        //! Position of the next character
+        int m_line;
+        int m_column;
+        //! Position of the start of the last token
+        int m_token_line;
+        int m_token_column;
+
+        void
+        initialize ();
+
+        bool
+        refill ();
+
+        int
+        peek ();
+
+        int
+        get ();
+
+        bool
+        read_literal (const char *rest);
+
+        bool
+        read_comment ();
+
+        bool
+        read_string ();
+
+        bool
+        read_hex (unsigned int& unicode);
+
+        enum json_token
+        read_number (int first);
+    };
+}
+
+#endif
+
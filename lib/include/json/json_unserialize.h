@@ -4,6 +4,7 @@
 #include "dplugin_json.h"
 #include <json/json.h>
 #include "json/json_mold_override.h"
+#include "json/json_stream.h"
 
 // cpp standard
 #include <memory>
@@ -31,6 +32,10 @@ namespace dio
         enum disir_status
         unserialize (struct disir_config **config, const std::string Json);
 
+        //! \brief Read a disir_config from a contiguous span, without copying it
+        enum disir_status
+        unserialize (struct disir_config **config, const char *data, size_t size);
+
     private:
 
         //! \brief Sets a version on the config
@@ -60,9 +65,26 @@ namespace dio
         unserialize_keyval_entry (struct disir_context *parent_context,
                                   Json::OrderedValueIterator& keyval_entry);
 
-        //! \brief After unserialization into internal m_configRoot, this constructs the config.
+        //! \brief Construct the config while reading the document from tokens.
+        //!
+        //! \return DISIR_STATUS_FS_ERROR if the document is not valid json.
+        //!
+        enum disir_status
+        read_config (JsonTokenizer& tokens, struct disir_config **config);
+
+        //! \brief Read the members of the current json object into parent_context
+        enum disir_status
+        stream_node (JsonTokenizer& tokens, struct disir_context *parent_context);
+
+        //! \brief Read the elements of the current json array as multiple values of name
+        enum disir_status
+        stream_array (JsonTokenizer& tokens, struct disir_context *parent,
+                      const std::string& name);
+
+        //! \brief Read the value started by token according to its json type
         enum disir_status
-        construct_config (Json::Value& root, struct disir_config **config);
+        stream_type (JsonTokenizer& tokens, struct disir_context *context,
+                     enum json_token token, const std::string& name);
 
         //! \brief recursively reads a json config starting from root and
         //!     populated a disir_config accordingly
@@ -6,6 +6,8 @@
 
 #include "value.h"
 #include "default.h"
+#include "version_index.h"
+#include "name_table.h"
 
 struct disir_keyval
 {
@@ -22,13 +24,21 @@ struct disir_keyval
 
     //! Default entry queue
     struct disir_default        *kv_default_queue;
+    //! kv_default_queue in version order, for lookup by version.
+    struct disir_version_index  kv_default_index;
 
     //! Queue of documentation entries
     struct disir_documentation  *kv_documentation_queue;
+    //! kv_documentation_queue in version order, for lookup by version.
+    struct disir_version_index  kv_documentation_index;
 
-    //! Name of this keyval.
+    //! Name of this keyval. The string is interned in kv_name_table.
     struct disir_value          kv_name;
 
+    //! Name table kv_name is interned in. The keyval holds a reference on it.
+    //! NULL if no name is set.
+    struct disir_name_table     *kv_name_table;
+
     //! Value held by this KEYVAL, given its root is CONFIG.
     //! The value type is infered from this structure
     struct disir_value          kv_value;
@@ -37,6 +47,11 @@ struct disir_keyval
     uint32_t                    kv_disabled;
 
     struct disir_restriction    *kv_restrictions_queue;
+
+    //! Exclusive restrictions of kv_restrictions_queue compiled when the mold is finalized.
+    //! Only applicable to parent toplevel context DISIR_CONTEXT_MOLD.
+    //! NULL if not compiled, or discarded since. See restriction_program.h
+    struct disir_restriction_program    *kv_restriction_program;
 };
 
 //! Construct a DISIR_CONTEXT_KEYVAL as a child of parent.
@@ -52,6 +67,10 @@ struct disir_keyval *dx_keyval_create (struct disir_context *parent);
 //! memory and unhooking from linked list storage.
 enum disir_status dx_keyval_destroy (struct disir_keyval **keyval);
 
+//! Release what the disir_keyval structure holds besides its child contexts,
+//! leaving the structure itself and its children untouched.
+void dx_keyval_release (struct disir_keyval *keyval);
+
 
 #endif // _LIBDISIR_PRIVATE_KEYVAL_H
 
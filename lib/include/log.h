@@ -39,6 +39,36 @@ enum disir_log_level {
 };
 
 
+//! Variable to control the loglevel
+extern enum disir_log_level runtime_loglevel;
+
+//! Variable to control whether or not to forcefully output TRACE log messages
+//! regardless of loglevel setting
+extern int force_enable_trace;
+
+//! Debug log entries with a severity above this threshold are compiled out entirely.
+//! Set through the DISIR_LOG_DEBUG_MAX_SEVERITY build option.
+#ifndef DISIR_LOG_DEBUG_MAX_SEVERITY
+#define DISIR_LOG_DEBUG_MAX_SEVERITY 10
+#endif
+
+//! The log level a debug entry of severity is logged at.
+//! Severities outside 1-10 are logged at DISIR_LOG_LEVEL_DEBUG.
+#define dx_log_debug_level(severity) \
+    (((severity) <= 0 || (severity) > 10) ? (int) DISIR_LOG_LEVEL_DEBUG \
+                                          : (int) DISIR_LOG_LEVEL_DEBUG_01 * (severity))
+
+//! Cheap check whether a debug entry of severity would be output.
+//! Folds to a constant false for severities compiled out, such that neither
+//! the call nor the evaluation of its arguments remain.
+#define dx_log_debug_enabled(severity) \
+    ((severity) <= DISIR_LOG_DEBUG_MAX_SEVERITY \
+     && dx_log_debug_level (severity) <= (int) runtime_loglevel)
+
+//! Cheap check whether a trace entry of level would be output.
+#define dx_log_trace_enabled(level) \
+    ((int) (level) <= (int) runtime_loglevel || force_enable_trace)
+
 //! Generic function signature for all logging methods
 void dx_log_disir (enum disir_log_level dll,
                 int severity,
@@ -93,7 +123,10 @@ void dx_log_disir_va (enum disir_log_level dll,
 #define log_info_context(context, ...) \
     _log_disir_level_context (DISIR_LOG_LEVEL_INFO, 0, context, ##__VA_ARGS__)
 #define log_debug_context(severity, context, ...) \
-    _log_disir_level_context(DISIR_LOG_LEVEL_DEBUG, severity, context, ##__VA_ARGS__)
+    do { \
+        if (dx_log_debug_enabled (severity)) \
+            _log_disir_level_context(DISIR_LOG_LEVEL_DEBUG, severity, context, ##__VA_ARGS__); \
+    } while (0)
 
 //! Log at different log levels
 #define log_fatal(...) _log_disir_level(DISIR_LOG_LEVEL_FATAL, ##__VA_ARGS__)
@@ -101,9 +134,21 @@ void dx_log_disir_va (enum disir_log_level dll,
 #define log_warn(...) _log_disir_level(DISIR_LOG_LEVEL_WARNING, ##__VA_ARGS__)
 #define log_test(...) _log_disir_level(DISIR_LOG_LEVEL_TEST, ##__VA_ARGS__)
 #define log_info(...) _log_disir_level(DISIR_LOG_LEVEL_INFO, ##__VA_ARGS__)
-#define log_debug(severity, ...) _log_disir_level_debug(severity, ##__VA_ARGS__)
-#define TRACE_ENTER(...) _log_disir_level(DISIR_LOG_LEVEL_TRACE_ENTER, ##__VA_ARGS__)
-#define TRACE_EXIT(...) _log_disir_level(DISIR_LOG_LEVEL_TRACE_EXIT, ##__VA_ARGS__)
+#define log_debug(severity, ...) \
+    do { \
+        if (dx_log_debug_enabled (severity)) \
+            _log_disir_level_debug(severity, ##__VA_ARGS__); \
+    } while (0)
+#define TRACE_ENTER(...) \
+    do { \
+        if (dx_log_trace_enabled (DISIR_LOG_LEVEL_TRACE_ENTER)) \
+            _log_disir_level(DISIR_LOG_LEVEL_TRACE_ENTER, ##__VA_ARGS__); \
+    } while (0)
+#define TRACE_EXIT(...) \
+    do { \
+        if (dx_log_trace_enabled (DISIR_LOG_LEVEL_TRACE_EXIT)) \
+            _log_disir_level(DISIR_LOG_LEVEL_TRACE_EXIT, ##__VA_ARGS__); \
+    } while (0)
 
 
 // Log specially to context
@@ -112,6 +157,21 @@ void dx_log_disir_va (enum disir_log_level dll,
     _log_disir_full(DISIR_LOG_LEVEL_ERROR, 0, context, NULL, 1, NULL, ##__VA_ARGS__)
 
 
+//! \brief Set the filepath of the log file, replacing the current one.
+//!
+//! Lines logged so far are written to the previous log file first.
+//! The file is opened on the next logged line, and kept open.
+//! NULL or an empty filepath disables file logging altogether.
+//!
+void dx_log_set_filepath (const char *filepath);
+
+//! \brief Synchronously write out every buffered log line.
+//!
+//! Log lines are otherwise written out in batches by a background thread.
+//!
+void dx_log_flush (void);
+
+
 //! Crash and burn.. Output message on stderr before it aborts.
 //! USE WITH EXTREME CARE
 void dx_crash_and_burn(const char* message, ...);
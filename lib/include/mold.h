@@ -4,6 +4,8 @@
 #include "context_private.h"
 #include "documentation.h"
 #include "element_storage.h"
+#include "version_index.h"
+#include "name_table.h"
 
 //! Represents a complete mold instance.
 struct disir_mold
@@ -22,8 +24,13 @@ struct disir_mold
     //! Storage of element entries, either DISIR_CONTEXT_KEYVAL or DISIR_CONTEXT_SECTION.
     struct disir_element_storage    *mo_elements;
 
+    //! Names of every keyval and section in the mold, shared with their config equivalents.
+    struct disir_name_table         *mo_names;
+
     //! Documentation associated with the disir_mold.
     struct disir_documentation      *mo_documentation_queue;
+    //! mo_documentation_queue in version order, for lookup by version.
+    struct disir_version_index      mo_documentation_index;
 };
 
 //! INTERNAL API
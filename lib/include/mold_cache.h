@@ -0,0 +1,65 @@
+#ifndef _LIBDISIR_PRIVATE_MOLD_CACHE_H
+#define _LIBDISIR_PRIVATE_MOLD_CACHE_H
+
+#include <disir/disir.h>
+
+//! \brief Retrieve a previously read mold from the instance mold cache.
+//!
+//! Cached molds are keyed by the plugin that read them and the filepath they were read from.
+//! An entry is only handed out while the file at filepath, and the file at
+//! namespace_filepath if given, are unchanged (same inode, size and modification time)
+//! since the mold was inserted. Stale entries are evicted.
+//!
+//! \param[in] instance Instance holding the cache.
+//! \param[in] plugin Plugin the mold was read through.
+//! \param[in] filepath Filepath the mold was read from.
+//! \param[in] namespace_filepath Optional filepath of a namespace entry the mold depends on.
+//! \param[out] mold Populated with the cached mold, with its reference count incremented.
+//!
+//! \return DISIR_STATUS_INVALID_ARGUMENT if instance, plugin, filepath or mold are NULL.
+//! \return DISIR_STATUS_NOT_EXIST if no up-to-date mold is cached.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dx_mold_cache_lookup (struct disir_instance *instance, struct disir_register_plugin *plugin,
+                      const char *filepath, const char *namespace_filepath,
+                      struct disir_mold **mold);
+
+//! \brief Insert a mold read from filepath into the instance mold cache.
+//!
+//! The cache holds its own reference to mold. Any existing entry for the same
+//! plugin and filepath is replaced.
+//! The state of the files is recorded when inserted, so this should be invoked
+//! right after the mold is read.
+//!
+//! \return DISIR_STATUS_INVALID_ARGUMENT if instance, plugin, filepath or mold are NULL.
+//! \return DISIR_STATUS_NO_MEMORY if the entry could not be allocated.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dx_mold_cache_insert (struct disir_instance *instance, struct disir_register_plugin *plugin,
+                      const char *filepath, const char *namespace_filepath,
+                      struct disir_mold *mold);
+
+//! \brief Resolve the namespace entry a mold read from filepath depends on.
+//!
+//! An entry of its own may be a namespace override, depending on the namespace entry
+//! next to it. The cached mold must be invalidated if either of them change.
+//!
+//! \param[in] plugin Plugin the mold is read through.
+//! \param[in] filepath Filepath the mold is read from.
+//! \param[in] namespace_entry Non-zero if filepath is itself a namespace entry.
+//! \param[out] buffer Populated with the namespace entry filepath.
+//! \param[in] size Size of buffer.
+//!
+//! \return buffer if the mold depends on a namespace entry, NULL otherwise.
+//!
+const char *
+dx_mold_cache_namespace_filepath (struct disir_register_plugin *plugin, const char *filepath,
+                                  int namespace_entry, char *buffer, size_t size);
+
+//! \brief Drop every mold held by the instance mold cache.
+void
+dx_mold_cache_clear (struct disir_instance *instance);
+
+#endif // _LIBDISIR_PRIVATE_MOLD_CACHE_H
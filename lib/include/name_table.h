@@ -0,0 +1,48 @@
+#ifndef _LIBDISIR_PRIVATE_NAME_TABLE_H
+#define _LIBDISIR_PRIVATE_NAME_TABLE_H
+
+#include <stdint.h>
+
+//! Forward declare Disir Name Table structure.
+//!
+//! The name table interns the names of keyval and section contexts, such that
+//! every context of the same name references a single, immutable copy.
+//! Each mold owns a table, which config contexts share through their mold equivalent.
+//! Configs own a second table for names missing from the mold.
+//!
+//! Interned names live until the last reference on the table is dropped.
+//! Interning is not thread safe; reference counting is.
+struct disir_name_table;
+
+//! \brief Allocate a new, empty name table with a reference count of one.
+//!
+//! \return NULL if the allocation failed.
+//! \return Pointer to the newly allocated name table.
+//!
+struct disir_name_table *
+dx_name_table_create (void);
+
+//! \brief Return the interned copy of the first size bytes of name.
+//!
+//! The returned string is zero terminated, and shall never be modified.
+//! Interning equal names always returns the same pointer.
+//!
+//! \return NULL if the allocation failed.
+//! \return Pointer to the interned name.
+//!
+char *
+dx_name_table_intern (struct disir_name_table *table, const char *name, int32_t size);
+
+//! \brief Increment the reference count of the name table.
+void
+dx_name_table_incref (struct disir_name_table *table);
+
+//! \brief Decrement the reference count of the name table.
+//!
+//! When the reference count reaches zero, every interned name is released and
+//! the table pointer is set to NULL. The pointer is always set to NULL.
+//!
+void
+dx_name_table_decref (struct disir_name_table **table);
+
+#endif // _LIBDISIR_PRIVATE_NAME_TABLE_H
@@ -1,9 +1,35 @@
 #ifndef _LIBDISIR_PRIVATE_QUERY_H
 #define _LIBDISIR_PRIVATE_QUERY_H
 
+#include <stdint.h>
+
+//! A single name@index element of a compiled query.
+struct disir_query_segment
+{
+    //! Name of the element. Points into the qu_names buffer of the query.
+    const char                  *qs_name;
+    int                         qs_index;
+};
+
+//! A query parsed once by dc_query_compile.
+//! Immutable once compiled, such that it may be shared between threads.
+struct disir_query
+{
+    //! The query as it was compiled, used in error messages.
+    char                        *qu_query;
+
+    //! Segment names, each NUL terminated, stored back-to-back.
+    char                        *qu_names;
+
+    //! Segments in order, from the outermost element to the leaf.
+    struct disir_query_segment  *qu_segments;
+    int32_t                     qu_size;
+};
+
 //! \brief Resolve a heirarchical name structure by extracting first name and index
 //!
-//! \param[in] parent The context errors on this query should be logged to
+//! \param[in] parent The context errors on this query should be logged to.
+//!     NULL when parsing a query not yet associated with any context.
 //! \param[in,out] name The buffer containing the name and index to extract.
 //!     The buffer is modified so that the same pointer can be safely used to reference only
 //!     the name portion extracted (on success).
@@ -49,6 +75,26 @@ enum disir_status
 dx_query_resolve_parent_context (struct disir_context *parent, struct disir_context **out,
                                  char *keyval_name, const char *query, va_list args);
 
+//! \brief Check whether the leaf segment of a query may be created in section.
+//!
+//! The leaf is available if the entry at its index does not exist, but the one before it does.
+//!
+//! \return DISIR_STATUS_NOT_EXIST if the leaf may not be created.
+//! \return DISIR_STATUS_OK if the leaf may be created.
+//!
+enum disir_status
+dx_query_leaf_available (struct disir_context *section, struct disir_query_segment *leaf);
+
+//! \brief Resolve the parent context of the leaf node in a compiled query.
+//!
+//! Compiled query equivalent of dx_query_resolve_parent_context.
+//! The leaf name is the name of the last segment of query.
+//!
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dx_query_resolve_parent_compiled (struct disir_context *parent, struct disir_query *query,
+                                  struct disir_context **out);
 
 #endif // _LIBDISIR_PRIVATE_QUERY_H
 
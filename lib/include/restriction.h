@@ -3,6 +3,8 @@
 
 #include <disir/context.h>
 
+#include "version_index.h"
+
 
 struct disir_restriction
 {
@@ -16,6 +18,8 @@ struct disir_restriction
 
     //! Documentation for this restriction.
     struct disir_documentation  *re_documentation_queue;
+    //! re_documentation_queue in version order, for lookup by version.
+    struct disir_version_index  re_documentation_index;
 
     //! The type of restriction this entry represents
     enum disir_restriction_type re_type;
@@ -48,6 +52,10 @@ struct disir_restriction * dx_restriction_create (struct disir_context *parent);
 //! Free all resources belonging to disir_restriction structure (including itself)
 enum disir_status dx_restriction_destroy (struct disir_restriction **restriction);
 
+//! Release what the disir_restriction structure holds besides its child contexts,
+//! leaving the structure itself, its children and its place in the parent untouched.
+void dx_restriction_release (struct disir_restriction *restriction);
+
 //! \brief Retrieve the restriction queue in parent associated with tthe input restriction context.
 //!
 //! This requires that the restriction has a type set on it.
@@ -0,0 +1,60 @@
+#ifndef _LIBDISIR_PRIVATE_RESTRICTION_PROGRAM_H
+#define _LIBDISIR_PRIVATE_RESTRICTION_PROGRAM_H
+
+#include <disir/context.h>
+
+//! The exclusive value restrictions of a mold keyval, compiled into a form that
+//! checks a value in O(log n) for numeric restrictions and O(1) for enum restrictions.
+//!
+//! Every exclusive restriction is given a rank by its introduced version.
+//! The restrictions active for a config version are exactly those whose rank is lower
+//! than the number of restrictions introduced at or before that version. A value
+//! fulfills the restrictions if the lowest rank among the restrictions it matches
+//! is lower than that number.
+//!
+//! A program borrows the enum strings of the restrictions it was compiled from.
+//! It is discarded whenever the keyval or one of its restrictions changes.
+//!
+struct disir_restriction_program;
+
+//! \brief Compile the exclusive value restrictions of every keyval in a mold tree.
+//!
+//! Keyvals whose program fails to compile are left without one, and
+//! are checked by walking their restriction queue instead.
+//!
+//! \param[in] context MOLD or SECTION context whose keyvals to compile.
+//!
+void
+dx_restriction_program_compile_tree (struct disir_context *context);
+
+//! \brief Compile the exclusive value restrictions of a mold keyval.
+//!
+//! Any previously compiled program on the keyval is replaced.
+//!
+//! \return DISIR_STATUS_NO_MEMORY on allocation failure.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dx_restriction_program_compile (struct disir_context *keyval);
+
+//! \brief Free the program and set the pointer to NULL.
+void
+dx_restriction_program_destroy (struct disir_restriction_program **program);
+
+//! \brief Check a value against the restrictions active for version.
+//!
+//! \param[in] program Compiled program of the mold keyval.
+//! \param[in] version Version of the config the value belongs to.
+//! \param[in] string_value Value to check if the keyval is an ENUM.
+//! \param[in] value Value to check otherwise.
+//! \param[out] active Populated with the number of exclusive restrictions active for version.
+//!
+//! \return 1 if the value fulfills any of the active restrictions.
+//! \return 0 otherwise.
+//!
+int
+dx_restriction_program_check (struct disir_restriction_program *program,
+                              struct disir_version *version,
+                              const char *string_value, double value, int *active);
+
+#endif // _LIBDISIR_PRIVATE_RESTRICTION_PROGRAM_H
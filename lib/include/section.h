@@ -2,6 +2,8 @@
 #define _LIBDISIR_PRIVATE_SECTION_H
 
 #include "value.h"
+#include "version_index.h"
+#include "name_table.h"
 
 struct disir_section
 {
@@ -17,10 +19,16 @@ struct disir_section
     //! Version this section entry was introduced.
     struct disir_version                se_deprecated;
 
-    //! Name of this section.
+    //! Name of this section. The string is interned in se_name_table.
     struct disir_value                  se_name;
 
+    //! Name table se_name is interned in. The section holds a reference on it.
+    //! NULL if no name is set.
+    struct disir_name_table             *se_name_table;
+
     struct disir_documentation          *se_documentation_queue;
+    //! se_documentation_queue in version order, for lookup by version.
+    struct disir_version_index          se_documentation_index;
 
     //! Element storage for this section.
     struct disir_element_storage        *se_elements;
@@ -42,6 +50,10 @@ struct disir_section *dx_section_create (struct disir_context *parent);
 //! memory and unhooking from linked list storage.
 enum disir_status dx_section_destroy (struct disir_section **section);
 
+//! Release what the disir_section structure holds besides its child contexts
+//! and their element storage, leaving the structure itself and its children untouched.
+void dx_section_release (struct disir_section *section);
+
 
 #endif // _LIBDISIR_PRIVATE_SECTION_H
 
@@ -1,6 +1,9 @@
 #ifndef _LIBDISIR_PRIVATE_VALUE_H
 #define _LIBDISIR_PRIVATE_VALUE_H
 
+//! Size of the inline string buffer in struct disir_value, including the zero terminator.
+#define DISIR_VALUE_INLINE_SIZE 16
+
 struct disir_value
 {
     enum disir_value_type dv_type;
@@ -14,7 +17,17 @@ struct disir_value
 
     };
 
+    //! Length of dv_string, excluding the zero terminator.
     int64_t         dv_size;
+
+    //! Number of bytes heap allocated for dv_string, excluding the zero terminator.
+    //! Zero if dv_string is not heap allocated; either NULL, dv_inline or
+    //! referencing memory the value does not own.
+    int64_t         dv_capacity;
+
+    //! Short strings are stored inline, with dv_string pointing here.
+    //! A structure holding an inline string must not be copied by assignment.
+    char            dv_inline[DISIR_VALUE_INLINE_SIZE];
 };
 
 //! \brief Return a string represetation of the passed value type enum
@@ -79,11 +92,14 @@ enum disir_status dx_value_copy (struct disir_value *destination, struct disir_v
 
 //! \brief Set the input 'value' with the contents of the input 'input'
 //!
-//! Allocate and copy the input 'input' into the 'value' structure.
+//! Copy the input 'input' into the 'value' structure.
 //! Only 'size' bytes are copied and then an additional \0 terminator
 //! is appended to the stored string. Passing in a NULL string pointer results in
 //! the value to be emptied and set to zero length.
 //!
+//! Strings shorter than DISIR_VALUE_INLINE_SIZE are stored inline in 'value'.
+//! Longer strings reuse the heap buffer of 'value' if it is large enough.
+//!
 //! \param value Value object to store a value type.
 //! \param input Input string which shall be stored in the 'value' object.
 //! \param size Length of the input string. Only 'size' number of bytes
@@ -97,6 +113,26 @@ enum disir_status dx_value_copy (struct disir_value *destination, struct disir_v
 enum disir_status
 dx_value_set_string (struct disir_value *value, const char *input, int32_t size);
 
+//! \brief Change the type of value.
+//!
+//! Leaving the STRING or ENUM type releases the string held by value,
+//! since the other types share its storage.
+//!
+//! \param value Value object to change the type of.
+//! \param type Type value shall hold.
+//!
+void
+dx_value_set_type (struct disir_value *value, enum disir_value_type type);
+
+//! \brief Release the heap memory held by a string value, leaving it empty.
+//!
+//! Safe to call on values of any type, and on values that were never populated.
+//!
+//! \param value Value object to release the string of.
+//!
+void
+dx_value_free (struct disir_value *value);
+
 //! \brief Reterieve the string type stored in value
 //!
 //! \param[in] value Value object to retrieve the string value from.
@@ -0,0 +1,54 @@
+#ifndef _LIBDISIR_PRIVATE_VERSION_INDEX_H
+#define _LIBDISIR_PRIVATE_VERSION_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <disir/disir.h>
+
+//! Contiguous array of versioned entries, in ascending order of introduced version.
+//!
+//! The index mirrors an MQ queue of the same entries, such that the entry active
+//! for a given version is resolved by binary search instead of walking the queue.
+//! Entries are borrowed; the index never frees them.
+//!
+//! Insert and find take the offset of the introduced struct disir_version
+//! within the entry type, e.g., offsetof (struct disir_default, de_introduced).
+//! A zero-initialized structure is an empty index.
+//!
+struct disir_version_index
+{
+    void        **vi_entries;
+    int32_t     vi_size;
+    int32_t     vi_capacity;
+};
+
+//! \brief Insert entry after every entry introduced at or before its own version.
+//!
+//! \return DISIR_STATUS_NO_MEMORY if the index could not grow.
+//! \return DISIR_STATUS_OK on success.
+//!
+enum disir_status
+dx_version_index_insert (struct disir_version_index *index, void *entry, size_t offset);
+
+//! \brief Remove entry from the index. Does nothing if entry is not indexed.
+void
+dx_version_index_remove (struct disir_version_index *index, void *entry);
+
+//! \brief Resolve the entry active for version.
+//!
+//! The active entry is the greatest introduced at or before version.
+//! Mirroring the queue lookups this replaces, the first entry is returned if every
+//! entry is introduced after version, and the last entry if version is NULL.
+//!
+//! \return NULL if the index is empty.
+//!
+void *
+dx_version_index_find (struct disir_version_index *index, struct disir_version *version,
+                       size_t offset);
+
+//! \brief Free the memory held by the index, leaving it empty.
+void
+dx_version_index_free (struct disir_version_index *index);
+
+#endif // _LIBDISIR_PRIVATE_VERSION_INDEX_H
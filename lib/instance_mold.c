@@ -40,7 +40,8 @@ disir_libdisir_mold (struct disir_mold **mold)
         goto error;
 
     status = dc_add_keyval_string (context, "log_filepath", "/var/log/disir.log",
-                                   "Log filepath for the internal disir log", NULL, NULL);
+                                   "Log filepath for the internal disir log."
+                                   " An empty filepath disables the log.", NULL, NULL);
     if (status != DISIR_STATUS_OK)
         goto error;
 
@@ -3,6 +3,10 @@
 #include <stdarg.h>
 #include <time.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
 
 #include <disir/disir.h>
 
@@ -20,6 +24,64 @@ enum disir_log_level runtime_loglevel = DISIR_LOG_LEVEL_DEBUG_01;
 //! Hardcode default for now.
 int force_enable_trace = 0;
 
+//! Size of each of the two log buffers.
+//! Producers append formatted lines to the active buffer,
+//! while the flusher thread writes out the other.
+#define LOG_BUFFER_SIZE (64 * 1024)
+
+//! Maximum size of a single formatted log line. Longer lines are truncated.
+#define LOG_LINE_SIZE 4096
+
+//! Interval, in milliseconds, at which the flusher thread writes out buffered lines.
+#define LOG_FLUSH_INTERVAL_MS 200
+
+//! Filepath logged to until overridden by dx_log_set_filepath ().
+#define LOG_DEFAULT_FILEPATH "/var/log/disir.log"
+
+//! Buffered log backend.
+//! The log file is kept open for the lifetime of the process, and lines are written
+//! out in batches by a background thread instead of opening the file for every line.
+struct log_backend
+{
+    //! Protects every member below, except lb_spare.
+    pthread_mutex_t     lb_mutex;
+    //! Held while writing to lb_fd. Always acquired after lb_mutex, if both are held.
+    //! Serializes the flusher thread and synchronous writers, preserving line order.
+    pthread_mutex_t     lb_write_mutex;
+    //! Signals the flusher thread that the active buffer is filling up, or to stop.
+    pthread_cond_t      lb_cond;
+
+    pthread_t           lb_flusher;
+    int                 lb_flusher_running;
+    int                 lb_stop;
+
+    //! Open log file descriptor. -1 if not yet opened, or if opening failed.
+    int                 lb_fd;
+    //! Set if opening lb_filepath failed - do not retry on every line.
+    int                 lb_open_failed;
+    //! Empty if file logging is disabled.
+    char                lb_filepath[4096];
+
+    char                *lb_active;
+    size_t              lb_active_used;
+    char                *lb_spare;
+
+    char                lb_buffers[2][LOG_BUFFER_SIZE];
+};
+
+static struct log_backend log_backend = {
+    .lb_mutex = PTHREAD_MUTEX_INITIALIZER,
+    .lb_write_mutex = PTHREAD_MUTEX_INITIALIZER,
+    .lb_cond = PTHREAD_COND_INITIALIZER,
+    .lb_fd = -1,
+    .lb_filepath = LOG_DEFAULT_FILEPATH,
+};
+
+//! Cached timestamp prefix, recomputed only when the second changes.
+static _Thread_local time_t log_timestamp_second = (time_t) -1;
+static _Thread_local char log_timestamp[32];
+static _Thread_local size_t log_timestamp_size;
+
 //! STATIC USAGE
 static const char *
 map_dll_to_string (enum disir_log_level dll)
@@ -63,6 +125,319 @@ dx_crash_and_burn (const char* message, ...)
     abort ();
 }
 
+//! STATIC API
+//! Write the whole buffer to fd, retrying on partial writes.
+//! Requires lb_write_mutex to be held.
+static void
+log_backend_write_fd (int fd, const char *buffer, size_t size)
+{
+    ssize_t res;
+
+    while (size > 0)
+    {
+        res = write (fd, buffer, size);
+        if (res < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            // Nowhere to report this. Drop the data.
+            return;
+        }
+        buffer += res;
+        size -= res;
+    }
+}
+
+//! STATIC API
+//! Open the log file, if not already open.
+//! Requires lb_mutex to be held.
+static void
+log_backend_open (void)
+{
+    if (log_backend.lb_fd >= 0 || log_backend.lb_open_failed)
+        return;
+
+    if (log_backend.lb_filepath[0] == '\0')
+    {
+        log_backend.lb_open_failed = 1;
+        return;
+    }
+
+    log_backend.lb_fd = open (log_backend.lb_filepath,
+                              O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (log_backend.lb_fd < 0)
+    {
+        log_backend.lb_open_failed = 1;
+    }
+}
+
+//! STATIC API
+//! Synchronously write out the active buffer.
+//! Requires lb_mutex to be held.
+static void
+log_backend_flush_locked (void)
+{
+    pthread_mutex_lock (&log_backend.lb_write_mutex);
+    if (log_backend.lb_fd >= 0 && log_backend.lb_active_used > 0)
+    {
+        log_backend_write_fd (log_backend.lb_fd,
+                              log_backend.lb_active, log_backend.lb_active_used);
+    }
+    log_backend.lb_active_used = 0;
+    pthread_mutex_unlock (&log_backend.lb_write_mutex);
+}
+
+//! STATIC API
+//! Background thread writing out the active buffer at regular intervals,
+//! or whenever it is half full.
+static void *
+log_backend_flusher (void *arg)
+{
+    struct timespec deadline;
+    char *buffer;
+    size_t size;
+    int fd;
+
+    (void) arg;
+
+    pthread_mutex_lock (&log_backend.lb_mutex);
+    while (1)
+    {
+        if (log_backend.lb_stop == 0 && log_backend.lb_active_used < LOG_BUFFER_SIZE / 2)
+        {
+            clock_gettime (CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += LOG_FLUSH_INTERVAL_MS * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L)
+            {
+                deadline.tv_sec += 1;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait (&log_backend.lb_cond, &log_backend.lb_mutex, &deadline);
+        }
+
+        if (log_backend.lb_active_used == 0)
+        {
+            if (log_backend.lb_stop)
+                break;
+            continue;
+        }
+
+        // Swap buffers, and write out the filled one without blocking producers.
+        buffer = log_backend.lb_active;
+        size = log_backend.lb_active_used;
+        fd = log_backend.lb_fd;
+        log_backend.lb_active = log_backend.lb_spare;
+        log_backend.lb_active_used = 0;
+        log_backend.lb_spare = buffer;
+
+        pthread_mutex_lock (&log_backend.lb_write_mutex);
+        pthread_mutex_unlock (&log_backend.lb_mutex);
+
+        if (fd >= 0)
+        {
+            log_backend_write_fd (fd, buffer, size);
+        }
+
+        pthread_mutex_unlock (&log_backend.lb_write_mutex);
+        pthread_mutex_lock (&log_backend.lb_mutex);
+    }
+    pthread_mutex_unlock (&log_backend.lb_mutex);
+
+    return NULL;
+}
+
+//! STATIC API
+//! The child of a fork has no flusher thread, and its parent owns the buffered lines.
+static void
+log_backend_atfork_prepare (void)
+{
+    pthread_mutex_lock (&log_backend.lb_mutex);
+    pthread_mutex_lock (&log_backend.lb_write_mutex);
+}
+
+//! STATIC API
+static void
+log_backend_atfork_parent (void)
+{
+    pthread_mutex_unlock (&log_backend.lb_write_mutex);
+    pthread_mutex_unlock (&log_backend.lb_mutex);
+}
+
+//! STATIC API
+static void
+log_backend_atfork_child (void)
+{
+    log_backend.lb_active_used = 0;
+    log_backend.lb_flusher_running = 0;
+    pthread_mutex_unlock (&log_backend.lb_write_mutex);
+    pthread_mutex_unlock (&log_backend.lb_mutex);
+}
+
+//! STATIC API
+//! Start the flusher thread, if not already running.
+//! Requires lb_mutex to be held.
+static void
+log_backend_start (void)
+{
+    static int atfork_registered = 0;
+
+    if (log_backend.lb_active == NULL)
+    {
+        log_backend.lb_active = log_backend.lb_buffers[0];
+        log_backend.lb_spare = log_backend.lb_buffers[1];
+    }
+
+    if (log_backend.lb_flusher_running || log_backend.lb_stop)
+        return;
+
+    if (atfork_registered == 0)
+    {
+        pthread_atfork (log_backend_atfork_prepare,
+                        log_backend_atfork_parent,
+                        log_backend_atfork_child);
+        atfork_registered = 1;
+    }
+
+    // Without a flusher thread, lines are written out synchronously.
+    if (pthread_create (&log_backend.lb_flusher, NULL, log_backend_flusher, NULL) == 0)
+    {
+        log_backend.lb_flusher_running = 1;
+    }
+}
+
+//! STATIC API
+//! Append a complete, newline terminated line to the log backend.
+static void
+log_backend_append (const char *line, size_t size)
+{
+    pthread_mutex_lock (&log_backend.lb_mutex);
+
+    log_backend_open ();
+    if (log_backend.lb_fd < 0)
+    {
+        pthread_mutex_unlock (&log_backend.lb_mutex);
+        return;
+    }
+
+    log_backend_start ();
+
+    if (size > LOG_BUFFER_SIZE - log_backend.lb_active_used)
+    {
+        // Buffer full. Write out synchronously rather than dropping lines.
+        log_backend_flush_locked ();
+    }
+
+    memcpy (log_backend.lb_active + log_backend.lb_active_used, line, size);
+    log_backend.lb_active_used += size;
+
+    if (log_backend.lb_flusher_running == 0)
+    {
+        // No flusher thread (e.g., after shutdown) - write out immediately.
+        log_backend_flush_locked ();
+    }
+    else if (log_backend.lb_active_used >= LOG_BUFFER_SIZE / 2)
+    {
+        pthread_cond_signal (&log_backend.lb_cond);
+    }
+
+    pthread_mutex_unlock (&log_backend.lb_mutex);
+}
+
+//! STATIC API
+//! Stop the flusher thread and write out any pending lines, on exit or library unload.
+__attribute__((destructor))
+static void
+log_backend_shutdown (void)
+{
+    pthread_mutex_lock (&log_backend.lb_mutex);
+    log_backend.lb_stop = 1;
+    pthread_cond_signal (&log_backend.lb_cond);
+    pthread_mutex_unlock (&log_backend.lb_mutex);
+
+    if (log_backend.lb_flusher_running)
+    {
+        pthread_join (log_backend.lb_flusher, NULL);
+        log_backend.lb_flusher_running = 0;
+    }
+
+    pthread_mutex_lock (&log_backend.lb_mutex);
+    log_backend_flush_locked ();
+    if (log_backend.lb_fd >= 0)
+    {
+        close (log_backend.lb_fd);
+        log_backend.lb_fd = -1;
+    }
+    pthread_mutex_unlock (&log_backend.lb_mutex);
+}
+
+//! INTERNAL API
+void
+dx_log_set_filepath (const char *filepath)
+{
+    pthread_mutex_lock (&log_backend.lb_mutex);
+
+    if (filepath == NULL)
+    {
+        filepath = "";
+    }
+
+    if (strcmp (log_backend.lb_filepath, filepath) == 0)
+    {
+        pthread_mutex_unlock (&log_backend.lb_mutex);
+        return;
+    }
+
+    // Lines logged so far belong to the previous file.
+    log_backend_flush_locked ();
+    if (log_backend.lb_fd >= 0)
+    {
+        close (log_backend.lb_fd);
+        log_backend.lb_fd = -1;
+    }
+
+    snprintf (log_backend.lb_filepath, sizeof (log_backend.lb_filepath), "%s", filepath);
+    log_backend.lb_open_failed = 0;
+
+    pthread_mutex_unlock (&log_backend.lb_mutex);
+}
+
+//! INTERNAL API
+void
+dx_log_flush (void)
+{
+    pthread_mutex_lock (&log_backend.lb_mutex);
+    log_backend_flush_locked ();
+    pthread_mutex_unlock (&log_backend.lb_mutex);
+}
+
+//! STATIC API
+//! Map the severity of a DISIR_LOG_LEVEL_DEBUG entry to its DEBUG_XX log level.
+static enum disir_log_level
+log_normalize_level (enum disir_log_level dll, int severity)
+{
+    if (dll != DISIR_LOG_LEVEL_DEBUG)
+        return dll;
+
+    if (severity <= 0 || severity > 10)
+        return DISIR_LOG_LEVEL_DEBUG;
+
+    return (enum disir_log_level) (DISIR_LOG_LEVEL_DEBUG_01 * severity);
+}
+
+//! STATIC API
+//! Return 1 if the normalized log level shall be output.
+static int
+log_level_enabled (enum disir_log_level dll)
+{
+    // Let TRACE messages through if force_enable_trace is set
+    if (dll == DISIR_LOG_LEVEL_TRACE_ENTER || dll == DISIR_LOG_LEVEL_TRACE_EXIT)
+    {
+        return (dll <= runtime_loglevel || force_enable_trace);
+    }
+
+    return (dll <= runtime_loglevel);
+}
+
 //! implements the actual stream logging
 //! prefix is injected between the fmt message and the timestamp/loglevel
 //! Ignored if null
@@ -70,80 +445,38 @@ static void
 dx_log_format (enum disir_log_level dll, int severity, const char *prefix,
                const char *suffix, const char* fmt_message, va_list args)
 {
-    char buffer[512];
-    size_t time_written;
+    char buffer[LOG_LINE_SIZE];
+    size_t written;
     int res;
     size_t buffer_size;
-    FILE *stream;
     time_t now;
-    struct tm *utctime;
+    struct tm utctime;
     char dll_prefix[10];
 
-    buffer_size = 512;
+    buffer_size = LOG_LINE_SIZE;
 
-    // Normalize debug level
-    if (dll == DISIR_LOG_LEVEL_DEBUG)
-    {
-        switch (severity)
-        {
-        case 0:
-            dll = DISIR_LOG_LEVEL_DEBUG;
-            break;
-        case 1:
-            dll = DISIR_LOG_LEVEL_DEBUG_01;
-            break;
-        case 2:
-            dll = DISIR_LOG_LEVEL_DEBUG_02;
-            break;
-        case 3:
-            dll = DISIR_LOG_LEVEL_DEBUG_03;
-            break;
-        case 4:
-            dll = DISIR_LOG_LEVEL_DEBUG_04;
-            break;
-        case 5:
-            dll = DISIR_LOG_LEVEL_DEBUG_05;
-            break;
-        case 6:
-            dll = DISIR_LOG_LEVEL_DEBUG_06;
-            break;
-        case 7:
-            dll = DISIR_LOG_LEVEL_DEBUG_07;
-            break;
-        case 8:
-            dll = DISIR_LOG_LEVEL_DEBUG_08;
-            break;
-        case 9:
-            dll = DISIR_LOG_LEVEL_DEBUG_09;
-            break;
-        case 10:
-            dll = DISIR_LOG_LEVEL_DEBUG_10;
-            break;
-        }
-    }
+    dll = log_normalize_level (dll, severity);
 
     // Dont log anything if loglevel doesnt match
-    // Let TRACE messages through if force_enable_trace is set
-    if (dll != DISIR_LOG_LEVEL_TRACE_ENTER && dll != DISIR_LOG_LEVEL_TRACE_EXIT)
-    {
-        if (dll > runtime_loglevel)
-            return;
-    }
-    else if (dll > runtime_loglevel && !force_enable_trace)
-    {
+    if (log_level_enabled (dll) == 0)
         return;
-    }
 
-    // Get UTC time
+    // Get UTC time - only reformatted once a second, per thread.
     time (&now);
-    utctime = gmtime (&now);
-
-    time_written = strftime (buffer, buffer_size, "[%Y-%m-%d %H:%M:%S]", utctime);
-    if (time_written >= buffer_size || time_written == 0)
+    if (now != log_timestamp_second)
     {
-        dx_crash_and_burn ("strftime returned: %d - not within buffer size: %d",
-            time_written, buffer_size);
+        gmtime_r (&now, &utctime);
+        log_timestamp_size = strftime (log_timestamp, sizeof (log_timestamp),
+                                       "[%Y-%m-%d %H:%M:%S]", &utctime);
+        if (log_timestamp_size == 0)
+        {
+            dx_crash_and_burn ("strftime returned: %d - not within buffer size: %d",
+                log_timestamp_size, sizeof (log_timestamp));
+        }
+        log_timestamp_second = now;
     }
+    memcpy (buffer, log_timestamp, log_timestamp_size);
+    written = log_timestamp_size;
 
     // Prepare the log level prefix string
     if (dll >= DISIR_LOG_LEVEL_DEBUG &&
@@ -165,44 +498,43 @@ dx_log_format (enum disir_log_level dll, int severity, const char *prefix,
         snprintf (dll_prefix, 6, "%s", map_dll_to_string (dll));
     }
 
-    res = snprintf (buffer + time_written, buffer_size - time_written,
+    res = snprintf (buffer + written, buffer_size - written,
             "-[%s] %s%s",
             dll_prefix,
             (prefix != NULL ? prefix : ""),
             (prefix != NULL ? " " : "")
             );
-    if (res >= (int)(buffer_size - time_written) || res < 0)
+    if (res >= (int)(buffer_size - written) || res < 0)
     {
         // Buffer not large enough, or encoding error..
         dx_crash_and_burn ("snprintf() returned res: %d - size: %d",
-            res, buffer_size - time_written);
+            res, buffer_size - written);
     }
+    written += res;
 
-    // Prepare outgoing stream
-    stream = fopen ("/var/log/disir.log", "a");
-
-    // Cant open file output stream! Bleh!
-    if (stream == NULL)
+    // Write incomming log message and suffix. Truncate if it does not fit,
+    // leaving room for the newline.
+    res = vsnprintf (buffer + written, buffer_size - written - 1, fmt_message, args);
+    if (res > 0)
     {
-      // Throw a tantrum?
-      return;
+        written += ((size_t) res < buffer_size - written - 1 ? (size_t) res
+                                                             : buffer_size - written - 2);
     }
 
-    // Output buffer with time, loglevel and context
-    fwrite (buffer, time_written + res, sizeof (char), stream);
-
-    // Write incomming log message
-    vfprintf (stream, fmt_message, args);
-
-    // Write suffix
     if (suffix != NULL)
-        fwrite (suffix, strlen (suffix), sizeof (char), stream); // XXX
+    {
+        res = snprintf (buffer + written, buffer_size - written - 1, "%s", suffix);
+        if (res > 0)
+        {
+            written += ((size_t) res < buffer_size - written - 1 ? (size_t) res
+                                                                 : buffer_size - written - 2);
+        }
+    }
 
     // Append newline to log message
-    fprintf (stream, "\n");
+    buffer[written++] = '\n';
 
-    // close output stream. We dont want to keep it open forever, atleast not yet.
-    fclose (stream);
+    log_backend_append (buffer, written);
 }
 
 //! INTERNAL API
@@ -310,6 +642,7 @@ dx_log_disir (enum disir_log_level dll,
             const char *fmt_message,
             va_list args)
 {
+    struct disir_error_slot *error_slot;
     char *prefix;
     char *suffix;
     char buffer[60];
@@ -325,6 +658,13 @@ dx_log_disir (enum disir_log_level dll,
     prefix = NULL;
     suffix = NULL;
 
+    // Nothing to store, and nothing to output. Get out before any formatting.
+    if (log_context == 0 && instance == NULL
+        && log_level_enabled (log_normalize_level (dll, severity)) == 0)
+    {
+        return;
+    }
+
     if (log_context)
     {
         va_copy (args_copy, args);
@@ -334,11 +674,14 @@ dx_log_disir (enum disir_log_level dll,
 
     if (instance != NULL)
     {
-        va_copy (args_copy, args);
-
-        dx_internal_log_to_storage (&instance->disir_error_message,
-                                    &instance->disir_error_message_size, fmt_message, args_copy);
-        va_end (args_copy);
+        error_slot = dx_error_slot (instance, 1);
+        if (error_slot)
+        {
+            va_copy (args_copy, args);
+            dx_internal_log_to_storage (&error_slot->es_message,
+                                        &error_slot->es_message_size, fmt_message, args_copy);
+            va_end (args_copy);
+        }
     }
 
     if (context)
@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <disir/disir.h>
+
+#include "disir_private.h"
+#include "mold_cache.h"
+#include "mold.h"
+#include "mqueue.h"
+#include "log.h"
+
+
+//! State of a file a cached mold was read from.
+struct mold_cache_file
+{
+    //! Zero if the file did not exist.
+    int                 mf_exists;
+    dev_t               mf_dev;
+    ino_t               mf_ino;
+    off_t               mf_size;
+    struct timespec     mf_mtime;
+};
+
+//! A mold held by the instance mold cache.
+struct disir_mold_cache_entry
+{
+    //! Plugin the mold was read through.
+    struct disir_register_plugin    *mc_plugin;
+
+    //! Filepath the mold was read from.
+    char                            *mc_filepath;
+
+    //! State of mc_filepath when the mold was read.
+    struct mold_cache_file          mc_file;
+
+    //! State of the namespace entry the mold depends on, if any.
+    struct mold_cache_file          mc_namespace;
+
+    //! Reference held by the cache.
+    struct disir_mold               *mc_mold;
+
+    struct disir_mold_cache_entry   *next, *prev;
+};
+
+
+//! STATIC API
+static void
+mold_cache_file_stat (const char *filepath, struct mold_cache_file *file)
+{
+    struct stat statbuf;
+
+    memset (file, 0, sizeof (struct mold_cache_file));
+
+    if (filepath == NULL || stat (filepath, &statbuf) != 0)
+        return;
+
+    file->mf_exists = 1;
+    file->mf_dev = statbuf.st_dev;
+    file->mf_ino = statbuf.st_ino;
+    file->mf_size = statbuf.st_size;
+    file->mf_mtime = statbuf.st_mtim;
+}
+
+//! STATIC API
+static int
+mold_cache_file_equal (const struct mold_cache_file *lhs, const struct mold_cache_file *rhs)
+{
+    if (lhs->mf_exists != rhs->mf_exists)
+        return 0;
+    if (lhs->mf_exists == 0)
+        return 1;
+
+    return (lhs->mf_dev == rhs->mf_dev
+            && lhs->mf_ino == rhs->mf_ino
+            && lhs->mf_size == rhs->mf_size
+            && lhs->mf_mtime.tv_sec == rhs->mf_mtime.tv_sec
+            && lhs->mf_mtime.tv_nsec == rhs->mf_mtime.tv_nsec);
+}
+
+//! STATIC API
+static void
+mold_cache_entry_destroy (struct disir_mold_cache_entry *entry)
+{
+    disir_mold_finished (&entry->mc_mold);
+    free (entry->mc_filepath);
+    free (entry);
+}
+
+//! STATIC API
+static struct disir_mold_cache_entry *
+mold_cache_find (struct disir_instance *instance, struct disir_register_plugin *plugin,
+                 const char *filepath)
+{
+    return MQ_FIND (instance->dio_mold_cache_queue,
+                    (entry->mc_plugin == plugin && strcmp (entry->mc_filepath, filepath) == 0));
+}
+
+//! INTERNAL API
+const char *
+dx_mold_cache_namespace_filepath (struct disir_register_plugin *plugin, const char *filepath,
+                                  int namespace_entry, char *buffer, size_t size)
+{
+    char *sep;
+    size_t length;
+
+    if (namespace_entry || plugin == NULL || filepath == NULL)
+        return NULL;
+
+    length = strlen (filepath);
+    if (length >= size)
+        return NULL;
+
+    memcpy (buffer, filepath, length + 1);
+    sep = strrchr (buffer, '/');
+    if (sep == NULL
+        || snprintf (sep, size - (sep - buffer), "/__namespace.%s", plugin->dp_mold_entry_type)
+           >= (int) (size - (sep - buffer)))
+    {
+        return NULL;
+    }
+
+    return buffer;
+}
+
+//! INTERNAL API
+enum disir_status
+dx_mold_cache_lookup (struct disir_instance *instance, struct disir_register_plugin *plugin,
+                      const char *filepath, const char *namespace_filepath,
+                      struct disir_mold **mold)
+{
+    struct disir_mold_cache_entry *entry;
+    struct mold_cache_file file;
+    struct mold_cache_file namespace_file;
+
+    if (instance == NULL || plugin == NULL || filepath == NULL || mold == NULL)
+    {
+        log_debug (0, "invoked with NULL argument(s). instance (%p) plugin (%p)"
+                      " filepath (%p) mold (%p)", instance, plugin, filepath, mold);
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    pthread_mutex_lock (&instance->dio_mold_cache_mutex);
+    entry = mold_cache_find (instance, plugin, filepath);
+    if (entry == NULL)
+    {
+        pthread_mutex_unlock (&instance->dio_mold_cache_mutex);
+        return DISIR_STATUS_NOT_EXIST;
+    }
+
+    mold_cache_file_stat (filepath, &file);
+    mold_cache_file_stat (namespace_filepath, &namespace_file);
+
+    if (mold_cache_file_equal (&entry->mc_file, &file) == 0
+        || mold_cache_file_equal (&entry->mc_namespace, &namespace_file) == 0)
+    {
+        log_debug (4, "evicting stale mold cache entry: %s", filepath);
+        MQ_REMOVE_SAFE (instance->dio_mold_cache_queue, entry);
+        mold_cache_entry_destroy (entry);
+        pthread_mutex_unlock (&instance->dio_mold_cache_mutex);
+        return DISIR_STATUS_NOT_EXIST;
+    }
+
+    __atomic_add_fetch (&entry->mc_mold->mo_reference_count, 1, __ATOMIC_RELAXED);
+    *mold = entry->mc_mold;
+    pthread_mutex_unlock (&instance->dio_mold_cache_mutex);
+
+    return DISIR_STATUS_OK;
+}
+
+//! INTERNAL API
+enum disir_status
+dx_mold_cache_insert (struct disir_instance *instance, struct disir_register_plugin *plugin,
+                      const char *filepath, const char *namespace_filepath,
+                      struct disir_mold *mold)
+{
+    struct disir_mold_cache_entry *entry;
+    struct disir_mold_cache_entry *previous;
+
+    if (instance == NULL || plugin == NULL || filepath == NULL || mold == NULL)
+    {
+        log_debug (0, "invoked with NULL argument(s). instance (%p) plugin (%p)"
+                      " filepath (%p) mold (%p)", instance, plugin, filepath, mold);
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    entry = calloc (1, sizeof (struct disir_mold_cache_entry));
+    if (entry == NULL)
+    {
+        return DISIR_STATUS_NO_MEMORY;
+    }
+
+    entry->mc_filepath = strdup (filepath);
+    if (entry->mc_filepath == NULL)
+    {
+        free (entry);
+        return DISIR_STATUS_NO_MEMORY;
+    }
+
+    entry->mc_plugin = plugin;
+    mold_cache_file_stat (filepath, &entry->mc_file);
+    mold_cache_file_stat (namespace_filepath, &entry->mc_namespace);
+
+    __atomic_add_fetch (&mold->mo_reference_count, 1, __ATOMIC_RELAXED);
+    entry->mc_mold = mold;
+
+    // Replace any previous entry for the same file. Another thread may have
+    // inserted one while this mold was read.
+    pthread_mutex_lock (&instance->dio_mold_cache_mutex);
+    previous = mold_cache_find (instance, plugin, filepath);
+    if (previous)
+    {
+        MQ_REMOVE_SAFE (instance->dio_mold_cache_queue, previous);
+        mold_cache_entry_destroy (previous);
+    }
+    MQ_ENQUEUE (instance->dio_mold_cache_queue, entry);
+    pthread_mutex_unlock (&instance->dio_mold_cache_mutex);
+
+    return DISIR_STATUS_OK;
+}
+
+//! INTERNAL API
+void
+dx_mold_cache_clear (struct disir_instance *instance)
+{
+    struct disir_mold_cache_entry *entry;
+
+    if (instance == NULL)
+        return;
+
+    pthread_mutex_lock (&instance->dio_mold_cache_mutex);
+    while ((entry = MQ_POP (instance->dio_mold_cache_queue)))
+    {
+        mold_cache_entry_destroy (entry);
+    }
+    pthread_mutex_unlock (&instance->dio_mold_cache_mutex);
+}
@@ -0,0 +1,199 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "disir_private.h"
+#include "name_table.h"
+#include "log.h"
+
+
+//! Initial number of slots in the table. Must be a power of two.
+#define NAME_TABLE_INIT_CAPACITY 64
+
+//! A single interned name.
+struct name_table_entry
+{
+    //! Interned, zero terminated name. NULL if the slot is empty.
+    char            *ne_name;
+
+    //! Cached hash of ne_name.
+    unsigned long   ne_hash;
+
+    //! Length of ne_name, excluding the zero terminator.
+    int32_t         ne_size;
+};
+
+struct disir_name_table
+{
+    //! Arena the interned names are allocated from.
+    struct disir_arena          *nt_arena;
+
+    //! Open addressed hash set of interned names.
+    struct name_table_entry     *nt_entries;
+
+    //! Number of names interned.
+    int32_t                     nt_size;
+
+    //! Number of slots in nt_entries. Always a power of two.
+    int32_t                     nt_capacity;
+
+    //! Number of references held on the table.
+    int64_t                     nt_refcount;
+};
+
+//! STATIC API
+//! Return the slot holding name, or the empty slot it would be inserted into.
+static struct name_table_entry *
+name_table_slot (struct name_table_entry *entries, int32_t capacity,
+                 const char *name, int32_t size, unsigned long hash)
+{
+    struct name_table_entry *entry;
+    int32_t slot;
+
+    slot = (int32_t) (hash & (capacity - 1));
+    while (1)
+    {
+        entry = &entries[slot];
+        if (entry->ne_name == NULL)
+            return entry;
+
+        if (entry->ne_hash == hash && entry->ne_size == size
+            && memcmp (entry->ne_name, name, size) == 0)
+        {
+            return entry;
+        }
+
+        slot = (slot + 1) & (capacity - 1);
+    }
+}
+
+//! STATIC API
+//! Double the number of slots in the table, keeping the load factor at or below one half.
+static int
+name_table_grow (struct disir_name_table *table)
+{
+    struct name_table_entry *entries;
+    struct name_table_entry *entry;
+    int32_t capacity;
+    int32_t i;
+
+    capacity = (table->nt_capacity ? table->nt_capacity * 2 : NAME_TABLE_INIT_CAPACITY);
+    entries = calloc (capacity, sizeof (struct name_table_entry));
+    if (entries == NULL)
+        return 0;
+
+    for (i = 0; i < table->nt_capacity; i++)
+    {
+        entry = &table->nt_entries[i];
+        if (entry->ne_name == NULL)
+            continue;
+
+        *name_table_slot (entries, capacity, entry->ne_name,
+                          entry->ne_size, entry->ne_hash) = *entry;
+    }
+
+    free (table->nt_entries);
+    table->nt_entries = entries;
+    table->nt_capacity = capacity;
+
+    return 1;
+}
+
+//! INTERNAL API
+struct disir_name_table *
+dx_name_table_create (void)
+{
+    struct disir_name_table *table;
+
+    table = calloc (1, sizeof (struct disir_name_table));
+    if (table == NULL)
+        return NULL;
+
+    // No chunk is allocated until the first name is interned.
+    table->nt_arena = dx_arena_create ();
+    if (table->nt_arena == NULL)
+    {
+        free (table);
+        return NULL;
+    }
+
+    table->nt_refcount = 1;
+
+    return table;
+}
+
+//! INTERNAL API
+char *
+dx_name_table_intern (struct disir_name_table *table, const char *name, int32_t size)
+{
+    struct name_table_entry *entry;
+    unsigned long hash;
+    char *interned;
+
+    if (table == NULL || name == NULL || size < 0)
+    {
+        log_debug (0, "invoked with invalid argument(s) (table %p, name %p, size %d)",
+                   table, name, size);
+        return NULL;
+    }
+
+    if (2 * (table->nt_size + 1) > table->nt_capacity && name_table_grow (table) == 0)
+    {
+        log_warn ("in name_table (%p) - failed to grow to fit %d names",
+                  table, table->nt_size + 1);
+        return NULL;
+    }
+
+    hash = dx_hash_string (name, size);
+    entry = name_table_slot (table->nt_entries, table->nt_capacity, name, size, hash);
+    if (entry->ne_name)
+    {
+        return entry->ne_name;
+    }
+
+    // Arena memory is zeroed; the terminator comes for free.
+    interned = dx_arena_alloc (table->nt_arena, size + 1);
+    if (interned == NULL)
+    {
+        log_warn ("in name_table (%p) - failed to allocate name of size %d", table, size);
+        return NULL;
+    }
+    memcpy (interned, name, size);
+
+    entry->ne_name = interned;
+    entry->ne_hash = hash;
+    entry->ne_size = size;
+    table->nt_size++;
+
+    return interned;
+}
+
+//! INTERNAL API
+void
+dx_name_table_incref (struct disir_name_table *table)
+{
+    if (table == NULL)
+        return;
+
+    __atomic_add_fetch (&table->nt_refcount, 1, __ATOMIC_RELAXED);
+}
+
+//! INTERNAL API
+void
+dx_name_table_decref (struct disir_name_table **table)
+{
+    struct disir_name_table *tmp;
+
+    if (table == NULL || *table == NULL)
+        return;
+
+    tmp = *table;
+    *table = NULL;
+
+    if (__atomic_sub_fetch (&tmp->nt_refcount, 1, __ATOMIC_ACQ_REL) > 0)
+        return;
+
+    dx_arena_decref (&tmp->nt_arena);
+    free (tmp->nt_entries);
+    free (tmp);
+}
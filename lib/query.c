@@ -31,12 +31,6 @@ dx_query_resolve_name (struct disir_context *parent, char *name, char *resolved,
     name_below = NULL;
     name_above = name;
 
-    if (parent == NULL)
-    {
-        log_fatal ("parent NULL pointer passed to internal function, that should never be called with invalid context...");
-        return DISIR_STATUS_INTERNAL_ERROR;
-    }
-
     key_seperator = strchr (name_above, '.');
     if (key_seperator != NULL)
     {
@@ -170,14 +164,13 @@ dx_query_resolve_parent_context (struct disir_context *parent, struct disir_cont
     char resolved[2048];
     char *last = NULL;
     struct disir_context *section;
+    struct disir_query_segment leaf;
     va_list args_copy;
     char *next;
     int index;
-    struct disir_collection *collection;
     char *keyval_entry;
 
     section = NULL;
-    collection = NULL;
 
     va_copy (args_copy, args);
     vsnprintf (buffer, 2048, query, args_copy);
@@ -222,19 +215,11 @@ dx_query_resolve_parent_context (struct disir_context *parent, struct disir_cont
     status = dx_query_resolve_name (section, keyval_entry, resolved, &next, &index);
     if (status == DISIR_STATUS_OK)
     {
-        // Query section for the collection of entries matching keyval name.
-        // We let the NOT_EXIST go through, so that the collection size == 0 is valid
-        status = dc_find_elements (section, keyval_entry, &collection);
-        if (status != DISIR_STATUS_OK && status != DISIR_STATUS_NOT_EXIST)
-        {
-            goto error;
-        }
-
-        // If the size equals the index (that is the index is refering to size + 1 th entry
-        // then this is a valid query
-        if (dc_collection_size (collection) != index)
+        leaf.qs_name = keyval_entry;
+        leaf.qs_index = index;
+        status = dx_query_leaf_available (section, &leaf);
+        if (status != DISIR_STATUS_OK)
         {
-            status = DISIR_STATUS_NOT_EXIST;
             goto error;
         }
     }
@@ -251,10 +236,6 @@ error:
     {
         dc_putcontext (&section);
     }
-    if (collection)
-    {
-        dc_collection_finished (&collection);
-    }
 
     return status;
 }
@@ -322,3 +303,267 @@ dc_query_resolve_context_va (struct disir_context *parent, const char *name,
 }
 
 
+
+//! PUBLIC API
+enum disir_status
+dc_query_compile (struct disir_query **query, const char *name, ...)
+{
+    enum disir_status status;
+    va_list args;
+
+    va_start (args, name);
+    status = dc_query_compile_va (query, name, args);
+    va_end (args);
+
+    return status;
+}
+
+//! PUBLIC API
+enum disir_status
+dc_query_compile_va (struct disir_query **query, const char *name, va_list args)
+{
+    enum disir_status status;
+    struct disir_query *compiled;
+    va_list args_copy;
+    char *resolved;
+    char *current;
+    char *next;
+    int index;
+    int size;
+    int32_t i;
+
+    if (query == NULL || name == NULL)
+    {
+        log_debug (0, "invoked with NULL pointer(s) (query (%p), name (%p))", query, name);
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    resolved = NULL;
+    compiled = calloc (1, sizeof (struct disir_query));
+    if (compiled == NULL)
+    {
+        return DISIR_STATUS_NO_MEMORY;
+    }
+
+    va_copy (args_copy, args);
+    size = vsnprintf (NULL, 0, name, args_copy);
+    va_end (args_copy);
+    if (size <= 0)
+    {
+        log_debug (0, "invoked with empty query.");
+        status = DISIR_STATUS_INVALID_ARGUMENT;
+        goto error;
+    }
+
+    // The resolved names never exceed the query they are resolved from.
+    compiled->qu_query = malloc (size + 1);
+    compiled->qu_names = malloc (size + 1);
+    resolved = malloc (size + 1);
+    if (compiled->qu_query == NULL || compiled->qu_names == NULL || resolved == NULL)
+    {
+        status = DISIR_STATUS_NO_MEMORY;
+        goto error;
+    }
+    vsnprintf (compiled->qu_query, size + 1, name, args);
+    memcpy (compiled->qu_names, compiled->qu_query, size + 1);
+
+    // One segment more than there are key seperators.
+    compiled->qu_size = 1;
+    for (current = compiled->qu_names; *current != '\0'; current++)
+    {
+        if (*current == '.')
+            compiled->qu_size += 1;
+    }
+    compiled->qu_segments = calloc (compiled->qu_size, sizeof (struct disir_query_segment));
+    if (compiled->qu_segments == NULL)
+    {
+        status = DISIR_STATUS_NO_MEMORY;
+        goto error;
+    }
+
+    resolved[0] = '\0';
+    current = compiled->qu_names;
+    for (i = 0; i < compiled->qu_size; i++)
+    {
+        next = NULL;
+        status = dx_query_resolve_name (NULL, current, resolved, &next, &index);
+        if (status != DISIR_STATUS_OK)
+        {
+            // Already logged
+            goto error;
+        }
+        if (*current == '\0')
+        {
+            log_debug (0, "'%s' missing key after key seperator.", compiled->qu_query);
+            status = DISIR_STATUS_INVALID_ARGUMENT;
+            goto error;
+        }
+
+        compiled->qu_segments[i].qs_name = current;
+        compiled->qu_segments[i].qs_index = index;
+        current = next;
+    }
+
+    free (resolved);
+    *query = compiled;
+    return DISIR_STATUS_OK;
+error:
+    free (resolved);
+    dc_query_finished (&compiled);
+    return status;
+}
+
+//! PUBLIC API
+enum disir_status
+dc_query_finished (struct disir_query **query)
+{
+    if (query == NULL || *query == NULL)
+    {
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    free ((*query)->qu_query);
+    free ((*query)->qu_names);
+    free ((*query)->qu_segments);
+    free (*query);
+    *query = NULL;
+
+    return DISIR_STATUS_OK;
+}
+
+//! STATIC API
+//! Resolve the first count segments of query, relative to parent.
+//! Zero segments resolve to parent itself.
+static enum disir_status
+query_resolve_segments (struct disir_context *parent, struct disir_query *query,
+                        int32_t count, struct disir_context **out)
+{
+    enum disir_status status;
+    struct disir_context *current;
+    struct disir_context *found;
+    struct disir_query_segment *segment;
+    int32_t i;
+
+    dx_context_incref (parent);
+    current = parent;
+
+    for (i = 0; i < count; i++)
+    {
+        segment = &query->qu_segments[i];
+
+        status = dc_find_element (current, segment->qs_name, segment->qs_index, &found);
+        dc_putcontext (&current);
+        if (status == DISIR_STATUS_NOT_EXIST)
+        {
+            dx_log_context (parent, "Unable to locate entry '%s@%d' of query '%s'",
+                                    segment->qs_name, segment->qs_index, query->qu_query);
+            return status;
+        }
+        else if (status != DISIR_STATUS_OK)
+        {
+            dx_log_context (parent, "unknown error occurred in name resolution.");
+            return status;
+        }
+
+        current = found;
+    }
+
+    *out = current;
+    return DISIR_STATUS_OK;
+}
+
+//! INTERNAL API
+enum disir_status
+dx_query_leaf_available (struct disir_context *section, struct disir_query_segment *leaf)
+{
+    enum disir_status status;
+    struct disir_context *context;
+
+    // The query is only valid if the index is refering to the size + 1 th entry,
+    // that is, the entry at index does not exist but the one before it does.
+    if (leaf->qs_index < 0)
+    {
+        return DISIR_STATUS_NOT_EXIST;
+    }
+    status = dc_find_element (section, leaf->qs_name, leaf->qs_index, &context);
+    if (status == DISIR_STATUS_OK)
+    {
+        dc_putcontext (&context);
+        return DISIR_STATUS_NOT_EXIST;
+    }
+    else if (status != DISIR_STATUS_NOT_EXIST)
+    {
+        return status;
+    }
+
+    if (leaf->qs_index > 0)
+    {
+        status = dc_find_element (section, leaf->qs_name, leaf->qs_index - 1, &context);
+        if (status != DISIR_STATUS_OK)
+        {
+            return status;
+        }
+        dc_putcontext (&context);
+    }
+
+    return DISIR_STATUS_OK;
+}
+
+//! INTERNAL API
+enum disir_status
+dx_query_resolve_parent_compiled (struct disir_context *parent, struct disir_query *query,
+                                  struct disir_context **out)
+{
+    enum disir_status status;
+    struct disir_context *section;
+
+    section = NULL;
+
+    status = query_resolve_segments (parent, query, query->qu_size - 1, &section);
+    if (status != DISIR_STATUS_OK)
+    {
+        return status;
+    }
+
+    status = dx_query_leaf_available (section, &query->qu_segments[query->qu_size - 1]);
+    if (status != DISIR_STATUS_OK)
+    {
+        dc_putcontext (&section);
+        return status;
+    }
+
+    *out = section;
+    return DISIR_STATUS_OK;
+}
+
+//! PUBLIC API
+enum disir_status
+dc_query_resolve (struct disir_context *parent, struct disir_query *query,
+                  struct disir_context **out)
+{
+    enum disir_status status;
+
+    status = CONTEXT_NULL_INVALID_TYPE_CHECK (parent);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
+        return status;
+    }
+
+    status = CONTEXT_TYPE_CHECK (parent, DISIR_CONTEXT_MOLD,
+                                         DISIR_CONTEXT_CONFIG,
+                                         DISIR_CONTEXT_SECTION);
+    if (status != DISIR_STATUS_OK)
+    {
+        // Already logged
+        return status;
+    }
+
+    if (query == NULL || out == NULL)
+    {
+        log_debug (0, "invoked with NULL pointer(s) (query (%p), out (%p))", query, out);
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
+
+    return query_resolve_segments (parent, query, query->qu_size, out);
+}
@@ -0,0 +1,467 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <disir/disir.h>
+
+#include "context_private.h"
+#include "disir_private.h"
+#include "keyval.h"
+#include "restriction.h"
+#include "restriction_program.h"
+#include "log.h"
+
+
+//! Rank of values matched by no restriction.
+#define PROGRAM_NO_MATCH INT32_MAX
+
+//! Minimum number of buckets in the enum index. Must be a power of two.
+#define PROGRAM_INIT_BUCKETS 16
+
+//! A single enum value in the program index.
+struct program_enum_entry
+{
+    //! Borrowed from the restriction. NULL if the bucket is empty.
+    const char                  *pe_value;
+    unsigned long               pe_hash;
+    //! Lowest rank of the restrictions allowing this value.
+    int32_t                     pe_rank;
+};
+
+struct disir_restriction_program
+{
+    //! Introduced version of each exclusive restriction, indexed by rank.
+    //! In ascending order.
+    struct disir_version        *rp_introduced;
+    int32_t                     rp_count;
+
+    //! Sorted, unique endpoints of every numeric range and value.
+    double                      *rp_points;
+    int32_t                     rp_npoints;
+
+    //! Lowest rank of the restrictions matching each point in rp_points,
+    //! and the open interval between each point and the next.
+    int32_t                     *rp_point_rank;
+    int32_t                     *rp_gap_rank;
+
+    //! Open addressed index of enum values.
+    struct program_enum_entry   *rp_enums;
+    //! Number of buckets in rp_enums. Zero or a power of two.
+    int32_t                     rp_nbuckets;
+};
+
+//! STATIC API
+//! Stable insertion sort of restrictions by introduced version.
+//! Restrictions are mostly introduced in queue order, making this close to linear.
+static void
+program_rank_sort (struct disir_restriction **ranked, int32_t count)
+{
+    struct disir_restriction *current;
+    int32_t i;
+    int32_t j;
+
+    for (i = 1; i < count; i++)
+    {
+        current = ranked[i];
+        j = i;
+        while (j > 0
+               && dc_version_compare (&ranked[j - 1]->re_introduced, &current->re_introduced) > 0)
+        {
+            ranked[j] = ranked[j - 1];
+            j--;
+        }
+        ranked[j] = current;
+    }
+}
+
+//! STATIC API
+static int
+program_point_compare (const void *lhs, const void *rhs)
+{
+    double a = *(const double *) lhs;
+    double b = *(const double *) rhs;
+
+    return (a < b ? -1 : (a > b));
+}
+
+//! STATIC API
+//! Index of point in the sorted, unique rp_points, or -1 if absent.
+//! If absent, below is populated with the number of points lower than value.
+static int32_t
+program_point_find (struct disir_restriction_program *program, double value, int32_t *below)
+{
+    int32_t low;
+    int32_t high;
+    int32_t middle;
+
+    low = 0;
+    high = program->rp_npoints;
+    while (low < high)
+    {
+        middle = low + (high - low) / 2;
+        if (program->rp_points[middle] < value)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    *below = low;
+    if (low < program->rp_npoints && program->rp_points[low] == value)
+        return low;
+
+    return -1;
+}
+
+//! STATIC API
+//! Return the bucket holding value, or the empty bucket it would be inserted into.
+static int32_t
+program_enum_bucket (struct disir_restriction_program *program, const char *value,
+                     unsigned long hash)
+{
+    struct program_enum_entry *entry;
+    int32_t bucket;
+    int32_t mask;
+
+    mask = program->rp_nbuckets - 1;
+    bucket = (int32_t) (hash & mask);
+    while ((entry = &program->rp_enums[bucket])->pe_value != NULL)
+    {
+        if (entry->pe_hash == hash && strcmp (entry->pe_value, value) == 0)
+            break;
+        bucket = (bucket + 1) & mask;
+    }
+
+    return bucket;
+}
+
+//! STATIC API
+static enum disir_status
+program_compile_numeric (struct disir_restriction_program *program,
+                         struct disir_restriction **ranked, int32_t numeric)
+{
+    struct disir_restriction *restriction;
+    double min;
+    double max;
+    int32_t rank;
+    int32_t lo;
+    int32_t hi;
+    int32_t unused;
+    int32_t i;
+    int32_t j;
+
+    program->rp_points = calloc (2 * numeric, sizeof (double));
+    if (program->rp_points == NULL)
+        return DISIR_STATUS_NO_MEMORY;
+
+    for (rank = 0; rank < program->rp_count; rank++)
+    {
+        restriction = ranked[rank];
+        if (restriction->re_type == DISIR_RESTRICTION_EXC_VALUE_RANGE)
+        {
+            program->rp_points[program->rp_npoints++] = restriction->re_value_min;
+            program->rp_points[program->rp_npoints++] = restriction->re_value_max;
+        }
+        else if (restriction->re_type == DISIR_RESTRICTION_EXC_VALUE_NUMERIC)
+        {
+            program->rp_points[program->rp_npoints++] = restriction->re_value_numeric;
+        }
+    }
+
+    qsort (program->rp_points, program->rp_npoints, sizeof (double), program_point_compare);
+    for (i = 0, j = 0; i < program->rp_npoints; i++)
+    {
+        if (j == 0 || program->rp_points[i] != program->rp_points[j - 1])
+            program->rp_points[j++] = program->rp_points[i];
+    }
+    program->rp_npoints = j;
+
+    program->rp_point_rank = malloc (program->rp_npoints * sizeof (int32_t));
+    program->rp_gap_rank = malloc (program->rp_npoints * sizeof (int32_t));
+    if (program->rp_point_rank == NULL || program->rp_gap_rank == NULL)
+        return DISIR_STATUS_NO_MEMORY;
+
+    for (i = 0; i < program->rp_npoints; i++)
+    {
+        program->rp_point_rank[i] = PROGRAM_NO_MATCH;
+        program->rp_gap_rank[i] = PROGRAM_NO_MATCH;
+    }
+
+    // Ranks are visited in ascending order - the first to cover a point is the lowest.
+    for (rank = 0; rank < program->rp_count; rank++)
+    {
+        restriction = ranked[rank];
+        if (restriction->re_type == DISIR_RESTRICTION_EXC_VALUE_RANGE)
+        {
+            min = restriction->re_value_min;
+            max = restriction->re_value_max;
+        }
+        else if (restriction->re_type == DISIR_RESTRICTION_EXC_VALUE_NUMERIC)
+        {
+            min = max = restriction->re_value_numeric;
+        }
+        else
+        {
+            continue;
+        }
+
+        lo = program_point_find (program, min, &unused);
+        hi = program_point_find (program, max, &unused);
+        for (i = lo; i >= 0 && i <= hi; i++)
+        {
+            if (program->rp_point_rank[i] == PROGRAM_NO_MATCH)
+                program->rp_point_rank[i] = rank;
+            if (i < hi && program->rp_gap_rank[i] == PROGRAM_NO_MATCH)
+                program->rp_gap_rank[i] = rank;
+        }
+    }
+
+    return DISIR_STATUS_OK;
+}
+
+//! STATIC API
+static enum disir_status
+program_compile_enum (struct disir_restriction_program *program,
+                      struct disir_restriction **ranked, int32_t enums)
+{
+    struct disir_restriction *restriction;
+    struct program_enum_entry *entry;
+    unsigned long hash;
+    int32_t rank;
+
+    // Keep the load factor at or below one half.
+    program->rp_nbuckets = PROGRAM_INIT_BUCKETS;
+    while (program->rp_nbuckets < 2 * enums)
+        program->rp_nbuckets <<= 1;
+
+    program->rp_enums = calloc (program->rp_nbuckets, sizeof (struct program_enum_entry));
+    if (program->rp_enums == NULL)
+        return DISIR_STATUS_NO_MEMORY;
+
+    for (rank = 0; rank < program->rp_count; rank++)
+    {
+        restriction = ranked[rank];
+        if (restriction->re_type != DISIR_RESTRICTION_EXC_VALUE_ENUM
+            || restriction->re_value_string == NULL)
+        {
+            continue;
+        }
+
+        hash = dx_hash_string (restriction->re_value_string, -1);
+        entry = &program->rp_enums[program_enum_bucket (program, restriction->re_value_string,
+                                                        hash)];
+        // The first rank to insert a value is its lowest.
+        if (entry->pe_value == NULL)
+        {
+            entry->pe_value = restriction->re_value_string;
+            entry->pe_hash = hash;
+            entry->pe_rank = rank;
+        }
+    }
+
+    return DISIR_STATUS_OK;
+}
+
+//! INTERNAL API
+enum disir_status
+dx_restriction_program_compile (struct disir_context *keyval)
+{
+    enum disir_status status;
+    struct disir_restriction_program *program;
+    struct disir_restriction **ranked;
+    struct disir_restriction *restriction;
+    int32_t numeric;
+    int32_t enums;
+    int32_t rank;
+
+    program = NULL;
+    ranked = NULL;
+    numeric = 0;
+    enums = 0;
+
+    dx_restriction_program_destroy (&keyval->cx_keyval->kv_restriction_program);
+
+    program = calloc (1, sizeof (struct disir_restriction_program));
+    if (program == NULL)
+    {
+        status = DISIR_STATUS_NO_MEMORY;
+        goto error;
+    }
+
+    for (restriction = keyval->cx_keyval->kv_restrictions_queue; restriction != NULL;
+         restriction = restriction->next)
+    {
+        if (restriction->re_type == DISIR_RESTRICTION_EXC_VALUE_RANGE
+            || restriction->re_type == DISIR_RESTRICTION_EXC_VALUE_NUMERIC)
+        {
+            numeric++;
+        }
+        else if (restriction->re_type == DISIR_RESTRICTION_EXC_VALUE_ENUM)
+        {
+            enums++;
+        }
+    }
+
+    program->rp_count = numeric + enums;
+    if (program->rp_count != 0)
+    {
+        ranked = calloc (program->rp_count, sizeof (struct disir_restriction *));
+        program->rp_introduced = calloc (program->rp_count, sizeof (struct disir_version));
+        if (ranked == NULL || program->rp_introduced == NULL)
+        {
+            status = DISIR_STATUS_NO_MEMORY;
+            goto error;
+        }
+    }
+
+    rank = 0;
+    for (restriction = keyval->cx_keyval->kv_restrictions_queue; restriction != NULL;
+         restriction = restriction->next)
+    {
+        if (restriction->re_type == DISIR_RESTRICTION_EXC_VALUE_RANGE
+            || restriction->re_type == DISIR_RESTRICTION_EXC_VALUE_NUMERIC
+            || restriction->re_type == DISIR_RESTRICTION_EXC_VALUE_ENUM)
+        {
+            ranked[rank++] = restriction;
+        }
+    }
+
+    program_rank_sort (ranked, program->rp_count);
+    for (rank = 0; rank < program->rp_count; rank++)
+    {
+        dc_version_set (&program->rp_introduced[rank], &ranked[rank]->re_introduced);
+    }
+
+    if (numeric != 0)
+    {
+        status = program_compile_numeric (program, ranked, numeric);
+        if (status != DISIR_STATUS_OK)
+            goto error;
+    }
+    if (enums != 0)
+    {
+        status = program_compile_enum (program, ranked, enums);
+        if (status != DISIR_STATUS_OK)
+            goto error;
+    }
+
+    log_debug_context (8, keyval, "compiled %d numeric and %d enum restrictions",
+                       numeric, enums);
+
+    free (ranked);
+    keyval->cx_keyval->kv_restriction_program = program;
+    return DISIR_STATUS_OK;
+error:
+    free (ranked);
+    dx_restriction_program_destroy (&program);
+    return status;
+}
+
+//! INTERNAL API
+void
+dx_restriction_program_compile_tree (struct disir_context *context)
+{
+    enum disir_status status;
+    struct disir_collection *collection;
+    struct disir_context *element;
+
+    collection = NULL;
+    element = NULL;
+
+    status = dc_get_elements (context, &collection);
+    if (status != DISIR_STATUS_OK)
+    {
+        log_debug (2, "cannot compile restrictions - failed to retrieve elements: %s",
+                      disir_status_string (status));
+        return;
+    }
+
+    while (dc_collection_next_borrowed (collection, &element) == DISIR_STATUS_OK)
+    {
+        if (dc_context_type (element) == DISIR_CONTEXT_SECTION)
+        {
+            dx_restriction_program_compile_tree (element);
+        }
+        else if (dc_context_type (element) == DISIR_CONTEXT_KEYVAL)
+        {
+            status = dx_restriction_program_compile (element);
+            if (status != DISIR_STATUS_OK)
+            {
+                log_warn_context (element, "failed to compile restrictions: %s",
+                                           disir_status_string (status));
+            }
+        }
+    }
+
+    dc_collection_finished (&collection);
+}
+
+//! INTERNAL API
+void
+dx_restriction_program_destroy (struct disir_restriction_program **program)
+{
+    if (program == NULL || *program == NULL)
+        return;
+
+    free ((*program)->rp_introduced);
+    free ((*program)->rp_points);
+    free ((*program)->rp_point_rank);
+    free ((*program)->rp_gap_rank);
+    free ((*program)->rp_enums);
+    free (*program);
+    *program = NULL;
+}
+
+//! INTERNAL API
+int
+dx_restriction_program_check (struct disir_restriction_program *program,
+                              struct disir_version *version,
+                              const char *string_value, double value, int *active)
+{
+    struct program_enum_entry *entry;
+    int32_t low;
+    int32_t high;
+    int32_t middle;
+    int32_t index;
+    int32_t below;
+    int32_t rank;
+
+    // Number of restrictions introduced at or before version.
+    low = 0;
+    high = program->rp_count;
+    while (low < high)
+    {
+        middle = low + (high - low) / 2;
+        if (dc_version_compare (&program->rp_introduced[middle], version) <= 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    *active = low;
+
+    rank = PROGRAM_NO_MATCH;
+    if (string_value != NULL)
+    {
+        if (program->rp_nbuckets != 0)
+        {
+            entry = &program->rp_enums[program_enum_bucket (program, string_value,
+                                                            dx_hash_string (string_value, -1))];
+            if (entry->pe_value != NULL)
+                rank = entry->pe_rank;
+        }
+    }
+    else if (program->rp_npoints != 0)
+    {
+        index = program_point_find (program, value, &below);
+        if (index != -1)
+        {
+            rank = program->rp_point_rank[index];
+        }
+        else if (below > 0 && below < program->rp_npoints)
+        {
+            // Strictly between rp_points[below - 1] and rp_points[below]
+            rank = program->rp_gap_rank[below - 1];
+        }
+    }
+
+    return (rank < *active);
+}
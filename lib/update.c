@@ -51,22 +51,18 @@ retrieve_all_keyvals_recursively (struct disir_context *current, struct disir_co
 
     do
     {
-        status = dc_collection_next (coll, &context);
+        status = dc_collection_next_borrowed (coll, &context);
         if (status != DISIR_STATUS_OK)
             break;
 
         status = retrieve_all_keyvals_recursively (context, keyvals);
         if (status != DISIR_STATUS_OK)
             break;
-
-        dc_putcontext (&context);
     }
     while (1);
 
     if (coll)
         dc_collection_finished (&coll);
-    if (context)
-        dc_putcontext (&context);
 
     return status;
 }
@@ -8,6 +8,7 @@
 #include <disir/disir.h>
 
 // Private disir includes
+#include "disir_private.h"
 #include "value.h"
 #include "log.h"
 
@@ -419,6 +420,8 @@ dx_value_get_float (struct disir_value *value, double *output_double)
 enum disir_status
 dx_value_set_string (struct disir_value *value, const char *input, int32_t size)
 {
+    char *buffer;
+
     if (value == NULL)
     {
         log_debug (0, "invoked with NULL value pointer.");
@@ -433,27 +436,29 @@ dx_value_set_string (struct disir_value *value, const char *input, int32_t size)
     }
     if (input == NULL)
     {
-        if (value->dv_size > 0)
-        {
-            free (value->dv_string);
-        }
-        value->dv_size = 0;
-        value->dv_string = NULL;
+        dx_value_free (value);
         return DISIR_STATUS_OK;
     }
-
-    if (value->dv_string == NULL || value->dv_size - 1 < size)
+    if (size < 0)
     {
-        // Just free the existing memory. We allocate a larger one below
-        if (value->dv_size - 1 < size)
-        {
-            free (value->dv_string);
-            value->dv_string = NULL;
-        }
+        log_debug (0, "invoked with negative size (%d)", size);
+        return DISIR_STATUS_INVALID_ARGUMENT;
+    }
 
+    if (value->dv_capacity > 0 && size <= value->dv_capacity)
+    {
+        // Reuse the heap buffer we already own.
+        buffer = value->dv_string;
+    }
+    else if (size < DISIR_VALUE_INLINE_SIZE)
+    {
+        buffer = value->dv_inline;
+    }
+    else
+    {
         // Size of requested string + 1 for NULL terminator
-        value->dv_string = calloc (1, size + 1);
-        if (value->dv_string == NULL)
+        buffer = malloc (size + 1);
+        if (buffer == NULL)
         {
             log_error ("failed to allocate sufficient memory for value string (%d)",
                        size + 1);
@@ -461,12 +466,23 @@ dx_value_set_string (struct disir_value *value, const char *input, int32_t size)
         }
     }
 
-    // Copy the incoming docstring to freely available space
-    memcpy (value->dv_string, input, size);
-    value->dv_size = size;
+    // Input may overlap the current string.
+    memmove (buffer, input, size);
 
     // Terminate it with a zero terminator. Just to be safe.
-    value->dv_string[size] = '\0';
+    buffer[size] = '\0';
+
+    if (buffer != value->dv_string && value->dv_capacity > 0)
+    {
+        free (value->dv_string);
+        value->dv_capacity = 0;
+    }
+    if (buffer != value->dv_string && buffer != value->dv_inline)
+    {
+        value->dv_capacity = size;
+    }
+    value->dv_string = buffer;
+    value->dv_size = size;
 
     log_debug (5, "stored string in disir_value (%p) of size (%d): %s\n",
                value, value->dv_size, value->dv_string);
@@ -474,6 +490,48 @@ dx_value_set_string (struct disir_value *value, const char *input, int32_t size)
     return DISIR_STATUS_OK;
 }
 
+//! INTERNAL API
+void
+dx_value_set_type (struct disir_value *value, enum disir_value_type type)
+{
+    if (value == NULL)
+        return;
+
+    if (type != DISIR_VALUE_TYPE_STRING && type != DISIR_VALUE_TYPE_ENUM)
+    {
+        // The string shares storage with the other value types.
+        dx_value_free (value);
+    }
+    else if (value->dv_type != DISIR_VALUE_TYPE_STRING &&
+             value->dv_type != DISIR_VALUE_TYPE_ENUM)
+    {
+        // Whatever the other value types left behind is no string.
+        value->dv_string = NULL;
+        value->dv_size = 0;
+        value->dv_capacity = 0;
+    }
+    value->dv_type = type;
+}
+
+//! INTERNAL API
+void
+dx_value_free (struct disir_value *value)
+{
+    if (value == NULL)
+        return;
+
+    if (value->dv_type != DISIR_VALUE_TYPE_STRING && value->dv_type != DISIR_VALUE_TYPE_ENUM)
+        return;
+
+    if (value->dv_capacity > 0)
+    {
+        free (value->dv_string);
+        value->dv_capacity = 0;
+    }
+    value->dv_string = NULL;
+    value->dv_size = 0;
+}
+
 //! INTERNAL API
 enum disir_status
 dx_value_get_string (struct disir_value *value, const char **output, int32_t *size)
@@ -502,3 +560,26 @@ dx_value_get_string (struct disir_value *value, const char **output, int32_t *si
     return DISIR_STATUS_OK;
 }
 
+//! INTERNAL API
+unsigned long
+dx_hash_string (const char *string, int32_t size)
+{
+    unsigned long hash = 5381;
+    int32_t i;
+
+    if (size < 0)
+    {
+        while (*string != '\0')
+        {
+            hash = ((hash << 5) + hash) + *string++;
+        }
+        return hash;
+    }
+
+    for (i = 0; i < size; i++)
+    {
+        hash = ((hash << 5) + hash) + string[i];
+    }
+
+    return hash;
+}
@@ -69,12 +69,7 @@ validate_inclusive_restrictions (struct disir_context *context)
 
     do
     {
-        if (element)
-        {
-            dc_putcontext (&element);
-        }
-
-        status = dc_collection_next (mold_collection, &element);
+        status = dc_collection_next_borrowed (mold_collection, &element);
         if (status == DISIR_STATUS_EXHAUSTED)
         {
             status = DISIR_STATUS_OK;
@@ -288,14 +283,6 @@ validate_children (struct disir_context *context)
 
     do
     {
-        // Put back the element resource from last iteration
-        if (element)
-        {
-            status = dc_putcontext (&element);
-            if (status != DISIR_STATUS_OK)
-                break;
-        }
-
         // XXX: What if the last context was finalized? We should still validate, shant we?
         // Break out if a serious error occurred in last iteration
         if (status_validate != DISIR_STATUS_OK
@@ -314,7 +301,7 @@ validate_children (struct disir_context *context)
             break;
         }
 
-        status = dc_collection_next (collection, &element);
+        status = dc_collection_next_borrowed (collection, &element);
         if (status == DISIR_STATUS_EXHAUSTED)
         {
             status = DISIR_STATUS_OK;
@@ -713,6 +700,59 @@ validate_context_validity (struct disir_context *context)
     return (status != DISIR_STATUS_OK ? status : invalid);
 }
 
+//! STATIC API
+//!
+//! Whether the cached validity of context may be used instead of re-checking it.
+//! Only finalized keyvals and sections are considered; any change to them or one
+//! of their descendants marks them dirty through dx_context_mark_dirty().
+//!
+static int
+validate_cached (struct disir_context *context)
+{
+    if (context->CONTEXT_STATE_FINALIZED == 0 || context->cx_validated_epoch == 0)
+        return 0;
+
+    if (dc_context_type (context) != DISIR_CONTEXT_KEYVAL
+        && dc_context_type (context) != DISIR_CONTEXT_SECTION)
+    {
+        return 0;
+    }
+
+    return (context->cx_root_context != NULL
+            && context->cx_validated_epoch == context->cx_root_context->cx_validation_epoch);
+}
+
+//! STATIC API
+//!
+//! Remember the outcome of validate_context_validity() on context.
+//! Operational errors are not cached.
+//!
+static void
+validate_cache_store (struct disir_context *context, enum disir_status status)
+{
+    context->cx_validated_epoch = 0;
+
+    if (context->cx_root_context == NULL)
+        return;
+
+    switch (status)
+    {
+    case DISIR_STATUS_OK:
+    case DISIR_STATUS_ELEMENTS_INVALID:
+    case DISIR_STATUS_WRONG_VALUE_TYPE:
+    case DISIR_STATUS_DEFAULT_MISSING:
+    case DISIR_STATUS_MOLD_MISSING:
+    case DISIR_STATUS_CONFLICTING_SEMVER:
+    case DISIR_STATUS_RESTRICTION_VIOLATED:
+        context->cx_validated_status = status;
+        context->cx_validated_invalid = context->CONTEXT_STATE_INVALID;
+        context->cx_validated_epoch = context->cx_root_context->cx_validation_epoch;
+        break;
+    default:
+        break;
+    }
+}
+
 //! INTERNAL API
 enum disir_status
 dx_validate_context (struct disir_context *context)
@@ -735,13 +775,24 @@ dx_validate_context (struct disir_context *context)
 
     status = DISIR_STATUS_OK;
 
-    // Optimistically clear INVALID state
-    // The below checks will return it to invalid state if checks fail.
-    context->CONTEXT_STATE_INVALID = 0;
+    if (validate_cached (context))
+    {
+        // Nothing changed below this context since it was last checked.
+        log_debug_context (8, context, "unchanged since last validation");
+        context->CONTEXT_STATE_INVALID = context->cx_validated_invalid;
+        status = context->cx_validated_status;
+    }
+    else
+    {
+        // Optimistically clear INVALID state
+        // The below checks will return it to invalid state if checks fail.
+        context->CONTEXT_STATE_INVALID = 0;
 
-    // XXX: This validity check may return any number of error conditions.
-    // This is used to determine if finalization of calling context may be done.
-    status = validate_context_validity (context);
+        // XXX: This validity check may return any number of error conditions.
+        // This is used to determine if finalization of calling context may be done.
+        status = validate_context_validity (context);
+        validate_cache_store (context, status);
+    }
 
     // If our parent context is finalized, and we get any sort of error, we mark invalid state
     // and return the original status back - we do not allow this context to be finalized
@@ -830,7 +881,7 @@ dx_invalid_elements (struct disir_context *context, struct disir_collection *col
 
     while (status == DISIR_STATUS_OK)
     {
-        status = dc_collection_next (col, &element);
+        status = dc_collection_next_borrowed (col, &element);
         if (status == DISIR_STATUS_EXHAUSTED)
         {
             status = DISIR_STATUS_OK;
@@ -863,7 +914,6 @@ dx_invalid_elements (struct disir_context *context, struct disir_collection *col
             }
         }
 
-        dc_putcontext (&element);
         status = DISIR_STATUS_OK;
     }
 
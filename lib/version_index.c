@@ -0,0 +1,115 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <disir/disir.h>
+
+#include "version_index.h"
+
+
+//! Number of entries allocated the first time an index grows.
+#define VERSION_INDEX_INIT_CAPACITY 4
+
+#define ENTRY_VERSION(entry, offset) \
+    ((struct disir_version *) ((char *) (entry) + (offset)))
+
+//! STATIC API
+//! Number of entries introduced at or before version.
+static int32_t
+version_index_upper_bound (struct disir_version_index *index, struct disir_version *version,
+                           size_t offset)
+{
+    int32_t low;
+    int32_t high;
+    int32_t middle;
+
+    low = 0;
+    high = index->vi_size;
+    while (low < high)
+    {
+        middle = low + (high - low) / 2;
+        if (dc_version_compare (ENTRY_VERSION (index->vi_entries[middle], offset), version) <= 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+//! INTERNAL API
+enum disir_status
+dx_version_index_insert (struct disir_version_index *index, void *entry, size_t offset)
+{
+    void **entries;
+    int32_t capacity;
+    int32_t position;
+
+    if (index->vi_size == index->vi_capacity)
+    {
+        capacity = (index->vi_capacity ? 2 * index->vi_capacity : VERSION_INDEX_INIT_CAPACITY);
+        entries = realloc (index->vi_entries, capacity * sizeof (void *));
+        if (entries == NULL)
+            return DISIR_STATUS_NO_MEMORY;
+
+        index->vi_entries = entries;
+        index->vi_capacity = capacity;
+    }
+
+    // Entries are mostly added in ascending order, making this an append.
+    position = version_index_upper_bound (index, ENTRY_VERSION (entry, offset), offset);
+    memmove (&index->vi_entries[position + 1], &index->vi_entries[position],
+             (index->vi_size - position) * sizeof (void *));
+    index->vi_entries[position] = entry;
+    index->vi_size++;
+
+    return DISIR_STATUS_OK;
+}
+
+//! INTERNAL API
+void
+dx_version_index_remove (struct disir_version_index *index, void *entry)
+{
+    int32_t position;
+
+    // Search by identity - the version of entry may have changed since it was inserted.
+    for (position = index->vi_size - 1; position >= 0; position--)
+    {
+        if (index->vi_entries[position] == entry)
+        {
+            memmove (&index->vi_entries[position], &index->vi_entries[position + 1],
+                     (index->vi_size - position - 1) * sizeof (void *));
+            index->vi_size--;
+            return;
+        }
+    }
+}
+
+//! INTERNAL API
+void *
+dx_version_index_find (struct disir_version_index *index, struct disir_version *version,
+                       size_t offset)
+{
+    int32_t position;
+
+    if (index->vi_size == 0)
+        return NULL;
+
+    if (version == NULL)
+        return index->vi_entries[index->vi_size - 1];
+
+    position = version_index_upper_bound (index, version, offset);
+    if (position == 0)
+        return index->vi_entries[0];
+
+    return index->vi_entries[position - 1];
+}
+
+//! INTERNAL API
+void
+dx_version_index_free (struct disir_version_index *index)
+{
+    free (index->vi_entries);
+    index->vi_entries = NULL;
+    index->vi_size = 0;
+    index->vi_capacity = 0;
+}
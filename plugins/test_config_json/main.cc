@@ -23,6 +23,7 @@ dio_register_plugin (struct disir_instance *instance, struct disir_register_plug
     plugin->dp_config_write = dio_json_config_write;
     plugin->dp_config_fd_write = dio_json_config_fd_write;
     plugin->dp_config_fd_read = dio_json_config_fd_read;
+    plugin->dp_config_span_read = dio_json_config_span_read;
     plugin->dp_config_entries = dio_json_config_entries;
     plugin->dp_config_query = dio_json_config_query;
 
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <string.h>
+
+// PRIVATE API
+extern "C" {
+#include "arena.h"
+}
+
+#include "test_helper.h"
+
+
+class ArenaTest : public testing::DisirTestWrapper
+{
+protected:
+    void SetUp()
+    {
+        DisirLogCurrentTestEnter();
+
+        arena = dx_arena_create ();
+        ASSERT_TRUE (arena != NULL);
+    }
+
+    void TearDown()
+    {
+        dx_arena_decref (&arena);
+        ASSERT_EQ (NULL, arena);
+
+        DisirLogCurrentTestExit ();
+    }
+
+public:
+    struct disir_arena *arena = NULL;
+};
+
+TEST_F (ArenaTest, alloc_shall_zero_memory)
+{
+    char *memory;
+    int i;
+
+    memory = (char *) dx_arena_alloc (arena, 100);
+    ASSERT_TRUE (memory != NULL);
+    for (i = 0; i < 100; i++)
+    {
+        ASSERT_EQ (0, memory[i]);
+    }
+}
+
+TEST_F (ArenaTest, free_shall_reuse_memory_of_same_size)
+{
+    void *first;
+    void *second;
+    char *reused;
+
+    first = dx_arena_alloc (arena, 64);
+    second = dx_arena_alloc (arena, 64);
+    ASSERT_NE (first, second);
+
+    memset (first, 0xff, 64);
+    dx_arena_free (arena, first, 64);
+
+    // Not handed out to an allocation of another size.
+    ASSERT_NE (first, dx_arena_alloc (arena, 128));
+
+    reused = (char *) dx_arena_alloc (arena, 64);
+    ASSERT_EQ (first, reused);
+    ASSERT_EQ (0, reused[0]);
+    ASSERT_EQ (0, reused[63]);
+
+    ASSERT_NE (first, dx_arena_alloc (arena, 64));
+}
+
+TEST_F (ArenaTest, track_and_untrack)
+{
+    struct disir_arena_link links[3];
+
+    ASSERT_EQ (NULL, dx_arena_tracked (arena));
+
+    dx_arena_track (arena, &links[0]);
+    dx_arena_track (arena, &links[1]);
+    dx_arena_track (arena, &links[2]);
+
+    ASSERT_EQ (&links[2], dx_arena_tracked (arena));
+    ASSERT_EQ (&links[1], links[2].al_next);
+    ASSERT_EQ (&links[0], links[1].al_next);
+
+    ASSERT_EQ (1, dx_arena_untrack (arena, &links[1]));
+    ASSERT_EQ (&links[0], links[2].al_next);
+    ASSERT_EQ (0, dx_arena_untrack (arena, &links[1]));
+
+    ASSERT_EQ (1, dx_arena_untrack (arena, &links[2]));
+    ASSERT_EQ (&links[0], dx_arena_tracked (arena));
+    ASSERT_EQ (1, dx_arena_untrack (arena, &links[0]));
+    ASSERT_EQ (NULL, dx_arena_tracked (arena));
+}
+
+TEST_F (ArenaTest, decref_count)
+{
+    dx_arena_incref (arena);
+    dx_arena_incref (arena);
+
+    dx_arena_decref_count (&arena, 2);
+    ASSERT_TRUE (arena != NULL);
+}
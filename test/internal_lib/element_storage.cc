@@ -225,3 +225,105 @@ TEST_F (ElementStoragePopulatedTest, get_all_collection_shall_be_in_insert_order
     ASSERT_STATUS (DISIR_STATUS_EXHAUSTED, status);
 }
 
+
+TEST_F (ElementStorageEmptyTest, get_at_invalid_argument_shall_fail)
+{
+    status = dx_element_storage_get_at (NULL, "carfight", 0, &context);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+
+    status = dx_element_storage_get_at (storage, NULL, 0, &context);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+
+    status = dx_element_storage_get_at (storage, "carfight", 0, NULL);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+}
+
+TEST_F (ElementStorageEmptyTest, get_at_empty_storage_shall_not_exist)
+{
+    status = dx_element_storage_get_at (storage, "carfight", 0, &context);
+    EXPECT_STATUS (DISIR_STATUS_NOT_EXIST, status);
+}
+
+TEST_F (ElementStoragePopulatedTest, get_at_shall_match_insert_order_per_name)
+{
+    struct disir_context *c;
+    unsigned int i;
+    unsigned int index;
+
+    // list holds 3 rounds of KEYVAL_NUMENTRIES insertions, in order.
+    i = 0;
+    for (auto it = list.begin(); it != list.end(); ++it, i++)
+    {
+        c = *it;
+        index = i / KEYVAL_NUMENTRIES;
+
+        status = dx_element_storage_get_at (storage, keyval_names[i % KEYVAL_NUMENTRIES],
+                                            index, &context);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        ASSERT_EQ (c, context);
+        // Borrowed reference - only the storage holds a reference.
+        ASSERT_EQ (1, context->cx_refcount);
+    }
+
+    status = dx_element_storage_get_at (storage, "carfight", 3, &context);
+    EXPECT_STATUS (DISIR_STATUS_NOT_EXIST, status);
+}
+
+TEST_F (ElementStoragePopulatedTest, remove_shall_keep_insert_order)
+{
+    struct disir_context *c;
+    unsigned int i;
+
+    ASSERT_EQ ((int32_t) (3 * KEYVAL_NUMENTRIES), dx_element_storage_numentries (storage));
+
+    // Remove the first round of insertions.
+    for (i = 0; i < KEYVAL_NUMENTRIES; i++)
+    {
+        c = list.front ();
+        list.pop_front ();
+
+        status = dx_element_storage_remove (storage, keyval_names[i], c);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+    }
+
+    ASSERT_EQ ((int32_t) (2 * KEYVAL_NUMENTRIES), dx_element_storage_numentries (storage));
+
+    i = 0;
+    for (auto it = list.begin(); it != list.end(); ++it, i++)
+    {
+        status = dx_element_storage_get_at (storage, keyval_names[i % KEYVAL_NUMENTRIES],
+                                            i / KEYVAL_NUMENTRIES, &context);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        ASSERT_EQ (*it, context);
+    }
+
+    status = dx_element_storage_get_all (storage, &collection);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_EQ ((2 * KEYVAL_NUMENTRIES), dc_collection_size (collection));
+}
+
+TEST_F (ElementStorageEmptyTest, remove_from_small_storage)
+{
+    struct disir_context *first;
+    struct disir_context *second;
+
+    first = dx_context_create (DISIR_CONTEXT_KEYVAL);
+    second = dx_context_create (DISIR_CONTEXT_KEYVAL);
+    ASSERT_TRUE (first != NULL && second != NULL);
+
+    status = dx_element_storage_add (storage, "carfight", first);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dx_element_storage_add (storage, "carfight", second);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    dx_context_decref (&second);
+
+    status = dx_element_storage_remove (storage, "carfight", first);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    dx_context_decref (&first);
+
+    ASSERT_EQ (1, dx_element_storage_numentries (storage));
+
+    status = dx_element_storage_get_first (storage, "carfight", &context);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    ASSERT_EQ (second, context);
+}
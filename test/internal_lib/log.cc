@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+// PRIVATE API
+extern "C" {
+#include "log.h"
+}
+
+#include "test_helper.h"
+
+
+class LogBackendTest : public testing::Test
+{
+protected:
+    void SetUp()
+    {
+        char tmpl[] = "/tmp/disir_log_XXXXXX";
+        int fd;
+
+        fd = mkstemp (tmpl);
+        ASSERT_NE (-1, fd);
+        close (fd);
+        filepath = tmpl;
+
+        dx_log_set_filepath (filepath.c_str ());
+    }
+
+    void TearDown()
+    {
+        dx_log_set_filepath ("/var/log/disir.log");
+        unlink (filepath.c_str ());
+    }
+
+    std::string read_log ()
+    {
+        std::ifstream file (filepath);
+        std::stringstream contents;
+
+        contents << file.rdbuf ();
+        return contents.str ();
+    }
+
+public:
+    std::string filepath;
+};
+
+TEST_F (LogBackendTest, lines_shall_be_written_on_flush)
+{
+    log_warn ("first buffered line");
+    log_warn ("second buffered line: %d", 42);
+
+    dx_log_flush ();
+
+    std::string contents = read_log ();
+    EXPECT_NE (std::string::npos, contents.find ("first buffered line\n"));
+    EXPECT_NE (std::string::npos, contents.find ("second buffered line: 42\n"));
+    EXPECT_LT (contents.find ("first buffered line"), contents.find ("second buffered line"));
+}
+
+TEST_F (LogBackendTest, changing_filepath_shall_write_out_pending_lines)
+{
+    log_warn ("line before switching file");
+
+    dx_log_set_filepath ("");
+
+    std::string contents = read_log ();
+    EXPECT_NE (std::string::npos, contents.find ("line before switching file\n"));
+}
+
+TEST_F (LogBackendTest, empty_filepath_shall_disable_logging)
+{
+    dx_log_set_filepath ("");
+
+    log_warn ("line that shall not be logged");
+    dx_log_flush ();
+
+    dx_log_set_filepath (filepath.c_str ());
+    dx_log_flush ();
+
+    EXPECT_EQ (std::string::npos, read_log ().find ("line that shall not be logged"));
+}
+
+TEST_F (LogBackendTest, long_lines_shall_be_truncated)
+{
+    std::string line (8192, 'x');
+
+    log_warn ("%s", line.c_str ());
+    dx_log_flush ();
+
+    std::string contents = read_log ();
+    ASSERT_FALSE (contents.empty ());
+    EXPECT_EQ ('\n', contents.back ());
+    EXPECT_LT (contents.size (), line.size ());
+}
+
+TEST (LogLevelTest, filtered_debug_shall_not_evaluate_arguments)
+{
+    enum disir_log_level saved = runtime_loglevel;
+    int evaluated = 0;
+
+    runtime_loglevel = DISIR_LOG_LEVEL_DEBUG_01;
+
+    log_debug (9, "evaluated: %d", ++evaluated);
+    EXPECT_EQ (0, evaluated);
+
+    EXPECT_TRUE (dx_log_debug_enabled (0));
+    EXPECT_EQ (DISIR_LOG_DEBUG_MAX_SEVERITY >= 1, dx_log_debug_enabled (1));
+    EXPECT_FALSE (dx_log_debug_enabled (2));
+
+    runtime_loglevel = saved;
+}
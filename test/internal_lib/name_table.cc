@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <string.h>
+
+// PRIVATE API
+extern "C" {
+#include "disir_private.h"
+#include "context_private.h"
+#include "element_storage.h"
+#include "name_table.h"
+}
+
+#include "test_helper.h"
+
+
+class NameTableTest : public testing::DisirTestWrapper
+{
+protected:
+    void SetUp()
+    {
+        DisirLogCurrentTestEnter();
+
+        table = dx_name_table_create ();
+        ASSERT_TRUE (table != NULL);
+    }
+
+    void TearDown()
+    {
+        dx_name_table_decref (&table);
+        ASSERT_EQ (NULL, table);
+
+        DisirLogCurrentTestExit ();
+    }
+
+public:
+    struct disir_name_table *table = NULL;
+};
+
+TEST_F (NameTableTest, intern_invalid_argument)
+{
+    EXPECT_EQ (NULL, dx_name_table_intern (NULL, "name", 4));
+    EXPECT_EQ (NULL, dx_name_table_intern (table, NULL, 4));
+    EXPECT_EQ (NULL, dx_name_table_intern (table, "name", -1));
+}
+
+TEST_F (NameTableTest, intern_shall_return_same_pointer_for_equal_names)
+{
+    char buffer[] = "keyval_name";
+    const char *first;
+    const char *second;
+    const char *other;
+
+    first = dx_name_table_intern (table, "keyval_name", strlen ("keyval_name"));
+    ASSERT_TRUE (first != NULL);
+    EXPECT_STREQ ("keyval_name", first);
+    EXPECT_NE (buffer, first);
+
+    second = dx_name_table_intern (table, buffer, strlen (buffer));
+    EXPECT_EQ (first, second);
+
+    other = dx_name_table_intern (table, "keyval", strlen ("keyval"));
+    ASSERT_TRUE (other != NULL);
+    EXPECT_NE (first, other);
+    EXPECT_STREQ ("keyval", other);
+}
+
+TEST_F (NameTableTest, intern_shall_only_read_size_bytes)
+{
+    const char *prefix;
+
+    prefix = dx_name_table_intern (table, "section_name", strlen ("section"));
+    ASSERT_TRUE (prefix != NULL);
+    EXPECT_STREQ ("section", prefix);
+    EXPECT_EQ (prefix, dx_name_table_intern (table, "section", strlen ("section")));
+
+    EXPECT_STREQ ("", dx_name_table_intern (table, "section", 0));
+}
+
+TEST_F (NameTableTest, intern_shall_keep_names_when_growing)
+{
+    const char *interned[512];
+    char name[32];
+    int i;
+
+    for (i = 0; i < 512; i++)
+    {
+        snprintf (name, sizeof (name), "name_%d", i);
+        interned[i] = dx_name_table_intern (table, name, strlen (name));
+        ASSERT_TRUE (interned[i] != NULL);
+    }
+
+    for (i = 0; i < 512; i++)
+    {
+        snprintf (name, sizeof (name), "name_%d", i);
+        EXPECT_EQ (interned[i], dx_name_table_intern (table, name, strlen (name)));
+        EXPECT_STREQ (name, interned[i]);
+    }
+}
+
+TEST_F (NameTableTest, element_storage_shall_keep_interned_names_alive)
+{
+    struct disir_element_storage *storage;
+    struct disir_context *context;
+    struct disir_context *queried;
+    enum disir_status status;
+    const char *name;
+
+    storage = dx_element_storage_create ();
+    ASSERT_TRUE (storage != NULL);
+    context = dx_context_create (DISIR_CONTEXT_KEYVAL);
+    ASSERT_TRUE (context != NULL);
+
+    name = dx_name_table_intern (table, "carfight", strlen ("carfight"));
+    ASSERT_TRUE (name != NULL);
+
+    status = dx_element_storage_add_interned (storage, name, NULL, context);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+
+    status = dx_element_storage_add_interned (storage, name, table, context);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    dx_context_decref (&context);
+
+    // The storage holds its own reference on the table.
+    dx_name_table_decref (&table);
+
+    status = dx_element_storage_get_first (storage, "carfight", &queried);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dx_element_storage_destroy (&storage);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+}
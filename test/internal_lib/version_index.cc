@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <stddef.h>
+
+// PRIVATE API
+extern "C" {
+#include "disir_private.h"
+#include "version_index.h"
+}
+
+#include "test_helper.h"
+
+struct versioned_entry
+{
+    int                     ve_id;
+    struct disir_version    ve_introduced;
+};
+
+#define ENTRY_OFFSET offsetof (struct versioned_entry, ve_introduced)
+#define ENTRY_NUMENTRIES 8
+
+class VersionIndexTest : public testing::DisirTestWrapper
+{
+protected:
+    void SetUp()
+    {
+        int i;
+
+        DisirLogCurrentTestEnter();
+
+        memset (&index, 0, sizeof (index));
+
+        // Entry i is introduced in version (i + 1).0
+        for (i = 0; i < ENTRY_NUMENTRIES; i++)
+        {
+            entries[i].ve_id = i;
+            entries[i].ve_introduced.sv_major = i + 1;
+            entries[i].ve_introduced.sv_minor = 0;
+        }
+    }
+
+    void TearDown()
+    {
+        dx_version_index_free (&index);
+        ASSERT_EQ (NULL, index.vi_entries);
+        ASSERT_EQ (0, index.vi_size);
+
+        DisirLogCurrentTestExit ();
+    }
+
+    struct versioned_entry *
+    find (int major, int minor)
+    {
+        struct disir_version version;
+
+        version.sv_major = major;
+        version.sv_minor = minor;
+        return (struct versioned_entry *) dx_version_index_find (&index, &version, ENTRY_OFFSET);
+    }
+
+public:
+    enum disir_status status;
+    struct disir_version_index index;
+    struct versioned_entry entries[ENTRY_NUMENTRIES];
+};
+
+
+TEST_F (VersionIndexTest, find_empty_shall_return_null)
+{
+    EXPECT_EQ (NULL, find (1, 0));
+    EXPECT_EQ (NULL, dx_version_index_find (&index, NULL, ENTRY_OFFSET));
+}
+
+TEST_F (VersionIndexTest, insert_out_of_order_shall_keep_version_order)
+{
+    int order[ENTRY_NUMENTRIES] = { 4, 0, 7, 2, 6, 1, 5, 3 };
+    int i;
+
+    for (i = 0; i < ENTRY_NUMENTRIES; i++)
+    {
+        status = dx_version_index_insert (&index, &entries[order[i]], ENTRY_OFFSET);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+    }
+
+    ASSERT_EQ (ENTRY_NUMENTRIES, index.vi_size);
+    for (i = 0; i < ENTRY_NUMENTRIES; i++)
+    {
+        ASSERT_EQ (&entries[i], index.vi_entries[i]);
+    }
+}
+
+TEST_F (VersionIndexTest, find_shall_return_greatest_at_or_below_version)
+{
+    int i;
+
+    for (i = 0; i < ENTRY_NUMENTRIES; i++)
+    {
+        status = dx_version_index_insert (&index, &entries[i], ENTRY_OFFSET);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+    }
+
+    for (i = 0; i < ENTRY_NUMENTRIES; i++)
+    {
+        EXPECT_EQ (&entries[i], find (i + 1, 0));
+        EXPECT_EQ (&entries[i], find (i + 1, 9));
+    }
+
+    // Below every entry, the first is returned.
+    EXPECT_EQ (&entries[0], find (0, 5));
+    // Above every entry, and no version, the last is returned.
+    EXPECT_EQ (&entries[ENTRY_NUMENTRIES - 1], find (100, 0));
+    EXPECT_EQ (&entries[ENTRY_NUMENTRIES - 1],
+               dx_version_index_find (&index, NULL, ENTRY_OFFSET));
+}
+
+TEST_F (VersionIndexTest, remove_shall_unhook_entry)
+{
+    struct versioned_entry missing;
+    int i;
+
+    for (i = 0; i < ENTRY_NUMENTRIES; i++)
+    {
+        status = dx_version_index_insert (&index, &entries[i], ENTRY_OFFSET);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+    }
+
+    dx_version_index_remove (&index, &entries[3]);
+    ASSERT_EQ (ENTRY_NUMENTRIES - 1, index.vi_size);
+    EXPECT_EQ (&entries[2], find (4, 0));
+    EXPECT_EQ (&entries[4], find (5, 0));
+
+    // Removing an entry not indexed is a no-op.
+    missing.ve_introduced.sv_major = 2;
+    missing.ve_introduced.sv_minor = 0;
+    dx_version_index_remove (&index, &missing);
+    ASSERT_EQ (ENTRY_NUMENTRIES - 1, index.vi_size);
+}
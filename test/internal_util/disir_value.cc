@@ -26,13 +26,7 @@ protected:
 
     void TearDown()
     {
-        if (value.dv_type == DISIR_VALUE_TYPE_STRING)
-        {
-            if (value.dv_string)
-            {
-                free (value.dv_string);
-            }
-        }
+        dx_value_free (&value);
         DisirLogCurrentTestExit ();
     }
 
@@ -138,6 +132,108 @@ TEST_F (DisirValueStringTest, set_string_valid_argument_shall_succeed)
     EXPECT_STREQ (sample, value.dv_string);
 }
 
+TEST_F (DisirValueStringTest, set_short_string_shall_be_stored_inline)
+{
+    status = dx_value_set_string (&value, "short", strlen ("short"));
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("short", value.dv_string);
+    EXPECT_EQ (value.dv_inline, value.dv_string);
+    EXPECT_EQ (0, value.dv_capacity);
+
+    // Largest string that fits inline
+    status = dx_value_set_string (&value, "0123456789abcde", DISIR_VALUE_INLINE_SIZE - 1);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("0123456789abcde", value.dv_string);
+    EXPECT_EQ (value.dv_inline, value.dv_string);
+    EXPECT_EQ (0, value.dv_capacity);
+}
+
+TEST_F (DisirValueStringTest, set_string_shall_reuse_heap_buffer)
+{
+    char *buffer;
+
+    status = dx_value_set_string (&value, sample, strlen (sample));
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_NE (value.dv_inline, value.dv_string);
+    EXPECT_EQ (strlen (sample), value.dv_capacity);
+    buffer = value.dv_string;
+
+    status = dx_value_set_string (&value, "short", strlen ("short"));
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("short", value.dv_string);
+    EXPECT_EQ (buffer, value.dv_string);
+    EXPECT_EQ (5, value.dv_size);
+
+    status = dx_value_set_string (&value, sample, strlen (sample));
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ (sample, value.dv_string);
+    EXPECT_EQ (buffer, value.dv_string);
+}
+
+TEST_F (DisirValueStringTest, set_string_shall_grow_from_inline_to_heap)
+{
+    status = dx_value_set_string (&value, "short", strlen ("short"));
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dx_value_set_string (&value, sample, strlen (sample));
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ (sample, value.dv_string);
+    EXPECT_NE (value.dv_inline, value.dv_string);
+    EXPECT_EQ (strlen (sample), value.dv_size);
+}
+
+TEST_F (DisirValueStringTest, set_string_from_itself_shall_succeed)
+{
+    status = dx_value_set_string (&value, sample, strlen (sample));
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dx_value_set_string (&value, value.dv_string + 4, strlen (sample) - 4);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ (sample + 4, value.dv_string);
+}
+
+TEST_F (DisirValueStringTest, set_string_null_shall_empty_value)
+{
+    const char *output;
+
+    status = dx_value_set_string (&value, sample, strlen (sample));
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dx_value_set_string (&value, NULL, 0);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_EQ (0, value.dv_capacity);
+
+    status = dx_value_get_string (&value, &output, NULL);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_EQ (NULL, output);
+}
+
+TEST_F (DisirValueStringTest, set_type_integer_shall_release_string)
+{
+    status = dx_value_set_string (&value, sample, strlen (sample));
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+
+    dx_value_set_type (&value, DISIR_VALUE_TYPE_INTEGER);
+    EXPECT_EQ (DISIR_VALUE_TYPE_INTEGER, value.dv_type);
+    EXPECT_EQ (0, value.dv_capacity);
+    EXPECT_EQ (0, value.dv_size);
+
+    // The integer shares storage with the string. It must not be freed.
+    value.dv_integer = 42;
+    dx_value_free (&value);
+    EXPECT_EQ (42, value.dv_integer);
+}
+
+TEST_F (DisirValueStringTest, set_type_enum_shall_keep_string)
+{
+    status = dx_value_set_string (&value, sample, strlen (sample));
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+
+    dx_value_set_type (&value, DISIR_VALUE_TYPE_ENUM);
+    EXPECT_EQ (DISIR_VALUE_TYPE_ENUM, value.dv_type);
+    EXPECT_STREQ (sample, value.dv_string);
+}
+
 TEST_F (DisirValueStringTest, get_string_invalid_argument_shall_fail)
 {
     const char *output;
@@ -230,6 +326,18 @@ TEST_F (DisirValueIntegerTest, string)
     ASSERT_STREQ (dx_value_type_string (type), "INTEGER");
 }
 
+TEST_F (DisirValueIntegerTest, set_type_string_shall_start_empty)
+{
+    const char *output;
+
+    value.dv_integer = 42;
+    dx_value_set_type (&value, DISIR_VALUE_TYPE_STRING);
+
+    status = dx_value_get_string (&value, &output, NULL);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_EQ (NULL, output);
+}
+
 TEST_F (DisirValueIntegerTest, compare_equal)
 {
     int res;
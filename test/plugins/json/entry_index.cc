@@ -0,0 +1,187 @@
+// JSON local
+#include "test_json.h"
+
+// standard
+#include <experimental/filesystem>
+#include <set>
+
+// system
+#include <fcntl.h>
+#include <sys/stat.h>
+
+
+class EntryIndexTest : public testing::JsonDioTestWrapper
+{
+    void SetUp ()
+    {
+        DisirLogCurrentTestEnter ();
+
+        status = disir_mold_read (instance, "test", "basic_keyval", &mold);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+        status = disir_mold_write (instance, "json_test", "index/first", mold);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        status = disir_mold_write (instance, "json_test", "index/nested/__namespace", mold);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+        age_directories ();
+
+        DisirLogTestBodyEnter ();
+    }
+
+    void TearDown ()
+    {
+        DisirLogTestBodyExit ();
+
+        if (mold)
+            disir_mold_finished (&mold);
+        if (entry)
+            disir_entry_finished (&entry);
+        free_entries ();
+
+        std::experimental::filesystem::remove_all (m_mold_base_dir);
+
+        DisirLogCurrentTestExit ();
+    }
+
+public:
+    //! Backdate the modification time of every mold directory by seconds, such that the
+    //! index trusts them.
+    void age_directories (time_t seconds = 10)
+    {
+        struct timespec times[2] = { { time (NULL) - seconds, 0 }, { time (NULL) - seconds, 0 } };
+
+        ASSERT_EQ (0, utimensat (AT_FDCWD, m_mold_base_dir.c_str(), times, 0));
+        for (auto &p : std::experimental::filesystem::recursive_directory_iterator (
+                                                                    m_mold_base_dir))
+        {
+            if (std::experimental::filesystem::is_directory (p.path()))
+            {
+                ASSERT_EQ (0, utimensat (AT_FDCWD, p.path().c_str(), times, 0));
+            }
+        }
+    }
+
+    std::set<std::string> mold_entries ()
+    {
+        std::set<std::string> names;
+        struct disir_entry *current;
+
+        free_entries ();
+        status = disir_mold_entries (instance, "json_test", &entries);
+        EXPECT_STATUS (DISIR_STATUS_OK, status);
+
+        for (current = entries; current != NULL; current = current->next)
+        {
+            names.insert (current->de_entry_name);
+        }
+        return names;
+    }
+
+    void free_entries ()
+    {
+        struct disir_entry *next;
+
+        while (entries)
+        {
+            next = entries->next;
+            disir_entry_finished (&entries);
+            entries = next;
+        }
+    }
+
+public:
+    struct disir_mold *mold = NULL;
+    struct disir_entry *entry = NULL;
+    struct disir_entry *entries = NULL;
+};
+
+TEST_F (EntryIndexTest, entries_shall_include_namespace_entries)
+{
+    auto names = mold_entries ();
+
+    ASSERT_EQ (1, names.count ("index/first"));
+    ASSERT_EQ (1, names.count ("index/nested/"));
+}
+
+TEST_F (EntryIndexTest, entries_shall_include_added_mold)
+{
+    auto names = mold_entries ();
+    ASSERT_EQ (0, names.count ("index/second"));
+
+    status = disir_mold_write (instance, "json_test", "index/second", mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    names = mold_entries ();
+    ASSERT_EQ (1, names.count ("index/first"));
+    ASSERT_EQ (1, names.count ("index/second"));
+}
+
+TEST_F (EntryIndexTest, entries_shall_include_added_directory)
+{
+    mold_entries ();
+
+    status = disir_mold_write (instance, "json_test", "index/deeper/down/third", mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    auto names = mold_entries ();
+    ASSERT_EQ (1, names.count ("index/deeper/down/third"));
+}
+
+TEST_F (EntryIndexTest, query_shall_not_find_removed_mold)
+{
+    mold_entries ();
+
+    status = disir_mold_query (instance, "json_test", "index/first", NULL);
+    ASSERT_STATUS (DISIR_STATUS_EXISTS, status);
+
+    std::experimental::filesystem::remove (m_mold_base_dir + "index/first.json");
+
+    status = disir_mold_query (instance, "json_test", "index/first", NULL);
+    ASSERT_STATUS (DISIR_STATUS_NOT_EXIST, status);
+}
+
+TEST_F (EntryIndexTest, query_shall_resolve_namespace_entry)
+{
+    mold_entries ();
+
+    status = disir_mold_query (instance, "json_test", "index/nested/any", &entry);
+    ASSERT_STATUS (DISIR_STATUS_EXISTS, status);
+    ASSERT_EQ (1, entry->flag.DE_NAMESPACE_ENTRY);
+
+    status = disir_mold_query (instance, "json_test", "index/missing/any", NULL);
+    ASSERT_STATUS (DISIR_STATUS_NOT_EXIST, status);
+}
+
+TEST_F (EntryIndexTest, query_shall_find_symlinked_mold)
+{
+    std::experimental::filesystem::create_symlink (m_mold_base_dir + "index/first.json",
+                                                   m_mold_base_dir + "index/linked.json");
+    age_directories (20);
+
+    auto names = mold_entries ();
+    ASSERT_EQ (1, names.count ("index/linked"));
+
+    status = disir_mold_query (instance, "json_test", "index/linked", NULL);
+    ASSERT_STATUS (DISIR_STATUS_EXISTS, status);
+}
+
+TEST_F (EntryIndexTest, query_shall_follow_symlink_target_created_after_indexing)
+{
+    // The link target lives outside every indexed directory.
+    const std::string target = "/tmp/json_test/symlink_target.json";
+
+    std::experimental::filesystem::remove (target);
+    std::experimental::filesystem::create_symlink (target,
+                                                   m_mold_base_dir + "index/dangling.json");
+    age_directories (30);
+
+    auto names = mold_entries ();
+    ASSERT_EQ (0, names.count ("index/dangling"));
+
+    std::experimental::filesystem::copy_file (m_mold_base_dir + "index/first.json", target);
+
+    status = disir_mold_query (instance, "json_test", "index/dangling", NULL);
+    std::experimental::filesystem::remove (target);
+    ASSERT_STATUS (DISIR_STATUS_EXISTS, status);
+}
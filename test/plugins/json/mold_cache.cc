@@ -0,0 +1,70 @@
+// JSON local
+#include "test_json.h"
+
+// standard
+#include <experimental/filesystem>
+
+
+class MoldCacheTest : public testing::JsonDioTestWrapper
+{
+    void SetUp ()
+    {
+        DisirLogCurrentTestEnter ();
+
+        status = disir_mold_read (instance, "test", "basic_keyval", &mold_namespace);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+        status = disir_mold_write (instance, "json_test", "cache/__namespace", mold_namespace);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+        DisirLogTestBodyEnter ();
+    }
+
+    void TearDown ()
+    {
+        DisirLogTestBodyExit ();
+
+        if (mold_namespace)
+            disir_mold_finished (&mold_namespace);
+        if (first)
+            disir_mold_finished (&first);
+        if (second)
+            disir_mold_finished (&second);
+
+        std::experimental::filesystem::remove_all (m_mold_base_dir);
+
+        DisirLogCurrentTestExit ();
+    }
+
+public:
+    struct disir_mold *mold_namespace = NULL;
+    struct disir_mold *first = NULL;
+    struct disir_mold *second = NULL;
+};
+
+TEST_F (MoldCacheTest, namespace_entries_shall_share_mold)
+{
+    status = disir_mold_read (instance, "json_test", "cache/first", &first);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = disir_mold_read (instance, "json_test", "cache/second", &second);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    ASSERT_EQ (first, second);
+}
+
+TEST_F (MoldCacheTest, modified_mold_shall_be_read_again)
+{
+    status = disir_mold_read (instance, "json_test", "cache/first", &first);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    // Replace the namespace entry with a new file.
+    std::experimental::filesystem::remove (m_mold_base_dir + "cache/__namespace.json");
+    status = disir_mold_write (instance, "json_test", "cache/__namespace", mold_namespace);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = disir_mold_read (instance, "json_test", "cache/first", &second);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    ASSERT_NE (first, second);
+}
@@ -1,5 +1,6 @@
 #include "test_json.h"
 #include "json/json_serialize.h"
+#include <disir/fslib/json.h>
 
 class MarshallConfigTest : public testing::JsonDioTestWrapper
 {
@@ -70,3 +71,102 @@ class MarshallConfigTest : public testing::JsonDioTestWrapper
         dio::ConfigWriter *writer = NULL;
 };
 
+
+TEST_F (MarshallConfigTest, serialize_keyvals_in_insertion_order)
+{
+    struct disir_mold *basic_mold = NULL;
+    std::string output;
+
+    status = disir_mold_read (instance, "test", "basic_keyval", &basic_mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = disir_generate_config_from_mold (basic_mold, NULL, &config);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = writer->serialize (config, output);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("{\n"
+                  "   \"version\" : \"1.0\",\n"
+                  "   \"config\" : {\n"
+                  "      \"key_string\" : \"string_value\",\n"
+                  "      \"key_integer\" : 42,\n"
+                  "      \"key_float\" : 3.14,\n"
+                  "      \"key_boolean\" : true\n"
+                  "   }\n"
+                  "}\n", output.c_str ());
+
+    disir_mold_finished (&basic_mold);
+}
+
+TEST_F (MarshallConfigTest, serialize_duplicate_keyvals_as_array)
+{
+    struct disir_mold *entries_mold = NULL;
+    std::string output;
+
+    status = disir_mold_read (instance, "test", "restriction_config_parent_keyval_min_entry",
+                              &entries_mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = disir_generate_config_from_mold (entries_mold, NULL, &config);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = writer->serialize (config, output);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("{\n"
+                  "   \"version\" : \"2.0\",\n"
+                  "   \"config\" : {\n"
+                  "      \"keyval\" : [ 5, 5, 5, 5 ]\n"
+                  "   }\n"
+                  "}\n", output.c_str ());
+
+    disir_mold_finished (&entries_mold);
+}
+
+TEST_F (MarshallConfigTest, serialize_empty_config_as_null)
+{
+    struct disir_mold *basic_mold = NULL;
+    struct disir_context *context_empty = NULL;
+    std::string output;
+
+    status = disir_mold_read (instance, "test", "basic_keyval", &basic_mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_config_begin (basic_mold, &context_empty);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_config_finalize (&context_empty, &config);
+    disir_mold_finished (&basic_mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = writer->serialize (config, output);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("{\n"
+                  "   \"version\" : \"1.0\",\n"
+                  "   \"config\" : null\n"
+                  "}\n", output.c_str ());
+}
+
+TEST_F (MarshallConfigTest, serialize_file_equals_string)
+{
+    std::string output;
+    std::string written;
+    char buffer[4096];
+    size_t size;
+    FILE *file;
+
+    status = disir_generate_config_from_mold (mold, NULL, &config);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = writer->serialize (config, output);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    file = tmpfile ();
+    ASSERT_TRUE (file != NULL);
+    status = dio_json_serialize_config (instance, config, file);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+
+    rewind (file);
+    while ((size = fread (buffer, 1, sizeof (buffer), file)) > 0)
+    {
+        written.append (buffer, size);
+    }
+    fclose (file);
+
+    EXPECT_EQ (output, written);
+}
@@ -2,6 +2,8 @@
 #include "json/json_serialize.h"
 #include "json/json_unserialize.h"
 
+#include <disir/fslib/json.h>
+
 class UnserializeConfigTest : public testing::JsonDioTestWrapper
 {
     void SetUp()
@@ -76,6 +78,29 @@ TEST_F(UnserializeConfigTest, unserialize_shall_succeed)
     ASSERT_STATUS (DISIR_STATUS_OK, status);
 }
 
+TEST_F(UnserializeConfigTest, unserialize_in_arena_shall_succeed)
+{
+    std::stringstream serialized_config;
+    Json::Value reread;
+
+    ASSERT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, disir_read_arena (NULL, 1));
+    ASSERT_EQ (0, disir_read_arena_enabled (instance));
+
+    ASSERT_STATUS (DISIR_STATUS_OK, disir_read_arena (instance, 1));
+    ASSERT_EQ (1, disir_read_arena_enabled (instance));
+
+    status = unserialize_config();
+    disir_read_arena (instance, 0);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = writer->serialize (config, serialized_config);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    bool ret = json_reader.parse (serialized_config.str(), reread);
+    ASSERT_EQ (true, ret) << json_reader.getFormattedErrorMessages();
+    ASSERT_EQ (root, reread);
+}
+
 TEST_F (UnserializeConfigTest, element_not_in_mold)
 {
     ASSERT_NO_THROW (
@@ -137,3 +162,69 @@ TEST_F (UnserializeConfigTest, float_as_int_shall_succeed)
     ASSERT_STATUS (DISIR_STATUS_OK, status);
 }
 
+
+TEST_F (UnserializeConfigTest, syntax_error_shall_fail)
+{
+    Json::StyledWriter json_writer;
+    std::string serialized;
+
+    serialized = json_writer.writeOrdered (root);
+    serialized.resize (serialized.size () / 2);
+
+    status = reader->unserialize (&config, serialized);
+    ASSERT_STATUS (DISIR_STATUS_FS_ERROR, status);
+    ASSERT_TRUE (config == NULL);
+}
+
+TEST_F (UnserializeConfigTest, version_after_config_shall_succeed)
+{
+    Json::FastWriter json_writer;
+    std::string serialized;
+
+    serialized = "{ \"config\" : " + json_writer.write (root["config"]) +
+                 ", \"version\" : \"" + root["version"].asString () + "\" }";
+
+    status = reader->unserialize (&config, serialized);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+}
+
+TEST_F (UnserializeConfigTest, comments_and_escapes_shall_succeed)
+{
+    const char *value;
+    Json::FastWriter json_writer;
+    std::string serialized;
+
+    ASSERT_NO_THROW (
+        root["config"]["test2"] = "placeholder";
+    );
+
+    serialized = "// leading comment\n" + json_writer.write (root);
+    serialized.replace (serialized.find ("placeholder"), strlen ("placeholder"),
+                        "\\\"\\u00e6\\ud83d\\ude00\\n /* not a comment */");
+
+    status = reader->unserialize (&config, serialized);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = disir_config_get_keyval_string (config, &value, "test2");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("\"\xc3\xa6\xf0\x9f\x98\x80\n /* not a comment */", value);
+}
+
+TEST_F (UnserializeConfigTest, unserialize_span_shall_succeed)
+{
+    Json::StyledWriter json_writer;
+    std::string serialized;
+
+    serialized = json_writer.writeOrdered (root);
+
+    status = dio_json_unserialize_config_span (instance, serialized.data (), serialized.size (),
+                                               mold, &config);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+}
+
+TEST_F (UnserializeConfigTest, unserialize_empty_span_shall_fail)
+{
+    status = dio_json_unserialize_config_span (instance, "", 0, mold, &config);
+    ASSERT_STATUS (DISIR_STATUS_FS_ERROR, status);
+    ASSERT_TRUE (config == NULL);
+}
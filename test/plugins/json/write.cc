@@ -0,0 +1,174 @@
+// JSON local
+#include "test_json.h"
+
+// standard
+#include <experimental/filesystem>
+#include <set>
+
+// system
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::experimental::filesystem;
+
+
+class WriteTest : public testing::JsonDioTestWrapper
+{
+    void SetUp ()
+    {
+        DisirLogCurrentTestEnter ();
+
+        status = disir_mold_read (instance, "test", "basic_keyval", &mold);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+        status = disir_generate_config_from_mold (mold, NULL, &config);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+        status = disir_mold_write (instance, "json_test", "write/entry", mold);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        status = disir_config_write (instance, "json_test", "write/entry", config);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+        DisirLogTestBodyEnter ();
+    }
+
+    void TearDown ()
+    {
+        DisirLogTestBodyExit ();
+
+        if (mold)
+            disir_mold_finished (&mold);
+        if (config)
+            disir_config_finished (&config);
+
+        // Leave no transaction behind for the other tests sharing the instance
+        disir_write_commit (instance);
+
+        fs::remove_all (m_mold_base_dir);
+        fs::remove_all (m_config_base_dir);
+        fs::remove_all (m_link_target_dir);
+
+        DisirLogCurrentTestExit ();
+    }
+
+public:
+    int count_temporary_files ()
+    {
+        int count = 0;
+        for (auto &p : fs::recursive_directory_iterator (m_config_base_dir))
+        {
+            if (p.path().extension() == ".tmp")
+                count++;
+        }
+        return count;
+    }
+
+public:
+    const std::string m_config_base_dir = "/tmp/json_test/config/";
+    const std::string m_config_filepath = m_config_base_dir + "write/entry.json";
+    const std::string m_link_target_dir = "/tmp/json_test/link_target/";
+
+    struct disir_mold *mold = NULL;
+    struct disir_config *config = NULL;
+};
+
+TEST_F (WriteTest, begin_invalid_argument)
+{
+    ASSERT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, disir_write_begin (NULL));
+    ASSERT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, disir_write_commit (NULL));
+}
+
+TEST_F (WriteTest, begin_twice_shall_fail)
+{
+    ASSERT_STATUS (DISIR_STATUS_OK, disir_write_begin (instance));
+    ASSERT_STATUS (DISIR_STATUS_EXISTS, disir_write_begin (instance));
+    ASSERT_STATUS (DISIR_STATUS_OK, disir_write_commit (instance));
+}
+
+TEST_F (WriteTest, commit_without_begin_shall_fail)
+{
+    ASSERT_STATUS (DISIR_STATUS_NOT_EXIST, disir_write_commit (instance));
+}
+
+TEST_F (WriteTest, write_in_transaction)
+{
+    std::set<std::string> entries = { "write/first", "write/second", "write/nested/third" };
+
+    ASSERT_STATUS (DISIR_STATUS_OK, disir_write_begin (instance));
+    for (auto entry : entries)
+    {
+        status = disir_mold_write (instance, "json_test", entry.c_str(), mold);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        status = disir_config_write (instance, "json_test", entry.c_str(), config);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+    }
+    ASSERT_STATUS (DISIR_STATUS_OK, disir_write_commit (instance));
+
+    ASSERT_EQ (0, count_temporary_files ());
+
+    disir_config_finished (&config);
+    for (auto entry : entries)
+    {
+        status = disir_config_read (instance, "json_test", entry.c_str(), NULL, &config);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        disir_config_finished (&config);
+    }
+}
+
+TEST_F (WriteTest, rewrite_shall_preserve_file_mode)
+{
+    struct stat statbuf;
+
+    ASSERT_EQ (0, chmod (m_config_filepath.c_str(), 0600));
+
+    status = disir_config_write (instance, "json_test", "write/entry", config);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    ASSERT_EQ (0, stat (m_config_filepath.c_str(), &statbuf));
+    EXPECT_EQ (0600u, statbuf.st_mode & 07777);
+    EXPECT_EQ (0, count_temporary_files ());
+}
+
+TEST_F (WriteTest, rewrite_shall_preserve_owner_and_group)
+{
+    struct stat statbuf;
+
+    if (geteuid () != 0)
+    {
+        // Only a privileged user can hand a file over to another owner.
+        return;
+    }
+
+    ASSERT_EQ (0, chown (m_config_filepath.c_str(), 1, 1));
+
+    status = disir_config_write (instance, "json_test", "write/entry", config);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    ASSERT_EQ (0, stat (m_config_filepath.c_str(), &statbuf));
+    EXPECT_EQ (1u, statbuf.st_uid);
+    EXPECT_EQ (1u, statbuf.st_gid);
+    EXPECT_EQ (0, count_temporary_files ());
+}
+
+TEST_F (WriteTest, rewrite_shall_keep_symlink)
+{
+    struct stat statbuf;
+    const std::string target = m_link_target_dir + "entry.json";
+
+    fs::create_directories (m_link_target_dir);
+    fs::rename (m_config_filepath, target);
+    fs::create_symlink (target, m_config_filepath);
+
+    status = disir_config_write (instance, "json_test", "write/entry", config);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    ASSERT_EQ (0, lstat (m_config_filepath.c_str(), &statbuf));
+    EXPECT_TRUE (S_ISLNK (statbuf.st_mode));
+    ASSERT_EQ (0, lstat (target.c_str(), &statbuf));
+    EXPECT_TRUE (S_ISREG (statbuf.st_mode));
+    EXPECT_EQ (0, count_temporary_files ());
+
+    disir_config_finished (&config);
+    status = disir_config_read (instance, "json_test", "write/entry", NULL, &config);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+}
@@ -236,3 +236,71 @@ TEST_F (CollectionTest, push_context_until_internal_resize)
     }
 }
 
+
+TEST_F (CollectionTest, next_borrowed_invalid_argument)
+{
+    status = dc_collection_next_borrowed (NULL, &context);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+
+    status = dc_collection_next_borrowed (collection, NULL);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+}
+
+TEST_F (CollectionTest, next_borrowed)
+{
+    struct disir_context *contexts[100];
+    struct disir_context *current;
+
+    for (i = 0; i < 100; i++)
+    {
+        status = dc_begin (context_mold, DISIR_CONTEXT_KEYVAL, &contexts[i]);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        status = dc_collection_push_context (collection, contexts[i]);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+    }
+
+    // Iterate 25 - borrowed contexts are not put back.
+    for (i = 0; i < 25; i++)
+    {
+        status = dc_collection_next_borrowed (collection, &current);
+        EXPECT_STATUS (DISIR_STATUS_OK, status);
+        ASSERT_TRUE (current == contexts[i]);
+    }
+
+    // Destroy a few entries behind and ahead of the iterator.
+    for (i = 0; i <= 20; i += 2)
+    {
+        dc_destroy (&contexts[i]);
+    }
+    for (i = 50; i < 80; i += 3)
+    {
+        dc_destroy (&contexts[i]);
+    }
+
+    // Destroyed entries are purged, and the iterator stays in place.
+    for (i = 25; i < 100; i++)
+    {
+        if (contexts[i] == NULL)
+        {
+            continue;
+        }
+
+        status = dc_collection_next_borrowed (collection, &current);
+        EXPECT_STATUS (DISIR_STATUS_OK, status);
+        ASSERT_TRUE (current == contexts[i]);
+    }
+
+    status = dc_collection_next_borrowed (collection, &current);
+    EXPECT_STATUS (DISIR_STATUS_EXHAUSTED, status);
+
+    size = dc_collection_size (collection);
+    ASSERT_EQ (79, size);
+
+    for (i = 0; i < 100; i++)
+    {
+        if (contexts[i] != NULL)
+        {
+            dc_destroy (&contexts[i]);
+        }
+    }
+}
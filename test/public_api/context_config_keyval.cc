@@ -249,6 +249,24 @@ TEST_F (ConfigKeyvalConstructingStringTest, set_value_integer_shall_fail)
                   dc_context_error (context_keyval));
 }
 
+TEST_F (ConfigKeyvalConstructingStringTest, set_value_integer_after_long_string_shall_release_it)
+{
+    const char long_string[] = "a string too long to be stored inline";
+    int64_t value;
+
+    status = dc_set_value_string (context_keyval, long_string, strlen (long_string));
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_set_value_integer (context_keyval, 74);
+    ASSERT_STATUS (DISIR_STATUS_INVALID_CONTEXT, status);
+
+    status = dc_get_value_integer (context_keyval, &value);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    ASSERT_EQ (74, value);
+
+    // Destroyed in TearDown, without freeing the integer as a string
+}
+
 TEST_F (ConfigKeyvalConstructingStringTest, get_value_integer_shall_fail)
 {
     int64_t value = LLONG_MAX;
@@ -280,3 +280,44 @@ TEST_F (ContextDefaultTest, set_value_float_on_type_string_shall_fail)
 }
 
 
+
+TEST_F (ContextDefaultEmptyTest, get_default_shall_resolve_version_out_of_order)
+{
+    struct disir_version version;
+    char output[32];
+    int32_t size;
+    int major;
+
+    status = dc_set_value_type (context_keyval, DISIR_VALUE_TYPE_INTEGER);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    // Defaults for versions 1.0 through 9.0, added in reverse.
+    version.sv_minor = 0;
+    for (major = 9; major >= 1; major--)
+    {
+        version.sv_major = major;
+        status = dc_add_default_integer (context_keyval, major * 10, &version);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+    }
+
+    version.sv_major = 4;
+    version.sv_minor = 0;
+    status = dc_get_default (context_keyval, &version, sizeof (output), output, &size);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("40", output);
+
+    // In between - the greatest default at or below version is active.
+    version.sv_minor = 5;
+    status = dc_get_default (context_keyval, &version, sizeof (output), output, &size);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("40", output);
+
+    version.sv_major = 20;
+    status = dc_get_default (context_keyval, &version, sizeof (output), output, &size);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("90", output);
+
+    status = dc_get_default (context_keyval, NULL, sizeof (output), output, &size);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("90", output);
+}
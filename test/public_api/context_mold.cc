@@ -374,3 +374,111 @@ TEST_F (ContextMoldTest, destroying_constructing_element_shall_not_update_mold_v
     res = dc_version_compare (&semver, &queried);
     ASSERT_EQ (res, 0);
 }
+
+TEST_F (ContextMoldTest, enable_arena_invalid_arguments)
+{
+    status = dc_enable_arena (NULL);
+    ASSERT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+
+    status = dc_begin (context_mold, DISIR_CONTEXT_KEYVAL, &context_keyval);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_enable_arena (context_keyval);
+    ASSERT_STATUS (DISIR_STATUS_WRONG_CONTEXT, status);
+}
+
+TEST_F (ContextMoldTest, enable_arena_on_finalized_mold_shall_fail)
+{
+    status = dc_mold_finalize (&context_mold, &mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    context_mold = dc_mold_getcontext (mold);
+    ASSERT_TRUE (context_mold != NULL);
+
+    status = dc_enable_arena (context_mold);
+    ASSERT_STATUS (DISIR_STATUS_CONTEXT_IN_WRONG_STATE, status);
+
+    // cleanup
+    dc_putcontext (&context_mold);
+}
+
+TEST_F (ContextMoldTest, enable_arena_with_children_shall_fail)
+{
+    status = dc_begin (context_mold, DISIR_CONTEXT_KEYVAL, &context_keyval);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_enable_arena (context_mold);
+    ASSERT_STATUS (DISIR_STATUS_CONTEXT_IN_WRONG_STATE, status);
+}
+
+TEST_F (ContextMoldTest, enable_arena_referenced_context_shall_outlive_mold)
+{
+    const char *name;
+    int32_t size;
+
+    status = dc_enable_arena (context_mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_add_keyval_string (context_mold, "keyval1",
+                                   "keyval1_value", "keyval1_doc", NULL, &context);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_add_keyval_string (context_mold, "keyval2", "keyval2_value",
+                                   "keyval2_doc", NULL, NULL);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_mold_finalize (&context_mold, &mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_get_name (context, &name, &size);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = disir_mold_finished (&mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    // Destroyed along with the mold, but the reference held remains valid.
+    status = dc_get_name (context, &name, &size);
+    ASSERT_STATUS (DISIR_STATUS_DESTROYED_CONTEXT, status);
+}
+
+TEST_F (ContextMoldTest, enable_arena_get_elements)
+{
+    struct disir_context *context_section;
+
+    status = dc_enable_arena (context_mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    // Enabling twice is a no-op.
+    status = dc_enable_arena (context_mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_add_keyval_string (context_mold, "keyval1",
+                                   "keyval1_value", "keyval1_doc", NULL, NULL);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_add_keyval_string (context_mold, "keyval2", "keyval2_value",
+                                   "keyval2_doc", NULL, NULL);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    // A destroyed context allocated in the arena shall not disturb the rest of the tree.
+    status = dc_begin (context_mold, DISIR_CONTEXT_SECTION, &context_section);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_destroy (&context_section);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_mold_finalize (&context_mold, &mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    ASSERT_EQ (NULL, context_mold);
+
+    context_mold = dc_mold_getcontext (mold);
+    ASSERT_TRUE (context_mold != NULL);
+
+    status = dc_get_elements (context_mold, &collection);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    ASSERT_EQ (2, dc_collection_size (collection));
+
+    status = dc_collection_next (collection, &context);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    ASSERT_EQ (DISIR_CONTEXT_KEYVAL, dc_context_type (context));
+
+    // cleanup
+    dc_putcontext (&context);
+    dc_putcontext (&context_mold);
+}
@@ -272,6 +272,59 @@ TEST_F (ContextRestrictionConfigConstructingEntriesTestPluginTest,
     ASSERT_STATUS (DISIR_STATUS_INVALID_CONTEXT, status);
 }
 
+// Removing the surplus entry from a finalized, invalid section
+// shall make the section valid again when the config is finalized.
+TEST_F (ContextRestrictionConfigConstructingEntriesTestPluginTest,
+        destroying_entry_in_finalized_section_revalidates_section)
+{
+    ASSERT_NO_SETUP_FAILURE();
+
+    struct disir_version semver;
+    ASSERT_NO_FATAL_FAILURE (
+        setup_testmold ("restriction_section_parent_keyval_max_entry");
+    );
+
+    // Set config version to 1.0.0 - this sets max at 2
+    semver.sv_major = 1;
+    semver.sv_minor = 0;
+    status = dc_set_version (context_config, &semver);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_begin (context_config, DISIR_CONTEXT_SECTION, &context_section);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_set_name (context_section, "section", strlen ("section"));
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    for (int i = 0; i < 3; i++)
+    {
+        status = dc_begin (context_section, DISIR_CONTEXT_KEYVAL, &context_keyval);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        status = dc_set_name (context_keyval, "keyval", strlen ("keyval"));
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        status = dc_finalize (&context_keyval);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+    }
+
+    status = dc_finalize (&context_section);
+    ASSERT_STATUS (DISIR_STATUS_INVALID_CONTEXT, status);
+    ASSERT_STATUS (DISIR_STATUS_INVALID_CONTEXT, dc_context_valid (context_section));
+
+    // Remove the third instance
+    status = dc_find_element (context_section, "keyval", 2, &context_keyval);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_destroy (&context_keyval);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_config_finalize (&context_config, &config);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STATUS (DISIR_STATUS_OK, dc_context_valid (context_section));
+
+    dc_putcontext (&context_section);
+
+    status = disir_config_valid (config, NULL);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+}
+
 // Adding a keyval to a finalized config parent that violates max entries
 // is not allowed.
 // dc_set_name shall fail with DISIR_STATUS_RESTRICTION_VIOLATED
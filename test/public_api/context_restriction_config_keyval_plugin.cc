@@ -193,3 +193,180 @@ TEST_F (ContextRestrictionConfigConstructingKeyvalPluginTest, float_restriction_
     ASSERT_EQ (45.87, value);
 }
 
+
+TEST_F (ContextRestrictionConfigFinalizedKeyvalPluginTest, float_restriction_set_versioned_valid)
+{
+    status = dc_find_element (context_config, "float_complex", 0, &context_integer);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    // Introduced in version 1.1, which is the version of the config
+    status = dc_set_value_float (context_integer, 13.37);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_set_value_float (context_integer, 100.0);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    // Endpoints of the unversioned range
+    status = dc_set_value_float (context_integer, 5.55);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_set_value_float (context_integer, 10.14);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+}
+
+TEST_F (ContextRestrictionConfigFinalizedKeyvalPluginTest, float_restriction_set_invalid_lists_allowed)
+{
+    status = dc_find_element (context_config, "float_complex", 0, &context_integer);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    // Between the unversioned range and the versioned numeric
+    status = dc_set_value_float (context_integer, 12.0);
+    ASSERT_STATUS (DISIR_STATUS_RESTRICTION_VIOLATED, status);
+
+    error = dc_context_error (context_integer);
+    ASSERT_TRUE (error != NULL);
+    EXPECT_STREQ ("No exclusive restrictions fulfilled for value 12.000000."
+                  " Must be one of: [5.550000, 10.140000], 66.690000, 13.370000,"
+                  " [60.000000, 100.000000]", error);
+}
+
+TEST_F (ContextRestrictionConfigConstructingKeyvalPluginTest,
+        float_restriction_introduced_later_than_config_is_inactive)
+{
+    struct disir_version version;
+
+    version.sv_major = 1;
+    version.sv_minor = 0;
+    status = dc_set_version (context_config, &version);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_set_name (context_keyval, "float_complex", strlen ("float_complex"));
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    // Only introduced in version 1.1
+    status = dc_set_value_float (context_keyval, 80.0);
+    ASSERT_STATUS (DISIR_STATUS_RESTRICTION_VIOLATED, status);
+
+    status = dc_set_value_float (context_keyval, 66.69);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+}
+
+class ContextRestrictionConfigEnumKeyvalTest : public testing::DisirTestWrapper
+{
+    void SetUp()
+    {
+        struct disir_context *context_mold = NULL;
+        struct disir_context *context_enum = NULL;
+        struct disir_version version;
+        char value[32];
+        int i;
+
+        DisirLogCurrentTestEnter ();
+
+        version.sv_major = 1;
+        version.sv_minor = 1;
+
+        status = dc_mold_begin (&context_mold);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        status = dc_add_keyval_enum (context_mold, "color", "color_0", "color doc",
+                                     NULL, &context_enum);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+        // The upper half of the values are introduced in version 1.1
+        for (i = 0; i < 64; i++)
+        {
+            snprintf (value, sizeof (value), "color_%d", i);
+            status = dc_add_restriction_value_enum (context_enum, value, "color value doc",
+                                                    (i < 32 ? NULL : &version), NULL);
+            ASSERT_STATUS (DISIR_STATUS_OK, status);
+        }
+        dc_putcontext (&context_enum);
+
+        status = dc_mold_finalize (&context_mold, &mold);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+        status = dc_config_begin (mold, &context_config);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        status = dc_begin (context_config, DISIR_CONTEXT_KEYVAL, &context_keyval);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+        DisirLogTestBodyEnter ();
+    }
+
+    void TearDown()
+    {
+        DisirLogTestBodyExit ();
+
+        if (context_keyval)
+        {
+            dc_destroy (&context_keyval);
+        }
+        if (context_config)
+        {
+            dc_destroy (&context_config);
+        }
+        if (mold)
+        {
+            disir_mold_finished (&mold);
+        }
+
+        DisirLogCurrentTestExit ();
+    }
+
+public:
+    enum disir_status status;
+    struct disir_mold *mold = NULL;
+    struct disir_context *context_config = NULL;
+    struct disir_context *context_keyval = NULL;
+};
+
+TEST_F (ContextRestrictionConfigEnumKeyvalTest, enum_restriction_set_every_value_valid)
+{
+    struct disir_version version;
+    char value[32];
+    int i;
+
+    version.sv_major = 1;
+    version.sv_minor = 1;
+    status = dc_set_version (context_config, &version);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_set_name (context_keyval, "color", strlen ("color"));
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    for (i = 0; i < 64; i++)
+    {
+        snprintf (value, sizeof (value), "color_%d", i);
+        status = dc_set_value_enum (context_keyval, value, strlen (value));
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+    }
+}
+
+TEST_F (ContextRestrictionConfigEnumKeyvalTest, enum_restriction_set_unknown_value_invalid)
+{
+    status = dc_set_name (context_keyval, "color", strlen ("color"));
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_set_value_enum (context_keyval, "color_64", strlen ("color_64"));
+    ASSERT_STATUS (DISIR_STATUS_RESTRICTION_VIOLATED, status);
+
+    status = dc_set_value_enum (context_keyval, "color_", strlen ("color_"));
+    ASSERT_STATUS (DISIR_STATUS_RESTRICTION_VIOLATED, status);
+}
+
+TEST_F (ContextRestrictionConfigEnumKeyvalTest, enum_restriction_introduced_later_than_config_invalid)
+{
+    struct disir_version version;
+
+    version.sv_major = 1;
+    version.sv_minor = 0;
+    status = dc_set_version (context_config, &version);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_set_name (context_keyval, "color", strlen ("color"));
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_set_value_enum (context_keyval, "color_31", strlen ("color_31"));
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_set_value_enum (context_keyval, "color_32", strlen ("color_32"));
+    ASSERT_STATUS (DISIR_STATUS_RESTRICTION_VIOLATED, status);
+}
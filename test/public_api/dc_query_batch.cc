@@ -0,0 +1,237 @@
+#include <vector>
+
+// PUBLIC API
+#include <disir/disir.h>
+#include <disir/context.h>
+#include <disir/config.h>
+
+// TEST API
+#include "test_helper.h"
+
+
+//
+// This class tests the public API functions:
+//  dc_query_get_batch
+//  dc_query_set_batch
+//
+class DcQueryBatchTest : public testing::DisirTestTestPlugin
+{
+    void SetUp()
+    {
+        DisirTestTestPlugin::SetUp ();
+
+        status = disir_config_read (instance, "test", "config_query_permutations",
+                                    NULL, &config);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        context_config = dc_config_getcontext (config);
+
+        DisirLogTestBodyEnter ();
+    }
+
+    void TearDown()
+    {
+        DisirLogTestBodyExit ();
+
+        for (auto& query : queries)
+        {
+            dc_query_finished (&query);
+        }
+        if (context_config)
+        {
+            dc_putcontext (&context_config);
+        }
+        if (config)
+        {
+            disir_config_finished (&config);
+        }
+
+        DisirTestTestPlugin::TearDown ();
+    }
+
+public:
+    struct disir_query_item
+    item (const char *query_string, enum disir_value_type type, void *value)
+    {
+        struct disir_query *query = NULL;
+        struct disir_query_item item = {};
+
+        status = dc_query_compile (&query, query_string);
+        EXPECT_STATUS (DISIR_STATUS_OK, status);
+        queries.push_back (query);
+
+        item.qi_query = query;
+        item.qi_type = type;
+        item.qi_value = value;
+        item.qi_status = DISIR_STATUS_OK;
+        return item;
+    }
+
+    enum disir_status status;
+    std::vector<struct disir_query *> queries;
+    struct disir_context *context_config = NULL;
+    struct disir_config *config = NULL;
+};
+
+TEST_F (DcQueryBatchTest, invalid_argument)
+{
+    struct disir_query_item items[1] = {};
+
+    status = dc_query_get_batch (NULL, items, 1);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+
+    status = dc_query_get_batch (context_config, NULL, 1);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+
+    status = dc_query_set_batch (context_config, items, -1);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+
+    // Item without query
+    status = dc_query_get_batch (context_config, items, 1);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, items[0].qi_status);
+
+    status = dc_query_get_batch (context_config, items, 0);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+}
+
+TEST_F (DcQueryBatchTest, get_shall_populate_every_item)
+{
+    const char *string_first = NULL;
+    const char *string_second = NULL;
+    const char *string_maximal = NULL;
+    const char *enum_maximal = NULL;
+    int64_t integer_maximal = 0;
+    int64_t integer_second = 0;
+    double float_maximal = 0;
+    uint8_t boolean_maximal = 1;
+
+    struct disir_query_item items[] = {
+        item ("first.maximal.key_integer", DISIR_VALUE_TYPE_INTEGER, &integer_maximal),
+        item ("first.key_string", DISIR_VALUE_TYPE_STRING, &string_first),
+        item ("first.second.key_integer", DISIR_VALUE_TYPE_INTEGER, &integer_second),
+        item ("first@1.key_string", DISIR_VALUE_TYPE_STRING, &string_second),
+        item ("first.maximal.key_float", DISIR_VALUE_TYPE_FLOAT, &float_maximal),
+        item ("first.maximal.key_string", DISIR_VALUE_TYPE_STRING, &string_maximal),
+        item ("first.maximal.key_boolean", DISIR_VALUE_TYPE_BOOLEAN, &boolean_maximal),
+        item ("first.maximal.key_enum", DISIR_VALUE_TYPE_ENUM, &enum_maximal),
+    };
+
+    status = dc_query_get_batch (context_config, items, sizeof (items) / sizeof (items[0]));
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    for (auto& entry : items)
+    {
+        EXPECT_STATUS (DISIR_STATUS_OK, entry.qi_status);
+    }
+    EXPECT_STREQ ("string_value", string_first);
+    EXPECT_STREQ ("string_value", string_second);
+    EXPECT_STREQ ("test", string_maximal);
+    EXPECT_STREQ ("one", enum_maximal);
+    EXPECT_EQ (5, integer_maximal);
+    EXPECT_EQ (5, integer_second);
+    EXPECT_DOUBLE_EQ (3.14, float_maximal);
+    EXPECT_EQ (0, boolean_maximal);
+}
+
+TEST_F (DcQueryBatchTest, get_shall_report_missing_items_individually)
+{
+    const char *string_value = NULL;
+    const char *string_missing = NULL;
+    int64_t integer_missing = 0;
+    int64_t integer_value = 0;
+
+    struct disir_query_item items[] = {
+        item ("first.key_string", DISIR_VALUE_TYPE_STRING, &string_value),
+        item ("first.missing.key_integer", DISIR_VALUE_TYPE_INTEGER, &integer_missing),
+        item ("first.key_missing", DISIR_VALUE_TYPE_STRING, &string_missing),
+        item ("first.second.key_integer", DISIR_VALUE_TYPE_INTEGER, &integer_value),
+    };
+
+    status = dc_query_get_batch (context_config, items, sizeof (items) / sizeof (items[0]));
+    EXPECT_STATUS (DISIR_STATUS_NOT_EXIST, status);
+
+    EXPECT_STATUS (DISIR_STATUS_OK, items[0].qi_status);
+    EXPECT_STATUS (DISIR_STATUS_NOT_EXIST, items[1].qi_status);
+    EXPECT_STATUS (DISIR_STATUS_NOT_EXIST, items[2].qi_status);
+    EXPECT_STATUS (DISIR_STATUS_OK, items[3].qi_status);
+    EXPECT_STREQ ("string_value", string_value);
+    EXPECT_EQ (5, integer_value);
+}
+
+TEST_F (DcQueryBatchTest, get_shall_report_wrong_type)
+{
+    double float_value = 0;
+
+    struct disir_query_item items[] = {
+        item ("first.key_string", DISIR_VALUE_TYPE_FLOAT, &float_value),
+    };
+
+    status = dc_query_get_batch (context_config, items, 1);
+    EXPECT_STATUS (DISIR_STATUS_WRONG_VALUE_TYPE, status);
+    EXPECT_STATUS (DISIR_STATUS_WRONG_VALUE_TYPE, items[0].qi_status);
+}
+
+TEST_F (DcQueryBatchTest, set_shall_update_and_create_keyvals)
+{
+    const char *string_value = "batch";
+    const char *string_created = "created";
+    const char *enum_value = "two";
+    int64_t integer_value = 42;
+    double float_value = 6.28;
+    uint8_t boolean_value = 1;
+
+    struct disir_query_item items[] = {
+        item ("first.maximal.key_integer", DISIR_VALUE_TYPE_INTEGER, &integer_value),
+        item ("first@1.key_string@1", DISIR_VALUE_TYPE_STRING, &string_created),
+        item ("first.key_string", DISIR_VALUE_TYPE_STRING, &string_value),
+        item ("first.maximal.key_float", DISIR_VALUE_TYPE_FLOAT, &float_value),
+        item ("first.maximal.key_boolean", DISIR_VALUE_TYPE_BOOLEAN, &boolean_value),
+        item ("first.maximal.key_enum", DISIR_VALUE_TYPE_ENUM, &enum_value),
+    };
+
+    status = dc_query_set_batch (context_config, items, sizeof (items) / sizeof (items[0]));
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    const char *string_result = NULL;
+    const char *enum_result = NULL;
+    int64_t integer_result = 0;
+    double float_result = 0;
+    uint8_t boolean_result = 0;
+
+    status = dc_query_get_integer (context_config, items[0].qi_query, &integer_result);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_EQ (42, integer_result);
+
+    status = dc_query_get_string (context_config, items[1].qi_query, &string_result);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("created", string_result);
+
+    status = dc_query_get_string (context_config, items[2].qi_query, &string_result);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("batch", string_result);
+
+    status = dc_query_get_float (context_config, items[3].qi_query, &float_result);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_DOUBLE_EQ (6.28, float_result);
+
+    status = dc_query_get_boolean (context_config, items[4].qi_query, &boolean_result);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_EQ (1, boolean_result);
+
+    status = dc_query_get_enum (context_config, items[5].qi_query, &enum_result);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("two", enum_result);
+}
+
+TEST_F (DcQueryBatchTest, set_shall_not_create_out_of_order)
+{
+    const char *string_value = "value";
+
+    struct disir_query_item items[] = {
+        item ("first.key_string@2", DISIR_VALUE_TYPE_STRING, &string_value),
+    };
+
+    status = dc_query_set_batch (context_config, items, 1);
+    EXPECT_STATUS (DISIR_STATUS_NOT_EXIST, status);
+    EXPECT_STATUS (DISIR_STATUS_NOT_EXIST, items[0].qi_status);
+}
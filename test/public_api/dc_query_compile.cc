@@ -0,0 +1,249 @@
+// PUBLIC API
+#include <disir/disir.h>
+#include <disir/context.h>
+#include <disir/config.h>
+
+// TEST API
+#include "test_helper.h"
+
+
+//
+// This class tests the public API functions:
+//  dc_query_compile
+//  dc_query_finished
+//  dc_query_resolve
+//  dc_query_get_*
+//  dc_query_set_*
+//
+class DcQueryCompileTest : public testing::DisirTestTestPlugin
+{
+    void SetUp()
+    {
+        DisirTestTestPlugin::SetUp ();
+
+        status = disir_config_read (instance, "test", "config_query_permutations",
+                                    NULL, &config);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        context_config = dc_config_getcontext (config);
+
+        DisirLogTestBodyEnter ();
+    }
+
+    void TearDown()
+    {
+        DisirLogTestBodyExit ();
+
+        if (query)
+        {
+            dc_query_finished (&query);
+        }
+        if (context)
+        {
+            dc_putcontext (&context);
+        }
+        if (context_config)
+        {
+            dc_putcontext (&context_config);
+        }
+        if (config)
+        {
+            disir_config_finished (&config);
+        }
+
+        DisirTestTestPlugin::TearDown ();
+    }
+
+public:
+    enum disir_status status;
+    const char *string_value = NULL;
+    struct disir_query *query = NULL;
+    struct disir_context *context = NULL;
+    struct disir_context *context_config = NULL;
+    struct disir_config *config = NULL;
+};
+
+TEST_F (DcQueryCompileTest, compile_invalid_argument)
+{
+    status = dc_query_compile (NULL, "first.key_string");
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+
+    status = dc_query_compile (&query, NULL);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+
+    status = dc_query_finished (NULL);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+
+    status = dc_query_finished (&query);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+}
+
+TEST_F (DcQueryCompileTest, compile_malformed_query_shall_fail)
+{
+    const char *malformed[] = {
+        "",
+        ".second.third@3",
+        "first@2.@4.third",
+        "@2.second",
+        "first@5..third",
+        "first@3.second@",
+        "first@2.second.",
+        "first@2x.second",
+    };
+    unsigned int i;
+
+    for (i = 0; i < sizeof (malformed) / sizeof (const char *); i++)
+    {
+        status = dc_query_compile (&query, "%s", malformed[i]);
+        EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+        EXPECT_TRUE (query == NULL);
+    }
+}
+
+TEST_F (DcQueryCompileTest, resolve_shall_match_uncompiled_query)
+{
+    struct disir_context *expected;
+
+    status = dc_query_compile (&query, "first@%d.second.key_integer", 1);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_query_resolve (context_config, query, &context);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_query_resolve_context (context_config, "first@1.second.key_integer", &expected);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_EQ (expected, context);
+    dc_putcontext (&expected);
+}
+
+TEST_F (DcQueryCompileTest, resolve_nonexisting_shall_fail)
+{
+    status = dc_query_compile (&query, "first@2.key_string@6");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_query_resolve (context_config, query, &context);
+    ASSERT_STATUS (DISIR_STATUS_NOT_EXIST, status);
+    ASSERT_TRUE (context == NULL);
+
+    status = dc_query_get_string (context_config, query, &string_value);
+    ASSERT_STATUS (DISIR_STATUS_NOT_EXIST, status);
+    ASSERT_TRUE (string_value == NULL);
+}
+
+TEST_F (DcQueryCompileTest, get_each_value_type)
+{
+    int64_t integer_value;
+    double float_value;
+    uint8_t boolean_value;
+
+    status = dc_query_compile (&query, "first.maximal.key_string");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_query_get_string (context_config, query, &string_value);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("test", string_value);
+    dc_query_finished (&query);
+
+    status = dc_query_compile (&query, "first.maximal.key_integer");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_query_get_integer (context_config, query, &integer_value);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_EQ (5, integer_value);
+
+    // Wrong value type
+    status = dc_query_get_string (context_config, query, &string_value);
+    EXPECT_STATUS (DISIR_STATUS_WRONG_VALUE_TYPE, status);
+    dc_query_finished (&query);
+
+    status = dc_query_compile (&query, "first.maximal.key_float");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_query_get_float (context_config, query, &float_value);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_EQ (3.14, float_value);
+    dc_query_finished (&query);
+
+    status = dc_query_compile (&query, "first.maximal.key_boolean");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_query_get_boolean (context_config, query, &boolean_value);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_EQ (0, boolean_value);
+    dc_query_finished (&query);
+
+    status = dc_query_compile (&query, "first.maximal.key_enum");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_query_get_enum (context_config, query, &string_value);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("one", string_value);
+}
+
+TEST_F (DcQueryCompileTest, set_existing_keyval)
+{
+    int64_t integer_value;
+
+    status = dc_query_compile (&query, "first@1.second.key_integer");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_query_set_integer (context_config, query, 3);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_query_get_integer (context_config, query, &integer_value);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_EQ (3, integer_value);
+
+    status = dc_query_set_string (context_config, query, "bloody");
+    EXPECT_STATUS (DISIR_STATUS_WRONG_VALUE_TYPE, status);
+}
+
+TEST_F (DcQueryCompileTest, set_nonexisting_keyval_within_range)
+{
+    status = dc_query_compile (&query, "first@1.key_string@1");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_query_set_string (context_config, query, "bloody");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = dc_query_get_string (context_config, query, &string_value);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("bloody", string_value);
+}
+
+TEST_F (DcQueryCompileTest, set_nonexisting_keyval_outside_range)
+{
+    status = dc_query_compile (&query, "first@1.key_string@2");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_query_set_string (context_config, query, "bloody");
+    ASSERT_STATUS (DISIR_STATUS_NOT_EXIST, status);
+}
+
+TEST_F (DcQueryCompileTest, set_invalid_keyval)
+{
+    status = dc_query_compile (&query, "first@1.bloody_key");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_query_set_string (context_config, query, "bloody");
+    ASSERT_STATUS (DISIR_STATUS_MOLD_MISSING, status);
+}
+
+TEST_F (DcQueryCompileTest, compiled_query_shall_resolve_against_multiple_configs)
+{
+    struct disir_config *other = NULL;
+    struct disir_context *context_other = NULL;
+
+    status = disir_config_read (instance, "test", "config_query_permutations", NULL, &other);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    context_other = dc_config_getcontext (other);
+
+    status = dc_query_compile (&query, "first.key_string");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_query_set_string (context_other, query, "other");
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+
+    status = dc_query_get_string (context_config, query, &string_value);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("string_value", string_value);
+
+    status = dc_query_get_string (context_other, query, &string_value);
+    EXPECT_STATUS (DISIR_STATUS_OK, status);
+    EXPECT_STREQ ("other", string_value);
+
+    dc_putcontext (&context_other);
+    disir_config_finished (&other);
+}
@@ -7,6 +7,8 @@
 #include <archive.h>
 #include <archive_entry.h>
 #include <map>
+#include <fstream>
+#include <iterator>
 
 
 //! Contains tests that test the public disir_archive_begin API with an existing archive.
@@ -199,6 +201,33 @@ public:
         archive_read_free (archive);
     }
 
+    //! Read every member of the archive at archive_path_out, in any compression,
+    //! without reading past the first end-of-archive marker.
+    void read_archive_members (std::multimap<std::string, std::string>& content)
+    {
+        struct archive *archive;
+        struct archive_entry *archive_entry;
+        char buffer[4096];
+        la_ssize_t size;
+
+        archive = archive_read_new ();
+        archive_read_support_format_tar (archive);
+        archive_read_support_filter_all (archive);
+
+        ASSERT_EQ (ARCHIVE_OK, archive_read_open_filename (archive, archive_path_out, 10240));
+        while (archive_read_next_header (archive, &archive_entry) == ARCHIVE_OK)
+        {
+            std::string data;
+            while ((size = archive_read_data (archive, buffer, sizeof (buffer))) > 0)
+            {
+                data.append (buffer, size);
+            }
+            content.emplace (archive_entry_pathname (archive_entry), data);
+        }
+
+        archive_read_free (archive);
+    }
+
 
     void archive_diff (std::vector<std::string> lhs, std::vector<std::string> rhs,
                                                      std::vector<std::string>& diff)
@@ -1029,3 +1058,119 @@ TEST_F (ArchiveExistingTest, not_permitted_to_read_archive)
 
     ASSERT_STREQ ("unable to read archive: '/tmp/archive.disir'", disir_error (instance_export));
 }
+
+TEST_F (ArchiveExistingTest, append_keeps_existing_entries_compressed)
+{
+    struct disir_archive_options options = {};
+
+    for (auto compression : { DISIR_ARCHIVE_COMPRESSION_XZ, DISIR_ARCHIVE_COMPRESSION_ZSTD,
+                              DISIR_ARCHIVE_COMPRESSION_NONE })
+    {
+        std::multimap<std::string, std::string> content;
+        std::string old_bytes;
+        std::string new_bytes;
+        long long offset = 0;
+
+        options.ao_compression = compression;
+        status = disir_archive_export_begin_with_options (instance_export, NULL,
+                                                          &options, &disir_archive);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        status = disir_archive_append_entry (instance_export, disir_archive,
+                                             "JSON", "basic_keyval");
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        status = disir_archive_finalize (instance_export, archive_path_in, &disir_archive);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+        std::ifstream old_archive (archive_path_out, std::ios::binary);
+        old_bytes.assign (std::istreambuf_iterator<char> (old_archive),
+                          std::istreambuf_iterator<char> ());
+
+        ASSERT_NO_FATAL_FAILURE (read_archive_members (content));
+        ASSERT_EQ (1u, content.count ("metadata.toml"));
+        auto metadata = content.find ("metadata.toml")->second;
+        auto key = metadata.find ("metadata_offset = ");
+        ASSERT_NE (std::string::npos, key);
+        offset = std::stoll (metadata.substr (key + strlen ("metadata_offset = ")));
+        ASSERT_GT (offset, 0);
+
+        status = disir_archive_export_begin (instance_export, archive_path_out, &disir_archive);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        status = disir_archive_append_entry (instance_export, disir_archive,
+                                             "JSON", "basic_section");
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        status = disir_archive_finalize (instance_export, archive_path_in, &disir_archive);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+        std::ifstream new_archive (archive_path_out, std::ios::binary);
+        new_bytes.assign (std::istreambuf_iterator<char> (new_archive),
+                          std::istreambuf_iterator<char> ());
+
+        // The compressed existing entries are copied verbatim
+        ASSERT_TRUE (new_bytes.compare (0, offset, old_bytes, 0, offset) == 0);
+
+        // A single archive holds both entries and one set of metadata
+        content.clear ();
+        ASSERT_NO_FATAL_FAILURE (read_archive_members (content));
+        EXPECT_EQ (1u, content.count ("metadata.toml"));
+        EXPECT_EQ (1u, content.count ("JSON/entries.toml"));
+        EXPECT_EQ (1u, content.count ("JSON/JSON/basic_keyval"));
+        EXPECT_EQ (1u, content.count ("JSON/JSON/basic_section"));
+
+        // Both entries are known to the appended archive
+        status = disir_archive_export_begin (instance_export, archive_path_out, &disir_archive);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        status = disir_archive_append_entry (instance_export, disir_archive,
+                                             "JSON", "basic_keyval");
+        EXPECT_STATUS (DISIR_STATUS_EXISTS, status);
+        status = disir_archive_append_entry (instance_export, disir_archive,
+                                             "JSON", "basic_section");
+        EXPECT_STATUS (DISIR_STATUS_EXISTS, status);
+        status = disir_archive_finalize (instance_export, NULL, &disir_archive);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+        remove_file (archive_path_out);
+    }
+}
+
+TEST_F (ArchiveExistingTest, append_with_other_compression_rewrites)
+{
+    struct disir_archive_options options = {};
+    struct archive_entry *archive_entry;
+    std::vector<std::string> content;
+    int ret;
+
+    status = disir_archive_export_begin (instance_export, NULL, &disir_archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = disir_archive_append_entry (instance_export, disir_archive, "JSON", "basic_keyval");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = disir_archive_finalize (instance_export, archive_path_in, &disir_archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    options.ao_compression = DISIR_ARCHIVE_COMPRESSION_ZSTD;
+    status = disir_archive_export_begin_with_options (instance_export, archive_path_out,
+                                                      &options, &disir_archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = disir_archive_append_entry (instance_export, disir_archive, "JSON", "basic_section");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = disir_archive_finalize (instance_export, archive_path_in, &disir_archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    // A single zstd archive holds both entries
+    archive = archive_read_new ();
+    archive_read_support_format_tar (archive);
+    archive_read_support_filter_zstd (archive);
+
+    ret = archive_read_open_filename (archive, archive_path_out, 10240);
+    ASSERT_TRUE (ret == ARCHIVE_OK);
+    while (archive_read_next_header (archive, &archive_entry) == ARCHIVE_OK)
+    {
+        content.push_back (archive_entry_pathname (archive_entry));
+    }
+    archive_read_free (archive);
+    archive = NULL;
+
+    EXPECT_TRUE (std::find (content.begin(), content.end(), "JSON/JSON/basic_keyval")
+                 != content.end());
+    EXPECT_TRUE (std::find (content.begin(), content.end(), "JSON/JSON/basic_section")
+                 != content.end());
+}
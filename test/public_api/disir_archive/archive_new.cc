@@ -6,6 +6,8 @@
 #include <archive.h>
 #include <archive_entry.h>
 #include <libgen.h>
+#include <fstream>
+#include <sstream>
 
 
 //! Contains tests that test the public disir_archive_append_group API.
@@ -46,6 +48,47 @@ class ArchiveAppendNewTest : public testing::DisirTestArchive
         archive_entry = NULL;
         DisirTestArchive::TearDown ();
     }
+public:
+    //! Read the content of the config entry name from the finalized archive.
+    void read_archive_entry (const std::string& name, std::string& content)
+    {
+        std::vector<char> buffer (8192);
+        la_ssize_t size;
+        int ret;
+
+        archive = archive_read_new();
+        archive_read_support_format_tar (archive);
+        archive_read_support_filter_xz (archive);
+
+        ret = archive_read_open_filename (archive, archive_path_out, 10240);
+        ASSERT_TRUE (ret == ARCHIVE_OK);
+
+        while (archive_read_next_header (archive, &archive_entry) == ARCHIVE_OK)
+        {
+            if (name != archive_entry_pathname (archive_entry))
+                continue;
+
+            while ((size = archive_read_data (archive, buffer.data(), buffer.size())) > 0)
+            {
+                content.append (buffer.data(), size);
+            }
+            ASSERT_EQ (0, size);
+        }
+
+        archive_read_free (archive);
+    }
+
+    //! Read the serialized config of entry, as written by the JSON plugin.
+    void read_config_file (const std::string& entry, std::string& content)
+    {
+        std::ifstream file ("/tmp/export/test_configs/" + entry + ".json");
+        std::stringstream stream;
+
+        ASSERT_TRUE (file.good ());
+        stream << file.rdbuf ();
+        content = stream.str ();
+    }
+
 public:
     enum disir_status status;
     struct disir_archive *disir_archive = NULL;
@@ -305,3 +348,148 @@ TEST_F (ArchiveAppendNewTest, finalize_with_path_to_directory)
 
     ASSERT_EQ (stat (archive_path_out, &st), 0);
 }
+
+TEST_F (ArchiveAppendNewTest, zstd_compression)
+{
+    struct disir_archive_options options = {};
+    int ret;
+
+    // Discard the default archive from SetUp
+    status = disir_archive_finalize (instance_export, NULL, &disir_archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    options.ao_compression = DISIR_ARCHIVE_COMPRESSION_ZSTD;
+    options.ao_level = 3;
+    options.ao_threads = 2;
+    status = disir_archive_export_begin_with_options (instance_export, NULL,
+                                                      &options, &disir_archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = disir_archive_append_entry (instance_export, disir_archive, "JSON", "basic_keyval");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = disir_archive_finalize (instance_export, archive_path_in, &disir_archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    archive = archive_read_new();
+    archive_read_support_format_tar (archive);
+    archive_read_support_filter_zstd (archive);
+
+    ret = archive_read_open_filename (archive, archive_path_out, 10240);
+    ASSERT_TRUE (ret == ARCHIVE_OK);
+    ASSERT_EQ (archive_read_next_header (archive, &archive_entry), ARCHIVE_OK);
+    EXPECT_EQ (archive_filter_code (archive, 0), ARCHIVE_FILTER_ZSTD);
+
+    archive_read_free (archive);
+}
+
+TEST_F (ArchiveAppendNewTest, no_compression)
+{
+    struct disir_archive_options options = {};
+    int ret;
+
+    status = disir_archive_finalize (instance_export, NULL, &disir_archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    options.ao_compression = DISIR_ARCHIVE_COMPRESSION_NONE;
+    status = disir_archive_export_begin_with_options (instance_export, NULL,
+                                                      &options, &disir_archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = disir_archive_append_entry (instance_export, disir_archive, "JSON", "basic_keyval");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = disir_archive_finalize (instance_export, archive_path_in, &disir_archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    archive = archive_read_new();
+    archive_read_support_format_tar (archive);
+
+    ret = archive_read_open_filename (archive, archive_path_out, 10240);
+    ASSERT_TRUE (ret == ARCHIVE_OK);
+    ASSERT_EQ (archive_read_next_header (archive, &archive_entry), ARCHIVE_OK);
+    EXPECT_EQ (archive_filter_code (archive, 0), ARCHIVE_FILTER_NONE);
+
+    archive_read_free (archive);
+}
+
+TEST_F (ArchiveAppendNewTest, invalid_compression)
+{
+    struct disir_archive_options options = {};
+    struct disir_archive *invalid = NULL;
+
+    status = disir_archive_finalize (instance_export, NULL, &disir_archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    options.ao_compression = (enum disir_archive_compression) 42;
+    status = disir_archive_export_begin_with_options (instance_export, NULL,
+                                                      &options, &invalid);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+    EXPECT_TRUE (invalid == NULL);
+
+    options.ao_compression = DISIR_ARCHIVE_COMPRESSION_XZ;
+    options.ao_level = 42;
+    status = disir_archive_export_begin_with_options (instance_export, NULL,
+                                                      &options, &invalid);
+    EXPECT_STATUS (DISIR_STATUS_INVALID_ARGUMENT, status);
+    EXPECT_TRUE (invalid == NULL);
+}
+
+TEST_F (ArchiveAppendNewTest, entry_content_matches_serialized_config)
+{
+    std::string expected;
+    std::string content;
+
+    status = disir_archive_append_entry (instance_export, disir_archive, "JSON", "basic_keyval");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = disir_archive_finalize (instance_export, archive_path_in, &disir_archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    read_config_file ("basic_keyval", expected);
+    read_archive_entry ("JSON/JSON/basic_keyval", content);
+
+    ASSERT_FALSE (content.empty ());
+    ASSERT_EQ (expected, content);
+}
+
+TEST_F (ArchiveAppendNewTest, large_entry_content_matches_serialized_config)
+{
+    struct disir_mold *mold = NULL;
+    struct disir_config *config = NULL;
+    std::string expected;
+    std::string content;
+    // Well beyond any initial size of the in-memory serialization buffer
+    std::string value (1024 * 1024, 'x');
+
+    status = disir_mold_read (instance_export, "test", "basic_keyval", &mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = disir_generate_config_from_mold (mold, NULL, &config);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = disir_config_set_keyval_string (config, value.c_str(), "key_string");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = disir_mold_write (instance_export, "JSON", "large_keyval", mold);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    status = disir_config_write (instance_export, "JSON", "large_keyval", config);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    disir_config_finished (&config);
+    disir_mold_finished (&mold);
+
+    status = disir_archive_append_entry (instance_export, disir_archive, "JSON", "large_keyval");
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = disir_archive_finalize (instance_export, archive_path_in, &disir_archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    read_config_file ("large_keyval", expected);
+    read_archive_entry ("JSON/JSON/large_keyval", content);
+
+    ASSERT_GT (content.size (), value.size ());
+    ASSERT_NE (std::string::npos, content.find (value));
+    ASSERT_EQ (expected, content);
+
+    remove ("/tmp/export/test_configs/large_keyval.json");
+    remove ("/tmp/export/test_molds/large_keyval.json");
+}
@@ -329,6 +329,61 @@ TEST_F (ImportTest, import_imported_config_version_higher_than_existing)
     );
 }
 
+TEST_F (ImportTest, import_extracted_archive)
+{
+    setup_export_import_config ("json_test_mold", "json_test_mold_2_0", true, NULL);
+
+    status = disir_archive_finalize (instance_export, "/tmp/archive.disir", &archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = disir_archive_import_with_flags (instance_import, "/tmp/archive.disir",
+                                              DISIR_ARCHIVE_IMPORT_EXTRACT,
+                                              &import, &import_entries);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    ASSERT_EQ (1, import_entries);
+
+    status = disir_import_entry_status (import, 0, &entry_id, &group_id, &version, &errmsg);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+    ASSERT_STREQ ("json_test_mold", entry_id);
+    ASSERT_STREQ ("2.0", version);
+
+    status = disir_import_resolve_entry (import, 0, DISIR_IMPORT_DO);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = disir_import_finalize (instance_import, DISIR_IMPORT_DO, &import, NULL);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    ASSERT_NO_FATAL_FAILURE (
+        compare_imported_with_ref ("json_test_mold", m_nondefault_configs["json_test_mold_2_0"]);
+    );
+}
+
+TEST_F (ImportTest, import_zstd_archive)
+{
+    struct disir_archive_options options = {};
+
+    status = disir_archive_finalize (instance_export, NULL, &archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    options.ao_compression = DISIR_ARCHIVE_COMPRESSION_ZSTD;
+    status = disir_archive_export_begin_with_options (instance_export, NULL, &options, &archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    setup_export_import_config ("json_test_mold", "json_test_mold_2_0", true, NULL);
+    finalize_export_begin_import ();
+    ASSERT_EQ (1, import_entries);
+
+    status = disir_import_resolve_entry (import, 0, DISIR_IMPORT_DO);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    status = disir_import_finalize (instance_import, DISIR_IMPORT_DO, &import, NULL);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    ASSERT_NO_FATAL_FAILURE (
+        compare_imported_with_ref ("json_test_mold", m_nondefault_configs["json_test_mold_2_0"]);
+    );
+}
+
 TEST_F (ImportTest, import_no_config_equiv_conflict)
 {
     setup_export_import_config ("multiple_defaults", "multiple_defaults_1_2", true, NULL);
@@ -547,3 +602,42 @@ TEST_F (ImportTest, import_equal_group_yet_no_equal_backend_name)
     disir_mold_finished (&mold);
 }
 
+
+TEST_F (ImportTest, import_with_jobs_shall_match_single_job)
+{
+    std::vector<std::string> reference;
+
+    setup_export_import_config ("json_test_mold", "json_test_mold_2_0", true, NULL);
+    setup_export_import_config ("multiple_defaults", "multiple_defaults_1_0", true,
+                                m_nondefault_configs["multiple_defaults_1_2"]);
+
+    status = disir_archive_finalize (instance_export, "/tmp/archive.disir", &archive);
+    ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+    for (int jobs : { 1, 2, 4, -1 })
+    {
+        std::vector<std::string> report;
+
+        status = disir_archive_import_with_jobs (instance_import, "/tmp/archive.disir", 0, jobs,
+                                                 &import, &import_entries);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+        ASSERT_EQ (2, import_entries);
+
+        for (int i = 0; i < import_entries; i++)
+        {
+            status = disir_import_entry_status (import, i, &entry_id, &group_id,
+                                                &version, &errmsg);
+            report.push_back (std::string (disir_status_string (status)) + " " + entry_id +
+                              " " + version + " " + (errmsg ? errmsg : ""));
+        }
+
+        status = disir_import_finalize (instance_import, DISIR_IMPORT_DISCARD, &import, NULL);
+        ASSERT_STATUS (DISIR_STATUS_OK, status);
+
+        if (reference.empty ())
+        {
+            reference = report;
+        }
+        EXPECT_EQ (reference, report) << "with " << jobs << " jobs";
+    }
+}
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <thread>
+#include <vector>
 
 #include <disir/disir.h>
 
@@ -81,3 +83,62 @@ TEST_F (DisirConfigTest, entries)
     ASSERT_GT (count, 0);
 }
 
+
+TEST_F (DisirConfigTest, error_shall_be_kept_per_thread)
+{
+    std::string other_error;
+    bool other_empty = false;
+
+    disir_error_set (instance, "main thread");
+
+    std::thread other ([&] ()
+    {
+        other_empty = (disir_error (instance) == NULL);
+        disir_error_set (instance, "other thread");
+        other_error = disir_error (instance);
+    });
+    other.join ();
+
+    EXPECT_TRUE (other_empty);
+    EXPECT_STREQ ("other thread", other_error.c_str ());
+    ASSERT_TRUE (disir_error (instance) != NULL);
+    EXPECT_STREQ ("main thread", disir_error (instance));
+
+    disir_error_clear (instance);
+}
+
+TEST_F (DisirConfigTest, read_concurrently_shall_succeed)
+{
+    enum disir_status results[8];
+    std::vector<std::thread> threads;
+    int i;
+
+    for (i = 0; i < 8; i++)
+    {
+        threads.emplace_back ([this, &results, i] ()
+        {
+            struct disir_config *config = NULL;
+            int j;
+
+            results[i] = DISIR_STATUS_OK;
+            for (j = 0; j < 20 && results[i] == DISIR_STATUS_OK; j++)
+            {
+                results[i] = disir_config_read (instance, "test", "basic_keyval",
+                                                NULL, &config);
+                if (config)
+                {
+                    disir_config_finished (&config);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join ();
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        EXPECT_STATUS (DISIR_STATUS_OK, results[i]);
+    }
+}